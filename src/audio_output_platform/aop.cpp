@@ -1,16 +1,18 @@
 #include "aop.h"
+#include "ring_buffer.h"
 #include "../assert_handler.h"  // JVE_ASSERT
 
 #include <QAudioFormat>
 #include <QAudioSink>
 #include <QMediaDevices>
 #include <QIODevice>
-#include <QMutex>
-#include <QMutexLocker>
 
+#include <algorithm>
 #include <vector>
 #include <atomic>
+#include <chrono>
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <string>
@@ -18,98 +20,6 @@
 
 namespace aop {
 
-// Ring buffer for audio data
-class RingBuffer {
-public:
-    explicit RingBuffer(size_t capacity_frames, int channels)
-        : m_channels(channels)
-        , m_capacity(capacity_frames * static_cast<size_t>(channels))
-        , m_buffer(m_capacity)
-        , m_read_pos(0)
-        , m_write_pos(0)
-        , m_count(0) {
-    }
-
-    // Write frames to buffer, returns frames written
-    int64_t write(const float* data, int64_t frames) {
-        QMutexLocker lock(&m_mutex);
-
-        size_t samples = static_cast<size_t>(frames) * static_cast<size_t>(m_channels);
-        size_t available = m_capacity - m_count;
-        size_t to_write = std::min(samples, available);
-
-        if (to_write == 0) return 0;
-
-        // Write in two parts if wrapping
-        size_t first_part = std::min(to_write, m_capacity - m_write_pos);
-        std::memcpy(m_buffer.data() + m_write_pos, data, first_part * sizeof(float));
-
-        size_t second_part = to_write - first_part;
-        if (second_part > 0) {
-            std::memcpy(m_buffer.data(), data + first_part, second_part * sizeof(float));
-        }
-
-        m_write_pos = (m_write_pos + to_write) % m_capacity;
-        m_count += to_write;
-
-        return static_cast<int64_t>(to_write / static_cast<size_t>(m_channels));
-    }
-
-    // Read frames from buffer, returns frames read
-    int64_t read(float* data, int64_t frames) {
-        QMutexLocker lock(&m_mutex);
-
-        size_t samples = static_cast<size_t>(frames) * static_cast<size_t>(m_channels);
-        size_t to_read = std::min(samples, m_count);
-
-        if (to_read == 0) {
-            // Underrun - fill with silence
-            std::memset(data, 0, samples * sizeof(float));
-            return 0;
-        }
-
-        // Read in two parts if wrapping
-        size_t first_part = std::min(to_read, m_capacity - m_read_pos);
-        std::memcpy(data, m_buffer.data() + m_read_pos, first_part * sizeof(float));
-
-        size_t second_part = to_read - first_part;
-        if (second_part > 0) {
-            std::memcpy(data + first_part, m_buffer.data(), second_part * sizeof(float));
-        }
-
-        m_read_pos = (m_read_pos + to_read) % m_capacity;
-        m_count -= to_read;
-
-        // If we read less than requested, fill rest with silence
-        if (to_read < samples) {
-            std::memset(data + to_read, 0, (samples - to_read) * sizeof(float));
-        }
-
-        return static_cast<int64_t>(to_read / static_cast<size_t>(m_channels));
-    }
-
-    int64_t available_frames() const {
-        QMutexLocker lock(&m_mutex);
-        return static_cast<int64_t>(m_count / static_cast<size_t>(m_channels));
-    }
-
-    void clear() {
-        QMutexLocker lock(&m_mutex);
-        m_read_pos = 0;
-        m_write_pos = 0;
-        m_count = 0;
-    }
-
-private:
-    int m_channels;
-    size_t m_capacity;
-    std::vector<float> m_buffer;
-    size_t m_read_pos;
-    size_t m_write_pos;
-    size_t m_count;
-    mutable QMutex m_mutex;
-};
-
 // QIODevice adapter for QAudioSink to read from ring buffer
 class AudioIODevice : public QIODevice {
 public:
@@ -139,6 +49,7 @@ public:
         }
 
         m_frames_read.fetch_add(frames_read, std::memory_order_relaxed);
+        check_low_watermark(frames_read < frames);
 
         return frames * bytes_per_frame;  // Always return requested amount (silence-padded)
     }
@@ -168,27 +79,261 @@ public:
         m_frames_read.store(0, std::memory_order_relaxed);
     }
 
+    // Swap in a new refill callback (nullptr = none). The pull thread
+    // only ever loads the pointer, so it never waits here; the setter
+    // waits for an in-flight call to finish before freeing the old one,
+    // so the owner of the old callback may be destroyed on return.
+    void set_low_watermark(int64_t frames, std::function<void()> on_low) {
+        auto* fn = (frames > 0 && on_low) ? new std::function<void()>(std::move(on_low)) : nullptr;
+        m_low_watermark.store(fn ? frames : 0);
+        m_low_armed.store(true);
+        std::function<void()>* old = m_on_low.exchange(fn);
+        while (m_low_in_flight.load() != 0) std::this_thread::yield();
+        delete old;
+    }
+
+    ~AudioIODevice() override {
+        delete m_on_low.exchange(nullptr);
+    }
+
 private:
+    // Pull thread. Edge-triggered: one notification per fall below the
+    // watermark (re-armed once the writer has refilled above it), plus
+    // one per underrunning pull, when the writer is behind anyway.
+    void check_low_watermark(bool underran) {
+        const int64_t wm = m_low_watermark.load(std::memory_order_relaxed);
+        if (wm <= 0) return;
+        if (m_buffer->available_frames() >= wm) {
+            m_low_armed.store(true, std::memory_order_relaxed);
+            return;
+        }
+        if (!m_low_armed.exchange(false, std::memory_order_relaxed) && !underran) return;
+
+        // seq_cst pairing with set_low_watermark: either the setter sees
+        // this call in flight and waits, or this load sees its swap.
+        m_low_in_flight.fetch_add(1);
+        if (std::function<void()>* fn = m_on_low.load()) (*fn)();
+        m_low_in_flight.fetch_sub(1);
+    }
+
     RingBuffer* m_buffer;
     int m_sample_rate;
     int m_channels;
     std::atomic<int64_t> m_frames_read;
     std::atomic<bool> m_had_underrun;
+
+    std::atomic<int64_t> m_low_watermark{0};
+    std::atomic<bool> m_low_armed{true};
+    std::atomic<std::function<void()>*> m_on_low{nullptr};
+    std::atomic<int> m_low_in_flight{0};
+};
+
+// Float32 WAV recorder for the virtual backend. Header sizes are patched
+// on every flush_header() (each sink stop) so the file is valid whenever
+// playback isn't running, and finally on destruction. RIFF sizes are 32
+// bits: recording stops at MAX_DATA_BYTES (~3.1h of 48 kHz stereo) and the
+// file stays valid; the sink itself keeps running.
+class WavWriter {
+public:
+    WavWriter(const std::string& path, int sample_rate, int channels)
+        : m_channels(channels) {
+        m_file = std::fopen(path.c_str(), "wb");
+        if (!m_file) return;
+        write_header(sample_rate);
+    }
+
+    ~WavWriter() {
+        if (!m_file) return;
+        flush_header();
+        std::fclose(m_file);
+    }
+
+    bool ok() const { return m_file != nullptr; }
+
+    void write(const float* data, int64_t frames) {
+        const uint32_t frame_bytes = static_cast<uint32_t>(m_channels * sizeof(float));
+        const int64_t room = (MAX_DATA_BYTES - m_data_bytes) / frame_bytes;
+        const int64_t n = std::min(frames, room);
+        if (n <= 0) return;
+        std::fwrite(data, frame_bytes, static_cast<size_t>(n), m_file);
+        m_data_bytes += static_cast<uint32_t>(n) * frame_bytes;
+    }
+
+    void flush_header() {
+        const long end = std::ftell(m_file);
+        const uint32_t frames = m_data_bytes / static_cast<uint32_t>(m_channels * sizeof(float));
+        put_u32_at(RIFF_SIZE_AT, static_cast<uint32_t>(HEADER_BYTES - 8) + m_data_bytes);
+        put_u32_at(FACT_FRAMES_AT, frames);
+        put_u32_at(DATA_SIZE_AT, m_data_bytes);
+        std::fseek(m_file, end, SEEK_SET);
+        std::fflush(m_file);
+    }
+
+private:
+    // RIFF + fmt (18 bytes, IEEE float) + fact + data header.
+    static constexpr long RIFF_SIZE_AT = 4;
+    static constexpr long FACT_FRAMES_AT = 46;
+    static constexpr long DATA_SIZE_AT = 54;
+    static constexpr uint32_t HEADER_BYTES = 58;
+    // Largest data chunk whose RIFF size (HEADER_BYTES - 8 + data) fits.
+    static constexpr uint32_t MAX_DATA_BYTES = UINT32_MAX - (HEADER_BYTES - 8);
+
+    void put(const void* p, size_t n) { std::fwrite(p, 1, n, m_file); }
+    void put_u16(uint16_t v) { uint8_t b[2] = {uint8_t(v), uint8_t(v >> 8)}; put(b, 2); }
+    void put_u32(uint32_t v) {
+        uint8_t b[4] = {uint8_t(v), uint8_t(v >> 8), uint8_t(v >> 16), uint8_t(v >> 24)};
+        put(b, 4);
+    }
+    void put_u32_at(long at, uint32_t v) {
+        std::fseek(m_file, at, SEEK_SET);
+        put_u32(v);
+    }
+
+    void write_header(int sample_rate) {
+        const uint16_t block_align = static_cast<uint16_t>(m_channels * sizeof(float));
+        put("RIFF", 4); put_u32(HEADER_BYTES - 8);
+        put("WAVE", 4);
+        put("fmt ", 4); put_u32(18);
+        put_u16(3);  // WAVE_FORMAT_IEEE_FLOAT
+        put_u16(static_cast<uint16_t>(m_channels));
+        put_u32(static_cast<uint32_t>(sample_rate));
+        put_u32(static_cast<uint32_t>(sample_rate) * block_align);
+        put_u16(block_align);
+        put_u16(32);
+        put_u16(0);  // cbSize
+        put("fact", 4); put_u32(4); put_u32(0);
+        put("data", 4); put_u32(0);
+    }
+
+    std::FILE* m_file = nullptr;
+    int m_channels;
+    uint32_t m_data_bytes = 0;
+};
+
+// Headless stand-in for QAudioSink (AopBackend::Virtual). A device thread
+// pulls period_frames at a time through AudioIODevice::readData — the
+// same path QAudioSink's pull takes — so the ring, playhead, underrun flag
+// and low-watermark notifications see an ordinary device. Realtime mode
+// paces pulls on steady_clock deadlines (a late wake pulls the missed
+// periods back to back, keeping the simulated clock on the wall clock);
+// unpaced mode pulls whenever a full period is buffered, and pulls a
+// shorter remainder once it has sat unchanged for UNPACED_TAIL_IDLE — the
+// writer's final partial period, which would otherwise never drain.
+class VirtualSink {
+public:
+    VirtualSink(AudioIODevice* device, int sample_rate, int channels, const AopVirtualConfig& config)
+        : m_device(device)
+        , m_sample_rate(sample_rate)
+        , m_channels(channels)
+        , m_config(config) {
+        if (!config.wav_path.empty()) {
+            m_wav = std::make_unique<WavWriter>(config.wav_path, sample_rate, channels);
+        }
+    }
+
+    ~VirtualSink() { stop(); }
+
+    // False when the WAV file couldn't be created.
+    bool ok() const { return !m_wav || m_wav->ok(); }
+
+    void start() {
+        if (m_thread.joinable()) return;
+        m_stop.store(false);
+        m_thread = std::thread([this]() { run(); });
+    }
+
+    void stop() {
+        if (!m_thread.joinable()) return;
+        m_stop.store(true);
+        m_thread.join();
+        if (m_wav) m_wav->flush_header();
+    }
+
+    void set_volume(float v) { m_volume.store(v, std::memory_order_relaxed); }
+    float volume() const { return m_volume.load(std::memory_order_relaxed); }
+
+private:
+    // How long an unpaced sink waits before re-checking a short ring.
+    static constexpr auto UNPACED_POLL = std::chrono::microseconds(200);
+    // How long a short, unchanged ring waits before an unpaced sink takes
+    // it as the writer's last partial period.
+    static constexpr auto UNPACED_TAIL_IDLE = std::chrono::milliseconds(5);
+
+    void run() {
+        const int64_t period = m_config.period_frames;
+        const qint64 frame_bytes = m_channels * static_cast<qint64>(sizeof(float));
+        const qint64 period_bytes = period * frame_bytes;
+        std::vector<float> buf(static_cast<size_t>(period * m_channels));
+        const auto t0 = std::chrono::steady_clock::now();
+        int64_t pulled = 0;
+        qint64 tail_bytes = 0;
+        auto tail_since = t0;
+
+        while (!m_stop.load(std::memory_order_relaxed)) {
+            qint64 pull_bytes = period_bytes;
+            if (m_config.realtime) {
+                std::this_thread::sleep_until(
+                    t0 + std::chrono::microseconds(((pulled + period) * 1000000LL) / m_sample_rate));
+            } else {
+                const qint64 avail = m_device->bytesAvailable();
+                if (avail < period_bytes) {
+                    const auto now = std::chrono::steady_clock::now();
+                    if (avail != tail_bytes) {
+                        tail_bytes = avail;
+                        tail_since = now;
+                    }
+                    if (avail == 0 || now - tail_since < UNPACED_TAIL_IDLE) {
+                        std::this_thread::sleep_for(UNPACED_POLL);
+                        continue;
+                    }
+                    pull_bytes = avail;
+                }
+                tail_bytes = 0;
+            }
+            m_device->readData(reinterpret_cast<char*>(buf.data()), pull_bytes);
+            const int64_t frames = pull_bytes / frame_bytes;
+            pulled += frames;
+
+            if (m_wav) {
+                const float vol = m_volume.load(std::memory_order_relaxed);
+                if (vol != 1.0f) {
+                    for (size_t i = 0; i < static_cast<size_t>(frames * m_channels); ++i) buf[i] *= vol;
+                }
+                m_wav->write(buf.data(), frames);
+            }
+        }
+    }
+
+    AudioIODevice* m_device;
+    int m_sample_rate;
+    int m_channels;
+    AopVirtualConfig m_config;
+    std::unique_ptr<WavWriter> m_wav;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<float> m_volume{1.0f};
 };
 
 // Implementation class
 class AudioOutputImpl {
 public:
-    AudioOutputImpl(int sample_rate, int channels, int buffer_frames, int target_buffer_ms)
+    AudioOutputImpl(int sample_rate, int channels, int buffer_frames, int target_buffer_ms,
+                    AopBackend backend, const AopVirtualConfig& virtual_config)
         : m_sample_rate(sample_rate)
         , m_channels(channels)
         , m_target_buffer_ms(target_buffer_ms)
         , m_ring_buffer(static_cast<size_t>(buffer_frames), channels)
         , m_io_device(&m_ring_buffer, sample_rate, channels)
-        , m_playing(false) {
+        , m_playing(false)
+        , m_backend(backend)
+        , m_virtual_config(virtual_config) {
     }
 
     ~AudioOutputImpl() {
+        // Virtual sink: no QObject, no owner thread — its dtor joins the
+        // device thread and finalizes the WAV.
+        m_virtual_sink.reset();
+
         // m_sink lives on the thread that started it (main, by
         // construction — QAudioSink on macOS requires a Qt event loop on
         // its owner thread, and only main has one). AudioOutput is also
@@ -203,6 +348,10 @@ public:
     }
 
     bool init(AopOpenReport* out_report) {
+        if (m_backend == AopBackend::Virtual) {
+            return init_virtual(out_report);
+        }
+
         // Set up audio format
         m_format.setSampleRate(m_sample_rate);
         m_format.setChannelCount(m_channels);
@@ -249,6 +398,12 @@ public:
 
     void start() {
         if (m_playing) return;
+        if (m_virtual_sink) {
+            m_sink_buffer_us = m_virtual_config.sink_latency_us;
+            m_virtual_sink->start();
+            m_playing = true;
+            return;
+        }
         // First call establishes the sink-owner thread. Subsequent calls
         // assert against it — QAudioSink construction + destruction on
         // different threads is UB (cross-thread QObject destruction).
@@ -277,6 +432,11 @@ public:
     }
 
     void stop() {
+        if (m_virtual_sink) {
+            m_virtual_sink->stop();
+            m_playing = false;
+            return;
+        }
         if (!m_sink || !m_playing) return;
         assert_sink_owner_thread("stop");
         stop_sink_unlocked();
@@ -287,24 +447,31 @@ public:
     }
 
     void flush() {
-        if (m_sink && m_playing) {
+        if (m_virtual_sink) {
+            m_virtual_sink->stop();
+            m_playing = false;
+        } else if (m_sink && m_playing) {
             assert_sink_owner_thread("flush");
             stop_sink_unlocked();
         }
+        // Sink stopped above, so the ring has no consumer: safe to clear.
         m_ring_buffer.clear();
         m_io_device.reset_playhead();
     }
 
+    // Producer side of the SPSC ring — the pump is the only writer.
     int64_t write_f32(const float* data, int64_t frames) {
-        int64_t written = m_ring_buffer.write(data, frames);
-
-        return written;
+        return m_ring_buffer.write(data, frames);
     }
 
     int64_t buffered_frames() const {
         return m_ring_buffer.available_frames();
     }
 
+    void set_low_watermark(int64_t frames, std::function<void()> on_low) {
+        m_io_device.set_low_watermark(frames, std::move(on_low));
+    }
+
     int64_t playhead_us() const {
         return m_io_device.playhead_us();
     }
@@ -324,10 +491,12 @@ public:
     }
 
     void set_volume(float v) {
+        if (m_virtual_sink) m_virtual_sink->set_volume(v);
         if (m_sink) m_sink->setVolume(static_cast<qreal>(v));
     }
 
     float volume() const {
+        if (m_virtual_sink) return m_virtual_sink->volume();
         return m_sink ? static_cast<float>(m_sink->volume()) : 1.0f;
     }
 
@@ -339,6 +508,31 @@ public:
     int target_buffer_ms() const { return m_target_buffer_ms; }
 
 private:
+    bool init_virtual(AopOpenReport* out_report) {
+        if (m_virtual_config.period_frames <= 0) {
+            if (out_report) out_report->device_name = "Virtual: period_frames must be positive";
+            return false;
+        }
+        if (m_virtual_config.sink_latency_us < 0 || m_virtual_config.sink_latency_us > 500000) {
+            if (out_report) out_report->device_name = "Virtual: sink_latency_us out of range [0, 500ms]";
+            return false;
+        }
+        m_virtual_sink = std::make_unique<VirtualSink>(
+            &m_io_device, m_sample_rate, m_channels, m_virtual_config);
+        if (!m_virtual_sink->ok()) {
+            if (out_report) out_report->device_name = "Virtual: cannot create " + m_virtual_config.wav_path;
+            return false;
+        }
+        if (out_report) {
+            out_report->actual_sample_rate = m_sample_rate;
+            out_report->actual_channels = m_channels;
+            out_report->actual_buffer_ms = 0;
+            out_report->device_name = m_virtual_config.realtime ? "Virtual (realtime)"
+                                                                : "Virtual (unpaced)";
+        }
+        return true;
+    }
+
     // Assert the calling thread matches the thread that first started the
     // sink. Set on first start(). start/stop/flush MUST be called from the
     // same thread for a sink's lifetime — QAudioSink is a QObject and
@@ -379,6 +573,10 @@ private:
     // UB. Set on first start() and held for the lifetime of this impl;
     // ~AudioOutputImpl asserts the destructor runs on the owner thread.
     std::thread::id m_sink_owner{};
+
+    AopBackend m_backend;
+    AopVirtualConfig m_virtual_config;
+    std::unique_ptr<VirtualSink> m_virtual_sink;  // Virtual backend only
 };
 
 // AudioOutput implementation
@@ -413,9 +611,11 @@ std::unique_ptr<AudioOutput> AudioOutput::Open(const AopConfig& config, AopOpenR
     // Ring buffer 3x target fill: gives CoreAudio headroom to consume while
     // the AudioPump refills. Without headroom (capacity == target), the buffer
     // yo-yos between full and empty every pump cycle → underruns at startup.
+    // (RingBuffer rounds this up to a power of two for index masking.)
     int buffer_frames = 3 * (sample_rate * buffer_ms) / 1000;
 
-    auto impl = std::make_unique<AudioOutputImpl>(sample_rate, channels, buffer_frames, buffer_ms);
+    auto impl = std::make_unique<AudioOutputImpl>(sample_rate, channels, buffer_frames, buffer_ms,
+                                                  config.backend, config.virtual_device);
 
     if (!impl->init(out_report)) {
         return nullptr;
@@ -438,6 +638,10 @@ int64_t AudioOutput::BufferedFrames() const {
     return m_impl->buffered_frames();
 }
 
+void AudioOutput::SetLowWatermark(int64_t frames, std::function<void()> on_low) {
+    m_impl->set_low_watermark(frames, std::move(on_low));
+}
+
 int64_t AudioOutput::PlayheadTimeUS() const {
     return m_impl->playhead_us();
 }
@@ -2,15 +2,43 @@
 
 #include <memory>
 #include <cstdint>
+#include <functional>
 #include <string>
 
 namespace aop {
 
+// Output backend, chosen at Open.
+enum class AopBackend {
+    Device,   // default system output via QAudioSink
+    Virtual,  // headless: a simulated device thread consumes the ring
+};
+
+// Virtual backend: stands in for the sound card on machines without one
+// (CI), so AudioOutput and its writers — the Lua audio_playback session,
+// tests and benchmarks — run and can be measured repeatably. (AudioPump
+// and PlaybackController live in playback_controller.mm, which builds on
+// Apple only.) A device thread pulls period_frames at a time from the same
+// ring and through the same pull path as the real sink — playhead,
+// underrun flag and low-watermark notifications behave identically.
+struct AopVirtualConfig {
+    // true: pull one period per period of wall time (steady_clock
+    // deadlines), so a slow writer underruns as on real hardware.
+    // false: unpaced — pull whenever a full period is buffered (and a
+    // final partial one once the writer stops adding to it), never
+    // underrun; the simulated clock runs as fast as the writer can feed it.
+    bool realtime = true;
+    int32_t period_frames = 0;    // frames per simulated device pull (> 0)
+    int64_t sink_latency_us = 0;  // simulated sink buffer: AudibleTimeUS lag
+    std::string wav_path;         // non-empty: record the consumed stream (float WAV)
+};
+
 // Configuration for audio output
 struct AopConfig {
     int32_t sample_rate;       // Requested sample rate (default 48000)
     int32_t channels;          // Channel count (default 2, stereo)
     int32_t target_buffer_ms;  // Target buffer size in ms (default 100)
+    AopBackend backend = AopBackend::Device;
+    AopVirtualConfig virtual_device;  // Virtual backend only
 };
 
 // Report from device open
@@ -25,25 +53,35 @@ struct AopOpenReport {
 class AudioOutputImpl;
 
 // Audio output device wrapper
-// Thread-safe for WriteF32 from any thread
+// The PCM ring is lock-free single-producer/single-consumer: WriteF32 from
+// one thread at a time (the AudioPump; main only while the pump is stopped
+// or paused in a flush handoff), the device pull thread reads.
 class AudioOutput {
 public:
     ~AudioOutput();
 
-    // Open the default audio output device
-    // Returns nullptr on failure (check out_report for details)
+    // Open the default audio output device, or the virtual backend
+    // (config.backend). Returns nullptr on failure (check out_report).
     static std::unique_ptr<AudioOutput> Open(const AopConfig& config, AopOpenReport* out_report);
 
     // Close the audio output (called automatically by destructor)
     void Close();
 
-    // Write PCM into ring buffer
+    // Write PCM into ring buffer (never blocks)
     // Returns number of frames actually written (may be less than requested if buffer full)
     int64_t WriteF32(const float* interleaved, int64_t frames);
 
     // How many frames are currently buffered (approximate)
     int64_t BufferedFrames() const;
 
+    // Refill notification for an event-driven writer. `on_low` runs on the
+    // device pull thread when a pull leaves fewer than `frames` buffered
+    // after the level had been at or above it (once per crossing), and on
+    // every pull that underruns. It must not block: set a flag, signal a
+    // condition variable. An empty callback or frames <= 0 disables; the
+    // setter returns only once no call to the previous callback is running.
+    void SetLowWatermark(int64_t frames, std::function<void()> on_low);
+
     // Device playhead in microseconds since Start() was called.
     // This is the BUFFER-FILL position (frames pulled from our IODevice into
     // QAudioSink). It leads the audible position by the QAudioSink internal
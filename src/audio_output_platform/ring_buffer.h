@@ -0,0 +1,157 @@
+#pragma once
+
+// Internal header — the PCM ring between AudioPump and the device pull.
+//
+// Exactly one producer (AudioOutput::WriteF32, the pump thread) and one
+// consumer (AudioIODevice::readData, QAudioSink's pull thread). The
+// previous ring serialised both sides on a QMutex; the device pull is a
+// real-time callback, and blocking it behind a pump write (which may be
+// preempted mid-memcpy) is a priority inversion that surfaces as an
+// underrun. Here neither side ever waits:
+//
+// - m_write / m_read are monotonically increasing frame counters, each
+//   stored only by its own side (release) and read by the other (acquire).
+//   fill = write - read; position in the buffer = counter & mask, so the
+//   capacity is rounded up to a power of two.
+// - The counters sit on separate cache lines, so a producer store doesn't
+//   invalidate the line the consumer is spinning through and vice versa.
+//   Each side also keeps a cached copy of the other's counter and only
+//   reloads it (one acquire) when the cache says there isn't room / data.
+//
+// A frame is published only after all its samples are copied, so the
+// consumer never sees part of a write ("torn read").
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace aop {
+
+class RingBuffer {
+public:
+    // Capacity is rounded up to the next power of two frames.
+    RingBuffer(size_t capacity_frames, int channels)
+        : m_channels(static_cast<size_t>(channels))
+        , m_capacity(round_up_pow2(capacity_frames))
+        , m_mask(m_capacity - 1)
+        , m_buffer(m_capacity * m_channels) {
+        assert(capacity_frames > 0 && "RingBuffer: capacity must be positive");
+        assert(channels > 0 && "RingBuffer: channels must be positive");
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    size_t capacity_frames() const { return m_capacity; }
+
+    // ── Producer side ──
+
+    // Write up to `frames` interleaved frames; returns frames written
+    // (short when the ring is full).
+    int64_t write(const float* data, int64_t frames) {
+        if (frames <= 0) return 0;
+        const size_t w = m_write.load(std::memory_order_relaxed);
+        size_t space = m_capacity - (w - m_read_cache);
+        if (space < static_cast<size_t>(frames)) {
+            m_read_cache = m_read.load(std::memory_order_acquire);
+            space = m_capacity - (w - m_read_cache);
+        }
+        const size_t n = std::min(space, static_cast<size_t>(frames));
+        if (n == 0) return 0;
+
+        copy_in(w & m_mask, data, n);
+        m_write.store(w + n, std::memory_order_release);
+        return static_cast<int64_t>(n);
+    }
+
+    // ── Consumer side ──
+
+    // Read up to `frames` frames into `data`, silence-padding whatever the
+    // ring couldn't supply; returns frames actually read (< frames means
+    // underrun).
+    int64_t read(float* data, int64_t frames) {
+        if (frames <= 0) return 0;
+        const size_t r = m_read.load(std::memory_order_relaxed);
+        size_t avail = m_write_cache - r;
+        if (avail < static_cast<size_t>(frames)) {
+            m_write_cache = m_write.load(std::memory_order_acquire);
+            avail = m_write_cache - r;
+        }
+        const size_t n = std::min(avail, static_cast<size_t>(frames));
+
+        if (n > 0) {
+            copy_out(r & m_mask, data, n);
+            m_read.store(r + n, std::memory_order_release);
+        }
+        if (n < static_cast<size_t>(frames)) {
+            std::memset(data + n * m_channels, 0,
+                        (static_cast<size_t>(frames) - n) * m_channels * sizeof(float));
+        }
+        return static_cast<int64_t>(n);
+    }
+
+    // Drop everything buffered. Consumer-side: only while nothing is
+    // reading (AOP flush stops the sink first). A write racing the clear
+    // either lands before it (dropped) or after it (kept) — never half.
+    void clear() {
+        const size_t w = m_write.load(std::memory_order_acquire);
+        m_write_cache = w;
+        m_read.store(w, std::memory_order_release);
+    }
+
+    // ── Either side ──
+
+    // Frames buffered right now (exact for the calling side, a snapshot
+    // for anyone else). Read before write so the difference can't go
+    // negative when the consumer advances between the two loads.
+    int64_t available_frames() const {
+        const size_t r = m_read.load(std::memory_order_acquire);
+        const size_t w = m_write.load(std::memory_order_acquire);
+        return static_cast<int64_t>(w - r);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    static size_t round_up_pow2(size_t n) {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    void copy_in(size_t pos, const float* src, size_t frames) {
+        const size_t first = std::min(frames, m_capacity - pos);
+        std::memcpy(m_buffer.data() + pos * m_channels, src, first * m_channels * sizeof(float));
+        if (frames > first) {
+            std::memcpy(m_buffer.data(), src + first * m_channels,
+                        (frames - first) * m_channels * sizeof(float));
+        }
+    }
+
+    void copy_out(size_t pos, float* dst, size_t frames) const {
+        const size_t first = std::min(frames, m_capacity - pos);
+        std::memcpy(dst, m_buffer.data() + pos * m_channels, first * m_channels * sizeof(float));
+        if (frames > first) {
+            std::memcpy(dst + first * m_channels, m_buffer.data(),
+                        (frames - first) * m_channels * sizeof(float));
+        }
+    }
+
+    const size_t m_channels;
+    const size_t m_capacity;  // frames, power of two
+    const size_t m_mask;
+    std::vector<float> m_buffer;
+
+    // Producer line: its counter plus its cached view of the consumer's.
+    alignas(CACHE_LINE) std::atomic<size_t> m_write{0};
+    size_t m_read_cache{0};
+
+    // Consumer line.
+    alignas(CACHE_LINE) std::atomic<size_t> m_read{0};
+    size_t m_write_cache{0};
+};
+
+} // namespace aop
@@ -20,7 +20,21 @@ void CPUVideoSurface::setFrame(const std::shared_ptr<emp::Frame>& frame) {
         clearFrame();
         return;
     }
-    setFrameData(frame->data(), frame->width(), frame->height(), frame->stride_bytes());
+    if (!frame->is_yuv()) {
+        setFrameData(frame->data(), frame->width(), frame->height(), frame->stride_bytes());
+        return;
+    }
+
+    // Planar YUV (TMB cache): convert straight into the source image rather
+    // than materializing a BGRA copy inside the cached frame.
+    m_frameWidth = frame->width();
+    m_frameHeight = frame->height();
+    if (m_imageSource.width() != m_frameWidth || m_imageSource.height() != m_frameHeight) {
+        m_imageSource = QImage(m_frameWidth, m_frameHeight, QImage::Format_ARGB32);
+        m_image = QImage(m_frameWidth, m_frameHeight, QImage::Format_ARGB32);
+    }
+    frame->CopyBGRA(m_imageSource.bits(), static_cast<int>(m_imageSource.bytesPerLine()));
+    regrade();
 }
 
 void CPUVideoSurface::setFrameData(const uint8_t* data, int width, int height, int stride) {
@@ -19,7 +19,8 @@ public:
     explicit CPUVideoSurface(QWidget* parent = nullptr);
     ~CPUVideoSurface() override;
 
-    // Set frame (calls frame->data() to get CPU pixels)
+    // Set frame (BGRA frames via frame->data(); YUV frames convert straight
+    // into the source image via Frame::CopyBGRA)
     void setFrame(const std::shared_ptr<emp::Frame>& frame);
 
     // Set frame from raw BGRA32 data
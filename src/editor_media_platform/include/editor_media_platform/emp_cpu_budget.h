@@ -0,0 +1,111 @@
+#pragma once
+
+// CPU budget — the process-wide share-out of decode threads.
+//
+// Every thread-spawning consumer in EMP used to size itself from
+// hardware_concurrency independently: TMB prefetch workers, the row-slice
+// pool, PeakGenerator workers, MediaFile::ProbeMetadataBatch, and each
+// FFmpeg video codec's own threads. Importing while playing oversubscribed the machine several
+// times over and playback dropped frames to peak generation.
+//
+// Consumers now ask the budget. Classes rank Playback > Scrub > Peaks >
+// Probe; each active class claims part of the machine and every lower class
+// gets what remains (at least one thread, at most its own cap):
+//
+//     slots(c) = clamp(total - Σ claim(h) over active h ranked above c,
+//                      1, cap(c))
+//
+// Playback/Scrub activity follows SetDecodeMode (Play / Scrub / Park);
+// Peaks/Probe activity is counted with CpuActivity while work is running.
+// Consumers that can resize live (PeakGenerator) subscribe to rebalances;
+// the rest read slots when they start (a probe batch, a codec open).
+//
+// The Playback slots are split between three pools that can all be busy at
+// once: the TMB decode workers, the shared row-slice pool, and the codecs'
+// own threads. The first two are sized once from the machine size, the
+// decode pool leaving out the slice share; codecs get what the two leave
+// over.
+
+#include <cstdint>
+#include <functional>
+
+namespace emp {
+
+enum class CpuClass { Playback = 0, Scrub, Peaks, Probe };
+static constexpr int CPU_CLASS_COUNT = 4;
+
+// Foreground activity, set from SetDecodeMode.
+enum class CpuForeground { Idle, Playback, Scrub };
+
+struct CpuBudgetStats {
+    int total_threads = 0;             // machine threads the budget shares out
+    int class_slots[CPU_CLASS_COUNT] = {};  // current slots per CpuClass
+    int active[CPU_CLASS_COUNT] = {};  // activity count per CpuClass
+    int video_decoders = 0;            // open SW video codec contexts
+    int decode_workers = 0;            // running TMB decode pool threads
+    int slice_workers = 0;             // row-slice pool share (CpuBudgetSliceWorkers)
+    int64_t rebalances = 0;            // times any class's slots changed
+};
+
+// Threads `c` may keep busy right now.
+int CpuBudgetSlots(CpuClass c);
+
+// Upper bound on CpuBudgetSlots(c) at the current machine size — what a
+// consumer that resizes live should spawn (idle extras park).
+int CpuBudgetCap(CpuClass c);
+
+// Workers for the shared row-slice pool (impl::SlicePool::shared): a
+// quarter of the machine, at most MAX_SLICE_WORKERS, none below 4 threads
+// (the pool then runs every slice on its caller). Reserved out of the
+// Playback slots whether or not the pool has started yet.
+static constexpr int MAX_SLICE_WORKERS = 8;
+int CpuBudgetSliceWorkers();
+
+// FFmpeg thread_count for a SW video codec being opened. The codec pool is
+// the Playback slots the TMB decode workers and the slice pool leave over —
+// the workers already keep one decode per thread in flight, so codec
+// threads on top of them only oversubscribe — split across the video
+// decoders already open,
+// at least 1 and at most MAX_CODEC_THREADS. Fixed for the codec's lifetime
+// (FFmpeg can't change thread_count after open).
+static constexpr int MAX_CODEC_THREADS = 8;
+int CpuBudgetCodecThreads();
+
+CpuBudgetStats GetCpuBudgetStats();
+
+// Machine size the budget divides; 0 = hardware_concurrency (default).
+// Tests and render nodes sharing a host pin it.
+void SetCpuBudgetThreads(int threads);
+
+void SetCpuForeground(CpuForeground fg);
+
+// RAII activity mark for Peaks / Probe work (Playback and Scrub come from
+// SetCpuForeground).
+class CpuActivity {
+public:
+    explicit CpuActivity(CpuClass c);
+    ~CpuActivity();
+    CpuActivity(const CpuActivity&) = delete;
+    CpuActivity& operator=(const CpuActivity&) = delete;
+
+private:
+    CpuClass m_class;
+};
+
+// Called (on the thread that changed the budget) after any class's slots
+// change. Returns an id for RemoveCpuBudgetListener. Listeners must not
+// call back into the listener registry.
+int AddCpuBudgetListener(std::function<void()> fn);
+void RemoveCpuBudgetListener(int id);
+
+namespace impl {
+// Open / close bookkeeping for CpuBudgetCodecThreads (FFmpegCodecContext).
+void cpu_budget_video_decoder_opened();
+void cpu_budget_video_decoder_closed();
+// Start / stop bookkeeping for the TMB decode pool (its threads come out of
+// the codec pool above).
+void cpu_budget_decode_workers_started(int count);
+void cpu_budget_decode_workers_stopped(int count);
+} // namespace impl
+
+} // namespace emp
@@ -0,0 +1,260 @@
+#pragma once
+
+// DecodeScheduler — work-stealing job scheduler for TMB's decode pool.
+//
+// Replaces the fixed worker roles (1 prep + N video + 1 audio) with
+// uniform workers that can each run any class of work. Every worker asks
+// the scheduler for the highest-priority runnable job, in class order:
+//
+//   AudioRefill > ImminentVideo > Warm > Speculative
+//
+// Two kinds of work feed the classes:
+//
+//   1. Queued jobs (READER_WARM / SPEED_DETECT). Each worker owns a job
+//      queue; submit() spreads jobs round-robin over them. Without a Picker
+//      a worker pops the newest job from its own queue and otherwise steals
+//      the oldest from another's. With a Picker (TMB installs the
+//      SPEED_DETECT-first, proximity-to-playhead picker) the Picker runs
+//      over each queue and then over the per-queue winners, so every worker
+//      takes the globally most urgent job — stealing it if it sits in
+//      another worker's queue. Per-queue picking alone would let a worker
+//      warm a far clip from its own queue while the imminent one waits in
+//      a queue whose owner is busy.
+//   2. Polled sources (audio refill, video prefetch). Track prefetch is not
+//      a discrete job: it's "find the most urgent track and decode one unit
+//      for it". A Source does exactly that and returns whether it did work.
+//
+// Preemption is at job boundaries: video decodes one frame per Source call,
+// so a starving audio track waits at most one frame decode for the next
+// free worker instead of for a dedicated audio thread.
+//
+// Per-worker class masks restrict what a worker may run. TMB keeps worker 0
+// off the Warm class so a burst of slow codec inits (H.264 VT ~264ms) can
+// never occupy every thread; the benchmark also uses masks to reproduce the
+// old fixed-role layout as a baseline.
+//
+// Threads are owned by the caller: each worker thread loops on run_next()
+// and, when that finds nothing, wait()s on the epoch it read before trying.
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace emp {
+
+// Priority classes, highest first.
+enum class DecodeClass : int {
+    AudioRefill = 0,    // audio track buffer low / cold
+    ImminentVideo = 1,  // video track below its low watermark
+    Warm = 2,           // decode-prep jobs (READER_WARM, SPEED_DETECT)
+    Speculative = 3,    // video top-up toward the high watermark
+};
+constexpr int kDecodeClassCount = 4;
+constexpr unsigned decode_class_bit(DecodeClass c) { return 1u << static_cast<int>(c); }
+constexpr unsigned kAllDecodeClasses = (1u << kDecodeClassCount) - 1;
+
+template <typename Job>
+class DecodeScheduler {
+public:
+    using Source = std::function<bool(int worker)>;
+    using Picker = std::function<int(const std::vector<Job>&)>;
+    using Runner = std::function<void(Job& job, int worker)>;
+
+    struct Stats {
+        uint64_t runs[kDecodeClassCount] = {};
+        uint64_t steals = 0;
+    };
+
+    // Size the scheduler for `workers` threads. Drops queued jobs and resets
+    // every worker to all classes. Not thread-safe: call before the worker
+    // threads start (sources/pickers/runners are kept).
+    void reset(int workers) {
+        assert(workers > 0 && "DecodeScheduler::reset: need at least one worker");
+        m_queues.clear();
+        for (int i = 0; i < workers; ++i) m_queues.push_back(std::make_unique<WorkerQueues>());
+        m_masks.assign(static_cast<size_t>(workers), kAllDecodeClasses);
+        for (auto& q : m_queued) q.store(0);
+        for (auto& r : m_runs) r.store(0);
+        m_steals.store(0);
+        m_next_home.store(0);
+    }
+
+    int worker_count() const { return static_cast<int>(m_queues.size()); }
+
+    // Configuration — before the worker threads start.
+    void set_worker_classes(int worker, unsigned class_mask) {
+        assert(worker >= 0 && worker < worker_count() && "DecodeScheduler: worker out of range");
+        m_masks[static_cast<size_t>(worker)] = class_mask;
+    }
+    void set_source(DecodeClass c, Source s) { m_sources[idx(c)] = std::move(s); }
+    void set_picker(DecodeClass c, Picker p) { m_pickers[idx(c)] = std::move(p); }
+    void set_runner(DecodeClass c, Runner r) { m_runners[idx(c)] = std::move(r); }
+
+    // Queue a job on a worker's queue (round-robin when home < 0) and wake
+    // idle workers. The class needs a Runner.
+    void submit(DecodeClass c, Job job, int home = -1) {
+        assert(m_runners[idx(c)] && "DecodeScheduler::submit: class has no runner");
+        const int n = worker_count();
+        assert(n > 0 && "DecodeScheduler::submit: reset() not called");
+        if (home < 0) home = static_cast<int>(m_next_home.fetch_add(1) % static_cast<unsigned>(n));
+        {
+            auto& wq = *m_queues[static_cast<size_t>(home)];
+            std::lock_guard<std::mutex> lock(wq.mutex);
+            wq.jobs[idx(c)].push_back(std::move(job));
+            m_queued[idx(c)].fetch_add(1);
+        }
+        notify();
+    }
+
+    // Drop every queued job of class c (in-flight jobs finish normally).
+    void clear(DecodeClass c) {
+        for (auto& wq : m_queues) {
+            std::lock_guard<std::mutex> lock(wq->mutex);
+            auto& q = wq->jobs[idx(c)];
+            m_queued[idx(c)].fetch_sub(static_cast<int>(q.size()));
+            q.clear();
+        }
+    }
+
+    int queued(DecodeClass c) const { return m_queued[idx(c)].load(); }
+
+    // Run one unit of the highest-priority work `worker` may take. Returns
+    // false when no class had anything — the caller should wait().
+    bool run_next(int worker) {
+        const unsigned mask = m_masks[static_cast<size_t>(worker)];
+        for (int c = 0; c < kDecodeClassCount; ++c) {
+            if (!(mask & (1u << c))) continue;
+            if (m_queued[c].load(std::memory_order_relaxed) > 0) {
+                Job job;
+                if (take(worker, c, job)) {
+                    m_runs[c].fetch_add(1, std::memory_order_relaxed);
+                    m_runners[c](job, worker);
+                    return true;
+                }
+            }
+            if (m_sources[c] && m_sources[c](worker)) {
+                m_runs[c].fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Wake protocol: read epoch() before run_next(); if it finds nothing,
+    // wait(seen, ...) returns as soon as anything notify()s after that read,
+    // so a wake racing with the empty pass is never lost.
+    uint64_t epoch() const { return m_epoch.load(); }
+
+    void notify() {
+        {
+            std::lock_guard<std::mutex> lock(m_wait_mutex);
+            m_epoch.fetch_add(1);
+        }
+        m_wait_cv.notify_all();
+    }
+
+    void wait(uint64_t seen_epoch, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_wait_mutex);
+        m_wait_cv.wait_for(lock, timeout, [&] { return m_epoch.load() != seen_epoch; });
+    }
+
+    Stats stats() const {
+        Stats s;
+        for (int c = 0; c < kDecodeClassCount; ++c) s.runs[c] = m_runs[c].load();
+        s.steals = m_steals.load();
+        return s;
+    }
+
+private:
+    struct WorkerQueues {
+        std::mutex mutex;
+        std::vector<Job> jobs[kDecodeClassCount];
+    };
+
+    static int idx(DecodeClass c) { return static_cast<int>(c); }
+
+    bool take(int worker, int c, Job& out) {
+        return m_pickers[c] ? take_picked(worker, c, out) : take_ordered(worker, c, out);
+    }
+
+    // Own queue's newest, else the oldest from the next non-empty victim.
+    bool take_ordered(int worker, int c, Job& out) {
+        const int n = worker_count();
+        for (int i = 0; i < n; ++i) {
+            const int victim = (worker + i) % n;
+            auto& wq = *m_queues[static_cast<size_t>(victim)];
+            std::lock_guard<std::mutex> lock(wq.mutex);
+            auto& q = wq.jobs[c];
+            if (q.empty()) continue;
+            pop_at(q, c, (i == 0) ? static_cast<int>(q.size()) - 1 : 0, out);
+            if (i > 0) m_steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    // Picker over each queue's winner. Queues are locked one at a time, so
+    // the winning queue is re-picked under its lock before popping — a job
+    // taken meanwhile just means the next-best in that queue runs.
+    bool take_picked(int worker, int c, Job& out) {
+        const int n = worker_count();
+        const Picker& picker = m_pickers[c];
+        std::vector<Job> winners;
+        std::vector<int> winner_queue;
+        for (int i = 0; i < n; ++i) {
+            const int victim = (worker + i) % n;
+            auto& wq = *m_queues[static_cast<size_t>(victim)];
+            std::lock_guard<std::mutex> lock(wq.mutex);
+            auto& q = wq.jobs[c];
+            if (q.empty()) continue;
+            int pick = picker(q);
+            if (pick < 0) continue;
+            winners.push_back(q[static_cast<size_t>(pick)]);
+            winner_queue.push_back(victim);
+        }
+        if (winners.empty()) return false;
+        int w = picker(winners);
+        if (w < 0) return false;
+
+        const int victim = winner_queue[static_cast<size_t>(w)];
+        auto& wq = *m_queues[static_cast<size_t>(victim)];
+        std::lock_guard<std::mutex> lock(wq.mutex);
+        auto& q = wq.jobs[c];
+        if (q.empty()) return false;
+        int pick = picker(q);
+        if (pick < 0) return false;
+        pop_at(q, c, pick, out);
+        if (victim != worker) m_steals.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void pop_at(std::vector<Job>& q, int c, int pick, Job& out) {
+        assert(pick >= 0 && pick < static_cast<int>(q.size()) && "DecodeScheduler: picker index out of range");
+        out = std::move(q[static_cast<size_t>(pick)]);
+        q.erase(q.begin() + pick);
+        m_queued[c].fetch_sub(1);
+    }
+
+    std::vector<std::unique_ptr<WorkerQueues>> m_queues;
+    std::vector<unsigned> m_masks;
+    Source m_sources[kDecodeClassCount];
+    Picker m_pickers[kDecodeClassCount];
+    Runner m_runners[kDecodeClassCount];
+
+    std::atomic<int> m_queued[kDecodeClassCount] = {};
+    std::atomic<uint64_t> m_runs[kDecodeClassCount] = {};
+    std::atomic<uint64_t> m_steals{0};
+    std::atomic<unsigned> m_next_home{0};
+
+    std::mutex m_wait_mutex;
+    std::condition_variable m_wait_cv;
+    std::atomic<uint64_t> m_epoch{0};
+};
+
+} // namespace emp
@@ -10,7 +10,22 @@ namespace emp {
 // Forward declaration for implementation
 class FrameImpl;
 
-// Decoded video frame in BGRA32 format
+// How a frame's CPU pixels are stored. BGRA32 is what every consumer reads
+// (data(), or CopyBGRA for any format); SW decode of the common YUV layouts can keep the decoder's
+// planar YUV instead (Reader::SetYuvOutput) — 4:2:0 8-bit is 1.5 bytes per
+// pixel against BGRA's 4 — and convert only when a frame is actually shown.
+enum class PixelFormat {
+    BGRA32,
+    YUV420P,    // 8-bit, planes Y U V, chroma 1/2 x 1/2
+    NV12,       // 8-bit, planes Y + interleaved UV, chroma 1/2 x 1/2
+    YUV422P10,  // 10-bit in 16-bit LE samples, planes Y U V, chroma 1/2 x 1
+    YUV444P,    // 8-bit, planes Y U V, full-resolution chroma
+};
+
+enum class ColorRange { Limited, Full };
+enum class ColorSpace { Unspecified, BT601, BT709, BT2020 };
+
+// Decoded video frame. data() and CopyBGRA produce BGRA32:
 // Memory layout: B, G, R, A for each pixel (matches Qt QImage::Format_ARGB32 on little-endian)
 class Frame {
 public:
@@ -20,18 +35,38 @@ public:
     int width() const;
     int height() const;
 
-    // Bytes per row (may include padding)
+    // Bytes per row of data() (may include padding)
     int stride_bytes() const;
 
     // Source presentation timestamp (for debug/telemetry only)
     TimeUS source_pts_us() const;
 
-    // Raw pixel data pointer (BGRA32 format, alpha=255)
+    // Raw pixel data pointer (BGRA32 format, alpha=255). BGRA frames only:
+    // a YUV frame has no BGRA pixels to point at (asserts) — convert into
+    // a caller-owned buffer with CopyBGRA, so the frame stays at its
+    // planar size.
     const uint8_t* data() const;
 
-    // Total data size in bytes (stride_bytes * height)
+    // Bytes of the frame's stored pixels — BGRA, or the YUV planes for a
+    // YUV frame. What caches charge; constant for the frame's lifetime.
     size_t data_size() const;
 
+    // Write the frame as BGRA32 into dst (width*4 bytes per row at
+    // dst_stride). YUV frames convert straight into dst; BGRA frames copy.
+    void CopyBGRA(uint8_t* dst, int dst_stride) const;
+
+    // Storage format and colour metadata. BGRA32 frames report 8-bit,
+    // Unspecified colorspace, Full range.
+    PixelFormat pixel_format() const;
+    bool is_yuv() const { return pixel_format() != PixelFormat::BGRA32; }
+    int bit_depth() const;
+    ColorSpace colorspace() const;
+    ColorRange color_range() const;
+
+    // YUV planes (plane < 3); nullptr / 0 for absent planes and BGRA frames.
+    const uint8_t* plane_data(int plane) const;
+    int plane_stride(int plane) const;
+
 #ifdef EMP_HAS_VIDEOTOOLBOX
     // Returns CVPixelBufferRef if frame has hardware buffer, nullptr otherwise
     // For Metal zero-copy rendering path
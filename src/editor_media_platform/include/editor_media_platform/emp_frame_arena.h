@@ -0,0 +1,46 @@
+#pragma once
+
+// Frame arena — the process-wide pool every decoded CPU frame buffer
+// (BGRA output of SW/qtrle/BRAW decode) is borrowed from.
+//
+// Replaces the per-Reader FrameBufferPool, whose warm() pre-reserved up to
+// 160 output-sized buffers per Reader: 16 pooled readers on a 4K timeline
+// could map tens of GB before a frame played. The arena reserves on demand
+// and recycles across readers, so reserved memory tracks what is actually
+// cached or in flight, under one hard cap.
+//
+// Buffers are bucketed by size class: powers of two from 64 KiB below
+// 2 MiB, whole multiples of 2 MiB above. Large classes are mapped as
+// 2 MiB-aligned slabs (transparent hugepage hint where the OS has one), so
+// a 4K frame is ~17 hugepages instead of ~8000 base pages. Free buffers keep
+// their mapping; TrimFrameArena (TMB::ParkReaders) hands their pages back
+// to the OS with madvise, so an idle editor holds address space, not RAM.
+
+#include <cstdint>
+
+namespace emp {
+
+struct FrameArenaStats {
+    int64_t cap_bytes = 0;         // hard cap on reserved_bytes
+    int64_t reserved_bytes = 0;    // mapped by the arena (in use + free)
+    int64_t in_use_bytes = 0;      // lent out to live Frames
+    int64_t high_water_bytes = 0;  // max in_use_bytes since process start
+    int64_t trimmed_bytes = 0;     // free bytes madvised away, cumulative
+    int64_t cap_failures = 0;      // acquires refused at the cap
+};
+
+// Default cap: the TMB video cache budget (4 GiB) plus headroom for frames
+// held outside it — in flight in decode, on screen, in the GOP pipeline.
+static constexpr int64_t DEFAULT_FRAME_ARENA_CAP = 6LL << 30;
+
+FrameArenaStats GetFrameArenaStats();
+
+// Lowering the cap below reserved_bytes releases free buffers until under
+// it (or none are left); buffers in use are never reclaimed — acquires
+// fail until enough Frames die.
+void SetFrameArenaCap(int64_t bytes);
+
+// madvise away the pages of every free buffer. Returns bytes trimmed.
+int64_t TrimFrameArena();
+
+} // namespace emp
@@ -0,0 +1,288 @@
+#pragma once
+
+// FrameIndexCache — fixed-capacity cache keyed by timeline frame.
+//
+// Backing store for TMB's per-track video cache. Two structures share one
+// contiguous node array:
+//
+//   1. Ring index: a power-of-two slot array covering a window of
+//      `window_frames` consecutive keys. slot = key & mask, so lookup is a
+//      single array read — no tree walk, no hashing. An occupancy bitmap
+//      over the slots answers nearest-neighbour queries (lower_bound / prev)
+//      with ctz/clz over 64 keys per word.
+//   2. Intrusive LRU list threaded through the nodes in insertion order.
+//      Evicting the oldest entry is an unlink — O(1), replacing the O(n)
+//      insert_seq scan the std::map version needed on every insert.
+//
+// The window follows inserts: a key outside it slides the window by the
+// minimum amount to cover the key, and entries that fall off the far end
+// are evicted (reported through the caller's on_evict). Since slot = key &
+// mask is independent of the window base, sliding never moves surviving
+// entries. With a window far larger than the entry capacity, slides only
+// happen after a long seek, and what they evict is stale anyway.
+//
+// Recency is insertion order only — lookups don't promote. This matches
+// the prefetch cache's needs: the producer decides what's fresh.
+//
+// Not thread-safe; TMB guards each instance with its track lock.
+
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace emp {
+
+template <typename V>
+class FrameIndexCache {
+public:
+    struct Entry {
+        int64_t key = 0;
+        V value{};
+    private:
+        friend class FrameIndexCache;
+        int32_t lru_prev = -1;
+        int32_t lru_next = -1;
+    };
+
+    // max_entries: node pool size (hard entry cap).
+    // window_frames: span of keys the ring covers; rounded up to a power of
+    // two and to at least 64 (one bitmap word).
+    FrameIndexCache(size_t max_entries, size_t window_frames)
+        : m_nodes(max_entries) {
+        assert(max_entries > 0 && "FrameIndexCache: max_entries must be > 0");
+        assert(max_entries < static_cast<size_t>(INT32_MAX) &&
+               "FrameIndexCache: max_entries exceeds int32 node index");
+        size_t w = 64;
+        while (w < window_frames) w <<= 1;
+        m_window = w;
+        m_mask = w - 1;
+        m_slots.assign(w, -1);
+        m_occupied.assign(w / 64, 0);
+        m_free.reserve(max_entries);
+        for (size_t i = max_entries; i-- > 0; ) m_free.push_back(static_cast<int32_t>(i));
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t capacity() const { return m_nodes.size(); }
+    size_t window_frames() const { return m_window; }
+
+    Entry* find(int64_t key) {
+        if (!in_window(key)) return nullptr;
+        int32_t idx = m_slots[slot_of(key)];
+        return idx < 0 ? nullptr : &m_nodes[idx];
+    }
+    const Entry* find(int64_t key) const {
+        return const_cast<FrameIndexCache*>(this)->find(key);
+    }
+
+    // Smallest key >= `key` (std::map::lower_bound). Keys further than
+    // max_distance away are not considered — bounds the bitmap scan for
+    // callers that would reject a distant neighbour anyway.
+    Entry* at_or_after(int64_t key, int64_t max_distance = INT64_MAX) {
+        if (m_size == 0) return nullptr;
+        int64_t from = key > m_base ? key : m_base;
+        int64_t to = m_base + static_cast<int64_t>(m_window);
+        if (max_distance < static_cast<int64_t>(m_window) && key + max_distance + 1 < to) {
+            to = key + max_distance + 1;
+        }
+        return scan_up(from, to);
+    }
+
+    // Largest key < `key` (std::prev(lower_bound)). Same max_distance rule.
+    Entry* before(int64_t key, int64_t max_distance = INT64_MAX) {
+        if (m_size == 0) return nullptr;
+        int64_t to = m_base + static_cast<int64_t>(m_window);
+        if (key < to) to = key;
+        int64_t from = m_base;
+        if (max_distance < static_cast<int64_t>(m_window) && key - max_distance > from) {
+            from = key - max_distance;
+        }
+        return scan_down(from, to);
+    }
+
+    // Lowest / highest cached key.
+    Entry* first() {
+        return m_size == 0 ? nullptr : scan_up(m_base, m_base + static_cast<int64_t>(m_window));
+    }
+    Entry* last() {
+        return m_size == 0 ? nullptr : scan_down(m_base, m_base + static_cast<int64_t>(m_window));
+    }
+
+    // Oldest insertion (LRU victim).
+    Entry* oldest() { return m_lru_head < 0 ? nullptr : &m_nodes[m_lru_head]; }
+
+    // Insert a key that is not present. Caller keeps size() < capacity()
+    // (evict oldest() first). If the key lies outside the window, the window
+    // slides and on_evict(const Entry&) runs for each entry that falls off,
+    // just before it is removed.
+    template <typename OnEvict>
+    Entry& insert(int64_t key, V value, OnEvict&& on_evict) {
+        assert(!find(key) && "FrameIndexCache::insert: key already present");
+        assert(m_size < m_nodes.size() && "FrameIndexCache::insert: cache full");
+
+        const int64_t w = static_cast<int64_t>(m_window);
+        if (m_size == 0) {
+            m_base = key - w / 2;
+        } else if (key < m_base) {
+            slide_to(key, on_evict);
+        } else if (key - m_base >= w) {
+            slide_to(key - w + 1, on_evict);
+        }
+
+        int32_t idx = m_free.back();
+        m_free.pop_back();
+        Entry& e = m_nodes[idx];
+        e.key = key;
+        e.value = std::move(value);
+        link_tail(idx);
+
+        size_t slot = slot_of(key);
+        m_slots[slot] = idx;
+        m_occupied[slot >> 6] |= uint64_t(1) << (slot & 63);
+        ++m_size;
+        return e;
+    }
+
+    // Remove an entry. The stored value is reset so shared resources it
+    // holds (decoded frames) are released now, not when the node is reused.
+    void erase(Entry* e) {
+        assert(e && "FrameIndexCache::erase: null entry");
+        int32_t idx = static_cast<int32_t>(e - m_nodes.data());
+        assert(idx >= 0 && static_cast<size_t>(idx) < m_nodes.size() &&
+               "FrameIndexCache::erase: entry not owned by this cache");
+        size_t slot = slot_of(e->key);
+        assert(m_slots[slot] == idx && "FrameIndexCache::erase: entry not live");
+        m_slots[slot] = -1;
+        m_occupied[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+        unlink(idx);
+        e->value = V{};
+        m_free.push_back(idx);
+        --m_size;
+    }
+
+    // Visit entries oldest → newest.
+    template <typename F>
+    void for_each(F&& f) {
+        for (int32_t i = m_lru_head; i >= 0; i = m_nodes[i].lru_next) f(m_nodes[i]);
+    }
+    template <typename F>
+    void for_each(F&& f) const {
+        for (int32_t i = m_lru_head; i >= 0; i = m_nodes[i].lru_next) f(m_nodes[i]);
+    }
+
+    // Erase every entry matching pred(const Entry&); on_erase(const Entry&)
+    // runs just before each removal.
+    template <typename Pred, typename OnErase>
+    void erase_if(Pred&& pred, OnErase&& on_erase) {
+        for (int32_t i = m_lru_head; i >= 0; ) {
+            int32_t next = m_nodes[i].lru_next;
+            if (pred(m_nodes[i])) {
+                on_erase(m_nodes[i]);
+                erase(&m_nodes[i]);
+            }
+            i = next;
+        }
+    }
+
+    void clear() {
+        erase_if([](const Entry&) { return true; }, [](const Entry&) {});
+    }
+
+private:
+    std::vector<Entry> m_nodes;      // contiguous node pool
+    std::vector<int32_t> m_free;     // free node indices (stack)
+    std::vector<int32_t> m_slots;    // ring: key & mask → node index, -1 empty
+    std::vector<uint64_t> m_occupied;// ring occupancy bitmap
+    size_t m_window = 0;
+    size_t m_mask = 0;
+    int64_t m_base = 0;              // lowest key the window covers
+    size_t m_size = 0;
+    int32_t m_lru_head = -1;         // oldest
+    int32_t m_lru_tail = -1;         // newest
+
+    size_t slot_of(int64_t key) const { return static_cast<size_t>(static_cast<uint64_t>(key)) & m_mask; }
+    bool in_window(int64_t key) const {
+        return m_size > 0 && key >= m_base && key - m_base < static_cast<int64_t>(m_window);
+    }
+
+    // Only the keys leaving the window are scanned, so a forward-play slide
+    // of one frame costs one bitmap word, not a walk over every entry.
+    template <typename OnEvict>
+    void slide_to(int64_t new_base, OnEvict& on_evict) {
+        const int64_t w = static_cast<int64_t>(m_window);
+        int64_t from, to;
+        if (new_base > m_base) {
+            from = m_base;
+            to = new_base - m_base < w ? new_base : m_base + w;
+        } else {
+            from = m_base - new_base < w ? new_base + w : m_base;
+            to = m_base + w;
+        }
+        while (Entry* e = scan_up(from, to)) {
+            from = e->key + 1;
+            on_evict(*e);
+            erase(e);
+        }
+        m_base = new_base;
+    }
+
+    void link_tail(int32_t idx) {
+        Entry& e = m_nodes[idx];
+        e.lru_prev = m_lru_tail;
+        e.lru_next = -1;
+        if (m_lru_tail >= 0) m_nodes[m_lru_tail].lru_next = idx;
+        else m_lru_head = idx;
+        m_lru_tail = idx;
+    }
+
+    void unlink(int32_t idx) {
+        Entry& e = m_nodes[idx];
+        if (e.lru_prev >= 0) m_nodes[e.lru_prev].lru_next = e.lru_next;
+        else m_lru_head = e.lru_next;
+        if (e.lru_next >= 0) m_nodes[e.lru_next].lru_prev = e.lru_prev;
+        else m_lru_tail = e.lru_prev;
+        e.lru_prev = e.lru_next = -1;
+    }
+
+    // Lowest occupied key in [from, to). Requires to - from <= window.
+    // Bitmap words are 64-aligned in slot space and the window is a multiple
+    // of 64, so a run of bits within one word never wraps.
+    Entry* scan_up(int64_t from, int64_t to) {
+        for (int64_t k = from; k < to; ) {
+            size_t slot = slot_of(k);
+            size_t bit = slot & 63;
+            int64_t span = static_cast<int64_t>(64 - bit);
+            if (to - k < span) span = to - k;
+            uint64_t word = m_occupied[slot >> 6] >> bit;
+            if (span < 64) word &= (uint64_t(1) << span) - 1;
+            if (word) return &m_nodes[m_slots[slot + static_cast<size_t>(__builtin_ctzll(word))]];
+            k += span;
+        }
+        return nullptr;
+    }
+
+    // Highest occupied key in [from, to). Same constraints as scan_up.
+    Entry* scan_down(int64_t from, int64_t to) {
+        for (int64_t k = to - 1; k >= from; ) {
+            size_t slot = slot_of(k);
+            size_t bit = slot & 63;
+            int64_t span = static_cast<int64_t>(bit + 1);
+            if (k - from + 1 < span) span = k - from + 1;
+            uint64_t word = m_occupied[slot >> 6];
+            if (bit < 63) word &= (uint64_t(1) << (bit + 1)) - 1;
+            size_t low = bit + 1 - static_cast<size_t>(span);
+            word &= ~((uint64_t(1) << low) - 1);
+            if (word) {
+                size_t hb = 63 - static_cast<size_t>(__builtin_clzll(word));
+                return &m_nodes[m_slots[slot - bit + hb]];
+            }
+            k -= span;
+        }
+        return nullptr;
+    }
+};
+
+} // namespace emp
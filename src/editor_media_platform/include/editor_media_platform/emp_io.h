@@ -0,0 +1,78 @@
+#pragma once
+
+// Demux I/O — the byte layer under every FFmpeg demuxer.
+//
+// Each open media file has one shared source: a descriptor, a block cache
+// and a read-ahead window that a small I/O pool keeps filled ahead of the
+// demuxers, in coalesced reads. On NAS/SMB volumes small synchronous
+// reads during demux were decode stalls; with read-ahead the demuxer
+// finds its next bytes in memory. GetIoStats reports, per file, how much
+// came from storage, how fast, and how long demuxers still waited on it.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace emp {
+
+struct IoFileStats {
+    std::string path;
+    int64_t size = 0;               // file size in bytes
+    int64_t bytes_read = 0;         // bytes read from storage
+    int64_t reads = 0;              // storage reads (coalesced runs)
+    int64_t read_ns = 0;            // time in storage reads
+    int64_t stalls = 0;             // demuxer reads that waited on storage
+    int64_t stall_ns = 0;           // time demuxers waited
+    int64_t hits = 0;               // block lookups served from memory
+    int64_t misses = 0;             // block lookups that went to storage
+    int64_t read_ahead_blocks = 0;  // blocks fetched ahead of demand
+    int64_t read_ahead_hits = 0;    // read-ahead blocks a demuxer then used
+
+    // Storage throughput while reading, MB/s (0 before the first read).
+    double throughput_mbps() const {
+        return read_ns > 0 ? (static_cast<double>(bytes_read) * 1e3) / static_cast<double>(read_ns)
+                           : 0.0;
+    }
+};
+
+// Stats for every file currently open by some demuxer. Counters start
+// when the file is opened and go away with its last demuxer.
+std::vector<IoFileStats> GetIoStats();
+
+// Read-ahead window per file, in bytes. Clamped to [0, 8 MiB] (half the
+// per-file block cache); 0 disables read-ahead. Default 4 MiB.
+static constexpr int64_t DEFAULT_IO_READ_AHEAD = 4 * 1024 * 1024;
+void SetIoReadAhead(int64_t bytes);
+int64_t GetIoReadAhead();
+
+// ── Local extent cache (opt-in) ──
+// Keeps 2 MiB extents of files on network volumes on a local disk, LRU
+// within a byte budget and kept across sessions, so a second pass over
+// remote media (scrub, replay, next session) reads local disk instead of
+// the network. Extents are keyed by path plus ComputeContentHash.
+
+struct IoExtentCacheStats {
+    int64_t hits = 0;          // extent reads served from local disk
+    int64_t misses = 0;        // extents fetched from the network
+    int64_t evictions = 0;     // extents dropped for the budget
+    int64_t extents = 0;       // extents on disk
+    int64_t bytes_cached = 0;  // their total size
+    int64_t budget_bytes = 0;  // 0 = disabled
+
+    double hit_ratio() const {
+        const int64_t total = hits + misses;
+        return total > 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+// Enable with a cache directory (created if missing) and a byte budget;
+// an empty dir or zero budget disables. remote_only (default) caches
+// network volumes only. Applies to files opened from then on.
+void SetIoExtentCache(const std::string& dir, int64_t budget_bytes, bool remote_only = true);
+IoExtentCacheStats GetIoExtentCacheStats();
+
+// Drop every cached extent of `path` — its bytes changed in place.
+// TimelineMediaBuffer::InvalidatePath calls this.
+void InvalidateIoExtentCache(const std::string& path);
+
+} // namespace emp
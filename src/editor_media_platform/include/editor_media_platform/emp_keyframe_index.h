@@ -0,0 +1,156 @@
+#pragma once
+
+// KeyframeIndex — persistent per-file GOP map for the video stream.
+//
+// Without it, every Park/Scrub seek is "av_seek_frame(BACKWARD) and hope":
+// the demuxer searches for some keyframe at or before the target (for
+// non-indexed containers like MPEG-TS that is a binary search of packet
+// reads), then decode_until_target decodes an unknown number of frames.
+// For long-GOP H.264/HEVC camera originals both halves are expensive, and
+// Play has to guess (the 2s need_seek heuristic) whether a forward jump is
+// cheaper as a seek or as a decode.
+//
+// The index records, per GOP, the keyframe's PTS (stream time base), its
+// byte position when known, and the GOP's frame count. Readers use it to
+//   1. seek straight to the keyframe that owns the target,
+//   2. skip a Play-mode seek when the target's keyframe is at or behind the
+//      decoder's position (the seek would land behind us — decode forward),
+// and TMB uses the mean GOP length to predict what a strided decode costs
+// (stride_for_clip).
+//
+// Where an index comes from, cheapest first:
+//   - the in-process registry (another MediaFile already found it),
+//   - the on-disk cache: <dir>/<content_hash>.kfidx, next to the peak cache
+//     and keyed by ComputeContentHash, so a copied/renamed file still hits
+//     and a rewritten one misses,
+//   - the container's own sample table (MOV/MP4 index every packet), read
+//     at MediaFile::Open,
+//   - a packet scan (BuildKeyframeIndex) — reads the whole file, so TMB
+//     runs it as a background decode-prep job, never on a decode path.
+
+#include "emp_errors.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace emp {
+
+static constexpr char     KEYFRAME_INDEX_MAGIC[4] = {'J','V','K','I'};
+static constexpr uint32_t KEYFRAME_INDEX_VERSION  = 1;
+static constexpr size_t   KEYFRAME_INDEX_HEADER_SIZE = 64;
+
+#pragma pack(push, 1)
+struct KeyframeIndexHeader {
+    char     magic[4];             //  4 bytes  (offset  0)
+    uint32_t version;              //  4 bytes  (offset  4)
+    int64_t  source_size;          //  8 bytes  (offset  8)
+    uint64_t content_hash;         //  8 bytes  (offset 16) — ComputeContentHash
+    int32_t  stream_index;         //  4 bytes  (offset 24) — AVStream index
+    int32_t  time_base_num;        //  4 bytes  (offset 28)
+    int32_t  time_base_den;        //  4 bytes  (offset 32)
+    int64_t  frame_duration;       //  8 bytes  (offset 36) — stream ticks
+    uint64_t gop_count;            //  8 bytes  (offset 44)
+    uint8_t  reserved[12];         // 12 bytes  (offset 52) = 64 total
+};
+#pragma pack(pop)
+static_assert(sizeof(KeyframeIndexHeader) == KEYFRAME_INDEX_HEADER_SIZE,
+    "KeyframeIndexHeader must be exactly 64 bytes");
+
+class KeyframeIndex {
+public:
+    struct Gop {
+        int64_t  keyframe_pts = 0;  // stream time base
+        int64_t  keyframe_pos = -1; // byte offset of the keyframe packet, -1 unknown
+        uint32_t frames = 0;        // packets from this keyframe up to the next
+    };
+
+    // gops must be non-empty and sorted by keyframe_pts (asserted).
+    KeyframeIndex(uint64_t content_hash, int64_t source_size, int stream_index,
+                  int32_t time_base_num, int32_t time_base_den,
+                  int64_t frame_duration, std::vector<Gop> gops);
+
+    uint64_t content_hash() const { return m_content_hash; }
+    int64_t source_size() const { return m_source_size; }
+    int stream_index() const { return m_stream_index; }
+    int32_t time_base_num() const { return m_tb_num; }
+    int32_t time_base_den() const { return m_tb_den; }
+    int64_t frame_duration() const { return m_frame_duration; }
+    const std::vector<Gop>& gops() const { return m_gops; }
+
+    // Index of the GOP owning `pts` (last keyframe_pts <= pts), or -1 when
+    // pts precedes the first keyframe.
+    int GopAt(int64_t pts) const;
+
+    // Frames decoded to reach `pts` after seeking to its keyframe, counting
+    // the keyframe itself. 1 for intra-only streams. Clamped to the GOP's
+    // frame count; pts before the first keyframe counts as the first GOP.
+    int64_t FramesToReach(int64_t pts) const;
+
+    // Mean frames decoded to reach a frame after a keyframe seek, averaged
+    // over every frame of the file: sum(frames * (frames + 1) / 2) / total.
+    // 1.0 for intra-only streams.
+    double MeanFramesToReach() const { return m_mean_reach; }
+
+    // Atomic write (.tmp + rename), like PeakFileWriter. Returns true on success.
+    bool Save(const std::string& path) const;
+
+    // nullptr on any mismatch: missing file, bad magic/version, truncated
+    // GOP table, or a content_hash/source_size that doesn't match the
+    // caller's (the source changed — rebuild).
+    static std::unique_ptr<KeyframeIndex> Load(const std::string& path,
+                                               uint64_t expected_hash,
+                                               int64_t expected_size);
+
+private:
+    uint64_t m_content_hash;
+    int64_t m_source_size;
+    int m_stream_index;
+    int32_t m_tb_num;
+    int32_t m_tb_den;
+    int64_t m_frame_duration;
+    std::vector<Gop> m_gops;
+    double m_mean_reach = 1.0;
+};
+
+// ============================================================================
+// Process-wide registry + on-disk cache
+// ============================================================================
+
+// Directory for persisted indexes. Empty (the default) keeps indexes in
+// memory only. Lua sets it at project open (database.get_keyframe_index_dir).
+void SetKeyframeIndexDir(const std::string& dir);
+std::string GetKeyframeIndexDir();
+
+// "<dir>/<016x hash>.kfidx", or "" when no dir is set.
+std::string KeyframeIndexPath(uint64_t content_hash);
+
+// Registry lookup by content hash, falling back to the on-disk cache (a
+// disk hit is registered) unless check_disk is false — Readers re-poll the
+// registry for a background-built index and must not stat per decode.
+// nullptr when neither has it. content_hash 0 ("no fingerprint") never
+// matches.
+std::shared_ptr<const KeyframeIndex> FindKeyframeIndex(uint64_t content_hash,
+                                                       int64_t source_size,
+                                                       bool check_disk = true);
+
+// Register an index and persist it when a dir is set. Returns the
+// registered instance (an earlier registration for the same hash wins, so
+// concurrent builders converge on one object).
+std::shared_ptr<const KeyframeIndex> PublishKeyframeIndex(
+    std::shared_ptr<const KeyframeIndex> index);
+
+// Drop every registered index (tests; disk files are untouched).
+void ClearKeyframeIndexRegistry();
+
+// Build an index by scanning every video packet of `path` with a private
+// format context (packet headers and payload reads, no decode). Cost is a
+// full sequential read of the file: background only. `cancel` (optional)
+// is polled per packet; a cancelled scan returns Error::internal.
+// Does not publish — the caller decides.
+Result<std::shared_ptr<const KeyframeIndex>> BuildKeyframeIndex(
+    const std::string& path, const std::atomic<bool>* cancel = nullptr);
+
+} // namespace emp
@@ -10,6 +10,7 @@ namespace emp {
 
 // Forward declaration for implementation
 class MediaFileImpl;
+class KeyframeIndex;
 
 // Information about an opened media file
 struct MediaFileInfo {
@@ -176,8 +177,9 @@ public:
     // and dispatches paths round-robin. Results come back in input order,
     // one Result per input path (each may independently be an error).
     //
-    // parallelism=0 (default) uses std::thread::hardware_concurrency(),
-    // clamped to the input size. Pass an explicit value to override.
+    // parallelism=0 (default) uses the CPU budget's Probe slots
+    // (emp_cpu_budget.h) — the whole machine when idle, one thread while
+    // playing — clamped to the input size. Pass an explicit value to override.
     //
     // Intended consumer: relink scan, bulk media browser probes, any
     // workflow that needs metadata for hundreds of files at once.
@@ -214,6 +216,17 @@ public:
     // (duration, fps, pix_fmt) is needed — use Open / ProbeMetadata.
     static Result<void> ProbeCodecExistence(const std::string& path);
 
+    // Keyframe index for the video stream (emp_keyframe_index.h), or
+    // nullptr while none is known. Open finds one in the registry, the
+    // on-disk cache, or the container's sample table; an index built later
+    // by a background scan (TMB decode-prep) is picked up from the registry
+    // on the next call.
+    std::shared_ptr<const KeyframeIndex> keyframe_index() const;
+
+    // Content fingerprint of the file's bytes (ComputeContentHash), or 0
+    // when none was computed (BRAW, audio-only, I/O failure).
+    uint64_t content_hash() const;
+
     // Internal: Constructor is public but MediaFileImpl is opaque, so only EMP can create MediaFiles
     explicit MediaFile(std::unique_ptr<MediaFileImpl> impl, MediaFileInfo info);
 
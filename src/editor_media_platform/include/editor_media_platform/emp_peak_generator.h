@@ -3,6 +3,7 @@
 #include "emp_peak_file.h"
 #include "emp_reader.h"
 #include "emp_media_file.h"
+#include "emp_cpu_budget.h"
 #include <string>
 #include <memory>
 #include <thread>
@@ -19,7 +20,8 @@ namespace emp {
 // PeakGenerator — concurrent round-robin peak computation engine
 //
 // Files are processed in interleaved 1-second chunks so all queued files
-// progress simultaneously. Multiple worker threads provide parallelism.
+// progress simultaneously. Multiple worker threads provide parallelism; how
+// many run at once follows the CPU budget (emp_cpu_budget.h).
 // The main thread can query partially-generated peak data for progressive
 // waveform display via QueryInProgress().
 //
@@ -76,6 +78,11 @@ public:
     // resources). Exposed for tests asserting admission-cap behavior.
     int GetRunningCount() const;
 
+    // Worker threads spawned, and how many the CPU budget lets run right
+    // now (the rest park). Exposed for tests asserting budget behavior.
+    int GetWorkerCount() const { return static_cast<int>(m_workers.size()); }
+    int GetActiveWorkerCount() const;
+
     // Query in-progress peak data for progressive waveform display.
     // Returns level-0 data resampled to pixel_width. Only valid while
     // state == Running. Thread-safe: called from main thread while
@@ -130,7 +137,7 @@ private:
     };
 
     // Worker thread entry point
-    void WorkerLoop();
+    void WorkerLoop(int index);
 
     // Job lifecycle subfunctions (rule 2.5: top-level reads like algorithm)
     bool InitJob(ChunkedJob& job);
@@ -149,6 +156,11 @@ private:
     std::condition_variable m_admission_cv;   // signalled when a Running slot frees
     std::atomic<bool> m_shutdown{false};
 
+    // CPU budget: workers with index >= m_budget_slots park (guarded by
+    // m_mutex; refreshed by the budget listener).
+    int m_budget_slots = 1;
+    int m_budget_listener = 0;
+
     // Two-queue scheduler: workers prefer jobs that have already been
     // admitted (m_running_queue) and fall through to the pending pool
     // only when admission has capacity. This prevents all workers from
@@ -6,6 +6,7 @@
 #include "emp_errors.h"
 #include "emp_time.h"
 #include <memory>
+#include <vector>
 
 namespace emp {
 
@@ -13,8 +14,11 @@ namespace emp {
 // Set by the transport layer (playback controller, ruler drag) via Lua bindings.
 //
 // Play:  Sequential decode with seek avoidance (need_seek check)
-// Scrub: Always seek to keyframe before target
-// Park:  Same as Scrub
+// Scrub: Shuttle decode — the keyframe at or before the target, at half
+//        resolution (see Reader::SetShuttleDecode). A ruler drag wants a
+//        responsive picture, not the exact frame; Park delivers that on
+//        release.
+// Park:  Always seek to keyframe before target, decode to the exact frame
 enum class DecodeMode { Play, Scrub, Park };
 
 // Global decode mode accessors (thread-safe)
@@ -56,6 +60,26 @@ public:
     Result<void> SeekUS(TimeUS t_us);
     Result<std::shared_ptr<Frame>> DecodeAtUS(TimeUS t_us);
 
+    // Reverse playback: seek to the keyframe owning t_us, decode forward to
+    // the floor frame of t_us once, and return the frames from the keyframe
+    // through that floor frame in ascending PTS order — at most max_frames,
+    // the newest kept. One GOP decode feeds up to a GOP of reverse steps
+    // instead of one decode-from-keyframe per step. Same past-EOF clamp as
+    // DecodeAtUS; BRAW, qtrle and shuttle decode return the single DecodeAtUS
+    // frame.
+    Result<std::vector<std::shared_ptr<Frame>>> DecodeGopUS(TimeUS t_us, int max_frames);
+
+    // Forward prefetch: the frames DecodeAt would return for t0, t0+stride,
+    // t0+2*stride, ... < t1 (t0/t1 share a rate), from one decode pass —
+    // seek decision once, every frame up to the last target decoded once,
+    // only the picked frames converted, in parallel where conversion is
+    // per-frame (HW wrap, planar YUV, BGRA at size). Targets past the last
+    // frame are left off, so the result can be shorter than the range; it
+    // is also cut at the first frame the frame arena has no room for.
+    // Error only when nothing could be returned. BRAW, qtrle and shuttle
+    // decode fall back to one DecodeAtUS per target.
+    Result<std::vector<std::shared_ptr<Frame>>> DecodeRange(FrameTime t0, FrameTime t1, int stride);
+
     // Audio decoding
     // Decodes audio from [t0, t1) using the given CFR grid rate
     // Output is resampled to the specified AudioFormat (float32 stereo @ device rate)
@@ -79,6 +103,27 @@ public:
     // Retained across cache-hit calls — reflects codec throughput, not per-call latency.
     float LastBatchMsPerFrame() const;
 
+    // Shuttle decode: every DecodeAt seeks to the keyframe at or before the
+    // target and returns THAT frame — one packet read, one decode, loop
+    // filter skipped — converted at half the normal output resolution.
+    // At 16-32x a long-GOP decoder otherwise spends most of its time
+    // decoding frames between keyframes that the stride then throws away.
+    // Always on in DecodeMode::Scrub; TMB turns it on per reader above
+    // SHUTTLE_FREE_RUN_SPEED. FFmpeg path only: BRAW (intra) and qtrle
+    // decode as usual. HW (VideoToolbox) frames are keyframe-only but keep
+    // their native size — they are wrapped, not converted.
+    void SetShuttleDecode(bool on);
+    bool ShuttleDecode() const;
+
+    // Planar YUV output: SW-decoded frames in yuv420p, nv12, yuv422p10le or
+    // yuv444p (and the yuvj variants) come back as YUV frames
+    // (Frame::pixel_format) instead of BGRA — 1.5 bytes/pixel for 4:2:0
+    // against 4 — downscaled per SetMaxOutputResolution. Conversion to BGRA
+    // happens at display (Frame::CopyBGRA). TMB turns this on for its cache;
+    // off by default. Other formats, HW, BRAW and qtrle frames stay BGRA.
+    void SetYuvOutput(bool on);
+    bool YuvOutput() const;
+
     // Set max output resolution for SW-decoded frames. Frames larger than
     // this are downscaled during decode. HW frames are unaffected.
     // 0,0 = no limit (output at source resolution).
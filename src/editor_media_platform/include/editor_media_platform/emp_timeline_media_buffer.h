@@ -3,6 +3,10 @@
 #include "emp_media_file.h"
 #include "emp_reader.h"
 #include "emp_frame.h"
+#include "emp_frame_arena.h"
+#include "emp_frame_index_cache.h"
+#include "emp_keyframe_index.h"
+#include "emp_decode_scheduler.h"
 #include "emp_audio.h"
 #include "emp_errors.h"
 #include "emp_time.h"
@@ -155,7 +159,7 @@ public:
     // Single owner — PlaybackController consumes this same constant.
     static constexpr float SHUTTLE_FREE_RUN_SPEED = 2.0f;
 
-    // Explicit pool sizing: 0 = synchronous (no workers), or >= 3 (1 prep + 1 video + 1 audio).
+    // Explicit pool sizing: 0 = synchronous (no workers), or >= 3 uniform decode workers.
     // See start_workers() for the rationale on the 3-thread minimum.
     static std::unique_ptr<TimelineMediaBuffer> Create(int pool_threads);
 
@@ -177,8 +181,12 @@ public:
     // Remove all clips on all tracks. Invalidates readers, clears caches.
     void ClearAllClips();
 
-    // Transport hint for pre-buffer direction
-    void SetPlayhead(int64_t frame, int direction, float speed);
+    // Transport hint for pre-buffer direction. Also anchors video prefetch
+    // deadlines: `frame` is taken to be on screen now, and later frames are
+    // due at the rate the playhead actually advances. clock_speed is that
+    // rate's magnitude as PlaybackClock reports it (ActiveSpeed during a
+    // ladder ramp, intent speed in shuttle free-run); 0 = |speed|.
+    void SetPlayhead(int64_t frame, int direction, float speed, float clock_speed = 0.0f);
 
     // Constant-time per-track video access.
     // cache_only=true: return cached frame or nullptr (no sync decode).
@@ -187,7 +195,7 @@ public:
     VideoResult GetVideoFrame(TrackId track, int64_t timeline_frame, bool cache_only = false);
 
     // Video track IDs with clips loaded, sorted descending (topmost first).
-    // Thread-safe: acquires m_tracks_mutex internally.
+    // Thread-safe: reads the published track map and clip layouts, no lock.
     std::vector<int> GetVideoTrackIds();
 
     // Effective (eligible) video-track set — pushed by the playback layer
@@ -224,6 +232,12 @@ public:
     // Returns nullptr if no mix params set.
     std::shared_ptr<PcmChunk> GetMixedAudio(TimeUS t0, TimeUS t1);
 
+    // Called on the mix thread each time a newly mixed chunk lands in the
+    // cache — the audio pump's cue that GetMixedAudio will now hit. Must
+    // not block or call back into TMB. Empty clears; the setter returns
+    // only once no call to the previous callback is running.
+    void SetAudioReadyCallback(std::function<void()> cb);
+
     // Set TC origin overrides for specific media paths (FR-004).
     // Call after SetTrackClips, before first SetPlayhead.
     // When acquire_reader opens a file whose path is in the map,
@@ -241,6 +255,55 @@ public:
     int64_t GetVideoCacheMissCount() const { return m_video_cache_misses.load(); }
     void ResetVideoCacheMissCount() { m_video_cache_misses.store(0); }
 
+    // Diagnostics: count of video prefetch decodes skipped because the frame
+    // could no longer be ready before its display deadline (see
+    // fill_prefetch). Reset with ResetVideoPrefetchDropCount().
+    int64_t GetVideoPrefetchDropCount() const { return m_video_prefetch_drops.load(); }
+    void ResetVideoPrefetchDropCount() { m_video_prefetch_drops.store(0); }
+
+    // Diagnostics: count of per-track / track-map lock acquisitions that
+    // found the lock already held and had to wait. Measures how often the
+    // tick thread, prefetch workers and Lua clip pushes collide.
+    int64_t GetLockContentionCount() const { return m_lock_contentions.load(); }
+    void ResetLockContentionCount() { m_lock_contentions.store(0); }
+
+    // MediaFile::Open calls made by the reader pool and decode-prep.
+    // Readers are per (track, clip) but share one MediaFile per path
+    // (open_media_file), so this counts distinct files, not clips.
+    int64_t GetMediaFileOpenCount() const { return m_media_file_opens.load(); }
+
+    // ── Video frame cache budget ──
+    // Every video track's frame cache draws from one TMB-wide byte budget.
+    // MAX_VIDEO_CACHE stays as a per-track entry ceiling (prefetch window
+    // sizing); the budget bounds actual memory, which an entry count can't
+    // — 144 entries is ~40 MB at 320x240 and ~4.7 GB at 4K. When the sum
+    // of all tracks exceeds the budget, the track furthest over its share
+    // gives up its entry furthest from the playhead. Shares are apportioned
+    // by eligibility (SetEffectiveVideoTracks) and playhead proximity:
+    // a track with a clip under the playhead weighs 2, a track reaching a
+    // clip within VIDEO_PREFETCH_MAX weighs 1, anything else weighs 0.
+    static constexpr int64_t DEFAULT_VIDEO_CACHE_BUDGET = 4LL << 30;  // 4 GiB
+    void SetCacheBudget(int64_t bytes);
+    int64_t GetCacheBudget() const;
+
+    // Per-track cache accounting. bytes counts distinct Frames once — stride
+    // and hold fills reference one Frame from several timeline positions.
+    struct VideoCacheTrackStats {
+        TrackId track;
+        int64_t bytes = 0;
+        int64_t share_bytes = 0;  // current apportioned slice of the budget
+        int64_t entries = 0;
+        int64_t hits = 0;         // GetVideoFrame served from cache (exact or nearest)
+        int64_t misses = 0;       // GetVideoFrame found nothing usable in cache
+        int64_t evictions = 0;    // entry-cap LRU + budget evictions
+    };
+    struct VideoCacheStats {
+        int64_t budget_bytes = 0;
+        int64_t used_bytes = 0;
+        std::vector<VideoCacheTrackStats> tracks;
+    };
+    VideoCacheStats GetVideoCacheStats() const;
+
     // Remove a path from the offline blacklist (called when FS watcher
     // detects a previously-missing file has reappeared).
     void ClearOffline(const std::string& path);
@@ -249,7 +312,8 @@ public:
     // in-place byte rewrite, so any cached decode of the old bytes is
     // stale. Evicts the reader pool entries (next acquire reopens the
     // file), all cached video frames / audio PCM / EOF markers for
-    // clips referencing this path, the decode-speed hint, and the
+    // clips referencing this path, the decode-speed hint, the path's
+    // local extent cache copies (emp_io.h), and the
     // whole pre-mixed audio buffer (can't be partially invalidated —
     // mix is composed across clips). Safe to call at any time; readers
     // currently in use stay alive via shared_ptr until callers release.
@@ -257,6 +321,7 @@ public:
 
     // Stop all background decode work (prefetch workers + decode-prep jobs).
     // Called on playback stop to release HW decoder sessions immediately.
+    // Also trims the frame arena (idle buffers' pages go back to the OS).
     // Prefetch restarts on next play via SetPlayhead().
     void ParkReaders();
 
@@ -271,6 +336,11 @@ public:
     // Test accessor: return video_buffer_end for a track (-1 if unset/missing)
     int64_t GetVideoBufferEnd(TrackId track) const;
 
+    // Test hook: replace the steady clock behind video prefetch deadlines
+    // (the SetPlayhead anchor and "now") with `now_ns`. nullptr restores
+    // the steady clock.
+    void SetDeadlineClock(int64_t (*now_ns)());
+
 private:
     TimelineMediaBuffer();
 
@@ -300,6 +370,9 @@ private:
 
     ReaderHandle acquire_reader(TrackId track, const std::string& clip_id,
                                 const std::string& path);
+    // The path's live MediaFile (m_media_files), or a fresh Open with the
+    // path's TC override applied. Does not touch m_offline.
+    Result<std::shared_ptr<MediaFile>> open_media_file(const std::string& path);
     void release_reader(TrackId track, const std::string& clip_id);
     PoolEntry evict_lru_reader();  // returns evicted entry for destruction outside lock
     std::string snapshot_pool_state(const char* action, const TrackId& track,
@@ -324,12 +397,47 @@ private:
     // Paths that failed to open (offline media)
     std::unordered_map<std::string, Error> m_offline;
 
+    // One MediaFile per path, shared by every pool Reader on it (and the
+    // decode-prep probes): analysed stream info, keyframe index and the
+    // DemuxSource — one descriptor and block cache — are per file; each
+    // Reader still demuxes at its own position. Weak: pool entries own the
+    // MediaFile, so evicting the last reader on a path closes it.
+    // Cleared by SetTcOverrides and InvalidatePath.
+    std::unordered_map<std::string, std::weak_ptr<MediaFile>> m_media_files;
+
     // TC origin overrides: path → TcOverride (FR-004)
     std::unordered_map<std::string, TcOverride> m_tc_overrides;
 
     // ── Per-track state ──
+    //
+    // Concurrency model. The clip layout and the track map are read far
+    // more often (every tick, every prefetch iteration) than they change
+    // (Lua re-posts, track add/remove), so both are published RCU-style:
+    // writers build a new immutable copy and swap a shared_ptr; readers
+    // load the pointer without locking and keep their snapshot alive for
+    // as long as they use it (Segment::clip points into a snapshot).
+    // Everything mutable per track — caches, watermarks, generation —
+    // sits behind that track's own mutex, so V1's prefetch never waits on
+    // V2's GetVideoFrame. Lock order: a track mutex may be held while
+    // try-locking another track's (budget eviction); no path blocks on a
+    // second track mutex, and m_tracks_mutex (writer-only) is never taken
+    // while holding a track mutex. Layout writers take a track mutex
+    // under m_tracks_mutex, so ReleaseTrack / ClearAllClips can't retire
+    // the state between their lookup and their publish.
+    using ClipLayout = std::vector<ClipInfo>;
+    using ClipLayoutPtr = std::shared_ptr<const ClipLayout>;
+
     struct TrackState {
-        std::vector<ClipInfo> clips;
+        // Guards every field below except clip_layout.
+        mutable std::mutex mutex;
+
+        // Published clip layout — read via layout(), replaced via publish()
+        // (caller holds `mutex` so the swap is ordered with the cache purge
+        // and generation bump that accompany it). Never null.
+        ClipLayoutPtr clip_layout = std::make_shared<const ClipLayout>();
+        ClipLayoutPtr layout() const { return std::atomic_load(&clip_layout); }
+        void publish(ClipLayoutPtr next) { std::atomic_store(&clip_layout, std::move(next)); }
+
         // Video frame cache: source_frame → decoded frame (per clip_id)
         struct CachedFrame {
             std::string clip_id;
@@ -338,7 +446,6 @@ private:
             int rotation = 0;
             int32_t par_num = 1;
             int32_t par_den = 1;
-            uint64_t insert_seq = 0;  // monotonic insertion order for LRU eviction
             // Offline marker: when true, this timeline position is known
             // to have no decodable content (past EOF, before start TC)
             // for a file that otherwise opens fine. Play-time cache_only
@@ -349,11 +456,27 @@ private:
             std::string error_code;
             std::string error_msg;
         };
-        std::map<int64_t, CachedFrame> video_cache; // key = timeline_frame
-        uint64_t video_cache_seq = 0;               // next insert_seq to assign
         // Must hold at least 2 × VIDEO_PREFETCH_MAX (96) so current clip + next
         // clip prefetch don't thrash each other via eviction.
         static constexpr size_t MAX_VIDEO_CACHE = 144;
+        // Ring window (timeline frames) the cache index covers. Entries more
+        // than this far from a new insert fall off — ~170s at 24fps, far
+        // beyond anything prefetch or scrub keeps useful.
+        static constexpr size_t VIDEO_CACHE_WINDOW = 4096;
+        using VideoCache = FrameIndexCache<CachedFrame>;
+        VideoCache video_cache{MAX_VIDEO_CACHE, VIDEO_CACHE_WINDOW}; // key = timeline_frame
+
+        // Budget accounting: bytes of distinct Frames held by video_cache.
+        // Refcounted by Frame pointer so a stride/hold fill that places one
+        // Frame at N positions is charged once. Maintained only through
+        // store_video_cache_entry / erase_video_cache_entry. The byte total
+        // is atomic so budget enforcement can sum every track without
+        // taking their locks.
+        std::unordered_map<const Frame*, int> video_frame_refs;
+        std::atomic<int64_t> video_cache_bytes{0};
+        int64_t video_cache_hits = 0;
+        int64_t video_cache_misses = 0;
+        int64_t video_cache_evictions = 0;
 
         // Audio PCM cache (pre-buffered at clip boundaries)
         struct CachedAudio {
@@ -389,34 +512,85 @@ private:
             int32_t par_num = 1, par_den = 1;
         };
         std::unordered_map<std::string, ClipEofInfo> clip_eof_frame;
+
+        // Reverse GOP decodes running now, keyed by the timeline position
+        // each started from (the newest frame it caches). Claimed by
+        // decode_gop_into_cache, so the pipelined REVERSE_GOP job and
+        // fill_prefetch never decode one GOP twice: the job skips a claimed
+        // GOP, fill_prefetch waits on gop_done for it to land.
+        std::unordered_set<int64_t> gops_in_flight;
+        std::condition_variable gop_done;
     };
 
-    mutable std::mutex m_tracks_mutex;
-    std::unordered_map<TrackId, TrackState, TrackIdHash> m_tracks;
+    // Track map, published RCU-style (see TrackState). TrackStates are
+    // shared so a worker holding one stays valid across ReleaseTrack; a
+    // released track is detached, purged and its generation bumped, so
+    // the worker abandons on its next check. m_tracks_mutex serializes
+    // map writers only — readers never take it.
+    using TrackMap = std::unordered_map<TrackId, std::shared_ptr<TrackState>, TrackIdHash>;
+    std::mutex m_tracks_mutex;
+    std::shared_ptr<const TrackMap> m_tracks = std::make_shared<const TrackMap>();
+
+    std::shared_ptr<const TrackMap> tracks() const { return std::atomic_load(&m_tracks); }
+    std::shared_ptr<TrackState> find_track(const TrackId& track) const;
+    // Caller holds m_tracks_mutex.
+    std::shared_ptr<TrackState> find_or_create_track_locked(const TrackId& track);
+    // Replace the track map with `next` (caller holds m_tracks_mutex).
+    void publish_tracks(std::shared_ptr<const TrackMap> next);
+    // Detach a removed track: purge its caches and bump its generation so
+    // in-flight prefetch on it abandons.
+    void retire_track(TrackState& ts);
+
+    // Lock with contention accounting: try_lock first, count a miss in
+    // m_lock_contentions, then block.
+    std::unique_lock<std::mutex> lock_counted(std::mutex& m) const;
+    std::unique_lock<std::mutex> lock_track(const TrackState& ts) const {
+        return lock_counted(ts.mutex);
+    }
 
-    // Effective video-track set pushed by playback layer. Guarded by
-    // m_tracks_mutex (read on REFILL hot path under same lock as m_tracks;
-    // write on mute/solo change is rare). When _valid is false, every
+    // Effective video-track set pushed by playback layer, published as an
+    // immutable snapshot (read on the REFILL hot path and in budget share
+    // computation, written on mute/solo change). Null = no push yet: every
     // track is treated as eligible (boot before first push).
-    std::vector<int> m_effective_video_tracks;
-    bool m_effective_video_tracks_valid{false};
+    std::shared_ptr<const std::vector<int>> m_effective_video_tracks;
+
+    // TMB-wide video cache byte budget.
+    std::atomic<int64_t> m_video_cache_budget{DEFAULT_VIDEO_CACHE_BUDGET};
 
     // Find segment (CLIP or GAP) at timeline frame. Never returns null-equivalent —
-    // gaps are explicit with bounds. Caller must hold m_tracks_mutex.
-    Segment find_segment_at(const TrackState& ts, int64_t timeline_frame) const;
+    // gaps are explicit with bounds. Segment::clip points into `clips`; the
+    // caller keeps that layout snapshot alive while using it.
+    Segment find_segment_at(const ClipLayout& clips, int64_t timeline_frame) const;
 
     // Track is in the effective/eligible set pushed by the playback layer.
-    // Until first push, every track is eligible. Caller must hold m_tracks_mutex.
+    // Until first push, every track is eligible. Lock-free.
     bool track_is_eligible(int track_index) const;
 
-    // Evict one entry from video cache: LRU via insert_seq.
-    // Lowest insert_seq = oldest insertion = least recently used.
+    // Evict one entry from video cache: oldest insertion (LRU list head).
     // Correct for both directions and across seek boundaries.
-    // O(n) on cache size (~144 entries). Caller must hold m_tracks_mutex.
+    // O(1). Caller must hold ts.mutex.
     void evict_video_cache_entry(TrackState& ts) const;
 
+    // All video_cache mutation goes through these so the byte accounting in
+    // TrackState stays exact. store_ replaces any entry at timeline_frame,
+    // enforces MAX_VIDEO_CACHE (LRU), then enforces the TMB-wide budget
+    // without evicting the entry just stored. uncharge_ is the on_evict /
+    // on_erase hook for FrameIndexCache bulk removals.
+    // Caller must hold ts.mutex.
+    void store_video_cache_entry(TrackState& ts, int64_t timeline_frame,
+                                 TrackState::CachedFrame entry);
+    void erase_video_cache_entry(TrackState& ts, TrackState::VideoCache::Entry* e) const;
+    void uncharge_video_cache_entry(TrackState& ts, const TrackState::CachedFrame& cf) const;
+
+    // Budget enforcement across all tracks (see SetCacheBudget). Never evicts
+    // `inserting`'s entry at protect_tf; inserting may be null (no protection).
+    // Caller holds inserting->mutex (if any); other tracks are try-locked
+    // and skipped while busy — their owner trims them on its next insert.
+    void enforce_video_cache_budget(TrackState* inserting, int64_t protect_tf);
+    std::unordered_map<TrackId, int64_t, TrackIdHash> video_cache_shares() const;
+
     // Microsecond variant for audio path. Requires m_seq_rate to be set.
-    SegmentUS find_segment_at_us(const TrackState& ts, TimeUS t_us) const;
+    SegmentUS find_segment_at_us(const ClipLayout& clips, TimeUS t_us) const;
 
     // Check audio cache for pre-buffered PCM covering [seg_t0, seg_t1) for clip_id
     // Returns sub-range PcmChunk on hit (full coverage required), nullptr on miss
@@ -436,14 +610,21 @@ private:
 
     // ── Pre-buffer thread pool ──
     // Decode-preparation jobs: submitted externally (SetPlayhead probe scan,
-    // SetTrackClips reader warming). Processed with priority by prefetch_worker.
+    // SetTrackClips reader warming). Queued on the decode scheduler's Warm
+    // class; any worker except the reserved one may run them.
     // PreBufferJob is public so unit tests can construct jobs and feed
     // pick_proximity_warm_job (which is also public, below). The struct has
     // no encapsulated invariants — just plain data fields used by the picker
     // and the worker pipeline.
 public:
     struct PreBufferJob {
-        enum Type { SPEED_DETECT, READER_WARM };
+        // KEYFRAME_INDEX: packet-scan media_path's keyframe index
+        // (emp_keyframe_index.h) when Open found none. Lowest priority —
+        // it reads the whole file.
+        // REVERSE_GOP: reverse playback pipelining — decode the GOP ending
+        // at gop_position on a second reader while the prefetching worker
+        // serves the current GOP from cache.
+        enum Type { SPEED_DETECT, READER_WARM, KEYFRAME_INDEX, REVERSE_GOP };
         Type type = SPEED_DETECT;
 
         TrackId track{TrackType::Video, 0};
@@ -456,7 +637,7 @@ public:
         int32_t probe_rate_den = 1;
 
         // Timeline position of the clip this job warms. Used by
-        // process_next_decode_prep_job to pick the READER_WARM job whose clip
+        // pick_decode_prep_job to pick the READER_WARM job whose clip
         // is closest to the current playhead in the playback direction — so
         // at shuttle speed where many warm jobs may be queued, the imminent
         // clip wins over far-future ones (LIFO over sequence-ordered Lua
@@ -465,7 +646,10 @@ public:
         // -1 = unknown (SPEED_DETECT jobs leave this at default).
         int64_t sequence_start = -1;
 
-        // WARM timing: set by submit_pre_buffer, checked by prefetch_worker
+        // REVERSE_GOP: newest timeline frame of the GOP to decode.
+        int64_t gop_position = -1;
+
+        // WARM timing: set by submit_pre_buffer, checked by run_decode_prep_job
         std::chrono::steady_clock::time_point submitted_at{};
     };
 private:
@@ -473,43 +657,98 @@ private:
     void start_workers(int count);
     void stop_workers();
 
-    // Self-directed prefetch loops (replace batch REFILL system).
-    // Each worker autonomously picks tracks and fills one frame at a time.
-    void prep_worker();            // SPEED_DETECT + READER_WARM (dedicated thread)
-    void prefetch_worker();        // video prefetch only
-    void audio_prefetch_worker();  // audio prefetch only
+    // Uniform decode worker: loops on m_scheduler.run_next(self). What it
+    // runs (audio refill, video prefetch, prep jobs) is decided per pick by
+    // the scheduler's priority classes — see emp_decode_scheduler.h.
+    void decode_worker(int self);
 
-    // Decode-prep job processing (SPEED_DETECT, READER_WARM)
-    bool process_next_decode_prep_job();
+    // Decode-prep job processing (SPEED_DETECT, READER_WARM, KEYFRAME_INDEX)
+    int pick_decode_prep_job(const std::vector<PreBufferJob>& jobs) const;
+    void run_decode_prep_job(PreBufferJob& job);
     void submit_pre_buffer(const PreBufferJob& job);
     static std::string job_key(const PreBufferJob& job);
 
     // Public for unit testing — no controller state, pure function over the
     // job vector + playhead state. Returns the index of the READER_WARM job
     // whose sequence_start is closest to `playhead` in `direction`, or -1 if
-    // no READER_WARM jobs exist. See process_next_decode_prep_job for the
-    // rationale on proximity priority.
+    // no READER_WARM jobs exist. See pick_decode_prep_job for the rationale
+    // on proximity priority.
 public:
     static int pick_proximity_warm_job(const std::vector<PreBufferJob>& jobs,
                                        int64_t playhead, int direction);
 private:
 
-    // Track selection for prefetch — find most urgent track needing work
-    bool pick_video_track(TrackId& out);
+    // Track selection for prefetch — find most urgent track needing work.
+    // Video tracks count only while less than `max_ahead` frames are
+    // buffered: VIDEO_PREFETCH_MIN selects imminent work, VIDEO_PREFETCH_MAX
+    // any top-up. Among those, earliest deadline of the next frame the
+    // track must decode wins (EDF).
+    bool pick_video_track(TrackId& out, int64_t max_ahead);
+
+    // ── Video prefetch deadlines ──
+    // Steady-clock ns at which timeline `frame` is due on screen,
+    // extrapolated from the last SetPlayhead anchor. INT64_MAX when no
+    // deadline applies (parked, no sequence rate).
+    int64_t frame_deadline_ns(int64_t frame) const;
+    // Steady-clock ns, or the SetDeadlineClock override.
+    int64_t deadline_clock_ns() const;
+    // "Now" for deadline checks: wall clock, clamped to the anchor plus
+    // DEADLINE_EXTRAPOLATION_MAX_MS so a stalled or absent tick source
+    // never makes the whole window look late.
+    int64_t deadline_now_ns() const;
+    // Measured steady-state decode cost for the clip's media (0 = unknown).
+    int64_t expected_decode_ns(const TrackId& track, const ClipInfo& clip) const;
+    // First frame at or after `from` in `direction` that lies inside a clip,
+    // or -1 if none before `limit` (exclusive, in direction of travel).
+    int64_t next_content_frame(const ClipLayout& clips, int64_t from,
+                               int direction, int64_t limit) const;
     bool pick_audio_track(TrackId& out);
 
+    // Scheduler sources: pick + fill one unit for the class. Return false
+    // when no track qualifies.
+    bool run_audio_refill();
+    bool run_video_prefetch(int64_t max_ahead);
+
     // Core prefetch algorithm (unified A/V, one frame per iteration)
     void fill_prefetch(const TrackId& track);
     void discard_already_played_prefetch(const TrackId& track);
 
     // Leaf helpers for fill_prefetch
     int stride_for_clip(const TrackId& track, const ClipInfo& clip) const;
-    void decode_into_cache(const TrackId& track, const Segment& seg,
-                           int64_t position, int stride, int direction,
-                           ReaderHandle& held_reader, std::string& held_clip_id,
-                           std::shared_ptr<Frame>& last_good_frame);
+    // Record a file's mean keyframe-seek reach for stride_for_clip.
+    void note_keyframe_index(const std::string& path, const KeyframeIndex& index);
+    // Note mf's keyframe index, or queue a KEYFRAME_INDEX scan if it has none.
+    void ensure_keyframe_index(const TrackId& track, const std::string& path,
+                               const MediaFile& mf);
+    // Returns the timeline frames the cursor moves past: `stride`, or the
+    // run cached by decode_range_into_cache when `range_slots` > stride.
+    int64_t decode_into_cache(const TrackId& track, const Segment& seg,
+                              int64_t position, int stride, int direction,
+                              ReaderHandle& held_reader, std::string& held_clip_id,
+                              std::shared_ptr<Frame>& last_good_frame,
+                              int range_slots = 0);
     void decode_audio_into_cache(const TrackId& track, const SegmentUS& seg,
                                  TimeUS position, TimeUS chunk_end);
+    // Reverse playback: one Reader::DecodeGopUS for the GOP owning
+    // `position`, cached at every timeline frame from `position` down to
+    // the oldest returned frame. Returns the count cached (0 = decode
+    // failed; caller falls back to the single-frame path).
+    int decode_gop_into_cache(const TrackId& track, const ClipInfo& clip,
+                              int64_t position, Reader& reader,
+                              std::shared_ptr<Frame>* newest = nullptr);
+    // Forward playback: one Reader::DecodeRange for `slots` timeline frames
+    // from `position` (speed 1.0 only: timeline and file frames step
+    // together), each decoded frame stride-filled, all stored under one
+    // track lock. Returns the count cached (0 = decode failed; caller falls
+    // back to the single-frame path).
+    int decode_range_into_cache(const TrackId& track, const ClipInfo& clip,
+                                int64_t position, int stride, int slots, Reader& reader,
+                                std::shared_ptr<Frame>* newest = nullptr);
+    // Queue a REVERSE_GOP job for the GOP ending at `position` when it is
+    // inside this clip and the prefetch window.
+    void submit_reverse_gop(const TrackId& track, const ClipInfo& clip, int64_t position);
+    // Fold one LastBatchMsPerFrame sample into m_decode_speed_cache.
+    void note_decode_speed(const TrackId& track, const std::string& path, float per_frame_ms);
 
     // Direction-aware watermark setters (never regress in direction of travel)
     void set_already_fetched_video(const TrackId& track, int64_t pos, int direction);
@@ -549,10 +788,11 @@ private:
         const TrackId& track, std::unordered_set<TrackId, TrackIdHash>& set);
 
     std::vector<std::thread> m_workers;
+    DecodeScheduler<PreBufferJob> m_scheduler;   // per-worker queues + priority classes
     std::mutex m_jobs_mutex;
-    std::condition_variable m_jobs_cv;
-    std::vector<PreBufferJob> m_jobs;            // decode-prep queue only
-    std::unordered_map<std::string, int64_t> m_pre_buffering;  // in-flight dedup
+    // Dedup for decode-prep jobs: a key is present from submit until the
+    // job finishes (queued or in flight). Protected by m_jobs_mutex.
+    std::unordered_map<std::string, int64_t> m_pre_buffering;
     std::atomic<bool> m_shutdown{false};
 
     // Active prefetch sets: tracks currently being filled by a worker
@@ -581,9 +821,32 @@ private:
 
     // Max adaptive stride: ceil(decode_ms / frame_period_ms), clamped
     static constexpr int MAX_STRIDE = 8;
-
-    // Pool sizing: floor = 1 prep + 1 video + 1 audio (start_workers layout
-    // invariant). Ceiling = FFmpeg shared-state contention plateau past ~14
+    // Above SHUTTLE_FREE_RUN_SPEED: keyframe-only decode, stride floored at
+    // the mean GOP length. 64 keeps ~12 decodes/s at 32x on 25fps media;
+    // GetVideoFrame's shuttle lookup has no distance bound, so the sparse
+    // cache still shows the nearest keyframe.
+    static constexpr int MAX_SHUTTLE_STRIDE = 64;
+
+    // Forward range decode: cache slots filled per Reader::DecodeRange (one
+    // decode pass, one track-lock acquisition). Capped by the clip end, the
+    // prefetch window and the first slot's deadline; a run shorter than
+    // VIDEO_RANGE_MIN_SLOTS takes the single-frame path, whose first frame
+    // lands sooner.
+    static constexpr int VIDEO_RANGE_MIN_SLOTS = 8;
+    static constexpr int VIDEO_RANGE_MAX_SLOTS = 24;
+
+    // Reverse GOP decode: frames converted per DecodeGopUS (newest kept).
+    // Covers a 2s GOP at 24fps; longer GOPs take a second, shorter decode
+    // from the same keyframe. Half of VIDEO_PREFETCH_MAX so one GOP plus
+    // the pipelined one fit the window.
+    static constexpr int REVERSE_GOP_MAX_FRAMES = 48;
+    // Pool key suffix for the REVERSE_GOP job's reader: a second reader
+    // per clip, so the pipelined decode never waits on (or repositions)
+    // the prefetching worker's reader.
+    static constexpr const char* REVERSE_GOP_READER_SUFFIX = "#reverse";
+
+    // Pool sizing: floor = 1 reserved (never runs prep jobs) + 2 that can
+    // warm in parallel (start_workers layout invariant). Ceiling = FFmpeg shared-state contention plateau past ~14
     // decode threads on Apple Silicon Pro/Max.
     static constexpr int MIN_POOL_THREADS = 3;
     static constexpr int MAX_POOL_THREADS = 16;
@@ -595,6 +858,10 @@ private:
     // WARM diagnostics: queue wait >200ms = workers starved (software)
     //                   acquire >1000ms = drive I/O or codec init slow (environment)
     static constexpr int WARM_QUEUE_WARN_MS = 200;
+
+    // Deadline extrapolation cap: past this long without a SetPlayhead, the
+    // playhead is treated as stalled rather than still advancing.
+    static constexpr int DEADLINE_EXTRAPOLATION_MAX_MS = 100;
     static constexpr int WARM_ACQUIRE_WARN_MS = 1000;
 
     // ── Playhead state ──
@@ -602,10 +869,11 @@ private:
     std::atomic<int64_t> m_prev_playhead_frame{-1};  // for discontinuity detection
     std::atomic<int> m_playhead_direction{0};
     std::atomic<float> m_playhead_speed{1.0f};
-
-    // Audio worker wake flag — set by SetPlayhead on discontinuity or low buffer,
-    // consumed by audio_prefetch_worker CV predicate. Eliminates 100ms polling gap.
-    std::atomic<bool> m_audio_work_pending{false};
+    // Deadline anchor: steady-clock ns of the last SetPlayhead, and the
+    // playhead's advance rate in timeline frames per second (0 = none).
+    std::atomic<int64_t> m_playhead_wall_ns{0};
+    std::atomic<double> m_playhead_frames_per_sec{0.0};
+    std::atomic<int64_t (*)()> m_deadline_clock{nullptr};
 
     // ── Autonomous pre-mixed audio ──
 
@@ -647,6 +915,11 @@ private:
     bool m_mix_params_changed = false;
     MixedAudioCache m_mixed_cache;
 
+    // SetAudioReadyCallback. Own mutex, held across the call, so clearing
+    // it waits out an in-flight notification without touching m_mix_mutex.
+    std::mutex m_audio_ready_mutex;
+    std::function<void()> m_audio_ready_cb;
+
     // Measured ms-per-frame per (track, file). Per-track keying is load-
     // bearing: a shared entry lets one track's cold-start keyframe timing
     // poison a sibling track's stride_for_clip before the sibling has any
@@ -654,8 +927,16 @@ private:
     // Protected by m_pool_mutex.
     std::map<std::pair<TrackId, std::string>, float> m_decode_speed_cache;
 
+    // Mean frames decoded to reach a frame after a keyframe seek, per file
+    // (KeyframeIndex::MeanFramesToReach). Absent = unknown, treated as 1
+    // (intra-only). Protected by m_pool_mutex.
+    std::unordered_map<std::string, float> m_keyframe_reach;
+
     // ── Diagnostics ──
     std::atomic<int64_t> m_video_cache_misses{0};
+    std::atomic<int64_t> m_video_prefetch_drops{0};
+    mutable std::atomic<int64_t> m_lock_contentions{0};
+    std::atomic<int64_t> m_media_file_opens{0};
 };
 
 } // namespace emp
@@ -0,0 +1,253 @@
+#include <editor_media_platform/emp_cpu_budget.h>
+#include "../../assert_handler.h"  // JVE_ASSERT (fires in Release; plain assert is stripped by -DNDEBUG)
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace emp {
+
+// ============================================================================
+// Policy — caps and claims per class
+// ============================================================================
+//
+// Claims are what an active class is expected to keep busy. Playback keeps
+// 1/8 of the machine back for everything below it (peaks still trickle in
+// during long plays); Scrub is bursty and leaves a quarter. Peaks claim
+// whatever slots they were given. Probe is last and claims nothing.
+//
+// Peak cap is the old PeakGenerator sizing (hw/2, at most 4): peak jobs are
+// I/O heavy and more workers only add seeks.
+//
+// Slice share is a quarter: slicing pays off when one heavy stream leaves
+// most decode workers idle, and the decode pool (total - 2 - share) still
+// keeps one worker per stream for multicam-sized timelines.
+
+namespace {
+
+constexpr int PEAKS_MAX_WORKERS = 4;
+
+struct BudgetState {
+    std::mutex mutex;
+    int threads_override = 0;
+    CpuForeground foreground = CpuForeground::Idle;
+    int active[CPU_CLASS_COUNT] = {};
+    int video_decoders = 0;
+    int decode_workers = 0;
+    int slots[CPU_CLASS_COUNT] = {};
+    int64_t rebalances = 0;
+
+    std::mutex listener_mutex;  // held while listeners run (see Remove)
+    std::map<int, std::function<void()>> listeners;
+    int next_listener_id = 1;
+};
+
+BudgetState& state() {
+    // Leaked: consumers (PeakGenerator, codec contexts) may outlive static
+    // destruction order at exit.
+    static BudgetState* s = new BudgetState();
+    return *s;
+}
+
+int total_threads_locked(const BudgetState& s) {
+    if (s.threads_override > 0) return s.threads_override;
+    const int hw = static_cast<int>(std::thread::hardware_concurrency());
+    return hw > 0 ? hw : 4;
+}
+
+int slice_workers(int total) {
+    return std::min(MAX_SLICE_WORKERS, total / 4);
+}
+
+int cap(CpuClass c, int total) {
+    switch (c) {
+        case CpuClass::Playback:
+        case CpuClass::Scrub:
+        case CpuClass::Probe:
+            return total;
+        case CpuClass::Peaks:
+            return std::min(PEAKS_MAX_WORKERS, std::max(1, total / 2));
+    }
+    return 1;
+}
+
+bool is_active(const BudgetState& s, CpuClass c) {
+    switch (c) {
+        case CpuClass::Playback: return s.foreground == CpuForeground::Playback;
+        case CpuClass::Scrub:    return s.foreground == CpuForeground::Scrub;
+        default:                 return s.active[static_cast<int>(c)] > 0;
+    }
+}
+
+int claim(CpuClass c, int total, int slots) {
+    switch (c) {
+        case CpuClass::Playback: return total - std::max(1, total / 8);
+        case CpuClass::Scrub:    return total - std::max(1, total / 4);
+        case CpuClass::Peaks:    return slots;
+        case CpuClass::Probe:    return 0;
+    }
+    return 0;
+}
+
+// Recompute slots top-down. Returns true when any class's slots changed.
+bool rebalance_locked(BudgetState& s) {
+    const int total = total_threads_locked(s);
+    int claimed = 0;
+    bool changed = false;
+    for (int i = 0; i < CPU_CLASS_COUNT; ++i) {
+        const auto c = static_cast<CpuClass>(i);
+        const int slots = std::clamp(total - claimed, 1, cap(c, total));
+        if (slots != s.slots[i]) {
+            s.slots[i] = slots;
+            changed = true;
+        }
+        if (is_active(s, c)) claimed += claim(c, total, slots);
+    }
+    if (changed) ++s.rebalances;
+    return changed;
+}
+
+void notify_listeners(BudgetState& s) {
+    std::lock_guard<std::mutex> lock(s.listener_mutex);
+    for (auto& [id, fn] : s.listeners) fn();
+}
+
+// Apply `mutate` under the budget lock, then notify if slots moved.
+template <typename F>
+void update(F&& mutate) {
+    auto& s = state();
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        mutate(s);
+        changed = rebalance_locked(s);
+    }
+    if (changed) notify_listeners(s);
+}
+
+} // namespace
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+int CpuBudgetSlots(CpuClass c) {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.slots[0] == 0) rebalance_locked(s);  // first use
+    return s.slots[static_cast<int>(c)];
+}
+
+int CpuBudgetCap(CpuClass c) {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return cap(c, total_threads_locked(s));
+}
+
+int CpuBudgetSliceWorkers() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return slice_workers(total_threads_locked(s));
+}
+
+int CpuBudgetCodecThreads() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.slots[0] == 0) rebalance_locked(s);
+    const int playback = s.slots[static_cast<int>(CpuClass::Playback)];
+    const int pool = std::max(0,
+        playback - s.decode_workers - slice_workers(total_threads_locked(s)));
+    // +1: the codec being opened.
+    return std::clamp(pool / (s.video_decoders + 1), 1, MAX_CODEC_THREADS);
+}
+
+CpuBudgetStats GetCpuBudgetStats() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.slots[0] == 0) rebalance_locked(s);
+    CpuBudgetStats stats;
+    stats.total_threads = total_threads_locked(s);
+    for (int i = 0; i < CPU_CLASS_COUNT; ++i) {
+        stats.class_slots[i] = s.slots[i];
+        stats.active[i] = is_active(s, static_cast<CpuClass>(i)) ? std::max(1, s.active[i]) : 0;
+    }
+    stats.video_decoders = s.video_decoders;
+    stats.decode_workers = s.decode_workers;
+    stats.slice_workers = slice_workers(stats.total_threads);
+    stats.rebalances = s.rebalances;
+    return stats;
+}
+
+void SetCpuBudgetThreads(int threads) {
+    JVE_ASSERT(threads >= 0, "SetCpuBudgetThreads: threads must be >= 0 (0 = hardware)");
+    update([threads](BudgetState& s) { s.threads_override = threads; });
+}
+
+void SetCpuForeground(CpuForeground fg) {
+    update([fg](BudgetState& s) { s.foreground = fg; });
+}
+
+CpuActivity::CpuActivity(CpuClass c) : m_class(c) {
+    JVE_ASSERT(c == CpuClass::Peaks || c == CpuClass::Probe,
+        "CpuActivity: Playback/Scrub activity comes from SetCpuForeground");
+    update([c](BudgetState& s) { ++s.active[static_cast<int>(c)]; });
+}
+
+CpuActivity::~CpuActivity() {
+    const CpuClass c = m_class;
+    update([c](BudgetState& s) {
+        JVE_ASSERT(s.active[static_cast<int>(c)] > 0, "CpuActivity: unbalanced release");
+        --s.active[static_cast<int>(c)];
+    });
+}
+
+int AddCpuBudgetListener(std::function<void()> fn) {
+    JVE_ASSERT(fn, "AddCpuBudgetListener: fn must be set");
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.listener_mutex);
+    const int id = s.next_listener_id++;
+    s.listeners.emplace(id, std::move(fn));
+    return id;
+}
+
+void RemoveCpuBudgetListener(int id) {
+    // Takes listener_mutex: once this returns, the listener is not running
+    // on any thread, so its owner may be destroyed.
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.listener_mutex);
+    s.listeners.erase(id);
+}
+
+namespace impl {
+
+void cpu_budget_video_decoder_opened() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    ++s.video_decoders;
+}
+
+void cpu_budget_video_decoder_closed() {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    JVE_ASSERT(s.video_decoders > 0, "cpu_budget_video_decoder_closed: no decoder open");
+    --s.video_decoders;
+}
+
+void cpu_budget_decode_workers_started(int count) {
+    JVE_ASSERT(count > 0, "cpu_budget_decode_workers_started: count must be > 0");
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.decode_workers += count;
+}
+
+void cpu_budget_decode_workers_stopped(int count) {
+    auto& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    JVE_ASSERT(count > 0 && s.decode_workers >= count,
+        "cpu_budget_decode_workers_stopped: more workers stopped than started");
+    s.decode_workers -= count;
+}
+
+} // namespace impl
+
+} // namespace emp
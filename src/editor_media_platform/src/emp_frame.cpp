@@ -1,5 +1,6 @@
 #include <editor_media_platform/emp_frame.h>
 #include "impl/frame_impl.h"
+#include "impl/yuv_convert.h"
 #include <cassert>
 #include <cstring>
 #include <algorithm>  // std::max, std::min
@@ -30,6 +31,36 @@ TimeUS Frame::source_pts_us() const { return m_impl->pts_us(); }
 const uint8_t* Frame::data() const { return m_impl->data(); }
 size_t Frame::data_size() const { return m_impl->data_size(); }
 
+void Frame::CopyBGRA(uint8_t* dst, int dst_stride) const {
+    m_impl->copy_bgra(dst, dst_stride);
+}
+
+PixelFormat Frame::pixel_format() const {
+    return m_impl->is_yuv() ? m_impl->yuv().format : PixelFormat::BGRA32;
+}
+
+int Frame::bit_depth() const {
+    return pixel_format() == PixelFormat::YUV422P10 ? 10 : 8;
+}
+
+ColorSpace Frame::colorspace() const {
+    return m_impl->is_yuv() ? m_impl->yuv().colorspace : ColorSpace::Unspecified;
+}
+
+ColorRange Frame::color_range() const {
+    return m_impl->is_yuv() ? m_impl->yuv().range : ColorRange::Full;
+}
+
+const uint8_t* Frame::plane_data(int plane) const {
+    assert(plane >= 0 && plane < 3 && "Frame::plane_data: plane out of range");
+    return m_impl->is_yuv() ? m_impl->yuv().plane[plane] : nullptr;
+}
+
+int Frame::plane_stride(int plane) const {
+    assert(plane >= 0 && plane < 3 && "Frame::plane_stride: plane out of range");
+    return m_impl->is_yuv() ? m_impl->yuv().stride[plane] : 0;
+}
+
 #ifdef EMP_HAS_VIDEOTOOLBOX
 void* Frame::native_buffer() const {
     return m_impl->hw_buffer();
@@ -39,11 +70,57 @@ void* Frame::native_buffer() const {
 // FrameImpl method implementations
 
 const uint8_t* FrameImpl::data() {
+    // A YUV frame has no BGRA pixels to point at, and materializing them
+    // here would grow the frame behind the back of every cache that
+    // charged data_size(). Callers convert into their own buffer.
+    assert(!m_is_yuv && "FrameImpl::data: YUV frame has no BGRA buffer - use copy_bgra");
+    if (m_is_yuv) return nullptr;
     if (m_raw_data) return m_raw_data;
     ensure_cpu_buffer();
     return m_cpu_buffer.data();
 }
 
+void FrameImpl::copy_bgra(uint8_t* dst, int dst_stride) {
+    assert(dst && "FrameImpl::copy_bgra: dst is null");
+    assert(dst_stride >= m_width * 4 && "FrameImpl::copy_bgra: dst_stride < width*4");
+    if (m_is_yuv) {
+        convert_yuv(dst, dst_stride);
+        return;
+    }
+    const uint8_t* src = data();
+    const size_t row_bytes = static_cast<size_t>(m_width) * 4;
+    if (dst_stride == m_stride) {
+        std::memcpy(dst, src, static_cast<size_t>(m_stride) * m_height);
+        return;
+    }
+    for (int y = 0; y < m_height; ++y) {
+        std::memcpy(dst + static_cast<size_t>(y) * dst_stride,
+                    src + static_cast<size_t>(y) * m_stride, row_bytes);
+    }
+}
+
+void FrameImpl::convert_yuv(uint8_t* dst, int dst_stride) const {
+    assert(m_is_yuv && "FrameImpl::convert_yuv: not a YUV frame");
+    impl::YuvLayout layout = impl::YuvLayout::I420;
+    switch (m_yuv.format) {
+        case PixelFormat::YUV420P:   layout = impl::YuvLayout::I420; break;
+        case PixelFormat::NV12:      layout = impl::YuvLayout::NV12; break;
+        case PixelFormat::YUV422P10: layout = impl::YuvLayout::I422P10; break;
+        case PixelFormat::YUV444P:   layout = impl::YuvLayout::I444; break;
+        case PixelFormat::BGRA32:
+            assert(false && "FrameImpl::convert_yuv: BGRA32 is not a YUV layout");
+            return;
+    }
+    const impl::YuvRange range = m_yuv.range == ColorRange::Full
+        ? impl::YuvRange::Full : impl::YuvRange::Limited;
+
+    // 1:1 init only builds the per-row span tables (a few KB); not worth
+    // caching per frame.
+    impl::YuvConverter conv;
+    conv.init(layout, range, m_width, m_height, m_width, m_height);
+    conv.convert(m_yuv.plane, m_yuv.stride, dst, dst_stride);
+}
+
 void FrameImpl::ensure_cpu_buffer() {
     // Fast path: already have CPU data
     if (m_cpu_buffer_valid) {
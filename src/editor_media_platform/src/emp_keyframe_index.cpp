@@ -0,0 +1,354 @@
+#include <editor_media_platform/emp_keyframe_index.h>
+#include <editor_media_platform/emp_peak_file.h>  // ComputeContentHash
+#include "impl/ffmpeg_context.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace emp {
+
+// ============================================================================
+// KeyframeIndex
+// ============================================================================
+
+KeyframeIndex::KeyframeIndex(uint64_t content_hash, int64_t source_size, int stream_index,
+                             int32_t time_base_num, int32_t time_base_den,
+                             int64_t frame_duration, std::vector<Gop> gops)
+    : m_content_hash(content_hash), m_source_size(source_size),
+      m_stream_index(stream_index), m_tb_num(time_base_num), m_tb_den(time_base_den),
+      m_frame_duration(frame_duration), m_gops(std::move(gops)) {
+    assert(!m_gops.empty() && "KeyframeIndex: need at least one GOP");
+    assert(m_tb_num > 0 && m_tb_den > 0 && "KeyframeIndex: invalid time base");
+    assert(m_frame_duration > 0 && "KeyframeIndex: frame_duration must be > 0");
+    assert(std::is_sorted(m_gops.begin(), m_gops.end(),
+               [](const Gop& a, const Gop& b) { return a.keyframe_pts < b.keyframe_pts; }) &&
+           "KeyframeIndex: GOPs must be sorted by keyframe_pts");
+
+    double reach_sum = 0.0;
+    double frame_sum = 0.0;
+    for (const auto& g : m_gops) {
+        const double n = g.frames;
+        reach_sum += n * (n + 1.0) / 2.0;
+        frame_sum += n;
+    }
+    m_mean_reach = frame_sum > 0 ? reach_sum / frame_sum : 1.0;
+}
+
+int KeyframeIndex::GopAt(int64_t pts) const {
+    auto it = std::upper_bound(m_gops.begin(), m_gops.end(), pts,
+        [](int64_t v, const Gop& g) { return v < g.keyframe_pts; });
+    return static_cast<int>(it - m_gops.begin()) - 1;
+}
+
+int64_t KeyframeIndex::FramesToReach(int64_t pts) const {
+    int g = GopAt(pts);
+    if (g < 0) return 1;
+    const Gop& gop = m_gops[static_cast<size_t>(g)];
+    int64_t n = (pts - gop.keyframe_pts) / m_frame_duration + 1;
+    if (gop.frames > 0 && n > static_cast<int64_t>(gop.frames)) n = gop.frames;
+    return n;
+}
+
+// On-disk GOP record: header, then gop_count of these.
+#pragma pack(push, 1)
+struct KeyframeIndexGopRecord {
+    int64_t  keyframe_pts;
+    int64_t  keyframe_pos;
+    uint32_t frames;
+};
+#pragma pack(pop)
+static_assert(sizeof(KeyframeIndexGopRecord) == 20, "KeyframeIndexGopRecord must be 20 bytes");
+
+bool KeyframeIndex::Save(const std::string& path) const {
+    KeyframeIndexHeader hdr{};
+    std::memcpy(hdr.magic, KEYFRAME_INDEX_MAGIC, 4);
+    hdr.version = KEYFRAME_INDEX_VERSION;
+    hdr.source_size = m_source_size;
+    hdr.content_hash = m_content_hash;
+    hdr.stream_index = m_stream_index;
+    hdr.time_base_num = m_tb_num;
+    hdr.time_base_den = m_tb_den;
+    hdr.frame_duration = m_frame_duration;
+    hdr.gop_count = m_gops.size();
+
+    std::vector<KeyframeIndexGopRecord> records(m_gops.size());
+    for (size_t i = 0; i < m_gops.size(); ++i) {
+        records[i].keyframe_pts = m_gops[i].keyframe_pts;
+        records[i].keyframe_pos = m_gops[i].keyframe_pos;
+        records[i].frames = m_gops[i].frames;
+    }
+
+    std::string tmp_path = path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    const size_t data_bytes = records.size() * sizeof(KeyframeIndexGopRecord);
+    bool ok = ::write(fd, &hdr, sizeof(hdr)) == static_cast<ssize_t>(sizeof(hdr)) &&
+              ::write(fd, records.data(), data_bytes) == static_cast<ssize_t>(data_bytes);
+    ::close(fd);
+
+    if (!ok || ::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+std::unique_ptr<KeyframeIndex> KeyframeIndex::Load(const std::string& path,
+                                                   uint64_t expected_hash,
+                                                   int64_t expected_size) {
+    if (expected_hash == 0) return nullptr;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    KeyframeIndexHeader hdr{};
+    std::vector<KeyframeIndexGopRecord> records;
+    bool ok = ::read(fd, &hdr, sizeof(hdr)) == static_cast<ssize_t>(sizeof(hdr)) &&
+              std::memcmp(hdr.magic, KEYFRAME_INDEX_MAGIC, 4) == 0 &&
+              hdr.version == KEYFRAME_INDEX_VERSION &&
+              hdr.content_hash == expected_hash &&
+              hdr.source_size == expected_size &&
+              hdr.gop_count > 0 &&
+              hdr.time_base_num > 0 && hdr.time_base_den > 0 &&
+              hdr.frame_duration > 0;
+    if (ok) {
+        // Bound the allocation by the file's real size before trusting gop_count.
+        struct stat st;
+        const uint64_t data_bytes = hdr.gop_count * sizeof(KeyframeIndexGopRecord);
+        ok = ::fstat(fd, &st) == 0 &&
+             static_cast<uint64_t>(st.st_size) == sizeof(hdr) + data_bytes;
+        if (ok) {
+            records.resize(static_cast<size_t>(hdr.gop_count));
+            ok = ::read(fd, records.data(), static_cast<size_t>(data_bytes)) ==
+                 static_cast<ssize_t>(data_bytes);
+        }
+    }
+    ::close(fd);
+    if (!ok) return nullptr;
+
+    std::vector<Gop> gops(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        gops[i].keyframe_pts = records[i].keyframe_pts;
+        gops[i].keyframe_pos = records[i].keyframe_pos;
+        gops[i].frames = records[i].frames;
+        if (i > 0 && gops[i].keyframe_pts <= gops[i - 1].keyframe_pts) return nullptr;
+    }
+    return std::unique_ptr<KeyframeIndex>(new KeyframeIndex(
+        hdr.content_hash, hdr.source_size, hdr.stream_index,
+        hdr.time_base_num, hdr.time_base_den, hdr.frame_duration, std::move(gops)));
+}
+
+// ============================================================================
+// Registry + on-disk cache
+// ============================================================================
+//
+// Keyed by content hash, not path: two MediaFiles over the same bytes
+// (the same file on two tracks, a relinked copy) share one index. Entries
+// are never evicted — an index is ~20 bytes per GOP, so even thousands
+// of long camera originals stay in the low megabytes.
+
+namespace {
+std::mutex g_kf_mutex;
+std::string g_kf_dir;
+std::unordered_map<uint64_t, std::shared_ptr<const KeyframeIndex>> g_kf_registry;
+}  // namespace
+
+void SetKeyframeIndexDir(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(g_kf_mutex);
+    g_kf_dir = dir;
+}
+
+std::string GetKeyframeIndexDir() {
+    std::lock_guard<std::mutex> lock(g_kf_mutex);
+    return g_kf_dir;
+}
+
+std::string KeyframeIndexPath(uint64_t content_hash) {
+    std::string dir = GetKeyframeIndexDir();
+    if (dir.empty()) return std::string();
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016llx.kfidx",
+                  static_cast<unsigned long long>(content_hash));
+    return dir + name;
+}
+
+std::shared_ptr<const KeyframeIndex> FindKeyframeIndex(uint64_t content_hash,
+                                                       int64_t source_size,
+                                                       bool check_disk) {
+    if (content_hash == 0) return nullptr;
+    {
+        std::lock_guard<std::mutex> lock(g_kf_mutex);
+        auto it = g_kf_registry.find(content_hash);
+        if (it != g_kf_registry.end()) {
+            return it->second->source_size() == source_size ? it->second : nullptr;
+        }
+    }
+
+    if (!check_disk) return nullptr;
+
+    // Disk read outside the lock — concurrent opens of different files
+    // must not serialize on one another's I/O.
+    std::string path = KeyframeIndexPath(content_hash);
+    if (path.empty()) return nullptr;
+    std::shared_ptr<const KeyframeIndex> loaded =
+        KeyframeIndex::Load(path, content_hash, source_size);
+    if (!loaded) return nullptr;
+
+    std::lock_guard<std::mutex> lock(g_kf_mutex);
+    auto inserted = g_kf_registry.emplace(content_hash, std::move(loaded));
+    return inserted.first->second;
+}
+
+std::shared_ptr<const KeyframeIndex> PublishKeyframeIndex(
+        std::shared_ptr<const KeyframeIndex> index) {
+    assert(index && "PublishKeyframeIndex: null index");
+    assert(index->content_hash() != 0 && "PublishKeyframeIndex: index has no content hash");
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(g_kf_mutex);
+        auto inserted = g_kf_registry.emplace(index->content_hash(), index);
+        if (!inserted.second) return inserted.first->second;
+        dir = g_kf_dir;
+    }
+    if (!dir.empty()) {
+        // Best effort: a failed write only costs a rebuild next session.
+        index->Save(KeyframeIndexPath(index->content_hash()));
+    }
+    return index;
+}
+
+void ClearKeyframeIndexRegistry() {
+    std::lock_guard<std::mutex> lock(g_kf_mutex);
+    g_kf_registry.clear();
+}
+
+// ============================================================================
+// Builders
+// ============================================================================
+
+namespace impl {
+
+// Stream ticks per frame from the nominal rate; 0 when the stream has none.
+static int64_t stream_frame_duration(AVStream* stream) {
+    AVRational rate = stream->avg_frame_rate;
+    if (rate.num <= 0 || rate.den <= 0) rate = stream->r_frame_rate;
+    if (rate.num <= 0 || rate.den <= 0) return 0;
+    int64_t d = av_rescale_q(1, av_inv_q(rate), stream->time_base);
+    return d > 0 ? d : 0;
+}
+
+// Turn a decode-order (ts, pos, is_key) sequence into GOPs. Packets before
+// the first keyframe are undecodable after a seek and are dropped; GOPs
+// whose keyframe doesn't advance the timestamp are merged into the
+// previous one.
+struct ScannedPacket { int64_t ts; int64_t pos; bool key; };
+
+static std::vector<KeyframeIndex::Gop> gops_from_packets(const std::vector<ScannedPacket>& pkts) {
+    std::vector<KeyframeIndex::Gop> gops;
+    for (const auto& p : pkts) {
+        if (p.key && (gops.empty() || p.ts > gops.back().keyframe_pts)) {
+            KeyframeIndex::Gop g;
+            g.keyframe_pts = p.ts;
+            g.keyframe_pos = p.pos;
+            g.frames = 1;
+            gops.push_back(g);
+        } else if (!gops.empty()) {
+            ++gops.back().frames;
+        }
+    }
+    return gops;
+}
+
+// Derive an index from the demuxer's own sample table, when it indexes
+// every packet (MOV/MP4 stsz/stss). Free at open time — no I/O beyond
+// what avformat_find_stream_info already did. Returns nullptr when the
+// table is partial (MKV cues list keyframes only) or when the codec
+// reorders frames: index timestamps are DTS, and with B-frames a
+// keyframe's DTS precedes its PTS, so only a packet scan gives PTS.
+std::shared_ptr<const KeyframeIndex> keyframe_index_from_container(
+        AVStream* stream, uint64_t content_hash, int64_t source_size) {
+    assert(stream && "keyframe_index_from_container: null stream");
+    if (content_hash == 0) return nullptr;
+    if (stream->codecpar->video_delay > 0) return nullptr;
+    const int count = avformat_index_get_entries_count(stream);
+    if (count <= 0 || stream->nb_frames <= 0 || count < stream->nb_frames) return nullptr;
+    const int64_t frame_duration = stream_frame_duration(stream);
+    if (frame_duration <= 0) return nullptr;
+
+    std::vector<ScannedPacket> pkts;
+    pkts.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        const AVIndexEntry* e = avformat_index_get_entry(stream, i);
+        if (!e) return nullptr;
+        pkts.push_back({e->timestamp, e->pos, (e->flags & AVINDEX_KEYFRAME) != 0});
+    }
+    auto gops = gops_from_packets(pkts);
+    if (gops.empty()) return nullptr;
+    return std::make_shared<KeyframeIndex>(content_hash, source_size, stream->index,
+        stream->time_base.num, stream->time_base.den, frame_duration, std::move(gops));
+}
+
+} // namespace impl
+
+Result<std::shared_ptr<const KeyframeIndex>> BuildKeyframeIndex(
+        const std::string& path, const std::atomic<bool>* cancel) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) return Error::file_not_found(path);
+    const int64_t source_size = static_cast<int64_t>(st.st_size);
+    const uint64_t content_hash = ComputeContentHash(path, source_size);
+    if (content_hash == 0) return Error::internal("BuildKeyframeIndex: no content hash for " + path);
+
+    impl::FFmpegFormatContext fmt_ctx;
+    auto open_result = fmt_ctx.open(path);
+    if (open_result.is_error()) return open_result.error();
+    auto stream_result = fmt_ctx.find_video_stream();
+    if (stream_result.is_error()) return stream_result.error();
+
+    AVFormatContext* fmt = fmt_ctx.get();
+    AVStream* stream = fmt_ctx.video_stream();
+    const int64_t frame_duration = impl::stream_frame_duration(stream);
+    if (frame_duration <= 0) {
+        return Error::unsupported("BuildKeyframeIndex: video stream has no frame rate");
+    }
+
+    // Only the video stream's packets are wanted; discarding the rest lets
+    // the demuxer skip their payloads where the container allows it.
+    for (unsigned i = 0; i < fmt->nb_streams; ++i) {
+        if (static_cast<int>(i) != stream->index) fmt->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    AVPacket* pkt = av_packet_alloc();
+    assert(pkt && "BuildKeyframeIndex: av_packet_alloc failed");
+    std::vector<impl::ScannedPacket> pkts;
+    int ret;
+    while ((ret = av_read_frame(fmt, pkt)) >= 0) {
+        if (pkt->stream_index == stream->index) {
+            int64_t ts = pkt->pts != AV_NOPTS_VALUE ? pkt->pts : pkt->dts;
+            if (ts != AV_NOPTS_VALUE) {
+                pkts.push_back({ts, pkt->pos, (pkt->flags & AV_PKT_FLAG_KEY) != 0});
+            }
+        }
+        av_packet_unref(pkt);
+        if (cancel && cancel->load(std::memory_order_relaxed)) {
+            av_packet_free(&pkt);
+            return Error::internal("BuildKeyframeIndex: cancelled");
+        }
+    }
+    av_packet_free(&pkt);
+    if (ret != AVERROR_EOF) return impl::ffmpeg_error(ret, "BuildKeyframeIndex: av_read_frame");
+
+    auto gops = impl::gops_from_packets(pkts);
+    if (gops.empty()) return Error::unsupported("BuildKeyframeIndex: no keyframes in " + path);
+    return std::shared_ptr<const KeyframeIndex>(std::make_shared<KeyframeIndex>(
+        content_hash, source_size, stream->index,
+        stream->time_base.num, stream->time_base.den, frame_duration, std::move(gops)));
+}
+
+} // namespace emp
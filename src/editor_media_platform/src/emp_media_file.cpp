@@ -1,5 +1,8 @@
 #include <editor_media_platform/emp_media_file.h>
 #include <editor_media_platform/emp_rate.h>
+#include <editor_media_platform/emp_keyframe_index.h>
+#include <editor_media_platform/emp_peak_file.h>  // ComputeContentHash
+#include <editor_media_platform/emp_cpu_budget.h>
 #include "impl/media_file_impl.h"
 #include "impl/ffmpeg_context.h"  // av_log_set_level
 #include "impl/braw_decode.h"
@@ -9,6 +12,7 @@
 #include <climits>  // INT_MAX for av_reduce
 #include <mutex>
 #include <thread>
+#include <sys/stat.h>
 
 namespace emp {
 
@@ -23,6 +27,40 @@ const MediaFileInfo& MediaFile::info() const {
     return m_info;
 }
 
+std::shared_ptr<const KeyframeIndex> MediaFile::keyframe_index() const {
+    if (m_impl->keyframe_index) return m_impl->keyframe_index;
+    return FindKeyframeIndex(m_impl->content_hash, m_impl->source_size, /*check_disk=*/false);
+}
+
+uint64_t MediaFile::content_hash() const {
+    return m_impl->content_hash;
+}
+
+namespace impl {
+std::shared_ptr<const KeyframeIndex> keyframe_index_from_container(
+    AVStream* stream, uint64_t content_hash, int64_t source_size);
+}
+
+// Resolve the video stream's keyframe index at open: registry, then the
+// on-disk cache, then the container's sample table (published so the
+// next open — and the next session — skips straight to the first two).
+// Costs two 64KB preads for the content hash; a miss on every source
+// leaves the index to TMB's background scan.
+static void attach_keyframe_index(MediaFileImpl& impl, const MediaFileInfo& info) {
+    if (!info.has_video) return;
+    struct stat st;
+    if (::stat(info.path.c_str(), &st) != 0) return;
+    impl.source_size = static_cast<int64_t>(st.st_size);
+    impl.content_hash = ComputeContentHash(info.path, impl.source_size);
+    if (impl.content_hash == 0) return;
+
+    impl.keyframe_index = FindKeyframeIndex(impl.content_hash, impl.source_size);
+    if (impl.keyframe_index) return;
+    auto derived = impl::keyframe_index_from_container(
+        impl.fmt_ctx.video_stream(), impl.content_hash, impl.source_size);
+    if (derived) impl.keyframe_index = PublishKeyframeIndex(std::move(derived));
+}
+
 Result<void> MediaFile::ProbeCodec() const {
     // BRAW: SDK IS the decoder — if we got metadata, we can decode.
     if (m_impl->backend == MediaFileBackend::Braw) {
@@ -32,7 +70,11 @@ Result<void> MediaFile::ProbeCodec() const {
     if (!m_info.has_video) {
         return {};  // audio-only — no video codec to check
     }
-    auto* params = m_impl->fmt_ctx.video_codec_params();
+    // From the Open snapshot: fmt_ctx may be leased to a demuxing Reader.
+    const auto& streams = m_impl->stream_params->streams;
+    const int vidx = m_impl->stream_params->video_stream_idx;
+    const AVCodecParameters* params =
+        vidx >= 0 ? streams[static_cast<size_t>(vidx)].codecpar.get() : nullptr;
     if (!params) {
         return Error::unsupported("No video codec parameters");
     }
@@ -660,6 +702,13 @@ Result<std::shared_ptr<MediaFile>> MediaFile::Open(const std::string& path) {
     auto info_result = build_ffmpeg_info(impl->fmt_ctx, path);
     if (info_result.is_error()) return info_result.error();
 
+    // Before any Reader leases fmt_ctx and starts demuxing on it.
+    auto snapshot = impl->fmt_ctx.snapshot_stream_params();
+    if (snapshot.is_error()) return snapshot.error();
+    impl->stream_params = std::move(snapshot.value());
+
+    attach_keyframe_index(*impl, info_result.value());
+
     return std::make_shared<MediaFile>(std::move(impl), std::move(info_result.value()));
 }
 
@@ -688,9 +737,12 @@ static void parallel_probe_dispatch(
         std::vector<Result<MediaFileInfo>>& results,
         size_t parallelism) {
     if (paths.empty()) return;
+    // Probe is the lowest CPU budget class: while playing it gets what
+    // Playback, Scrub and Peaks leave (at least one thread). Read once per
+    // batch — probes are short, the batch doesn't resize.
+    CpuActivity busy(CpuClass::Probe);
     if (parallelism == 0) {
-        parallelism = std::thread::hardware_concurrency();
-        if (parallelism == 0) parallelism = 4;
+        parallelism = static_cast<size_t>(CpuBudgetSlots(CpuClass::Probe));
     }
     if (parallelism > paths.size()) parallelism = paths.size();
 
@@ -3,6 +3,7 @@
 #include <cstring>
 #include <algorithm>
 #include <limits>
+#include <optional>
 #include <vector>
 #include <sys/stat.h>
 #include "../../jve_log.h"
@@ -10,34 +11,37 @@
 
 namespace emp {
 
-// ============================================================================
-// Thread count policy
-// ============================================================================
-
-static int ComputeWorkerCount()
-{
-    int hw = static_cast<int>(std::thread::hardware_concurrency());
-    if (hw <= 0) hw = 2;  // fallback for platforms that return 0
-    int count = std::max(1, hw / 2);
-    return std::min(count, 4);
-}
-
 // ============================================================================
 // Constructor / Destructor
 // ============================================================================
+//
+// Worker count follows the CPU budget (emp_cpu_budget.h): spawn the Peaks
+// cap, run only as many as CpuBudgetSlots(Peaks) allows. Workers indexed at
+// or above the slot count park in WorkerLoop; the budget listener wakes
+// them when playback stops and slots come back.
 
 PeakGenerator::PeakGenerator()
 {
-    int count = ComputeWorkerCount();
-    JVE_LOG_EVENT(Media, "PeakGenerator: starting %d worker threads (hw=%d)",
-        count, static_cast<int>(std::thread::hardware_concurrency()));
+    int count = CpuBudgetCap(CpuClass::Peaks);
+    m_budget_slots = CpuBudgetSlots(CpuClass::Peaks);
+    JVE_LOG_EVENT(Media, "PeakGenerator: starting %d worker threads (%d active, hw=%d)",
+        count, m_budget_slots, static_cast<int>(std::thread::hardware_concurrency()));
+    m_budget_listener = AddCpuBudgetListener([this]() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_budget_slots = CpuBudgetSlots(CpuClass::Peaks);
+        }
+        m_cv.notify_all();
+    });
     for (int i = 0; i < count; ++i) {
-        m_workers.emplace_back(&PeakGenerator::WorkerLoop, this);
+        m_workers.emplace_back(&PeakGenerator::WorkerLoop, this, i);
     }
 }
 
 PeakGenerator::~PeakGenerator()
 {
+    // Before m_mutex/m_cv go away: once removed, the listener can't run.
+    RemoveCpuBudgetListener(m_budget_listener);
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         m_shutdown = true;
@@ -149,12 +153,23 @@ int PeakGenerator::GetRunningCount() const
     return m_running_count;
 }
 
+int PeakGenerator::GetActiveWorkerCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return std::min(m_budget_slots, static_cast<int>(m_workers.size()));
+}
+
 // ============================================================================
 // WorkerLoop — round-robin chunk scheduler (rule 2.5)
 // ============================================================================
 
-void PeakGenerator::WorkerLoop()
+void PeakGenerator::WorkerLoop(int index)
 {
+    // Peaks count as active while this worker has chunks to run, so Probe
+    // gets the machine back between bursts. Held across chunks — marking
+    // each chunk rebalanced the budget and woke its listeners per chunk.
+    std::optional<CpuActivity> busy;
+
     while (true) {
         std::shared_ptr<ChunkedJob> job;
         bool just_admitted = false;
@@ -163,12 +178,22 @@ void PeakGenerator::WorkerLoop()
 
             // Wake when something is runnable: shutdown, an already-
             // admitted job, or a pool job plus admission capacity.
-            m_cv.wait(lock, [this]() {
+            // Workers beyond the budget's Peaks slots stay parked.
+            auto runnable = [this, index]() {
                 if (m_shutdown.load()) return true;
+                if (index >= m_budget_slots) return false;
                 if (!m_running_queue.empty()) return true;
                 return !m_queued_pool.empty()
                     && m_running_count < MAX_RUNNING_JOBS;
-            });
+            };
+            if (busy && !runnable()) {
+                // Going idle. Release outside m_mutex: the rebalance runs
+                // the budget listener, which takes it.
+                lock.unlock();
+                busy.reset();
+                continue;
+            }
+            m_cv.wait(lock, runnable);
             if (m_shutdown.load()) return;
 
             // Prefer Running jobs — they hold media resources and their
@@ -215,6 +240,7 @@ void PeakGenerator::WorkerLoop()
             }
         }
 
+        if (!busy) busy.emplace(CpuClass::Peaks);
         bool more = ProcessOneChunk(*job);
 
         if (job->cancel_flag.load()) {
@@ -1,4 +1,6 @@
 #include <editor_media_platform/emp_reader.h>
+#include <editor_media_platform/emp_keyframe_index.h>
+#include <editor_media_platform/emp_cpu_budget.h>
 #include "impl/ffmpeg_context.h"
 #include "impl/ffmpeg_hwaccel.h"
 #include "impl/ffmpeg_resample.h"
@@ -7,9 +9,11 @@
 #include "impl/media_file_impl.h"
 #include "impl/frame_impl.h"
 #include "impl/pcm_chunk_impl.h"
+#include "impl/slice_pool.h"
 #include <atomic>
 #include <cassert>
 #include "../../assert_handler.h"  // JVE_ASSERT (fires in Release; plain assert is stripped by -DNDEBUG)
+#include <algorithm>
 #include <vector>
 #include <memory>
 #include <chrono>
@@ -36,7 +40,7 @@ inline int emp_log_level() {
 #endif
 
 #include <cstdlib>  // malloc, free
-#include "impl/frame_buffer_pool.h"
+#include "impl/frame_arena.h"
 
 namespace emp {
 
@@ -48,6 +52,11 @@ void SetDecodeMode(DecodeMode mode) {
     EMP_LOG_DEBUG("DecodeMode set to %s",
         mode == DecodeMode::Play ? "Play" :
         mode == DecodeMode::Scrub ? "Scrub" : "Park");
+    // Foreground class for the CPU budget. The default mode is Play but the
+    // budget starts Idle — nothing is decoding until the first transport call.
+    SetCpuForeground(mode == DecodeMode::Play ? CpuForeground::Playback :
+                     mode == DecodeMode::Scrub ? CpuForeground::Scrub :
+                     CpuForeground::Idle);
 }
 
 DecodeMode GetDecodeMode() {
@@ -56,16 +65,20 @@ DecodeMode GetDecodeMode() {
 
 // Forward declarations from impl files
 namespace impl {
+Result<AVFrame*> decode_next_keyframe(AVCodecContext* codec_ctx, AVFormatContext* fmt_ctx,
+                                      int stream_idx, AVPacket* pkt, AVFrame* frame);
 Result<AVFrame*> decode_until_target(AVCodecContext* codec_ctx, AVFormatContext* fmt_ctx,
                                       AVStream* stream, int stream_idx,
                                       TimeUS target_us,
                                       AVPacket* pkt, AVFrame* frame, AVFrame* best_frame);
 // backoff_us: how far before target to seek. Always pass 0 — AVSEEK_FLAG_BACKWARD
 // already lands on the keyframe at or before the target.
+// kf_index (may be null): snap the seek to the target's keyframe.
 Result<void> seek_with_backoff(AVFormatContext* fmt_ctx, AVStream* stream,
                                 AVCodecContext* codec_ctx, TimeUS target_us,
-                                TimeUS backoff_us);
-bool need_seek(TimeUS current_pts_us, TimeUS target_us, bool have_current);
+                                TimeUS backoff_us, const KeyframeIndex* kf_index);
+bool need_seek(TimeUS current_pts_us, TimeUS target_us, bool have_current,
+               const KeyframeIndex* kf_index, AVStream* stream);
 std::vector<uint8_t> allocate_bgra_buffer(int width, int height, int* out_stride);
 void convert_frame_to_bgra(FFmpegScaleContext& scale_ctx, AVFrame* frame,
                             uint8_t* dst_data, int dst_stride);
@@ -94,12 +107,24 @@ public:
     }
 
     ~ReaderImpl() {
+        if (lessor && fmt == &lessor->impl_ptr()->fmt_ctx) {
+            lessor->impl_ptr()->primary_leased.store(false, std::memory_order_release);
+        }
         av_packet_free(&m_pkt);
         av_frame_free(&m_frame);
         av_packet_free(&m_audio_pkt);
         av_frame_free(&m_audio_frame);
     }
 
+    // Demuxer this Reader reads from: the MediaFile's primary context if
+    // its lease was free at Create, else `session` (own position, shared
+    // bytes). `lessor` keeps the MediaFile alive until the lease is handed
+    // back here — Reader::m_media_file is destroyed before m_impl.
+    std::shared_ptr<MediaFile> lessor;
+    impl::FFmpegFormatContext session;
+    impl::FFmpegFormatContext* fmt = nullptr;
+    impl::FFmpegFormatContext& demux() { return *fmt; }
+
     // Video decode state
     impl::FFmpegCodecContext codec_ctx;
     impl::FFmpegScaleContext scale_ctx;
@@ -112,9 +137,20 @@ public:
     // BRAW decoder (replaces FFmpeg for .braw files)
     std::unique_ptr<impl::BrawReaderContext> braw;
 
-    // Frame buffer pool — shared_ptr so cached frames can return buffers
-    // after the Reader is destroyed.
-    std::shared_ptr<FrameBufferPool> frame_pool = std::make_shared<FrameBufferPool>();
+    // Keyframe index of the video stream (emp_keyframe_index.h). Null until
+    // one is known — re-polled from the MediaFile (registry only, no I/O)
+    // at each seek decision, so a background-built index is picked up by
+    // Readers that already exist.
+    std::shared_ptr<const KeyframeIndex> keyframe_index;
+
+    // Shuttle decode (Reader::SetShuttleDecode). shuttle_scale_ctx converts
+    // at half of scale_ctx's output size; (re)built lazily when that size
+    // changes (SetMaxOutputResolution).
+    std::atomic<bool> shuttle_decode{false};
+    impl::FFmpegScaleContext shuttle_scale_ctx;
+
+    // Planar YUV output (Reader::SetYuvOutput).
+    std::atomic<bool> yuv_output{false};
 
     // Tracks where the decoder was last positioned (PTS of last decoded frame).
     // Used by Play path to avoid unnecessary seeks during sequential decode.
@@ -286,6 +322,22 @@ float Reader::LastBatchMsPerFrame() const {
     return m_impl->last_batch_ms_per_frame;
 }
 
+void Reader::SetShuttleDecode(bool on) {
+    m_impl->shuttle_decode.store(on, std::memory_order_relaxed);
+}
+
+bool Reader::ShuttleDecode() const {
+    return m_impl->shuttle_decode.load(std::memory_order_relaxed);
+}
+
+void Reader::SetYuvOutput(bool on) {
+    m_impl->yuv_output.store(on, std::memory_order_relaxed);
+}
+
+bool Reader::YuvOutput() const {
+    return m_impl->yuv_output.load(std::memory_order_relaxed);
+}
+
 void Reader::SetMaxOutputResolution(int w, int h) {
     assert((w == 0) == (h == 0) &&
         "SetMaxOutputResolution: both w,h must be 0 (no limit) or both > 0");
@@ -301,26 +353,17 @@ void Reader::SetMaxOutputResolution(int w, int h) {
         return true;
     };
 
+    // No buffer warm-up: output buffers come from the process-wide
+    // FrameArena (emp_frame_arena.h), which recycles across Readers.
     if (m_impl->braw && w > 0 && h > 0) {
         // BRAW: use SDK's native resolution scaling
         m_impl->braw->set_resolution_scale(w, h);
-        int out_w = m_impl->braw->output_width();
-        int out_h = m_impl->braw->output_height();
-        int frame_stride = ((out_w * 4) + 31) & ~31;
-        size_t buf_size = static_cast<size_t>(frame_stride) * out_h;
-        m_impl->frame_pool->warm(buf_size, FrameBufferPool::MAX_POOLED);
     } else if (m_impl->qtrle && w > 0 && h > 0) {
         // qtrle: configure decoder's scaled output dimensions
         int out_w, out_h;
         if (compute_output(m_impl->qtrle->width(), m_impl->qtrle->height(),
                            w, h, out_w, out_h)) {
             m_impl->qtrle->set_scaled_output(out_w, out_h);
-
-            // Pre-allocate frame buffers with malloc (no zero-init).
-            // Page faults happen on first use inside decoder's dispatch_apply.
-            int frame_stride = ((out_w * 4) + 31) & ~31;
-            size_t buf_size = static_cast<size_t>(frame_stride) * out_h;
-            m_impl->frame_pool->warm(buf_size, FrameBufferPool::MAX_POOLED);
         }
     } else if (m_impl->scale_ctx.get() && w > 0 && h > 0) {
         // FFmpeg SW path: re-init swscale to convert+scale in one pass.
@@ -334,10 +377,6 @@ void Reader::SetMaxOutputResolution(int w, int h) {
             if (result.is_error()) {
                 EMP_LOG_WARN("SetMaxOutputResolution: reinit_output failed: %s",
                              result.error().message.c_str());
-            } else {
-                int frame_stride = ((out_w * 4) + 31) & ~31;
-                size_t buf_size = static_cast<size_t>(frame_stride) * out_h;
-                m_impl->frame_pool->warm(buf_size, FrameBufferPool::MAX_POOLED);
             }
         }
     }
@@ -389,15 +428,27 @@ static Result<std::shared_ptr<Reader>> CreateImpl(std::shared_ptr<MediaFile> ass
         return std::make_shared<Reader>(std::move(impl), std::move(asset));
     }
 
+    // Demux lease — see MediaFileImpl::primary_leased.
+    impl->lessor = asset;
+    bool leased = false;
+    if (asset_impl->primary_leased.compare_exchange_strong(leased, true)) {
+        impl->fmt = &asset_impl->fmt_ctx;
+    } else {
+        auto session_result = impl->session.open_session(*asset_impl->stream_params);
+        if (session_result.is_error()) return session_result.error();
+        impl->fmt = &impl->session;
+    }
+
     // Initialize video codec if asset has video AND we weren't told to
     // skip it. Skipping for audio_only avoids the VideoToolbox init
     // mutex (g_vt_init_mutex) entirely.
     if (asset->info().has_video && !audio_only) {
-        AVCodecParameters* params = asset_impl->fmt_ctx.video_codec_params();
+        // Our own demuxer's params — the primary may be leased elsewhere.
+        AVCodecParameters* params = impl->fmt->video_codec_params();
 
         if (params->codec_id == AV_CODEC_ID_QTRLE) {
             // Custom parallel qtrle decoder — bypasses FFmpeg's single-threaded
-            // implementation for 10x+ speedup at 4K via GCD dispatch_apply.
+            // implementation for 10x+ speedup at 4K (rows sliced on SlicePool).
             impl->qtrle = std::make_unique<impl::QtrleDecoder>();
             auto qtrle_result = impl->qtrle->init(params->width, params->height);
             if (qtrle_result.is_error()) {
@@ -472,6 +523,11 @@ bool Reader::HasVideoCodec() const {
     return m_impl->codec_ctx.get() != nullptr;
 }
 
+static const KeyframeIndex* keyframe_index_for_seek(ReaderImpl& impl, const MediaFile& mf) {
+    if (!impl.keyframe_index) impl.keyframe_index = mf.keyframe_index();
+    return impl.keyframe_index.get();
+}
+
 Result<void> Reader::Seek(FrameTime t) {
     return SeekUS(t.to_us());
 }
@@ -481,14 +537,14 @@ Result<void> Reader::SeekUS(TimeUS t_us) {
         return Error::unsupported("Seek requires video stream");
     }
 
-    MediaFileImpl* asset_impl = m_media_file->impl_ptr();
-    AVStream* stream = asset_impl->fmt_ctx.video_stream();
+    AVStream* stream = m_impl->demux().video_stream();
 
     auto result = impl::seek_with_backoff(
-        asset_impl->fmt_ctx.get(),
+        m_impl->demux().get(),
         stream,
         m_impl->codec_ctx.get(),
-        t_us, 0
+        t_us, 0,
+        keyframe_index_for_seek(*m_impl, *m_media_file)
     );
 
     return result;
@@ -499,17 +555,119 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAt(FrameTime t) {
 }
 
 // Helper: Convert AVFrame to emp::Frame (handles both hw and sw paths).
-// SW path converts directly into a pool-acquired buffer — no zero-init overhead.
+// SW path converts directly into an arena buffer — no zero-init overhead —
+// unless the decoder's own buffer already is the output (BGRA, or YUV
+// frames kept planar at source size), which the Frame references instead.
+// Fails only when the FrameArena is at its cap.
 // If scale_ctx was re-initialized with output dims, sws_scale converts+scales
 // in one pass (no intermediate full-resolution buffer).
-static std::shared_ptr<Frame> avframe_to_emp_frame(
+static ColorSpace av_colorspace_to_emp(int spc) {
+    switch (spc) {
+        case AVCOL_SPC_BT709:      return ColorSpace::BT709;
+        case AVCOL_SPC_BT470BG:
+        case AVCOL_SPC_SMPTE170M:  return ColorSpace::BT601;
+        case AVCOL_SPC_BT2020_NCL:
+        case AVCOL_SPC_BT2020_CL:  return ColorSpace::BT2020;
+        default:                   return ColorSpace::Unspecified;
+    }
+}
+
+static PixelFormat yuv_layout_to_pixel_format(impl::YuvLayout layout) {
+    switch (layout) {
+        case impl::YuvLayout::I420:    return PixelFormat::YUV420P;
+        case impl::YuvLayout::NV12:    return PixelFormat::NV12;
+        case impl::YuvLayout::I422P10: return PixelFormat::YUV422P10;
+        case impl::YuvLayout::I444:    return PixelFormat::YUV444P;
+    }
+    assert(false && "yuv_layout_to_pixel_format: unknown layout");
+    return PixelFormat::YUV420P;
+}
+
+// Zero-copy backing: a Frame over the decoder's own refcounted buffers.
+// The clone holds one reference per plane buffer (av_frame_ref); the
+// FrameImpl's raw release callback drops it. Returns nullptr when the
+// frame can't be referenced as-is — not refcounted (a decoder handing out
+// its internal buffer) or bottom-up (negative linesize).
+static bool can_ref_decoded_frame(const AVFrame* av_frame, int planes) {
+    if (!av_frame->buf[0]) return false;
+    for (int p = 0; p < planes; ++p) {
+        if (av_frame->linesize[p] <= 0) return false;
+    }
+    return true;
+}
+
+static AVFrame* ref_decoded_frame(AVFrame* av_frame, int planes) {
+    return can_ref_decoded_frame(av_frame, planes) ? av_frame_clone(av_frame) : nullptr;
+}
+
+static FrameImpl::RawReleaseCallback avframe_release_cb(AVFrame* ref) {
+    return [ref](uint8_t*, size_t) mutable { av_frame_free(&ref); };
+}
+
+// SW frames in a layout YuvConverter covers, kept planar (Reader::SetYuvOutput)
+// and converted to BGRA only when displayed. At source size the Frame
+// references the decoder's planes directly; a downscale copies them (box-
+// filtered to the output dims) into one arena buffer. Returns nullptr when
+// the frame doesn't qualify — caller converts to BGRA as usual.
+static Result<std::shared_ptr<Frame>> avframe_to_yuv_frame(
+    AVFrame* av_frame, TimeUS pts_us, int out_w, int out_h)
+{
+    impl::YuvLayout layout;
+    impl::YuvRange range;
+    if (!impl::native_yuv_layout(static_cast<AVPixelFormat>(av_frame->format), &layout, &range)) {
+        return std::shared_ptr<Frame>();
+    }
+    if (out_w > av_frame->width || out_h > av_frame->height) {
+        return std::shared_ptr<Frame>();
+    }
+
+    const impl::YuvPlaneGeometry g = impl::yuv_plane_geometry(layout, out_w, out_h);
+    FrameImpl::YuvPlanes yuv;
+    yuv.format = yuv_layout_to_pixel_format(layout);
+    yuv.colorspace = av_colorspace_to_emp(av_frame->colorspace);
+    yuv.range = range == impl::YuvRange::Full ? ColorRange::Full : ColorRange::Limited;
+
+    if (out_w == av_frame->width && out_h == av_frame->height) {
+        if (AVFrame* ref = ref_decoded_frame(av_frame, g.planes)) {
+            size_t bytes = 0;
+            for (int p = 0; p < g.planes; ++p) {
+                yuv.plane[p] = ref->data[p];
+                yuv.stride[p] = ref->linesize[p];
+                bytes += static_cast<size_t>(ref->linesize[p]) * g.height[p];
+            }
+            return std::make_shared<Frame>(std::make_unique<FrameImpl>(
+                out_w, out_h, pts_us, yuv,
+                ref->data[0], bytes, avframe_release_cb(ref)
+            ));
+        }
+    }
+
+    auto entry = FrameArena::instance().acquire(g.total);
+    if (!entry.data) return Error::internal("frame arena cap reached");
+
+    const uint8_t* src[3] = {av_frame->data[0], av_frame->data[1], av_frame->data[2]};
+    const int src_stride[3] = {av_frame->linesize[0], av_frame->linesize[1], av_frame->linesize[2]};
+    impl::yuv_resample_planes(layout, src, src_stride, av_frame->width, av_frame->height,
+                              entry.data, g);
+
+    for (int p = 0; p < g.planes; ++p) {
+        yuv.plane[p] = entry.data + g.offset[p];
+        yuv.stride[p] = g.stride[p];
+    }
+
+    return std::make_shared<Frame>(std::make_unique<FrameImpl>(
+        out_w, out_h, pts_us, yuv,
+        entry.data, entry.size, FrameArena::release_cb()
+    ));
+}
+
+static Result<std::shared_ptr<Frame>> avframe_to_emp_frame(
     AVFrame* av_frame, TimeUS pts_us,
     impl::FFmpegScaleContext& scale_ctx,
     [[maybe_unused]] impl::FFmpegCodecContext& codec_ctx,
-    std::shared_ptr<FrameBufferPool> frame_pool)
+    bool yuv_output)
 {
     assert(av_frame && "avframe_to_emp_frame: av_frame is null");
-    assert(frame_pool && "avframe_to_emp_frame: frame_pool is null");
 
 #ifdef EMP_HAS_VIDEOTOOLBOX
     if (av_frame->format == AV_PIX_FMT_VIDEOTOOLBOX) {
@@ -525,21 +683,40 @@ static std::shared_ptr<Frame> avframe_to_emp_frame(
     }
 #endif
 
-    // SW decode: sws_scale converts (and downscales if scale_ctx was re-initialized
-    // with output dims via SetMaxOutputResolution) directly into a pool buffer.
+    // SW decode: convert (and downscale if scale_ctx was re-initialized with
+    // output dims via SetMaxOutputResolution) directly into an arena buffer —
+    // the native YUV converter for the common layouts, swscale otherwise.
     int out_w = scale_ctx.dst_width();
     int out_h = scale_ctx.dst_height();
     assert(out_w > 0 && out_h > 0 &&
         "avframe_to_emp_frame: scale_ctx has zero output dims (init not called?)");
+    if (yuv_output) {
+        auto yuv = avframe_to_yuv_frame(av_frame, pts_us, out_w, out_h);
+        if (yuv.is_error() || yuv.value()) return yuv;
+    }
+
+    // Decoder already produced BGRA at the output size (rawvideo, BGRA
+    // intra codecs): wrap its buffer instead of copying it through swscale.
+    if (av_frame->format == AV_PIX_FMT_BGRA &&
+        out_w == av_frame->width && out_h == av_frame->height) {
+        if (AVFrame* ref = ref_decoded_frame(av_frame, 1)) {
+            const int stride = ref->linesize[0];
+            return std::make_shared<Frame>(std::make_unique<FrameImpl>(
+                out_w, out_h, stride, pts_us,
+                ref->data[0], static_cast<size_t>(stride) * out_h, avframe_release_cb(ref)
+            ));
+        }
+    }
     int out_stride = ((out_w * 4) + 31) & ~31;
     size_t buf_size = static_cast<size_t>(out_stride) * out_h;
 
-    auto entry = frame_pool->acquire(buf_size);
-    scale_ctx.convert(av_frame, entry.data, out_stride);
+    auto entry = FrameArena::instance().acquire(buf_size);
+    if (!entry.data) return Error::internal("frame arena cap reached");
+    impl::convert_frame_to_bgra(scale_ctx, av_frame, entry.data, out_stride);
 
     return std::make_shared<Frame>(std::make_unique<FrameImpl>(
         out_w, out_h, out_stride, pts_us,
-        entry.data, entry.size, FrameBufferPool::make_release_cb(frame_pool)
+        entry.data, entry.size, FrameArena::release_cb()
     ));
 }
 
@@ -569,10 +746,9 @@ static Result<std::shared_ptr<Frame>> decode_qtrle(
         AVFormatContext* fmt_ctx, AVStream* stream, int stream_idx,
         TimeUS target_us, AVPacket* pkt,
         TimeUS& last_decode_pts, bool& have_decode_pos,
-        std::shared_ptr<FrameBufferPool> frame_pool) {
-
-    assert(frame_pool && "decode_qtrle: frame_pool is null");
+        const KeyframeIndex* kf_index) {
 
+    auto& arena = FrameArena::instance();
     DecodeMode mode = GetDecodeMode();
     bool did_seek = false;
 
@@ -582,7 +758,8 @@ static Result<std::shared_ptr<Frame>> decode_qtrle(
         if (seek_result.is_error()) return seek_result.error();
         decoder.flush();
         did_seek = true;
-    } else if (impl::need_seek(last_decode_pts, target_us, have_decode_pos)) {
+    } else if (impl::need_seek(last_decode_pts, target_us, have_decode_pos,
+                               kf_index, stream)) {
         auto seek_result = seek_format_only(fmt_ctx, stream, target_us);
         if (seek_result.is_error()) return seek_result.error();
         decoder.flush();
@@ -598,9 +775,10 @@ static Result<std::shared_ptr<Frame>> decode_qtrle(
     int frame_stride = ((out_w * 4) + 31) & ~31;
     size_t buf_size = static_cast<size_t>(frame_stride) * out_h;
 
-    // Acquire the frame's final buffer upfront — malloc, no zero-init.
-    // Decoder writes directly here via dispatch_apply (parallel page faults).
-    auto frame_entry = frame_pool->acquire(buf_size);
+    // Acquire the frame's final buffer upfront — no zero-init. Decoder
+    // writes directly here via SlicePool slices (parallel page faults).
+    auto frame_entry = arena.acquire(buf_size);
+    if (!frame_entry.data) return Error::internal("qtrle: frame arena cap reached");
 
     // Read and decode packets until we reach the target PTS.
     // Decodes into the persistent reference buffer + inline scale to output.
@@ -617,7 +795,7 @@ static Result<std::shared_ptr<Frame>> decode_qtrle(
             // after a read failure, so the next call must seek rather than
             // trust last_decode_pts.
             have_decode_pos = false;
-            frame_pool->release(frame_entry.data, frame_entry.size);
+            arena.release(frame_entry.data, frame_entry.size);
             return impl::ffmpeg_error(ret, "av_read_frame (qtrle)");
         }
 
@@ -637,7 +815,7 @@ static Result<std::shared_ptr<Frame>> decode_qtrle(
             // fmt_ctx already advanced past this packet; bookkeeping is now
             // out of sync. Force seek on next call.
             have_decode_pos = false;
-            frame_pool->release(frame_entry.data, frame_entry.size);
+            arena.release(frame_entry.data, frame_entry.size);
             return decode_result.error();
         }
 
@@ -660,7 +838,7 @@ static Result<std::shared_ptr<Frame>> decode_qtrle(
         // matched. Either way, fmt_ctx is now in a state that doesn't match
         // last_decode_pts — force a seek on the next call.
         have_decode_pos = false;
-        frame_pool->release(frame_entry.data, frame_entry.size);
+        arena.release(frame_entry.data, frame_entry.size);
         return Error::internal("qtrle: no frame found at target time");
     }
 
@@ -685,39 +863,114 @@ static Result<std::shared_ptr<Frame>> decode_qtrle(
     auto result_frame = std::make_shared<Frame>(std::make_unique<FrameImpl>(
         out_w, out_h, frame_stride, best_pts,
         frame_entry.data, frame_entry.size,
-        FrameBufferPool::make_release_cb(frame_pool)
+        FrameArena::release_cb()
     ));
 
     return result_frame;
 }
 
-Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
-    const auto& info = m_media_file->info();
-    if (!info.has_video) {
-        return Error::unsupported("DecodeAt requires video stream");
+// ============================================================================
+// Shuttle decode — keyframe only, half resolution
+// ============================================================================
+
+static bool shuttle_active(const ReaderImpl& impl) {
+    return GetDecodeMode() == DecodeMode::Scrub ||
+           impl.shuttle_decode.load(std::memory_order_relaxed);
+}
+
+static Result<std::shared_ptr<Frame>> decode_shuttle_frame(
+    ReaderImpl& impl, MediaFile& media_file, TimeUS t_us)
+{
+    AVFormatContext* fmt_ctx = impl.demux().get();
+    AVStream* stream = impl.demux().video_stream();
+    int stream_idx = impl.demux().video_stream_index();
+    AVCodecContext* codec = impl.codec_ctx.get();
+    auto decode_start = std::chrono::steady_clock::now();
+
+    auto seek_result = impl::seek_with_backoff(
+        fmt_ctx, stream, codec, t_us, 0, keyframe_index_for_seek(impl, media_file));
+    if (seek_result.is_error()) {
+        return seek_result.error();
+    }
+    // Decoder is drained after this; the next non-shuttle decode must seek.
+    impl.have_decode_pos = false;
+
+    // Only keyframe packets reach the decoder, so skip_frame is a guard for
+    // decoders that split a packet into several pictures. NONINTRA rather
+    // than NONKEY: h264 treats open-GOP recovery-point I-frames as non-key
+    // and would discard the very frame we sent. The loop filter is most of
+    // an intra frame's cost after entropy decode and invisible at shuttle.
+    const AVDiscard prev_skip_frame = codec->skip_frame;
+    const AVDiscard prev_skip_loop = codec->skip_loop_filter;
+    codec->skip_frame = AVDISCARD_NONINTRA;
+    codec->skip_loop_filter = AVDISCARD_ALL;
+    auto key_result = impl::decode_next_keyframe(codec, fmt_ctx, stream_idx,
+                                                 impl.m_pkt, impl.m_frame);
+    codec->skip_frame = prev_skip_frame;
+    codec->skip_loop_filter = prev_skip_loop;
+    if (key_result.is_error()) {
+        return key_result.error();
+    }
+    AVFrame* key_frame = key_result.value();
+    TimeUS key_pts = impl::stream_pts_to_us(key_frame->pts, stream);
+
+    const int half_w = std::max(1, impl.scale_ctx.dst_width() / 2);
+    const int half_h = std::max(1, impl.scale_ctx.dst_height() / 2);
+    if (!impl.shuttle_scale_ctx.get() ||
+            impl.shuttle_scale_ctx.dst_width() != half_w ||
+            impl.shuttle_scale_ctx.dst_height() != half_h) {
+        auto init_result = impl.shuttle_scale_ctx.init(
+            impl.scale_ctx.src_width(), impl.scale_ctx.src_height(),
+            impl.scale_ctx.src_fmt(), half_w, half_h);
+        if (init_result.is_error()) {
+            av_frame_unref(key_frame);
+            return init_result.error();
+        }
     }
+    auto result = avframe_to_emp_frame(key_frame, key_pts, impl.shuttle_scale_ctx,
+                                       impl.codec_ctx,
+                                       impl.yuv_output.load(std::memory_order_relaxed));
+    av_frame_unref(key_frame);
+
+    impl.last_batch_ms_per_frame = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - decode_start).count();
+    EMP_LOG_DEBUG("Shuttle decode: key_pts=%lld target=%lld %.1fms",
+            (long long)key_pts, (long long)t_us, (double)impl.last_batch_ms_per_frame);
+    return result;
+}
 
-    // Past-EOF clamp. Editor convention: requesting a frame past the file's
-    // content returns the last valid frame (hold-last behavior — matches
-    // Premiere/Resolve/FCP). Implementing that honestly requires clamping
-    // here; without the clamp, av_seek_frame(target, BACKWARD) lands at the
-    // file-start keyframe (no keyframe exists past EOF), and decode_frames_batch
-    // re-decodes every frame in the file trying to reach the impossible
-    // target. At 14fps per iteration for a 3s fixture that turned a 72-frame
-    // prefetch window into a 5s stall.
-    //
-    // Clamping to last_frame_pts makes the first past-EOF request decode one
-    // frame; subsequent past-EOF requests hit the decoder at its exhausted
-    // state, decode_frames_batch returns Error::eof() (via the found_target
-    // check), and callers like TMB take the hold-frame-fast-path.
+// Past-EOF clamp. Editor convention: requesting a frame past the file's
+// content returns the last valid frame (hold-last behavior — matches
+// Premiere/Resolve/FCP). Implementing that honestly requires clamping
+// here; without the clamp, av_seek_frame(target, BACKWARD) lands at the
+// file-start keyframe (no keyframe exists past EOF), and decode_frames_batch
+// re-decodes every frame in the file trying to reach the impossible
+// target. At 14fps per iteration for a 3s fixture that turned a 72-frame
+// prefetch window into a 5s stall.
+//
+// Clamping to last_frame_pts makes the first past-EOF request decode one
+// frame; subsequent past-EOF requests hit the decoder at its exhausted
+// state, decode_frames_batch returns Error::eof() (via the found_target
+// check), and callers like TMB take the hold-frame-fast-path.
+static TimeUS clamp_past_eof(const MediaFileInfo& info, TimeUS t_us) {
     if (info.video_fps_num > 0 && info.video_fps_den > 0 && info.duration_us > 0) {
         TimeUS frame_period_us = (1000000LL * info.video_fps_den) / info.video_fps_num;
         TimeUS last_frame_pts_us = info.duration_us - frame_period_us;
         TimeUS slack_us = frame_period_us / 2;
         if (t_us > last_frame_pts_us + slack_us) {
-            t_us = last_frame_pts_us;
+            return last_frame_pts_us;
         }
     }
+    return t_us;
+}
+
+Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
+    const auto& info = m_media_file->info();
+    if (!info.has_video) {
+        return Error::unsupported("DecodeAt requires video stream");
+    }
+
+    t_us = clamp_past_eof(info, t_us);
 
     // BRAW decode path — uses SDK, no FFmpeg involvement
     if (m_impl->braw) {
@@ -730,7 +983,7 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
         // PTS: convert frame_index back to microseconds (floor to grid)
         TimeUS frame_pts = frame_index * 1000000LL * info.video_fps_den / info.video_fps_num;
         auto result = m_impl->braw->decode_frame(
-            static_cast<uint64_t>(frame_index), frame_pts, m_impl->frame_pool);
+            static_cast<uint64_t>(frame_index), frame_pts);
 
         float decode_ms = std::chrono::duration<float, std::milli>(
             std::chrono::steady_clock::now() - decode_start).count();
@@ -739,10 +992,9 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
         return result;
     }
 
-    MediaFileImpl* asset_impl = m_media_file->impl_ptr();
-    AVFormatContext* fmt_ctx = asset_impl->fmt_ctx.get();
-    AVStream* stream = asset_impl->fmt_ctx.video_stream();
-    int stream_idx = asset_impl->fmt_ctx.video_stream_index();
+    AVFormatContext* fmt_ctx = m_impl->demux().get();
+    AVStream* stream = m_impl->demux().video_stream();
+    int stream_idx = m_impl->demux().video_stream_index();
 
     // Custom qtrle decode path
     if (m_impl->qtrle) {
@@ -752,7 +1004,7 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
             *m_impl->qtrle, fmt_ctx, stream, stream_idx,
             t_us, m_impl->m_pkt,
             m_impl->last_decode_pts, m_impl->have_decode_pos,
-            m_impl->frame_pool
+            keyframe_index_for_seek(*m_impl, *m_media_file)
         );
 
         auto decode_end = std::chrono::steady_clock::now();
@@ -769,21 +1021,27 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
         return result;
     }
 
+    if (shuttle_active(*m_impl)) {
+        return decode_shuttle_frame(*m_impl, *m_media_file, t_us);
+    }
+
     DecodeMode mode = GetDecodeMode();
     auto decode_start = std::chrono::steady_clock::now();
 
     // Seek decision: Park/Scrub always seek. Play seeks only when needed.
+    const KeyframeIndex* kf_index = keyframe_index_for_seek(*m_impl, *m_media_file);
     if (mode == DecodeMode::Scrub || mode == DecodeMode::Park) {
         auto seek_result = impl::seek_with_backoff(
-            fmt_ctx, stream, m_impl->codec_ctx.get(), t_us, 0
+            fmt_ctx, stream, m_impl->codec_ctx.get(), t_us, 0, kf_index
         );
         if (seek_result.is_error()) {
             return seek_result.error();
         }
     } else {
-        if (impl::need_seek(m_impl->last_decode_pts, t_us, m_impl->have_decode_pos)) {
+        if (impl::need_seek(m_impl->last_decode_pts, t_us, m_impl->have_decode_pos,
+                            kf_index, stream)) {
             auto seek_result = impl::seek_with_backoff(
-                fmt_ctx, stream, m_impl->codec_ctx.get(), t_us, 0
+                fmt_ctx, stream, m_impl->codec_ctx.get(), t_us, 0, kf_index
             );
             if (seek_result.is_error()) {
                 return seek_result.error();
@@ -810,7 +1068,7 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
         TimeUS floor_pts = impl::stream_pts_to_us(floor_frame->pts, stream);
         auto result = avframe_to_emp_frame(
             floor_frame, floor_pts, m_impl->scale_ctx, m_impl->codec_ctx,
-            m_impl->frame_pool
+            m_impl->yuv_output.load(std::memory_order_relaxed)
         );
         av_frame_free(&best_frame);
 
@@ -870,7 +1128,7 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
     auto result = avframe_to_emp_frame(
         decoded_frames[floor_idx].frame, floor_pts,
         m_impl->scale_ctx, m_impl->codec_ctx,
-        m_impl->frame_pool
+        m_impl->yuv_output.load(std::memory_order_relaxed)
     );
 
     // Record per-frame decode cost before freeing.
@@ -896,6 +1154,324 @@ Result<std::shared_ptr<Frame>> Reader::DecodeAtUS(TimeUS t_us) {
     return result;
 }
 
+// ============================================================================
+// DecodeGopUS — reverse playback: one forward GOP decode, many frames
+// ============================================================================
+//
+// Stepping backwards through long-GOP media with DecodeAtUS costs a seek
+// plus a decode from the keyframe for EVERY frame: frame k of a GOP pays
+// k decodes, O(GOP²) per GOP (a 60-frame H.264 GOP is ~1800 decodes to
+// show 60 frames). This decodes the GOP prefix once — keyframe through
+// the target — and converts every frame of it, so the caller can serve
+// the next max_frames reverse steps from its cache.
+//
+// Frames past the target (B-frame reorder tail) are dropped: the target
+// is the newest frame reverse playback needs. The oldest frames beyond
+// max_frames are dropped too (memory bound for 4K); the caller's next
+// request for them seeks to the same keyframe and decodes a shorter
+// prefix.
+Result<std::vector<std::shared_ptr<Frame>>> Reader::DecodeGopUS(TimeUS t_us, int max_frames) {
+    assert(max_frames > 0 && "DecodeGopUS: max_frames must be positive");
+    const auto& info = m_media_file->info();
+    if (!info.has_video) {
+        return Error::unsupported("DecodeGop requires video stream");
+    }
+
+    // BRAW decodes by frame index (every frame is a keyframe) and qtrle has
+    // its own keyframe walk — neither has a GOP prefix to share. Shuttle
+    // decode only ever produces the keyframe. One frame.
+    if (m_impl->braw || m_impl->qtrle || shuttle_active(*m_impl)) {
+        auto single = DecodeAtUS(t_us);
+        if (single.is_error()) return single.error();
+        return std::vector<std::shared_ptr<Frame>>{single.value()};
+    }
+
+    t_us = clamp_past_eof(info, t_us);
+
+    AVFormatContext* fmt_ctx = m_impl->demux().get();
+    AVStream* stream = m_impl->demux().video_stream();
+    int stream_idx = m_impl->demux().video_stream_index();
+    auto decode_start = std::chrono::steady_clock::now();
+
+    // Always seek: the target's keyframe is behind the decoder in reverse.
+    auto seek_result = impl::seek_with_backoff(
+        fmt_ctx, stream, m_impl->codec_ctx.get(), t_us, 0,
+        keyframe_index_for_seek(*m_impl, *m_media_file)
+    );
+    if (seek_result.is_error()) {
+        return seek_result.error();
+    }
+
+    auto batch_result = impl::decode_frames_batch(
+        m_impl->codec_ctx.get(), fmt_ctx, stream, stream_idx,
+        t_us, m_impl->m_pkt, m_impl->m_frame
+    );
+    if (batch_result.is_error()) {
+        return batch_result.error();
+    }
+    auto& decoded_frames = batch_result.value();
+    assert(!decoded_frames.empty() && "decode_frames_batch returned empty batch");
+
+    // Decoder sits just past the target (same bookkeeping as the Play path).
+    TimeUS batch_max_pts = decoded_frames[0].pts_us;
+    for (const auto& df : decoded_frames) {
+        if (df.pts_us > batch_max_pts) batch_max_pts = df.pts_us;
+    }
+    m_impl->last_decode_pts = batch_max_pts;
+    m_impl->have_decode_pos = true;
+
+    // Keep frames <= target in presentation order. Decode order differs
+    // from PTS order with B-frames, so sort the survivors.
+    std::vector<impl::DecodedFrame*> keep;
+    keep.reserve(decoded_frames.size());
+    for (auto& df : decoded_frames) {
+        if (df.pts_us <= t_us) keep.push_back(&df);
+    }
+    // No frame <= target (target before the stream's first PTS): take the
+    // earliest, like DecodeAtUS's floor fallback.
+    if (keep.empty()) {
+        impl::DecodedFrame* first = &decoded_frames[0];
+        for (auto& df : decoded_frames) {
+            if (df.pts_us < first->pts_us) first = &df;
+        }
+        keep.push_back(first);
+    }
+    std::sort(keep.begin(), keep.end(),
+              [](const impl::DecodedFrame* a, const impl::DecodedFrame* b) {
+                  return a->pts_us < b->pts_us;
+              });
+    size_t first_kept = keep.size() > static_cast<size_t>(max_frames)
+        ? keep.size() - static_cast<size_t>(max_frames) : 0;
+
+    // Convert newest first: if the frame arena hits its cap mid-GOP, the
+    // frames nearest the target are the ones kept.
+    std::vector<std::shared_ptr<Frame>> out;
+    out.reserve(keep.size() - first_kept);
+    Result<std::shared_ptr<Frame>> convert_error = Error::internal("no frames converted");
+    for (size_t i = keep.size(); i-- > first_kept; ) {
+        auto converted = avframe_to_emp_frame(
+            keep[i]->frame, keep[i]->pts_us,
+            m_impl->scale_ctx, m_impl->codec_ctx,
+            m_impl->yuv_output.load(std::memory_order_relaxed)
+        );
+        if (converted.is_error()) {
+            convert_error = converted.error();
+            break;
+        }
+        out.push_back(converted.value());
+    }
+    std::reverse(out.begin(), out.end());
+    if (out.empty()) {
+        for (auto& df : decoded_frames) {
+            av_frame_free(&df.frame);
+        }
+        return convert_error.error();
+    }
+
+    // Cost per frame delivered, not per frame decoded: that is what the
+    // caller's stride/deadline math budgets for in reverse.
+    float decode_ms = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - decode_start).count();
+    m_impl->last_batch_ms_per_frame = decode_ms / static_cast<float>(out.size());
+
+    EMP_LOG_DEBUG("DecodeGop: %zu decoded, %zu returned in %.1fms target=%lld",
+            decoded_frames.size(), out.size(), (double)decode_ms, (long long)t_us);
+
+    for (auto& df : decoded_frames) {
+        av_frame_free(&df.frame);
+    }
+
+    return out;
+}
+
+// ============================================================================
+// DecodeRange — forward prefetch: one decode pass, a run of grid frames
+// ============================================================================
+//
+// TMB prefetch used to call DecodeAt once per cache slot. On the Play path
+// each call already runs decode_frames_batch, which decodes every frame up
+// to the target and throws away all but one — so a run of slots paid a
+// lock round trip, a seek decision, an EOF clamp and a frame-list walk per
+// frame. DecodeRange decodes up to the last target once, picks the floor
+// frame for every target (same floor-on-grid rule as DecodeAt), and
+// converts the frames it picked — across SlicePool when conversion needs
+// no per-Reader state (HW wrap, planar YUV output, BGRA at size).
+
+// True when converting av_frame touches none of the Reader's conversion
+// state (scale_ctx): safe to run for several frames at once.
+static bool converts_independently(const AVFrame* av_frame, int out_w, int out_h,
+                                   bool yuv_output) {
+#ifdef EMP_HAS_VIDEOTOOLBOX
+    if (av_frame->format == AV_PIX_FMT_VIDEOTOOLBOX) return true;
+#endif
+    if (yuv_output) {
+        impl::YuvLayout layout;
+        impl::YuvRange range;
+        if (impl::native_yuv_layout(static_cast<AVPixelFormat>(av_frame->format), &layout, &range) &&
+                out_w <= av_frame->width && out_h <= av_frame->height) {
+            return true;
+        }
+    }
+    // BGRA at size is only independent when avframe_to_emp_frame wraps it;
+    // a bottom-up frame falls through to swscale on the shared scale_ctx.
+    return av_frame->format == AV_PIX_FMT_BGRA &&
+           out_w == av_frame->width && out_h == av_frame->height &&
+           can_ref_decoded_frame(av_frame, 1);
+}
+
+Result<std::vector<std::shared_ptr<Frame>>> Reader::DecodeRange(FrameTime t0, FrameTime t1,
+                                                                 int stride) {
+    JVE_ASSERT(stride >= 1, "DecodeRange: stride must be >= 1");
+    JVE_ASSERT(t0.rate.num == t1.rate.num && t0.rate.den == t1.rate.den,
+               "DecodeRange: t0 and t1 must share a rate");
+    if (t1.frame <= t0.frame) {
+        return Error::invalid_arg("DecodeRange: empty range");
+    }
+    const auto& info = m_media_file->info();
+    if (!info.has_video) {
+        return Error::unsupported("DecodeRange requires video stream");
+    }
+
+    // Targets past the last frame are left off (the caller's single-frame
+    // path owns EOF); a range that starts there clamps like DecodeAt.
+    std::vector<TimeUS> targets;
+    for (int64_t f = t0.frame; f < t1.frame; f += stride) {
+        const TimeUS t_us = FrameTime::from_frame(f, t0.rate).to_us();
+        const TimeUS clamped = clamp_past_eof(info, t_us);
+        if (clamped != t_us) {
+            if (targets.empty()) targets.push_back(clamped);
+            break;
+        }
+        targets.push_back(t_us);
+    }
+
+    // BRAW and qtrle decode one frame per call; shuttle only ever produces
+    // keyframes. Same frames, no shared pass.
+    if (m_impl->braw || m_impl->qtrle || shuttle_active(*m_impl)) {
+        std::vector<std::shared_ptr<Frame>> out;
+        out.reserve(targets.size());
+        for (TimeUS t_us : targets) {
+            auto single = DecodeAtUS(t_us);
+            if (single.is_error()) {
+                if (out.empty()) return single.error();
+                break;
+            }
+            out.push_back(single.value());
+        }
+        return out;
+    }
+
+    AVFormatContext* fmt_ctx = m_impl->demux().get();
+    AVStream* stream = m_impl->demux().video_stream();
+    int stream_idx = m_impl->demux().video_stream_index();
+    auto decode_start = std::chrono::steady_clock::now();
+
+    // Seek decision as DecodeAtUS, made once for the first target.
+    const KeyframeIndex* kf_index = keyframe_index_for_seek(*m_impl, *m_media_file);
+    if (GetDecodeMode() == DecodeMode::Park ||
+            impl::need_seek(m_impl->last_decode_pts, targets.front(),
+                            m_impl->have_decode_pos, kf_index, stream)) {
+        auto seek_result = impl::seek_with_backoff(
+            fmt_ctx, stream, m_impl->codec_ctx.get(), targets.front(), 0, kf_index);
+        if (seek_result.is_error()) {
+            return seek_result.error();
+        }
+    }
+
+    auto batch_result = impl::decode_frames_batch(
+        m_impl->codec_ctx.get(), fmt_ctx, stream, stream_idx,
+        targets.back(), m_impl->m_pkt, m_impl->m_frame
+    );
+    if (batch_result.is_error()) {
+        return batch_result.error();
+    }
+    auto& decoded_frames = batch_result.value();
+    assert(!decoded_frames.empty() && "decode_frames_batch returned empty batch");
+
+    std::vector<impl::DecodedFrame*> sorted;
+    sorted.reserve(decoded_frames.size());
+    TimeUS batch_max_pts = decoded_frames[0].pts_us;
+    for (auto& df : decoded_frames) {
+        sorted.push_back(&df);
+        if (df.pts_us > batch_max_pts) batch_max_pts = df.pts_us;
+    }
+    m_impl->last_decode_pts = batch_max_pts;
+    m_impl->have_decode_pos = true;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const impl::DecodedFrame* a, const impl::DecodedFrame* b) {
+                  return a->pts_us < b->pts_us;
+              });
+
+    // Floor frame per target; the earliest frame stands in for targets
+    // before it (DecodeAtUS's fallback). Targets are ascending, so one walk.
+    std::vector<int> pick(targets.size());
+    std::vector<int> picked;  // distinct indices into `sorted`, ascending
+    size_t cursor = 0;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        while (cursor + 1 < sorted.size() && sorted[cursor + 1]->pts_us <= targets[i]) {
+            ++cursor;
+        }
+        pick[i] = static_cast<int>(cursor);
+        if (picked.empty() || picked.back() != pick[i]) picked.push_back(pick[i]);
+    }
+
+    // Convert each picked frame once. Independent conversions go across
+    // SlicePool; the rest share scale_ctx and run here in order (the native
+    // BGRA converter already slices each frame).
+    const bool yuv_output = m_impl->yuv_output.load(std::memory_order_relaxed);
+    const int out_w = m_impl->scale_ctx.dst_width();
+    const int out_h = m_impl->scale_ctx.dst_height();
+    std::vector<std::shared_ptr<Frame>> converted(sorted.size());
+    std::vector<int> parallel;
+    Result<std::shared_ptr<Frame>> convert_error = Error::internal("no frames converted");
+    for (int idx : picked) {
+        if (converts_independently(sorted[idx]->frame, out_w, out_h, yuv_output)) {
+            parallel.push_back(idx);
+            continue;
+        }
+        auto r = avframe_to_emp_frame(sorted[idx]->frame, sorted[idx]->pts_us,
+                                      m_impl->scale_ctx, m_impl->codec_ctx, yuv_output);
+        if (r.is_error()) { convert_error = r.error(); break; }
+        converted[idx] = r.value();
+    }
+    if (!parallel.empty()) {
+        std::vector<Result<std::shared_ptr<Frame>>> results(
+            parallel.size(), Result<std::shared_ptr<Frame>>(std::shared_ptr<Frame>()));
+        impl::SlicePool::shared().parallel_for(static_cast<int>(parallel.size()), [&](int j) {
+            const impl::DecodedFrame* df = sorted[parallel[j]];
+            results[j] = avframe_to_emp_frame(df->frame, df->pts_us,
+                                              m_impl->scale_ctx, m_impl->codec_ctx, yuv_output);
+        });
+        for (size_t j = 0; j < parallel.size(); ++j) {
+            if (results[j].is_error()) convert_error = results[j].error();
+            else converted[parallel[j]] = results[j].value();
+        }
+    }
+
+    // Deliver the targets in order up to the first unconverted frame (frame
+    // arena at its cap): the caller gets a contiguous run to cache.
+    std::vector<std::shared_ptr<Frame>> out;
+    out.reserve(targets.size());
+    for (size_t i = 0; i < targets.size() && converted[pick[i]]; ++i) {
+        out.push_back(converted[pick[i]]);
+    }
+
+    for (auto& df : decoded_frames) {
+        av_frame_free(&df.frame);
+    }
+    if (out.empty()) {
+        return convert_error.error();
+    }
+
+    float decode_ms = std::chrono::duration<float, std::milli>(
+        std::chrono::steady_clock::now() - decode_start).count();
+    m_impl->last_batch_ms_per_frame = decode_ms / static_cast<float>(decoded_frames.size());
+
+    EMP_LOG_DEBUG("DecodeRange: %zu targets, %zu decoded, %zu converted in %.1fms",
+            targets.size(), decoded_frames.size(), picked.size(), (double)decode_ms);
+    return out;
+}
+
 Result<std::shared_ptr<PcmChunk>> Reader::DecodeAudioRange(FrameTime t0, FrameTime t1,
                                                             const AudioFormat& out,
                                                             int source_channel) {
@@ -1043,8 +1619,7 @@ Result<std::shared_ptr<PcmChunk>> Reader::DecodeAudioRangeUS(TimeUS t0_us, TimeU
         }
     }
 
-    MediaFileImpl* asset_impl = m_media_file->impl_ptr();
-    AVFormatContext* fmt_ctx = asset_impl->fmt_ctx.get();
+    AVFormatContext* fmt_ctx = m_impl->demux().get();
     const auto& info = m_media_file->info();
 
     // Resolve flat source_channel → (av_stream_idx, channel_within_stream).
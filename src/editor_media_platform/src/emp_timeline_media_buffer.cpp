@@ -1,4 +1,6 @@
 #include <editor_media_platform/emp_timeline_media_buffer.h>
+#include <editor_media_platform/emp_cpu_budget.h>
+#include <editor_media_platform/emp_io.h>
 #include "impl/pcm_chunk_impl.h"
 #include "../../assert_handler.h"
 #include <cassert>
@@ -115,22 +117,76 @@ std::unique_ptr<TimelineMediaBuffer> TimelineMediaBuffer::Create(int pool_thread
     return tmb;
 }
 
-// Reserves 2 cores for main/UI/render; clamps to the pool-layout invariants.
+// Reserves 2 cores for main/UI/render and the budget's slice-pool share
+// (the workers hand it their frame conversions); clamps to the pool-layout
+// invariants. Machine size comes from the CPU budget (so a pinned budget
+// pins the pool too). The pool is the Playback class's consumer; it is
+// sized once — the budget governs how many threads each SW codec opens
+// with, not the pool.
 std::unique_ptr<TimelineMediaBuffer> TimelineMediaBuffer::Create() {
-    const int hw = static_cast<int>(std::thread::hardware_concurrency());
-    const int sized = std::clamp(hw - 2, MIN_POOL_THREADS, MAX_POOL_THREADS);
+    const CpuBudgetStats budget = GetCpuBudgetStats();
+    const int sized = std::clamp(budget.total_threads - 2 - budget.slice_workers,
+                                 MIN_POOL_THREADS, MAX_POOL_THREADS);
     return Create(sized);
 }
 
+// ============================================================================
+// Track map + locking — RCU-published map, per-track mutexes
+// ============================================================================
+
+std::unique_lock<std::mutex> TimelineMediaBuffer::lock_counted(std::mutex& m) const {
+    std::unique_lock<std::mutex> lock(m, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        m_lock_contentions.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+    return lock;
+}
+
+std::shared_ptr<TimelineMediaBuffer::TrackState>
+TimelineMediaBuffer::find_track(const TrackId& track) const {
+    auto map = tracks();
+    auto it = map->find(track);
+    return it != map->end() ? it->second : nullptr;
+}
+
+std::shared_ptr<TimelineMediaBuffer::TrackState>
+TimelineMediaBuffer::find_or_create_track_locked(const TrackId& track) {
+    auto map = tracks();
+    auto it = map->find(track);
+    if (it != map->end()) return it->second;
+    auto next = std::make_shared<TrackMap>(*map);
+    auto ts = std::make_shared<TrackState>();
+    (*next)[track] = ts;
+    publish_tracks(std::move(next));
+    return ts;
+}
+
+void TimelineMediaBuffer::publish_tracks(std::shared_ptr<const TrackMap> next) {
+    assert(next && "publish_tracks: null track map");
+    std::atomic_store(&m_tracks, std::move(next));
+}
+
+void TimelineMediaBuffer::retire_track(TrackState& ts) {
+    auto lock = lock_track(ts);
+    ts.video_cache.clear();
+    ts.video_frame_refs.clear();
+    ts.video_cache_bytes = 0;
+    ts.audio_cache.clear();
+    ts.clip_eof_frame.clear();
+    ts.video_buffer_end = -1;
+    ts.audio_buffer_end = -1;
+    ts.prefetch_generation++;
+}
+
 // ============================================================================
 // Track clip layout
 // ============================================================================
 
 std::vector<int> TimelineMediaBuffer::GetVideoTrackIds() {
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
     std::vector<int> ids;
-    for (const auto& [track_id, ts] : m_tracks) {
-        if (track_id.type == TrackType::Video && !ts.clips.empty()) {
+    for (const auto& [track_id, ts] : *tracks()) {
+        if (track_id.type == TrackType::Video && !ts->layout()->empty()) {
             ids.push_back(track_id.index);
         }
     }
@@ -139,9 +195,8 @@ std::vector<int> TimelineMediaBuffer::GetVideoTrackIds() {
 }
 
 void TimelineMediaBuffer::SetEffectiveVideoTracks(const std::vector<int>& track_indices) {
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
-    m_effective_video_tracks = track_indices;
-    m_effective_video_tracks_valid = true;
+    std::atomic_store(&m_effective_video_tracks,
+                      std::make_shared<const std::vector<int>>(track_indices));
     // No cache flush — previously-decoded frames on now-ineligible tracks
     // stay until evicted naturally. Re-enabling a track resumes decode from
     // the playhead. wake_prefetch_workers happens at the SetTrackClips
@@ -153,30 +208,39 @@ void TimelineMediaBuffer::SetTrackClips(TrackId track, const std::vector<ClipInf
     bool clips_changed = false;
     // Clips not in old list — need reader pre-warming during active playback
     std::vector<ClipInfo> clips_to_warm;
-    {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        auto& ts = m_tracks[track];
-
-        // Fast path: skip entirely if clip list is unchanged (called every
-        // tick). Equality delegates to ClipInfo::has_same_decode_inputs so
-        // every field stays compared in one place — adding a field to
-        // ClipInfo forces its author to update that single comparison.
-        if (ts.clips.size() == clips.size()) {
-            bool same = true;
-            for (size_t i = 0; i < clips.size(); ++i) {
-                if (!ts.clips[i].has_same_decode_inputs(clips[i])) {
-                    same = false;
-                    break;
-                }
-            }
-            if (same) return;
+
+    // Fast path: skip entirely if clip list is unchanged (called every
+    // tick). Equality delegates to ClipInfo::has_same_decode_inputs so
+    // every field stays compared in one place — adding a field to
+    // ClipInfo forces its author to update that single comparison.
+    // Compared against the published snapshot without taking any lock,
+    // so the per-tick re-post never contends with prefetch.
+    auto same_layout = [&clips](const ClipLayout& current) {
+        if (current.size() != clips.size()) return false;
+        for (size_t i = 0; i < clips.size(); ++i) {
+            if (!current[i].has_same_decode_inputs(clips[i])) return false;
         }
+        return true;
+    };
+    if (auto live = find_track(track); live && same_layout(*live->layout())) return;
+    {
+        // Map lock held from lookup through publish: ReleaseTrack and
+        // ClearAllClips detach a track under it before retiring it, so
+        // the state published into below is still the live one.
+        auto map_lock = lock_counted(m_tracks_mutex);
+        auto tsp = find_or_create_track_locked(track);
+        auto& ts = *tsp;
+        auto lock = lock_track(ts);
+        // Re-check under the lock: a concurrent SetTrackClips may have
+        // published this exact layout since the snapshot above.
+        auto old_layout = ts.layout();
+        if (same_layout(*old_layout)) return;
 
         // Clip list changed. Only evict cache entries for clips that were REMOVED.
         // Pre-buffered frames for clips still in the new list must survive —
         // the boundary crossing is exactly when we need them most.
         std::unordered_set<std::string> old_clip_ids;
-        for (const auto& c : ts.clips) {
+        for (const auto& c : *old_layout) {
             old_clip_ids.insert(c.clip_id);
         }
         std::unordered_set<std::string> new_clip_ids;
@@ -188,13 +252,13 @@ void TimelineMediaBuffer::SetTrackClips(TrackId track, const std::vector<ClipInf
             }
         }
 
-        for (auto it = ts.video_cache.begin(); it != ts.video_cache.end(); ) {
-            if (new_clip_ids.find(it->second.clip_id) == new_clip_ids.end()) {
-                it = ts.video_cache.erase(it);
-            } else {
-                ++it;
-            }
-        }
+        ts.video_cache.erase_if(
+            [&new_clip_ids](const TrackState::VideoCache::Entry& e) {
+                return new_clip_ids.find(e.value.clip_id) == new_clip_ids.end();
+            },
+            [this, &ts](const TrackState::VideoCache::Entry& e) {
+                uncharge_video_cache_entry(ts, e.value);
+            });
 
         for (auto it = ts.audio_cache.begin(); it != ts.audio_cache.end(); ) {
             if (new_clip_ids.find(it->clip_id) == new_clip_ids.end()) {
@@ -213,7 +277,7 @@ void TimelineMediaBuffer::SetTrackClips(TrackId track, const std::vector<ClipInf
             }
         }
 
-        ts.clips = clips;
+        ts.publish(std::make_shared<const ClipLayout>(clips));
 
         // Reset buffer_end so prefetch re-evaluates from playhead.
         // Increment generation so in-flight prefetch abandons early.
@@ -252,12 +316,16 @@ void TimelineMediaBuffer::AddClips(TrackId track, std::vector<ClipInfo> clips) {
 
     std::vector<ClipInfo> clips_to_warm;
     {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        auto& ts = m_tracks[track];
+        // Map lock across lookup and publish, as in SetTrackClips.
+        auto map_lock = lock_counted(m_tracks_mutex);
+        auto tsp = find_or_create_track_locked(track);
+        auto& ts = *tsp;
+        auto lock = lock_track(ts);
+        auto next = std::make_shared<ClipLayout>(*ts.layout());
 
         // Build set of existing clip_ids for dedup
         std::unordered_set<std::string> existing_ids;
-        for (const auto& c : ts.clips) {
+        for (const auto& c : *next) {
             existing_ids.insert(c.clip_id);
         }
 
@@ -266,17 +334,18 @@ void TimelineMediaBuffer::AddClips(TrackId track, std::vector<ClipInfo> clips) {
             if (existing_ids.find(c.clip_id) == existing_ids.end()) {
                 existing_ids.insert(c.clip_id);
                 clips_to_warm.push_back(c);
-                ts.clips.push_back(std::move(c));
+                next->push_back(std::move(c));
             }
         }
 
         if (clips_to_warm.empty()) return;  // all duplicates
 
         // Re-sort by sequence_start
-        std::sort(ts.clips.begin(), ts.clips.end(),
+        std::sort(next->begin(), next->end(),
             [](const ClipInfo& a, const ClipInfo& b) {
                 return a.sequence_start < b.sequence_start;
             });
+        ts.publish(std::move(next));
     }
     // New audio clips invalidate the mixed cache: the mix thread may have
     // already cached silence for ranges that now contain audio. Without
@@ -329,10 +398,13 @@ void TimelineMediaBuffer::AddClips(TrackId track, std::vector<ClipInfo> clips) {
 }
 
 void TimelineMediaBuffer::ClearAllClips() {
+    std::shared_ptr<const TrackMap> old;
     {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        m_tracks.clear();
+        auto lock = lock_counted(m_tracks_mutex);
+        old = tracks();
+        publish_tracks(std::make_shared<const TrackMap>());
     }
+    for (const auto& [id, ts] : *old) retire_track(*ts);
     // Invalidate watermarks is implicit — m_tracks is empty.
     // Mixed audio cache is stale too.
     {
@@ -345,9 +417,23 @@ void TimelineMediaBuffer::ClearAllClips() {
 // Playhead
 // ============================================================================
 
-void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed) {
+void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed, float clock_speed) {
+    assert(clock_speed >= 0.0f && "SetPlayhead: clock_speed is a magnitude");
     int prev_direction = m_playhead_direction.load(std::memory_order_relaxed);
     int64_t prev_frame = m_prev_playhead_frame.load(std::memory_order_relaxed);
+
+    // Deadline anchor: `frame` is on screen now and the playhead moves at
+    // clock_speed × sequence fps. Stored before the frame itself so a worker
+    // that sees the new frame never pairs it with the previous anchor's
+    // (older) wall time.
+    double frames_per_sec = 0.0;
+    if (direction != 0 && m_seq_rate.num > 0) {
+        const float rate = clock_speed > 0.0f ? clock_speed : std::abs(speed);
+        frames_per_sec = rate * static_cast<double>(m_seq_rate.num) / m_seq_rate.den;
+    }
+    m_playhead_wall_ns.store(deadline_clock_ns(), std::memory_order_relaxed);
+    m_playhead_frames_per_sec.store(frames_per_sec, std::memory_order_relaxed);
+
     m_playhead_frame.store(frame, std::memory_order_relaxed);
     m_playhead_direction.store(direction, std::memory_order_relaxed);
     m_playhead_speed.store(speed, std::memory_order_relaxed);
@@ -360,21 +446,19 @@ void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed)
 
     // Direction change: reset watermark buffer_ends (buffer is invalid for new direction)
     if (direction != 0 && prev_direction != 0 && prev_direction != direction) {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        for (auto& [track, ts] : m_tracks) {
-            ts.video_buffer_end = -1;
-            ts.audio_buffer_end = -1;
+        for (const auto& [track, ts] : *tracks()) {
+            auto lock = lock_track(*ts);
+            ts->video_buffer_end = -1;
+            ts->audio_buffer_end = -1;
         }
     }
 
     // Cold-start priming: on play start (0→nonzero), reset buffers and wake prefetch
     if (direction != 0 && prev_direction == 0) {
-        {
-            std::lock_guard<std::mutex> lock(m_tracks_mutex);
-            for (auto& [track, ts] : m_tracks) {
-                ts.video_buffer_end = -1;
-                ts.audio_buffer_end = -1;
-            }
+        for (const auto& [track, ts] : *tracks()) {
+            auto lock = lock_track(*ts);
+            ts->video_buffer_end = -1;
+            ts->audio_buffer_end = -1;
         }
         // Clear stale mixed cache from previous play session.
         // Without this, mix thread sees old cache_end >= target_end and
@@ -384,7 +468,6 @@ void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed)
             m_mixed_cache.clear();
         }
         // Wake prefetch workers — they self-direct what to fill
-        m_audio_work_pending.store(true, std::memory_order_relaxed);
         wake_prefetch_workers();
     }
 
@@ -401,18 +484,13 @@ void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed)
         int64_t discontinuity_threshold = static_cast<int64_t>(spd * 2.0f) + 1;
         if (delta > discontinuity_threshold) {
             bool any_reset = false;
-            {
-                std::lock_guard<std::mutex> lock(m_tracks_mutex);
-                for (auto& [tid, ts] : m_tracks) {
-                    if (tid.type != TrackType::Audio) continue;
-                    ts.audio_buffer_end = -1;
-                    any_reset = true;
-                }
-            }
-            if (any_reset) {
-                m_audio_work_pending.store(true, std::memory_order_relaxed);
-                wake_prefetch_workers();
+            for (const auto& [tid, ts] : *tracks()) {
+                if (tid.type != TrackType::Audio) continue;
+                auto lock = lock_track(*ts);
+                ts->audio_buffer_end = -1;
+                any_reset = true;
             }
+            if (any_reset) wake_prefetch_workers();
         }
     }
 
@@ -421,12 +499,12 @@ void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed)
     // buffer is getting thin. Prevents underruns from slow cumulative drift.
     if (direction != 0 && m_seq_rate.num > 0) {
         TimeUS playhead_us = FrameTime::from_frame(frame, m_seq_rate).to_us();
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        for (const auto& [tid, ts] : m_tracks) {
+        for (const auto& [tid, ts] : *tracks()) {
             if (tid.type != TrackType::Audio) continue;
-            if (is_audio_buffer_low(ts, playhead_us, direction)) {
-                m_audio_work_pending.store(true, std::memory_order_relaxed);
-                m_jobs_cv.notify_all();
+            auto lock = lock_track(*ts);
+            if (is_audio_buffer_low(*ts, playhead_us, direction)) {
+                lock.unlock();
+                wake_prefetch_workers();
                 break;
             }
         }
@@ -440,15 +518,16 @@ void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed)
                              int64_t source_in; int32_t rate_num, rate_den; };
         std::vector<ProbeTarget> probes;
         {
-            std::lock_guard<std::mutex> tlock(m_tracks_mutex);
+            auto map = tracks();
             std::lock_guard<std::mutex> plock(m_pool_mutex);
             int64_t scan_end = (direction > 0)
                 ? frame + PROBE_WINDOW
                 : std::max(frame - PROBE_WINDOW, int64_t(0));
 
-            for (const auto& [tid, ts] : m_tracks) {
+            for (const auto& [tid, ts] : *map) {
                 if (tid.type != TrackType::Video) continue;
-                for (const auto& c : ts.clips) {
+                auto layout = ts->layout();
+                for (const auto& c : *layout) {
                     bool in_window = (direction > 0)
                         ? (c.sequence_start < scan_end && c.sequence_end() > frame)
                         : (c.sequence_start < frame && c.sequence_end() > scan_end);
@@ -480,9 +559,9 @@ void TimelineMediaBuffer::SetPlayhead(int64_t frame, int direction, float speed)
 // Returns explicit CLIP or GAP with bounds. No null-means-gap pattern.
 // ============================================================================
 
-Segment TimelineMediaBuffer::find_segment_at(const TrackState& ts, int64_t timeline_frame) const {
+Segment TimelineMediaBuffer::find_segment_at(const ClipLayout& clips, int64_t timeline_frame) const {
     // Check if timeline_frame falls inside any clip
-    for (const auto& clip : ts.clips) {
+    for (const auto& clip : clips) {
         if (timeline_frame >= clip.sequence_start && timeline_frame < clip.sequence_end()) {
             return Segment{Segment::CLIP, clip.sequence_start, clip.sequence_end(), &clip};
         }
@@ -492,7 +571,7 @@ Segment TimelineMediaBuffer::find_segment_at(const TrackState& ts, int64_t timel
     int64_t gap_start = std::numeric_limits<int64_t>::min();
     int64_t gap_end = std::numeric_limits<int64_t>::max();
 
-    for (const auto& clip : ts.clips) {
+    for (const auto& clip : clips) {
         // Clips ending at or before this frame → gap starts after them
         if (clip.sequence_end() <= timeline_frame) {
             if (clip.sequence_end() > gap_start) {
@@ -515,7 +594,7 @@ Segment TimelineMediaBuffer::find_segment_at(const TrackState& ts, int64_t timel
 // ============================================================================
 
 bool TimelineMediaBuffer::track_is_eligible(int track_index) const {
-    // Caller holds m_tracks_mutex. Eligibility = "the playback layer asked us
+    // Lock-free snapshot read. Eligibility = "the playback layer asked us
     // to decode this." Until the first SetEffectiveVideoTracks push every
     // track is eligible (boot semantics). After first push, exact membership.
     //
@@ -525,34 +604,245 @@ bool TimelineMediaBuffer::track_is_eligible(int track_index) const {
     // blends, or mattes — all of which require the lower layer decoded even
     // when an upper layer has a clip. The compositor is the only authority
     // on what it needs; TMB decodes what's asked, no inference.
-    if (!m_effective_video_tracks_valid) return true;
-    for (int idx : m_effective_video_tracks) {
+    auto effective = std::atomic_load(&m_effective_video_tracks);
+    if (!effective) return true;
+    for (int idx : *effective) {
         if (idx == track_index) return true;
     }
     return false;
 }
 
 // ============================================================================
-// evict_video_cache_entry — LRU via insertion sequence number
+// evict_video_cache_entry — LRU via insertion order
 // ============================================================================
 
 void TimelineMediaBuffer::evict_video_cache_entry(TrackState& ts) const {
     assert(!ts.video_cache.empty() && "evict_video_cache_entry: cache is empty");
 
-    // Each CachedFrame carries a monotonic insert_seq assigned at insertion.
-    // Evict the entry with the lowest insert_seq (= oldest = least recently used).
-    //
-    // This is correct across seek boundaries: after a backward seek, old frames
-    // from the previous position have lower insert_seq than newly-prefetched
-    // frames, so they're evicted first regardless of their timeline_frame key.
-    // O(n) on ~144 entries = ~microseconds.
-    auto victim = ts.video_cache.begin();
-    for (auto it = std::next(victim); it != ts.video_cache.end(); ++it) {
-        if (it->second.insert_seq < victim->second.insert_seq) {
-            victim = it;
+    // The cache's intrusive LRU list is in insertion order; its head is the
+    // oldest insertion (= least recently used). Correct across seek
+    // boundaries: after a backward seek, frames from the previous position
+    // were inserted earlier than newly-prefetched frames, so they're evicted
+    // first regardless of their timeline_frame key.
+    erase_video_cache_entry(ts, ts.video_cache.oldest());
+    ts.video_cache_evictions++;
+}
+
+// ============================================================================
+// Video cache byte accounting + TMB-wide budget
+// ============================================================================
+
+void TimelineMediaBuffer::uncharge_video_cache_entry(
+        TrackState& ts, const TrackState::CachedFrame& cf) const {
+    const Frame* f = cf.frame.get();
+    if (f) {
+        auto ref = ts.video_frame_refs.find(f);
+        assert(ref != ts.video_frame_refs.end() &&
+               "uncharge_video_cache_entry: cached frame missing from refcount map");
+        if (--ref->second == 0) {
+            ts.video_cache_bytes -= static_cast<int64_t>(f->data_size());
+            ts.video_frame_refs.erase(ref);
+        }
+    }
+    assert(ts.video_cache_bytes >= 0 && "uncharge_video_cache_entry: byte count went negative");
+}
+
+void TimelineMediaBuffer::erase_video_cache_entry(
+        TrackState& ts, TrackState::VideoCache::Entry* e) const {
+    assert(e && "erase_video_cache_entry: null entry");
+    uncharge_video_cache_entry(ts, e->value);
+    ts.video_cache.erase(e);
+}
+
+void TimelineMediaBuffer::store_video_cache_entry(
+        TrackState& ts, int64_t timeline_frame, TrackState::CachedFrame entry) {
+    auto& cache = ts.video_cache;
+
+    // Overwrite: release the old entry's charge first (not an eviction).
+    if (auto* existing = cache.find(timeline_frame)) {
+        erase_video_cache_entry(ts, existing);
+    }
+    while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
+        evict_video_cache_entry(ts);
+    }
+
+    if (entry.frame) {
+        int& refs = ts.video_frame_refs[entry.frame.get()];
+        if (refs++ == 0) {
+            ts.video_cache_bytes += static_cast<int64_t>(entry.frame->data_size());
+        }
+    }
+    // Entries that fall outside the ring window after a long seek are
+    // evictions like any other.
+    cache.insert(timeline_frame, std::move(entry),
+        [this, &ts](const TrackState::VideoCache::Entry& e) {
+            uncharge_video_cache_entry(ts, e.value);
+            ts.video_cache_evictions++;
+        });
+
+    enforce_video_cache_budget(&ts, timeline_frame);
+}
+
+std::unordered_map<TrackId, int64_t, TrackIdHash>
+TimelineMediaBuffer::video_cache_shares() const {
+    // Weight each video track by how soon the compositor will ask it for
+    // frames: clip under the playhead = 2, clip starting within the prefetch
+    // window in the direction of travel = 1, otherwise (ineligible, or a gap
+    // reaching past the window) = 0. A zero-weight track's share is 0, so its
+    // cached frames are the first to go when the budget is exceeded.
+    // Reads only published snapshots — no track locks.
+    const int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
+    const int dir = m_playhead_direction.load(std::memory_order_relaxed);
+    const int64_t budget = m_video_cache_budget.load(std::memory_order_relaxed);
+
+    std::unordered_map<TrackId, int64_t, TrackIdHash> weights;
+    int64_t total_weight = 0;
+    for (const auto& [id, ts] : *tracks()) {
+        if (id.type != TrackType::Video) continue;
+        int64_t w = 0;
+        auto layout = ts->layout();
+        if (track_is_eligible(id.index) && !layout->empty()) {
+            Segment seg = find_segment_at(*layout, playhead);
+            if (seg.type == Segment::CLIP) {
+                w = 2;
+            } else if (dir >= 0 && seg.end != std::numeric_limits<int64_t>::max()
+                       && seg.end - playhead <= VIDEO_PREFETCH_MAX) {
+                w = 1;
+            } else if (dir < 0 && seg.start != std::numeric_limits<int64_t>::min()
+                       && playhead - seg.start <= VIDEO_PREFETCH_MAX) {
+                w = 1;
+            }
+        }
+        weights[id] = w;
+        total_weight += w;
+    }
+
+    std::unordered_map<TrackId, int64_t, TrackIdHash> shares;
+    for (const auto& [id, w] : weights) {
+        shares[id] = total_weight > 0 ? (budget / total_weight) * w : 0;
+    }
+    return shares;
+}
+
+void TimelineMediaBuffer::enforce_video_cache_budget(
+        TrackState* inserting, int64_t protect_tf) {
+    const int64_t budget = m_video_cache_budget.load(std::memory_order_relaxed);
+    const auto map = tracks();
+    auto total_used = [&map]() {
+        int64_t used = 0;
+        for (const auto& [id, ts] : *map) used += ts->video_cache_bytes.load(std::memory_order_relaxed);
+        return used;
+    };
+    if (total_used() <= budget) return;
+
+    const auto shares = video_cache_shares();
+    const int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
+    const int dir = m_playhead_direction.load(std::memory_order_relaxed);
+
+    // Eviction distance: frames already played (behind the playhead in the
+    // direction of travel) rank past every frame inside the prefetch window
+    // ahead. Monotonic away from the playhead on each side, so the maximum
+    // is always at first() or last().
+    auto distance = [playhead, dir](int64_t tf) -> int64_t {
+        int64_t d = tf - playhead;
+        if (dir == 0) return d < 0 ? -d : d;
+        int64_t ahead = d * dir;
+        return ahead >= 0 ? ahead : -ahead + VIDEO_PREFETCH_MAX;
+    };
+
+    struct Candidate { TrackState* ts; int64_t over; };
+    std::vector<Candidate> ranked;
+    while (total_used() > budget) {
+        // Rank tracks by how far over their share they are; evict from the
+        // first one we can lock. The caller already holds `inserting`. Any
+        // other track is try-locked when a track lock is held (blocking on a
+        // second track mutex could deadlock against its owner doing the
+        // same); with no caller lock (SetCacheBudget) blocking is safe.
+        ranked.clear();
+        for (const auto& [id, ts] : *map) {
+            auto share_it = shares.find(id);
+            int64_t share = share_it != shares.end() ? share_it->second : 0;
+            ranked.push_back({ts.get(), ts->video_cache_bytes.load(std::memory_order_relaxed) - share});
         }
+        std::sort(ranked.begin(), ranked.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.over > b.over; });
+
+        bool evicted = false;
+        for (const auto& c : ranked) {
+            TrackState& ts = *c.ts;
+            std::unique_lock<std::mutex> lock;
+            if (&ts != inserting) {
+                if (inserting) {
+                    lock = std::unique_lock<std::mutex>(ts.mutex, std::try_to_lock);
+                    if (!lock.owns_lock()) {
+                        m_lock_contentions.fetch_add(1, std::memory_order_relaxed);
+                        continue;  // busy — its owner trims it on its next insert
+                    }
+                } else {
+                    lock = lock_track(ts);
+                }
+            }
+            auto& cache = ts.video_cache;
+            if (cache.empty()) continue;
+            if (&ts == inserting && cache.size() == 1) continue;  // only protect_tf left
+
+            auto* front = cache.first();
+            auto* back = cache.last();
+            bool protect = (&ts == inserting);
+            TrackState::VideoCache::Entry* e;
+            if (protect && front->key == protect_tf) {
+                e = back;
+            } else if (protect && back->key == protect_tf) {
+                e = front;
+            } else {
+                e = distance(back->key) >= distance(front->key) ? back : front;
+            }
+            erase_video_cache_entry(ts, e);
+            ts.video_cache_evictions++;
+            evicted = true;
+            break;
+        }
+        // Nothing evictable or lockable: only the just-stored frame remains
+        // (budget < one frame), or every over-share track is busy.
+        if (!evicted) break;
     }
-    ts.video_cache.erase(victim);
+}
+
+void TimelineMediaBuffer::SetCacheBudget(int64_t bytes) {
+    assert(bytes > 0 && "SetCacheBudget: budget must be positive");
+    m_video_cache_budget.store(bytes, std::memory_order_relaxed);
+    // Shrink immediately rather than waiting for the next insert.
+    enforce_video_cache_budget(nullptr, 0);
+}
+
+int64_t TimelineMediaBuffer::GetCacheBudget() const {
+    return m_video_cache_budget.load(std::memory_order_relaxed);
+}
+
+TimelineMediaBuffer::VideoCacheStats TimelineMediaBuffer::GetVideoCacheStats() const {
+    VideoCacheStats stats;
+    stats.budget_bytes = m_video_cache_budget.load(std::memory_order_relaxed);
+    const auto shares = video_cache_shares();
+    for (const auto& [id, ts] : *tracks()) {
+        if (id.type != TrackType::Video) continue;
+        auto lock = lock_track(*ts);
+        VideoCacheTrackStats t;
+        t.track = id;
+        t.bytes = ts->video_cache_bytes.load(std::memory_order_relaxed);
+        auto share_it = shares.find(id);
+        t.share_bytes = share_it != shares.end() ? share_it->second : 0;
+        t.entries = static_cast<int64_t>(ts->video_cache.size());
+        t.hits = ts->video_cache_hits;
+        t.misses = ts->video_cache_misses;
+        t.evictions = ts->video_cache_evictions;
+        stats.used_bytes += t.bytes;
+        stats.tracks.push_back(t);
+    }
+    std::sort(stats.tracks.begin(), stats.tracks.end(),
+              [](const VideoCacheTrackStats& a, const VideoCacheTrackStats& b) {
+                  return a.track.index < b.track.index;
+              });
+    return stats;
 }
 
 // ============================================================================
@@ -564,28 +854,32 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
     result.frame = nullptr;
     result.offline = false;
 
-    // Find track and clip
-    std::unique_lock<std::mutex> tracks_lock(m_tracks_mutex);
-    auto track_it = m_tracks.find(track);
-    if (track_it == m_tracks.end()) {
+    // Find track and clip. Segment lookup runs on the published layout
+    // snapshot before the track lock is taken; `layout` keeps seg.clip
+    // valid even if SetTrackClips publishes a new list meanwhile.
+    auto tsp = find_track(track);
+    if (!tsp) {
         return result; // gap — no track data
     }
-    auto& ts = track_it->second;
+    auto& ts = *tsp;
+    const auto layout = ts.layout();
 
-    Segment seg = find_segment_at(ts, timeline_frame);
+    Segment seg = find_segment_at(*layout, timeline_frame);
     if (seg.type == Segment::GAP) {
         // Gap: still wake prefetch so it pre-fills upcoming clips.
         char tbuf[8]; track_str(track, tbuf, sizeof(tbuf));
         EMP_LOG_DEBUG("GetVideoFrame gap: track %s frame %lld, %zu clips [%lld..%lld)",
             tbuf, (long long)timeline_frame,
-            ts.clips.size(),
-            ts.clips.empty() ? -1LL : (long long)ts.clips.front().sequence_start,
-            ts.clips.empty() ? -1LL : (long long)ts.clips.back().sequence_end());
+            layout->size(),
+            layout->empty() ? -1LL : (long long)layout->front().sequence_start,
+            layout->empty() ? -1LL : (long long)layout->back().sequence_end());
         int dir = m_playhead_direction.load(std::memory_order_relaxed);
-        if (dir != 0 && is_video_buffer_low(ts, timeline_frame, dir)) {
-            tracks_lock.unlock();
-            wake_prefetch_workers();
+        bool wake = false;
+        if (dir != 0) {
+            auto tracks_lock = lock_track(ts);
+            wake = is_video_buffer_low(ts, timeline_frame, dir);
         }
+        if (wake) wake_prefetch_workers();
         return result; // gap — no clip at this position
     }
 
@@ -606,25 +900,28 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
         static_cast<int64_t>((timeline_frame - clip->sequence_start) * clip->speed_ratio);
     result.source_frame = source_frame;
 
+    auto tracks_lock = lock_track(ts);
+
     // Check video cache (keyed by timeline_frame for this track)
-    auto cache_it = ts.video_cache.find(timeline_frame);
-    if (cache_it != ts.video_cache.end() &&
-        cache_it->second.clip_id == clip->clip_id &&
-        cache_it->second.source_frame == source_frame) {
+    const auto* cache_it = ts.video_cache.find(timeline_frame);
+    if (cache_it &&
+        cache_it->value.clip_id == clip->clip_id &&
+        cache_it->value.source_frame == source_frame) {
+        ts.video_cache_hits++;
         // Offline marker hit: surface the "not enough media" state to
         // the delivery layer so the red panel renders instead of a
         // frozen previous frame. Set by the decode path below when
         // EOFReached / before-start is observed during prefetch.
-        if (cache_it->second.offline) {
+        if (cache_it->value.offline) {
             result.offline = true;
-            result.error_code = cache_it->second.error_code;
-            result.error_msg = cache_it->second.error_msg;
+            result.error_code = cache_it->value.error_code;
+            result.error_msg = cache_it->value.error_msg;
             return result;
         }
-        result.frame = cache_it->second.frame;
-        result.rotation = cache_it->second.rotation;
-        result.par_num = cache_it->second.par_num;
-        result.par_den = cache_it->second.par_den;
+        result.frame = cache_it->value.frame;
+        result.rotation = cache_it->value.rotation;
+        result.par_num = cache_it->value.par_num;
+        result.par_den = cache_it->value.par_den;
 
         // Wake prefetch if buffer running low during playback
         int dir = m_playhead_direction.load(std::memory_order_relaxed);
@@ -648,7 +945,6 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
         : MAX_NEAREST_DISTANCE_BASE;
     if (cache_only) {
         const std::string& cid = clip->clip_id;
-        auto lo = ts.video_cache.lower_bound(timeline_frame);
         const TrackState::CachedFrame* best = nullptr;
         int64_t best_dist = INT64_MAX;
         int dir = m_playhead_direction.load(std::memory_order_relaxed);
@@ -658,10 +954,14 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
         // lets the offline-registry / cache_only paths below produce the
         // correct offline-is-true result so the delivery layer renders
         // the red "Not enough media" panel instead of a stale neighbor.
-        if (dir >= 0 && lo != ts.video_cache.end()
-            && lo->second.clip_id == cid && !lo->second.offline) {
-            int64_t d = lo->first - timeline_frame;
-            if (d < best_dist && d <= max_nearest_distance) { best = &lo->second; best_dist = d; }
+        // Neighbour lookups are bounded by max_nearest_distance so the
+        // bitmap scan stops where a hit would be rejected anyway.
+        if (dir >= 0) {
+            const auto* lo = ts.video_cache.at_or_after(timeline_frame, max_nearest_distance);
+            if (lo && lo->value.clip_id == cid && !lo->value.offline) {
+                int64_t d = lo->key - timeline_frame;
+                if (d < best_dist) { best = &lo->value; best_dist = d; }
+            }
         }
         // Check entry before timeline_frame. Normal play: only for reverse
         // (`dir <= 0`). Shuttle mode: ALSO for forward play — at >2× the
@@ -670,14 +970,15 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
         // concern that normally rules out look-behind in forward play
         // doesn't apply: the user is scrubbing and expects "show me the
         // closest thing the decoder has, choppy is OK."
-        if ((dir <= 0 || shuttle_mode) && lo != ts.video_cache.begin()) {
-            auto prev = std::prev(lo);
-            if (prev->second.clip_id == cid && !prev->second.offline) {
-                int64_t d = timeline_frame - prev->first;
-                if (d < best_dist && d <= max_nearest_distance) { best = &prev->second; best_dist = d; }
+        if (dir <= 0 || shuttle_mode) {
+            const auto* prev = ts.video_cache.before(timeline_frame, max_nearest_distance);
+            if (prev && prev->value.clip_id == cid && !prev->value.offline) {
+                int64_t d = timeline_frame - prev->key;
+                if (d < best_dist) { best = &prev->value; best_dist = d; }
             }
         }
         if (best) {
+            ts.video_cache_hits++;
             result.frame = best->frame;
             result.source_frame = best->source_frame;
             result.rotation = best->rotation;
@@ -693,8 +994,9 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
     }
 
     int direction = m_playhead_direction.load(std::memory_order_relaxed);
+    ts.video_cache_misses++;
 
-    // Copy clip locals and release tracks_lock first (lock ordering).
+    // Copy clip locals and release the track lock first (lock ordering).
     std::string media_path = clip->media_path;
     std::string clip_id = clip->clip_id;
 
@@ -727,19 +1029,17 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
         diag_dir = m_playhead_direction.load(std::memory_order_relaxed);
         diag_shuttle = shuttle_mode;
         std::snprintf(diag_query_cid, sizeof(diag_query_cid), "%.8s", clip_id.c_str());
-        auto lo = ts.video_cache.lower_bound(timeline_frame);
-        if (lo != ts.video_cache.end()) {
+        if (const auto* lo = ts.video_cache.at_or_after(timeline_frame)) {
             diag_fwd_present = true;
-            diag_fwd_tf = lo->first;
-            std::snprintf(diag_fwd_cid, sizeof(diag_fwd_cid), "%.8s", lo->second.clip_id.c_str());
-            diag_fwd_offline = lo->second.offline;
+            diag_fwd_tf = lo->key;
+            std::snprintf(diag_fwd_cid, sizeof(diag_fwd_cid), "%.8s", lo->value.clip_id.c_str());
+            diag_fwd_offline = lo->value.offline;
         }
-        if (lo != ts.video_cache.begin()) {
-            auto prev = std::prev(lo);
+        if (const auto* prev = ts.video_cache.before(timeline_frame)) {
             diag_bwd_present = true;
-            diag_bwd_tf = prev->first;
-            std::snprintf(diag_bwd_cid, sizeof(diag_bwd_cid), "%.8s", prev->second.clip_id.c_str());
-            diag_bwd_offline = prev->second.offline;
+            diag_bwd_tf = prev->key;
+            std::snprintf(diag_bwd_cid, sizeof(diag_bwd_cid), "%.8s", prev->value.clip_id.c_str());
+            diag_bwd_offline = prev->value.offline;
         }
     }
     tracks_lock.unlock();
@@ -805,19 +1105,16 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
     // Cache re-check: REFILL worker may have populated our frame while we
     // waited for the reader's use_mutex. Avoid redundant decode.
     {
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto cache_it2 = tit->second.video_cache.find(timeline_frame);
-            if (cache_it2 != tit->second.video_cache.end() &&
-                cache_it2->second.clip_id == clip_id &&
-                cache_it2->second.source_frame == source_frame) {
-                result.frame = cache_it2->second.frame;
-                result.rotation = cache_it2->second.rotation;
-                result.par_num = cache_it2->second.par_num;
-                result.par_den = cache_it2->second.par_den;
-                return result;
-            }
+        auto tlock = lock_track(ts);
+        const auto* cache_it2 = ts.video_cache.find(timeline_frame);
+        if (cache_it2 &&
+            cache_it2->value.clip_id == clip_id &&
+            cache_it2->value.source_frame == source_frame) {
+            result.frame = cache_it2->value.frame;
+            result.rotation = cache_it2->value.rotation;
+            result.par_num = cache_it2->value.par_num;
+            result.par_den = cache_it2->value.par_den;
+            return result;
         }
     }
 
@@ -846,24 +1143,19 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
         // Cache the offline marker so cache_only play-time lookups
         // return offline=true without waiting for prefetch to re-decode.
         {
-            std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-            auto tit = m_tracks.find(track);
-            if (tit != m_tracks.end()) {
-                auto& cache = tit->second.video_cache;
-                while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                    evict_video_cache_entry(tit->second);
-                }
+            auto tit = find_track(track);
+            if (tit) {
+                auto tlock = lock_track(*tit);
                 TrackState::CachedFrame entry{};
                 entry.clip_id = clip_id;
                 entry.source_frame = source_frame;
                 entry.rotation = result.rotation;
                 entry.par_num = result.par_num;
                 entry.par_den = result.par_den;
-                entry.insert_seq = tit->second.video_cache_seq++;
                 entry.offline = true;
                 entry.error_code = result.error_code;
                 entry.error_msg = result.error_msg;
-                cache[timeline_frame] = std::move(entry);
+                store_video_cache_entry(*tit, timeline_frame, std::move(entry));
             }
         }
         EMP_LOG_DEBUG("GetVideoFrame: before-start clip=%.8s tf=%lld file_frame=%lld",
@@ -877,24 +1169,19 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
     // exactly on file frame boundaries.
     Rate file_rate = info.video_rate();
     FrameTime ft = FrameTime::from_frame(file_frame, file_rate);
+    reader->SetShuttleDecode(shuttle_mode);
     auto decode_result = reader->DecodeAt(ft);
 
     if (decode_result.is_ok()) {
         result.frame = decode_result.value();
 
         // Cache the decoded frame (including metadata for cache-hit path)
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto& cache = tit->second.video_cache;
-
-            while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                evict_video_cache_entry(tit->second);
-            }
-
-            cache[timeline_frame] = {clip_id, source_frame, result.frame,
-                                     result.rotation, result.par_num, result.par_den,
-                                     tit->second.video_cache_seq++};
+        auto tit = find_track(track);
+        if (tit) {
+            auto tlock = lock_track(*tit);
+            store_video_cache_entry(*tit, timeline_frame,
+                {clip_id, source_frame, result.frame,
+                 result.rotation, result.par_num, result.par_den});
         }
     } else {
         // Decode failure. Split by error code:
@@ -917,24 +1204,19 @@ VideoResult TimelineMediaBuffer::GetVideoFrame(TrackId track, int64_t timeline_f
             // decoded frame (freeze) or the cache_only early-return
             // gives a nil frame with offline=false — both appear as
             // easily-missable black/stale content during playback.
-            std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-            auto tit = m_tracks.find(track);
-            if (tit != m_tracks.end()) {
-                auto& cache = tit->second.video_cache;
-                while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                    evict_video_cache_entry(tit->second);
-                }
+            auto tit = find_track(track);
+            if (tit) {
+                auto tlock = lock_track(*tit);
                 TrackState::CachedFrame entry{};
                 entry.clip_id = clip_id;
                 entry.source_frame = source_frame;
                 entry.rotation = result.rotation;
                 entry.par_num = result.par_num;
                 entry.par_den = result.par_den;
-                entry.insert_seq = tit->second.video_cache_seq++;
                 entry.offline = true;
                 entry.error_code = result.error_code;
                 entry.error_msg = result.error_msg;
-                cache[timeline_frame] = std::move(entry);
+                store_video_cache_entry(*tit, timeline_frame, std::move(entry));
             }
             EMP_LOG_DEBUG("GetVideoFrame: past-end clip=%.8s tf=%lld file_frame=%lld",
                 clip_id.c_str(), (long long)timeline_frame, (long long)file_frame);
@@ -979,11 +1261,11 @@ void TimelineMediaBuffer::SetAudioFormat(const AudioFormat& fmt) {
 // find_segment_at_us — microsecond segment finder (audio path)
 // ============================================================================
 
-SegmentUS TimelineMediaBuffer::find_segment_at_us(const TrackState& ts, TimeUS t_us) const {
+SegmentUS TimelineMediaBuffer::find_segment_at_us(const ClipLayout& clips, TimeUS t_us) const {
     assert(m_seq_rate.num > 0 && "find_segment_at_us: SetSequenceRate not called");
 
     // Check if t_us falls inside any clip
-    for (const auto& clip : ts.clips) {
+    for (const auto& clip : clips) {
         assert(clip.rate_den > 0 && "find_segment_at_us: clip has zero rate_den");
         TimeUS start = FrameTime::from_frame(clip.sequence_start, m_seq_rate).to_us();
         TimeUS end = FrameTime::from_frame(clip.sequence_end(), m_seq_rate).to_us();
@@ -996,7 +1278,7 @@ SegmentUS TimelineMediaBuffer::find_segment_at_us(const TrackState& ts, TimeUS t
     TimeUS gap_start = std::numeric_limits<TimeUS>::min();
     TimeUS gap_end = std::numeric_limits<TimeUS>::max();
 
-    for (const auto& clip : ts.clips) {
+    for (const auto& clip : clips) {
         TimeUS clip_end = FrameTime::from_frame(clip.sequence_end(), m_seq_rate).to_us();
         TimeUS clip_start = FrameTime::from_frame(clip.sequence_start, m_seq_rate).to_us();
 
@@ -1159,25 +1441,26 @@ std::shared_ptr<PcmChunk> TimelineMediaBuffer::GetTrackAudio(
     assert(t1 > t0 && "GetTrackAudio: t1 must be greater than t0");
     assert(m_seq_rate.num > 0 && "GetTrackAudio: SetSequenceRate not called");
 
-    // Find track
-    std::unique_lock<std::mutex> tracks_lock(m_tracks_mutex);
-    auto track_it = m_tracks.find(track);
-    if (track_it == m_tracks.end()) {
+    // Find track. Segment lookup runs on the layout snapshot (lock-free);
+    // the track lock is only needed for the audio cache and watermark.
+    auto tsp = find_track(track);
+    if (!tsp) {
         return nullptr;  // Track not yet populated — silence (not offline)
     }
-    auto& ts = track_it->second;
+    auto& ts = *tsp;
+    const auto layout = ts.layout();
 
     // Find segment at t0. If it's a gap, skip to the next clip within [t0, t1).
     // Without this, a request spanning gap+clip (e.g., [2.0s..3.3s) where the
     // gap ends at 2.5s) would return null, silencing the entire range.
-    SegmentUS seg = find_segment_at_us(ts, t0);
+    SegmentUS seg = find_segment_at_us(*layout, t0);
     if (seg.type == SegmentUS::GAP) {
         if (seg.end_us >= t1) {
             return nullptr;  // gap covers entire range — silence is correct
         }
         // Advance past gap into the next clip
         t0 = seg.end_us;
-        seg = find_segment_at_us(ts, t0);
+        seg = find_segment_at_us(*layout, t0);
         if (seg.type == SegmentUS::GAP) {
             return nullptr;  // consecutive gaps or past all content
         }
@@ -1205,6 +1488,7 @@ std::shared_ptr<PcmChunk> TimelineMediaBuffer::GetTrackAudio(
     }
 
     // Check audio cache before decode (uses timeline coords, not source coords)
+    auto tracks_lock = lock_track(ts);
     std::string clip_id = clip->clip_id;
     auto cached = check_audio_cache(ts, clip_id, clamped_t0, clamped_t1, fmt);
 
@@ -1316,10 +1600,10 @@ std::shared_ptr<PcmChunk> TimelineMediaBuffer::GetTrackAudio(
     // the same caller after a backward seek) hit the cache instead of re-decoding.
     // This prevents the Reader from being asked to go backwards.
     if (first_chunk && first_chunk->frames() > 0) {
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto& cache = tit->second.audio_cache;
+        auto tit = find_track(track);
+        if (tit) {
+            auto tlock = lock_track(*tit);
+            auto& cache = tit->audio_cache;
             while (cache.size() >= TrackState::MAX_AUDIO_CACHE) {
                 cache.erase(cache.begin());
             }
@@ -1344,11 +1628,12 @@ std::shared_ptr<PcmChunk> TimelineMediaBuffer::GetTrackAudio(
     TimeUS cursor = first_clip_end_us;
 
     while (cursor < t1) {
-        std::unique_lock<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit == m_tracks.end()) break;
+        auto tit = find_track(track);
+        if (!tit) break;
+        const auto next_layout = tit->layout();
+        auto tlock = lock_track(*tit);
 
-        SegmentUS next_seg = find_segment_at_us(tit->second, cursor);
+        SegmentUS next_seg = find_segment_at_us(*next_layout, cursor);
         if (next_seg.type == SegmentUS::GAP) {
             // Skip past gap to next clip
             if (next_seg.end_us >= t1 || next_seg.end_us == std::numeric_limits<TimeUS>::max()) break;
@@ -1372,7 +1657,7 @@ std::shared_ptr<PcmChunk> TimelineMediaBuffer::GetTrackAudio(
 
         // Check audio cache before decode
         std::string next_clip_id = next->clip_id;
-        auto next_cached = check_audio_cache(tit->second, next_clip_id, seg_t0, seg_t1, fmt);
+        auto next_cached = check_audio_cache(*tit, next_clip_id, seg_t0, seg_t1, fmt);
         if (next_cached) {
             segments.push_back({next_cached, seg_t0});
             if (seg_t1 > output_end) output_end = seg_t1;
@@ -1490,14 +1775,14 @@ bool TimelineMediaBuffer::is_audio_buffer_low(const TrackState& ts, TimeUS playh
 }
 
 void TimelineMediaBuffer::wake_prefetch_workers() {
-    m_jobs_cv.notify_all();
+    m_scheduler.notify();
 }
 
 void TimelineMediaBuffer::discard_already_played_prefetch(const TrackId& track) {
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
-    auto it = m_tracks.find(track);
-    if (it == m_tracks.end()) return;
-    auto& ts = it->second;
+    auto tsp = find_track(track);
+    if (!tsp) return;
+    auto& ts = *tsp;
+    auto lock = lock_track(ts);
 
     int dir = m_playhead_direction.load(std::memory_order_relaxed);
     if (dir == 0) return;
@@ -1539,36 +1824,171 @@ int TimelineMediaBuffer::stride_for_clip(const TrackId& track, const ClipInfo& c
 
     std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
     auto dit = m_decode_speed_cache.find(std::make_pair(track, clip.media_path));
-    if (dit == m_decode_speed_cache.end()) return 1;
-    if (dit->second <= 0) return 1;  // sentinel: first sample only, need second
+    auto rit = m_keyframe_reach.find(clip.media_path);
+    const double reach = (rit != m_keyframe_reach.end()) ? rit->second : 1.0;
 
     // Higher speed → tighter effective_period → wider stride. Per-clip single-
     // threaded (claim_track_for_prefetch); slower CPU shows up as higher
     // decode_ms → wider stride, so graceful degradation falls out naturally.
     float speed = std::max(1.0f, std::abs(m_playhead_speed.load(std::memory_order_relaxed)));
+    const bool shuttle = speed > SHUTTLE_FREE_RUN_SPEED;
+
+    // Shuttle decodes keyframes only (Reader::SetShuttleDecode): a stride
+    // shorter than the GOP lands on the keyframe already decoded. The mean
+    // reach r of a file of n-frame GOPs is (n + 1) / 2, so n = 2r - 1.
+    const int gop_floor = shuttle
+        ? std::max(1, static_cast<int>(std::lround(2.0 * reach - 1.0))) : 1;
+    auto clamp = [&](int stride) {
+        return shuttle ? std::min(std::max(stride, gop_floor), MAX_SHUTTLE_STRIDE)
+                       : std::min(stride, MAX_STRIDE);
+    };
+
+    if (dit == m_decode_speed_cache.end()) return clamp(1);
+    if (dit->second <= 0) return clamp(1);  // sentinel: first sample only, need second
+
     double frame_period_ms = 1000.0 * clip.rate_den / clip.rate_num;
     double effective_period = frame_period_ms / speed;
     assert(effective_period > 0 && "stride_for_clip: effective_period must be positive");
-    if (dit->second <= effective_period * 1.5) return 1;
+    if (dit->second <= effective_period * 1.5) return clamp(1);
+
+    // A strided frame isn't one decode: reaching it decodes forward from
+    // whichever is nearer, its keyframe or the previous strided frame. For
+    // intra-only media reach is 1; for long-GOP media the keyframe index
+    // supplies the mean reach. So the cost is per_frame × min(stride,
+    // reach). Shuttle's keyframe-only decode is one frame whatever the GOP.
+    const double reach_frames = shuttle ? 1.0 : reach;
+    auto strided_cost_ms = [&](int s) {
+        return dit->second * std::min(static_cast<double>(s), reach_frames);
+    };
+
+    // Smallest stride whose spare time covers its cost:
+    // (stride - 1) × effective_period ≥ cost(stride). The -1 is padding —
+    // without it the margin is ~20ms and any jitter causes permanent
+    // behind-ness; with it the margin is ~1 frame period (~40ms at 25fps),
+    // enough to absorb I/O stalls, thread scheduling, and recover from
+    // brief deficits. Below reach the cost grows a per_frame per step,
+    // faster than the period it buys (decode is > 1.5 periods here), so
+    // the answer lies at or past reach unless the cap (MAX_STRIDE against
+    // a long GOP) cuts it short — then the cap wins.
+    const int max_stride = shuttle ? MAX_SHUTTLE_STRIDE : MAX_STRIDE;
+    int stride = 1;
+    while (stride < max_stride &&
+           (stride - 1) * effective_period < strided_cost_ms(stride)) {
+        ++stride;
+    }
+    return clamp(stride);
+}
+
+void TimelineMediaBuffer::note_keyframe_index(const std::string& path,
+                                              const KeyframeIndex& index) {
+    std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+    m_keyframe_reach[path] = static_cast<float>(index.MeanFramesToReach());
+}
+
+// Called wherever TMB opens a MediaFile. Open already found any index the
+// registry, disk cache, or container could supply; a file with none gets
+// one background scan. m_keyframe_reach doubles as the "already handled"
+// set — a failed scan records 1.0 (the unknown default) so the next pool
+// miss doesn't rescan the whole file.
+void TimelineMediaBuffer::ensure_keyframe_index(const TrackId& track, const std::string& path,
+                                                const MediaFile& mf) {
+    if (auto kf = mf.keyframe_index()) {
+        note_keyframe_index(path, *kf);
+        return;
+    }
+    if (track.type != TrackType::Video || mf.content_hash() == 0) return;
+    {
+        std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+        if (m_keyframe_reach.count(path)) return;
+    }
+    PreBufferJob scan;
+    scan.type = PreBufferJob::KEYFRAME_INDEX;
+    scan.track = track;
+    scan.media_path = path;
+    submit_pre_buffer(scan);
+}
+
+// ============================================================================
+// Video prefetch deadlines (EDF)
+// ============================================================================
+//
+// Each video prefetch decode has a display deadline: the wall time at which
+// its frame is shown, extrapolated from the SetPlayhead anchor at the
+// clock's advance rate. pick_video_track serves the track whose next
+// needed frame is due first, so in a multicam stack the track about to hit
+// a cut wins over tracks coasting through gaps or far ahead of need.
+// fill_prefetch drops a decode ahead of the playhead that can't finish
+// before its deadline — the frame would be stale on arrival and the time is
+// better spent on frames that can still make it. The frame at the playhead
+// itself is never dropped: its deadline is the anchor, so on a cold start
+// it is always "late", and it is the one frame the display needs now.
+
+int64_t TimelineMediaBuffer::frame_deadline_ns(int64_t frame) const {
+    const double fps = m_playhead_frames_per_sec.load(std::memory_order_relaxed);
+    const int dir = m_playhead_direction.load(std::memory_order_relaxed);
+    if (fps <= 0.0 || dir == 0) return std::numeric_limits<int64_t>::max();
+    const int64_t anchor_ns = m_playhead_wall_ns.load(std::memory_order_relaxed);
+    const int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
+    const double frames_ahead = static_cast<double>((frame - playhead) * dir);
+    return anchor_ns + static_cast<int64_t>(frames_ahead * 1e9 / fps);
+}
+
+int64_t TimelineMediaBuffer::deadline_clock_ns() const {
+    if (auto clock = m_deadline_clock.load(std::memory_order_relaxed)) return clock();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TimelineMediaBuffer::SetDeadlineClock(int64_t (*now_ns)()) {
+    m_deadline_clock.store(now_ns, std::memory_order_relaxed);
+}
+
+int64_t TimelineMediaBuffer::deadline_now_ns() const {
+    const int64_t now_ns = deadline_clock_ns();
+    const int64_t cap_ns = m_playhead_wall_ns.load(std::memory_order_relaxed)
+        + int64_t(DEADLINE_EXTRAPOLATION_MAX_MS) * 1000000;
+    return std::min(now_ns, cap_ns);
+}
 
-    // +1 padding: ceil gives the minimum stride to break even with decode cost.
-    // Without padding, margin is ~20ms — any jitter causes permanent behind-ness.
-    // With +1, margin is ~1 frame period (~40ms at 25fps), enough to absorb
-    // I/O stalls, thread scheduling, and recover from brief deficits.
-    int stride = static_cast<int>(std::ceil(dit->second / effective_period)) + 1;
-    return std::min(stride, MAX_STRIDE);
+int64_t TimelineMediaBuffer::expected_decode_ns(const TrackId& track, const ClipInfo& clip) const {
+    std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+    auto dit = m_decode_speed_cache.find(std::make_pair(track, clip.media_path));
+    if (dit == m_decode_speed_cache.end() || dit->second <= 0) return 0;  // unknown / sentinel
+    return static_cast<int64_t>(dit->second * 1e6);
+}
+
+int64_t TimelineMediaBuffer::next_content_frame(const ClipLayout& clips, int64_t from,
+                                                int direction, int64_t limit) const {
+    assert((direction == 1 || direction == -1) &&
+           "next_content_frame: direction must be +1 or -1");
+    int64_t pos = from;
+    // Each step either lands in a clip or jumps a whole gap, so the loop is
+    // bounded by the clip count.
+    for (size_t step = 0; step <= clips.size(); ++step) {
+        if ((limit - pos) * direction <= 0) return -1;
+        Segment seg = find_segment_at(clips, pos);
+        if (seg.type == Segment::CLIP) return pos;
+        if (direction > 0) {
+            if (seg.end >= std::numeric_limits<int64_t>::max()) return -1;
+            pos = seg.end;
+        } else {
+            if (seg.start <= std::numeric_limits<int64_t>::min()) return -1;
+            pos = seg.start - 1;
+        }
+    }
+    return -1;
 }
 
 void TimelineMediaBuffer::set_already_fetched_video(const TrackId& track, int64_t pos, int direction) {
     assert((direction == 1 || direction == -1) &&
            "set_already_fetched_video: direction must be +1 or -1");
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
-    auto it = m_tracks.find(track);
-    if (it != m_tracks.end()) {
+    auto ts = find_track(track);
+    if (ts) {
+        auto lock = lock_track(*ts);
         // Direction-aware monotonic advance: never regress in direction of travel
-        if (it->second.video_buffer_end < 0 ||
-            (pos - it->second.video_buffer_end) * direction > 0) {
-            it->second.video_buffer_end = pos;
+        if (ts->video_buffer_end < 0 ||
+            (pos - ts->video_buffer_end) * direction > 0) {
+            ts->video_buffer_end = pos;
         }
     }
 }
@@ -1578,21 +1998,21 @@ void TimelineMediaBuffer::AdvanceVideoBufferEnd(TrackId track, int64_t pos, int
 }
 
 int64_t TimelineMediaBuffer::GetVideoBufferEnd(TrackId track) const {
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
-    auto it = m_tracks.find(track);
-    if (it == m_tracks.end()) return -1;
-    return it->second.video_buffer_end;
+    auto ts = find_track(track);
+    if (!ts) return -1;
+    auto lock = lock_track(*ts);
+    return ts->video_buffer_end;
 }
 
 void TimelineMediaBuffer::set_already_fetched_audio(const TrackId& track, TimeUS pos, int direction) {
     assert((direction == 1 || direction == -1) &&
            "set_already_fetched_audio: direction must be +1 or -1");
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
-    auto it = m_tracks.find(track);
-    if (it != m_tracks.end()) {
-        if (it->second.audio_buffer_end < 0 ||
-            (pos - it->second.audio_buffer_end) * direction > 0) {
-            it->second.audio_buffer_end = pos;
+    auto ts = find_track(track);
+    if (ts) {
+        auto lock = lock_track(*ts);
+        if (ts->audio_buffer_end < 0 ||
+            (pos - ts->audio_buffer_end) * direction > 0) {
+            ts->audio_buffer_end = pos;
         }
     }
 }
@@ -1710,9 +2130,8 @@ void TimelineMediaBuffer::SetAudioMixParams(
     // Log mix params (fires each time params change — low frequency)
     for (const auto& p : params) {
         TrackId tid{TrackType::Audio, p.track_index};
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto it = m_tracks.find(tid);
-        int clip_count = (it != m_tracks.end()) ? static_cast<int>(it->second.clips.size()) : -1;
+        auto ts = find_track(tid);
+        int clip_count = ts ? static_cast<int>(ts->layout()->size()) : -1;
         EMP_LOG_DEBUG("SetAudioMixParams: A%d vol=%.2f clips_in_tmb=%d",
             p.track_index, p.volume, clip_count);
     }
@@ -1744,6 +2163,11 @@ std::shared_ptr<PcmChunk> TimelineMediaBuffer::GetMixedAudio(TimeUS t0, TimeUS t
     return execute_mix_range(params, fmt, t0, t1);
 }
 
+void TimelineMediaBuffer::SetAudioReadyCallback(std::function<void()> cb) {
+    std::lock_guard<std::mutex> lock(m_audio_ready_mutex);
+    m_audio_ready_cb = std::move(cb);
+}
+
 // ============================================================================
 // execute_mix_range — per-track decode + volume-weighted sum
 // ============================================================================
@@ -1910,9 +2334,13 @@ void TimelineMediaBuffer::mix_thread_loop() {
         auto pcm = execute_mix_range(params, fmt, chunk_t0, chunk_t1);
 
         if (pcm && pcm->frames() > 0) {
-            std::lock_guard<std::mutex> lock(m_mix_mutex);
-            m_mixed_cache.append(pcm, direction);
-            m_mixed_cache.evict_behind(playhead_us, direction);
+            {
+                std::lock_guard<std::mutex> lock(m_mix_mutex);
+                m_mixed_cache.append(pcm, direction);
+                m_mixed_cache.evict_behind(playhead_us, direction);
+            }
+            std::lock_guard<std::mutex> lock(m_audio_ready_mutex);
+            if (m_audio_ready_cb) m_audio_ready_cb();
         }
       } catch (const JveAssertError& e) {
         EMP_LOG_WARN("mix_thread_loop: assert caught (continuing): %s", e.what());
@@ -1939,6 +2367,10 @@ Result<MediaFileInfo> TimelineMediaBuffer::ProbeFile(const std::string& path) {
 void TimelineMediaBuffer::SetTcOverrides(std::unordered_map<std::string, TcOverride> overrides) {
     std::lock_guard<std::mutex> lock(m_pool_mutex);
     m_tc_overrides = std::move(overrides);
+    // Shared MediaFiles carry the override they were opened with; drop them
+    // so the next pool miss reopens under the new table. Live readers keep
+    // theirs, as before.
+    m_media_files.clear();
     if (!m_tc_overrides.empty()) {
         EMP_LOG_DEBUG("TMB: %zu TC origin override(s) set", m_tc_overrides.size());
     }
@@ -2006,15 +2438,17 @@ void TimelineMediaBuffer::ParkReaders() {
     m_playhead_direction.store(0, std::memory_order_relaxed);
 
     // 2. Clear pending decode-prep jobs, in-flight tracking, and prefetch claims.
+    // Queue and dedup keys are cleared together under m_jobs_mutex (which
+    // submit_pre_buffer holds across its push) so no key outlives its job.
     // Wake workers so they see direction==0 and park.
     {
         std::lock_guard<std::mutex> lock(m_jobs_mutex);
-        m_jobs.clear();
+        if (m_scheduler.worker_count() > 0) m_scheduler.clear(DecodeClass::Warm);
         m_pre_buffering.clear();
         m_video_prefetching.clear();
         m_audio_prefetching.clear();
     }
-    m_jobs_cv.notify_all();
+    wake_prefetch_workers();
 
     // 3. Reset buffer_ends and per-clip EOF markers.
     // EOF markers must be cleared: they're an optimization to avoid repeated
@@ -2022,14 +2456,21 @@ void TimelineMediaBuffer::ParkReaders() {
     // play), the playhead may be at a decodable position — stale EOF markers
     // would block GetVideoFrame's Play path (source_frame >= eof check).
     // Prefetch re-discovers the actual EOF boundary during the new session.
-    {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        for (auto& [track, ts] : m_tracks) {
-            ts.video_buffer_end = -1;
-            ts.audio_buffer_end = -1;
-            ts.clip_eof_frame.clear();
-            ts.audio_cache.clear();
-        }
+    for (const auto& [track, ts] : *tracks()) {
+        auto lock = lock_track(*ts);
+        ts->video_buffer_end = -1;
+        ts->audio_buffer_end = -1;
+        ts->clip_eof_frame.clear();
+        ts->audio_cache.clear();
+    }
+
+    // 4. Hand idle frame-buffer pages back to the OS. Cached frames keep
+    // theirs; buffers freed during playback (evictions, consumed prefetch)
+    // stay mapped for the next session but stop costing RAM.
+    int64_t trimmed = TrimFrameArena();
+    if (trimmed > 0) {
+        EMP_LOG_DEBUG("ParkReaders: trimmed %lld MB of idle frame buffers",
+                      (long long)(trimmed >> 20));
     }
 }
 
@@ -2039,10 +2480,19 @@ void TimelineMediaBuffer::ParkReaders() {
 
 void TimelineMediaBuffer::ReleaseTrack(TrackId track) {
     // Remove track state
+    std::shared_ptr<TrackState> removed;
     {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        m_tracks.erase(track);
+        auto lock = lock_counted(m_tracks_mutex);
+        auto map = tracks();
+        auto it = map->find(track);
+        if (it != map->end()) {
+            removed = it->second;
+            auto next = std::make_shared<TrackMap>(*map);
+            next->erase(track);
+            publish_tracks(std::move(next));
+        }
     }
+    if (removed) retire_track(*removed);
 
     // Release readers for this track
     std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
@@ -2056,10 +2506,13 @@ void TimelineMediaBuffer::ReleaseTrack(TrackId track) {
 }
 
 void TimelineMediaBuffer::ReleaseAll() {
+    std::shared_ptr<const TrackMap> old;
     {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        m_tracks.clear();
+        auto lock = lock_counted(m_tracks_mutex);
+        old = tracks();
+        publish_tracks(std::make_shared<const TrackMap>());
     }
+    for (const auto& [id, ts] : *old) retire_track(*ts);
     {
         std::lock_guard<std::mutex> lock(m_pool_mutex);
         m_readers.clear();
@@ -2077,6 +2530,9 @@ void TimelineMediaBuffer::ClearOffline(const std::string& path) {
 }
 
 void TimelineMediaBuffer::InvalidatePath(const std::string& path) {
+    // Phase 0: the local extent cache's copies of the old bytes (emp_io.h).
+    InvalidateIoExtentCache(path);
+
     // Phase 1: reader pool + decode-speed hint (m_pool_mutex).
     // Move evicted readers out and let them destruct OUTSIDE the lock —
     // Reader destruction may run VT teardown (slow) and must not block
@@ -2099,29 +2555,32 @@ void TimelineMediaBuffer::InvalidatePath(const std::string& path) {
                 ++it;
             }
         }
+        m_keyframe_reach.erase(path);
+        m_media_files.erase(path);
         // m_offline: leave untouched. Content rewrite of an already-offline
         // path (unusual) stays offline; ClearOffline handles the "file
         // reappeared" transition separately.
     }
 
-    // Phase 2: per-track caches (m_tracks_mutex). Video/audio caches key
-    // on clip_id, so resolve clip_ids whose media_path matches first.
+    // Phase 2: per-track caches (each track's own lock, one at a time).
+    // Video/audio caches key on clip_id, so resolve clip_ids whose
+    // media_path matches first.
     {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        for (auto& kv : m_tracks) {
-            auto& ts = kv.second;
+        for (const auto& kv : *tracks()) {
+            auto& ts = *kv.second;
             std::unordered_set<std::string> matching_clip_ids;
-            for (const auto& c : ts.clips) {
+            for (const auto& c : *ts.layout()) {
                 if (c.media_path == path) matching_clip_ids.insert(c.clip_id);
             }
             if (matching_clip_ids.empty()) continue;
-            for (auto it = ts.video_cache.begin(); it != ts.video_cache.end(); ) {
-                if (matching_clip_ids.count(it->second.clip_id)) {
-                    it = ts.video_cache.erase(it);
-                } else {
-                    ++it;
-                }
-            }
+            auto lock = lock_track(ts);
+            ts.video_cache.erase_if(
+                [&matching_clip_ids](const TrackState::VideoCache::Entry& e) {
+                    return matching_clip_ids.count(e.value.clip_id) > 0;
+                },
+                [this, &ts](const TrackState::VideoCache::Entry& e) {
+                    uncharge_video_cache_entry(ts, e.value);
+                });
             for (auto it = ts.audio_cache.begin(); it != ts.audio_cache.end(); ) {
                 if (matching_clip_ids.count(it->clip_id)) {
                     it = ts.audio_cache.erase(it);
@@ -2161,6 +2620,40 @@ void TimelineMediaBuffer::InvalidatePath(const std::string& path) {
 // Reader pool — LRU with per-(track, path) isolation
 // ============================================================================
 
+Result<std::shared_ptr<MediaFile>> TimelineMediaBuffer::open_media_file(const std::string& path) {
+    {
+        std::lock_guard<std::mutex> lock(m_pool_mutex);
+        auto it = m_media_files.find(path);
+        if (it != m_media_files.end()) {
+            if (auto live = it->second.lock()) return live;
+        }
+    }
+
+    // Open outside the lock (~86ms on external drives). Two threads missing
+    // the same path both open; the first to publish wins and the loser's
+    // MediaFile is dropped before any Reader sees it.
+    m_media_file_opens.fetch_add(1, std::memory_order_relaxed);
+    auto result = MediaFile::Open(path);
+    if (result.is_error()) return result.error();
+    auto mf = result.value();
+
+    std::lock_guard<std::mutex> lock(m_pool_mutex);
+    auto& slot = m_media_files[path];
+    if (auto live = slot.lock()) return live;
+    // TC origin override (FR-004). Must land before the first
+    // Reader::Create, which calls mark_decode_started.
+    auto tc_it = m_tc_overrides.find(path);
+    if (tc_it != m_tc_overrides.end()) {
+        mf->set_tc_origin_override(tc_it->second.first_frame_tc,
+                                   tc_it->second.first_sample_tc);
+    }
+    slot = mf;
+    for (auto it = m_media_files.begin(); it != m_media_files.end(); ) {
+        it = it->second.expired() ? m_media_files.erase(it) : std::next(it);
+    }
+    return mf;
+}
+
 TimelineMediaBuffer::ReaderHandle TimelineMediaBuffer::acquire_reader(
         TrackId track, const std::string& clip_id, const std::string& path) {
 
@@ -2185,11 +2678,12 @@ TimelineMediaBuffer::ReaderHandle TimelineMediaBuffer::acquire_reader(
         return ReaderHandle{reader, use_mtx, std::unique_lock<std::mutex>(*use_mtx)};
     }
 
-    // Phase 2 (NO lock ~86ms on external drives): MediaFile::Open + Reader::Create
+    // Phase 2 (NO lock ~86ms on external drives): MediaFile::Open (first
+    // reader on the path only — see open_media_file) + Reader::Create
     // Only FileNotFound errors register in m_offline (permanent blacklist until
     // ClearOffline). Other errors (Unsupported, Internal) are per-attempt — the
     // path is NOT blacklisted so TMB retries on next access (codec install, etc.).
-    auto mf_result = MediaFile::Open(path);
+    auto mf_result = open_media_file(path);
     if (mf_result.is_error()) {
         auto& err = mf_result.error();
         if (err.code == ErrorCode::FileNotFound) {
@@ -2201,16 +2695,7 @@ TimelineMediaBuffer::ReaderHandle TimelineMediaBuffer::acquire_reader(
         return ReaderHandle{};
     }
     auto mf = mf_result.value();
-
-    // Apply TC origin override if caller provided one for this path (FR-004).
-    // Must happen before Reader::Create (which calls mark_decode_started).
-    {
-        auto tc_it = m_tc_overrides.find(path);
-        if (tc_it != m_tc_overrides.end()) {
-            mf->set_tc_origin_override(tc_it->second.first_frame_tc,
-                                        tc_it->second.first_sample_tc);
-        }
-    }
+    ensure_keyframe_index(track, path, *mf);
 
     auto reader_result = Reader::Create(mf);
     if (reader_result.is_error()) {
@@ -2234,6 +2719,10 @@ TimelineMediaBuffer::ReaderHandle TimelineMediaBuffer::acquire_reader(
     if (m_seq_width > 0 && m_seq_height > 0) {
         new_reader->SetMaxOutputResolution(m_seq_width, m_seq_height);
     }
+    // Cache frames as planar YUV where the format allows: a 4:2:0 frame is
+    // 1.5 bytes/pixel against BGRA's 4, so the same byte budget holds ~2.5x
+    // the frames. Display surfaces convert via Frame::CopyBGRA.
+    new_reader->SetYuvOutput(true);
 
     // Phase 3 (under lock): install into pool or discard if another thread raced.
     // Evicted readers + log data collected under lock, then destructor + fprintf
@@ -2349,64 +2838,91 @@ std::string TimelineMediaBuffer::snapshot_pool_state(const char* action, const T
 
 void TimelineMediaBuffer::start_workers(int count) {
     m_shutdown.store(false);
-    assert(count >= MIN_POOL_THREADS && "start_workers: need >= MIN_POOL_THREADS (1 prep + 1 video + 1 audio)");
-
-    // 1 prep worker (SPEED_DETECT, READER_WARM — can block on codec init).
-    // N-2 video workers (prefetch only — never blocked by prep jobs).
-    // 1 audio worker.
-    // This prevents SPEED_DETECT (up to 264ms for H.264 VT init) from
-    // starving video prefetch, which caused frame drops on clip transitions.
-    m_workers.emplace_back(&TimelineMediaBuffer::prep_worker, this);
-    for (int i = 0; i < count - 2; ++i) {
-        m_workers.emplace_back(&TimelineMediaBuffer::prefetch_worker, this);
+    assert(count >= MIN_POOL_THREADS && "start_workers: need >= MIN_POOL_THREADS (1 reserved + 2 warm-capable)");
+
+    // Uniform workers over a work-stealing scheduler. The old layout
+    // (1 prep + N-2 video + 1 audio) hard-partitioned the pool: at 32×
+    // shuttle ~50 READER_WARM jobs queued behind the single prep thread
+    // while video threads idled on full buffers, and a starving audio track
+    // couldn't borrow a video thread. Now every worker takes the most urgent
+    // class first — audio refill, imminent video, warm, speculative video.
+    //
+    // Worker 0 is reserved: it never runs prep jobs. SPEED_DETECT can block
+    // for up to 264ms on H.264 VT init, and a burst of them must not occupy
+    // every thread while an audio or imminent video track starves — the
+    // failure the dedicated prep thread was originally introduced for.
+    m_scheduler.reset(count);
+    m_scheduler.set_worker_classes(0, kAllDecodeClasses & ~decode_class_bit(DecodeClass::Warm));
+    m_scheduler.set_source(DecodeClass::AudioRefill,
+        [this](int) { return run_audio_refill(); });
+    m_scheduler.set_source(DecodeClass::ImminentVideo,
+        [this](int) { return run_video_prefetch(VIDEO_PREFETCH_MIN); });
+    m_scheduler.set_source(DecodeClass::Speculative,
+        [this](int) { return run_video_prefetch(VIDEO_PREFETCH_MAX); });
+    m_scheduler.set_picker(DecodeClass::Warm,
+        [this](const std::vector<PreBufferJob>& jobs) { return pick_decode_prep_job(jobs); });
+    m_scheduler.set_runner(DecodeClass::Warm,
+        [this](PreBufferJob& job, int) { run_decode_prep_job(job); });
+
+    for (int i = 0; i < count; ++i) {
+        m_workers.emplace_back(&TimelineMediaBuffer::decode_worker, this, i);
     }
-    m_workers.emplace_back(&TimelineMediaBuffer::audio_prefetch_worker, this);
+    impl::cpu_budget_decode_workers_started(count);
 }
 
 void TimelineMediaBuffer::stop_workers() {
     m_shutdown.store(true);
-    m_jobs_cv.notify_all();
+    m_scheduler.notify();
     for (auto& w : m_workers) {
         if (w.joinable()) w.join();
     }
+    if (!m_workers.empty()) {
+        impl::cpu_budget_decode_workers_stopped(static_cast<int>(m_workers.size()));
+    }
     m_workers.clear();
     {
         std::lock_guard<std::mutex> lock(m_jobs_mutex);
-        m_jobs.clear();
+        if (m_scheduler.worker_count() > 0) m_scheduler.clear(DecodeClass::Warm);
         m_pre_buffering.clear();
     }
 }
 
 // Build dedup key from job fields.
 // SPEED_DETECT: "SPEED_DETECT:media_path" (one probe per file)
+// KEYFRAME_INDEX: "KEYFRAME_INDEX:media_path" (one scan per file)
 // READER_WARM: "V1:WARM:clip_id" (one warm per clip per track)
 std::string TimelineMediaBuffer::job_key(const PreBufferJob& job) {
     if (job.type == PreBufferJob::SPEED_DETECT) {
         return "SPEED_DETECT:" + job.media_path;
     }
+    if (job.type == PreBufferJob::KEYFRAME_INDEX) {
+        return "KEYFRAME_INDEX:" + job.media_path;
+    }
     char buf[8];
     snprintf(buf, sizeof(buf), "%c%d:",
              job.track.type == TrackType::Video ? 'V' : 'A',
              job.track.index);
+    if (job.type == PreBufferJob::REVERSE_GOP) {
+        return std::string(buf) + "REVERSE_GOP:" + job.clip_id + ":"
+            + std::to_string(job.gop_position);
+    }
     return std::string(buf) + "WARM:" + job.clip_id;
 }
 
 void TimelineMediaBuffer::submit_pre_buffer(const PreBufferJob& job) {
+    // Sync mode (no workers): nothing would ever run the job.
+    if (m_scheduler.worker_count() == 0) return;
+
     std::lock_guard<std::mutex> lock(m_jobs_mutex);
 
+    // Dedup: the key is held from submit until the job finishes, so one
+    // lookup covers queued and in-flight jobs across every worker queue.
     auto key = job_key(job);
+    if (!m_pre_buffering.emplace(key, 0).second) return;
 
-    // Simple dedup: skip if same key is in-flight or queued
-    if (m_pre_buffering.find(key) != m_pre_buffering.end()) return;
-
-    for (const auto& j : m_jobs) {
-        if (j.track == job.track && j.clip_id == job.clip_id &&
-            j.type == job.type) return;
-    }
-
-    m_jobs.push_back(job);
-    m_jobs.back().submitted_at = std::chrono::steady_clock::now();
-    m_jobs_cv.notify_all();
+    PreBufferJob queued = job;
+    queued.submitted_at = std::chrono::steady_clock::now();
+    m_scheduler.submit(DecodeClass::Warm, std::move(queued));
 }
 
 // ============================================================================
@@ -2420,7 +2936,7 @@ void TimelineMediaBuffer::submit_pre_buffer(const PreBufferJob& job) {
 // `direction==0` (park) treats all jobs by absolute distance, same code path.
 //
 // SPEED_DETECT jobs and any non-WARM jobs are ignored here — the caller
-// (`process_next_decode_prep_job`) drains SPEED_DETECT first.
+// (`pick_decode_prep_job`) drains SPEED_DETECT first.
 //
 // Fail-fast: any READER_WARM job missing `sequence_start` (default -1) is
 // a programmer error at the submission site, never silently ordered last.
@@ -2463,45 +2979,55 @@ int TimelineMediaBuffer::pick_proximity_warm_job(
 }
 
 // ============================================================================
-// process_next_decode_prep_job — dequeue and execute one SPEED_DETECT or READER_WARM
+// pick_decode_prep_job / run_decode_prep_job — Warm class picker + runner
 // ============================================================================
 
-bool TimelineMediaBuffer::process_next_decode_prep_job() {
-    PreBufferJob job;
-    std::string key;
-    {
-        std::lock_guard<std::mutex> lock(m_jobs_mutex);
-        if (m_jobs.empty()) return false;
-
-        // Priority: SPEED_DETECT first (these unblock stride decisions for the
-        // prefetcher), then READER_WARM by PROXIMITY to the current playhead in
-        // playback direction. The proximity-priority picker is load-bearing at
-        // shuttle speed: PlaybackController's speed-scaled prefetch horizon
-        // submits ~50 warm jobs per dispatch at 32× across a wide range; without
-        // proximity sort the imminent clip (the next boundary the playhead is
-        // about to cross) sits behind dozens of far-future ones in the queue
-        // and the single prep_worker grinds through them serially, producing a
-        // ~10s visible freeze at the boundary (live-confirmed). With proximity
-        // sort the imminent clip is warmed first; far-future clips wait
-        // harmlessly until the prep_worker drains earlier jobs.
-        int pick = -1;
-        for (int i = static_cast<int>(m_jobs.size()) - 1; i >= 0; --i) {
-            if (m_jobs[i].type == PreBufferJob::SPEED_DETECT) { pick = i; break; }
-        }
-        if (pick < 0) {
-            const int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
-            const int direction    = m_playhead_direction.load(std::memory_order_relaxed);
-            pick = pick_proximity_warm_job(m_jobs, playhead, direction);
-        }
-        if (pick < 0) return false;
-
-        job = std::move(m_jobs[pick]);
-        m_jobs.erase(m_jobs.begin() + pick);
-        key = job_key(job);
-        m_pre_buffering[key] = 0;
-    }
-
-    // RAII: remove from in-flight set when done
+// Scheduler picker for one worker queue (called under that queue's lock,
+// for the owner and for thieves alike).
+//
+// Priority: SPEED_DETECT first (these unblock stride decisions for the
+// prefetcher), then READER_WARM by PROXIMITY to the current playhead in
+// playback direction. The proximity-priority picker is load-bearing at
+// shuttle speed: PlaybackController's speed-scaled prefetch horizon
+// submits ~50 warm jobs per dispatch at 32× across a wide range; without
+// proximity sort the imminent clip (the next boundary the playhead is
+// about to cross) sits behind dozens of far-future ones in the queue and
+// a single prep thread grinds through them serially, producing a ~10s
+// visible freeze at the boundary (live-confirmed). With proximity sort
+// the imminent clip is warmed first; far-future clips wait harmlessly
+// while the warm-capable workers drain earlier jobs in parallel.
+//
+// REVERSE_GOP jobs go right after SPEED_DETECT — they hold frames the
+// reverse playhead reaches within the prefetch window — newest GOP
+// (closest to the playhead) first.
+//
+// KEYFRAME_INDEX scans run last: each reads a whole file, and an index
+// only sharpens seeks that already work without one.
+int TimelineMediaBuffer::pick_decode_prep_job(const std::vector<PreBufferJob>& jobs) const {
+    for (int i = static_cast<int>(jobs.size()) - 1; i >= 0; --i) {
+        if (jobs[i].type == PreBufferJob::SPEED_DETECT) return i;
+    }
+    int reverse_pick = -1;
+    for (int i = 0; i < static_cast<int>(jobs.size()); ++i) {
+        if (jobs[i].type != PreBufferJob::REVERSE_GOP) continue;
+        if (reverse_pick < 0 || jobs[i].gop_position > jobs[reverse_pick].gop_position) {
+            reverse_pick = i;
+        }
+    }
+    if (reverse_pick >= 0) return reverse_pick;
+    const int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
+    const int direction    = m_playhead_direction.load(std::memory_order_relaxed);
+    int pick = pick_proximity_warm_job(jobs, playhead, direction);
+    if (pick >= 0) return pick;
+    for (int i = 0; i < static_cast<int>(jobs.size()); ++i) {
+        if (jobs[i].type == PreBufferJob::KEYFRAME_INDEX) return i;
+    }
+    return -1;
+}
+
+void TimelineMediaBuffer::run_decode_prep_job(PreBufferJob& job) {
+    // RAII: release the dedup key (held since submit) when done
+    const std::string key = job_key(job);
     auto guard = make_scope_exit([this, &key] {
         std::lock_guard<std::mutex> lock(m_jobs_mutex);
         m_pre_buffering.erase(key);
@@ -2509,22 +3035,16 @@ bool TimelineMediaBuffer::process_next_decode_prep_job() {
 
     if (job.type == PreBufferJob::SPEED_DETECT) {
         // Create a throwaway reader for the speed probe. Using acquire_reader
-        // would corrupt the pool reader's format context position (seek + decode),
+        // would corrupt the pool reader's demux position (seek + decode),
         // causing subsequent prefetch calls to read from the wrong position or
-        // hit EOF. Throwaway reader is discarded after the probe — pool untouched.
-        auto mf_result = MediaFile::Open(job.media_path);
-        if (mf_result.is_error()) return true;  // skip — will be caught by prefetch
+        // hit EOF. The throwaway shares the path's MediaFile but demuxes on
+        // its own session, and is discarded after the probe — pool untouched.
+        auto mf_result = open_media_file(job.media_path);
+        if (mf_result.is_error()) return;  // skip — will be caught by prefetch
         auto probe_mf = mf_result.value();
-        // Apply TC origin override (same as acquire_reader)
-        {
-            auto tc_it = m_tc_overrides.find(job.media_path);
-            if (tc_it != m_tc_overrides.end()) {
-                probe_mf->set_tc_origin_override(tc_it->second.first_frame_tc,
-                                                  tc_it->second.first_sample_tc);
-            }
-        }
+        ensure_keyframe_index(job.track, job.media_path, *probe_mf);
         auto reader_result = Reader::Create(probe_mf);
-        if (reader_result.is_error()) return true;
+        if (reader_result.is_error()) return;
         auto probe_reader = reader_result.value();
         // Set max output resolution so throwaway reader scales down during
         // decode (e.g. 4K qtrle → 1080p). Without this, the probe decodes
@@ -2548,7 +3068,7 @@ bool TimelineMediaBuffer::process_next_decode_prep_job() {
                     tbuf, job.clip_id.c_str(),
                     (long long)job.probe_source_in,
                     (long long)pinfo.first_frame_tc);
-                return true;
+                return;
             }
             // Use file's native rate for seek (clip rate may differ)
             Rate file_rate = pinfo.video_rate();
@@ -2580,6 +3100,54 @@ bool TimelineMediaBuffer::process_next_decode_prep_job() {
                 EMP_LOG_WARN("SPEED_DETECT: %s clip=%.8s decode failed", tbuf, job.clip_id.c_str());
             }
         }
+    } else if (job.type == PreBufferJob::KEYFRAME_INDEX) {
+        auto t0 = std::chrono::steady_clock::now();
+        auto result = BuildKeyframeIndex(job.media_path, &m_shutdown);
+        auto scan_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (result.is_error()) {
+            EMP_LOG_DEBUG("KEYFRAME_INDEX: %s failed after %lldms: %s",
+                job.media_path.c_str(), (long long)scan_ms, result.error().message.c_str());
+            if (!m_shutdown.load()) {
+                std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+                m_keyframe_reach.emplace(job.media_path, 1.0f);
+            }
+            return;
+        }
+        auto index = PublishKeyframeIndex(result.value());
+        note_keyframe_index(job.media_path, *index);
+        EMP_LOG_DEBUG("KEYFRAME_INDEX: %s gops=%zu reach=%.1f scan=%lldms",
+            job.media_path.c_str(), index->gops().size(),
+            index->MeanFramesToReach(), (long long)scan_ms);
+    } else if (job.type == PreBufferJob::REVERSE_GOP) {
+        // Stale checks first: playback turned around, the playhead passed
+        // the GOP, or the clip under gop_position is no longer this one.
+        if (m_playhead_direction.load(std::memory_order_relaxed) >= 0) return;
+        const int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
+        const int64_t ahead = PrefetchCursor(job.gop_position, -1).ahead_of(playhead);
+        if (ahead < 0 || ahead >= VIDEO_PREFETCH_MAX) return;
+        auto tsp = find_track(job.track);
+        if (!tsp) return;
+        const auto layout = tsp->layout();
+        Segment seg = find_segment_at(*layout, job.gop_position);
+        if (seg.type != Segment::CLIP || seg.clip->clip_id != job.clip_id) return;
+        {
+            auto tlock = lock_track(*tsp);
+            const auto* e = tsp->video_cache.find(job.gop_position);
+            if (e && e->value.clip_id == job.clip_id && e->value.frame) return;
+            // fill_prefetch got here first; its decode chains the next job.
+            if (tsp->gops_in_flight.count(job.gop_position)) return;
+        }
+
+        auto handle = acquire_reader(job.track, job.clip_id + REVERSE_GOP_READER_SUFFIX,
+                                     job.media_path);
+        if (!handle) return;
+        int cached = decode_gop_into_cache(job.track, *seg.clip, job.gop_position,
+                                           *handle.reader);
+        handle = {};  // release before chaining
+        if (cached > 0) {
+            submit_reverse_gop(job.track, *seg.clip, job.gop_position - cached);
+        }
     } else {
         // READER_WARM
         auto queue_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -2599,18 +3167,29 @@ bool TimelineMediaBuffer::process_next_decode_prep_job() {
                     job.clip_id.c_str(), job.media_path.c_str(), (long long)acquire_ms);
         }
         if (acquire_ms > WARM_ACQUIRE_WARN_MS) {
-            EMP_LOG_WARN("WARM: acquire_reader took %lldms for clip %s (threshold %dms)",
-                    (long long)acquire_ms, job.clip_id.c_str(), WARM_ACQUIRE_WARN_MS);
+            // Slow storage shows up here first: say how much of the wait
+            // was demux I/O on this file.
+            double stall_ms = 0.0, mbps = 0.0;
+            for (const auto& io : GetIoStats()) {
+                if (io.path == job.media_path) {
+                    stall_ms = static_cast<double>(io.stall_ns) / 1e6;
+                    mbps = io.throughput_mbps();
+                    break;
+                }
+            }
+            EMP_LOG_WARN("WARM: acquire_reader took %lldms for clip %s (threshold %dms; "
+                    "file io stall %.0fms total, %.1f MB/s)",
+                    (long long)acquire_ms, job.clip_id.c_str(), WARM_ACQUIRE_WARN_MS,
+                    stall_ms, mbps);
         }
     }
-    return true;
 }
 
 // ============================================================================
 // pick_video_track — find highest-index video track needing prefetch
 // ============================================================================
 
-bool TimelineMediaBuffer::pick_video_track(TrackId& out) {
+bool TimelineMediaBuffer::pick_video_track(TrackId& out, int64_t max_ahead) {
     int direction = m_playhead_direction.load(std::memory_order_relaxed);
     if (direction == 0) return false;
     int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
@@ -2621,26 +3200,43 @@ bool TimelineMediaBuffer::pick_video_track(TrackId& out) {
         being_prefetched = m_video_prefetching;
     }
 
-    // Fairness: pick the video track furthest behind playhead (most urgent).
-    // Previous "highest index wins" caused permanent starvation of lower tracks
-    // when the top track had slow decode (e.g. ProRes 4444 SW at 136ms/frame).
+    // Fairness: earliest deadline first. Previous "highest index wins" caused
+    // permanent starvation of lower tracks when the top track had slow decode
+    // (e.g. ProRes 4444 SW at 136ms/frame); "least buffered" then treated a
+    // track coasting through a gap as urgent as one about to hit a cut. The
+    // deadline is that of the next frame the track must actually decode, so
+    // gaps count as buffered. Ties (including no deadline: parked clock,
+    // no sequence rate) fall back to least buffered.
     TrackId most_urgent{TrackType::Video, -1};
+    int64_t best_deadline = std::numeric_limits<int64_t>::max();
     int64_t worst_buffer = std::numeric_limits<int64_t>::max();
     bool found = false;
 
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
-    for (const auto& [tid, ts] : m_tracks) {
+    for (const auto& [tid, ts] : *tracks()) {
         if (tid.type != TrackType::Video) continue;
-        if (ts.clips.empty()) continue;
+        if (ts->layout()->empty()) continue;
         if (being_prefetched.count(tid)) continue;
 
-        int64_t buffer_end = ts.video_buffer_end;
+        int64_t buffer_end;
+        {
+            auto lock = lock_track(*ts);
+            buffer_end = ts->video_buffer_end;
+        }
         if (buffer_end < 0) buffer_end = playhead;
         int64_t ahead = PrefetchCursor(buffer_end, direction).ahead_of(playhead);
-        if (ahead >= VIDEO_PREFETCH_MAX) continue;  // this track is full
+        if (ahead >= max_ahead) continue;  // this track is full (for this class)
 
-        if (ahead < worst_buffer) {
+        // No content left in the window: still a candidate (fill_prefetch
+        // marks the window done so the track stops being picked), but last.
+        int64_t next = next_content_frame(*ts->layout(), buffer_end, direction,
+                                          playhead + direction * max_ahead);
+        int64_t deadline = next < 0 ? std::numeric_limits<int64_t>::max()
+                                    : frame_deadline_ns(next);
+
+        if (deadline < best_deadline ||
+            (deadline == best_deadline && ahead < worst_buffer)) {
             most_urgent = tid;
+            best_deadline = deadline;
             worst_buffer = ahead;
             found = true;
         }
@@ -2672,13 +3268,16 @@ bool TimelineMediaBuffer::pick_audio_track(TrackId& out) {
     TimeUS worst_buffer = std::numeric_limits<TimeUS>::max();
     bool found = false;
 
-    std::lock_guard<std::mutex> lock(m_tracks_mutex);
-    for (const auto& [tid, ts] : m_tracks) {
+    for (const auto& [tid, ts] : *tracks()) {
         if (tid.type != TrackType::Audio) continue;
-        if (ts.clips.empty()) continue;
+        if (ts->layout()->empty()) continue;
         if (being_prefetched.count(tid)) continue;
 
-        TimeUS buffer_end = ts.audio_buffer_end;
+        TimeUS buffer_end;
+        {
+            auto lock = lock_track(*ts);
+            buffer_end = ts->audio_buffer_end;
+        }
         if (buffer_end < 0) buffer_end = playhead_us;
         TimeUS ahead = PrefetchCursor(buffer_end, direction).ahead_of(playhead_us);
         if (ahead >= AUDIO_PREFETCH_MAX) continue;  // this track is full
@@ -2695,13 +3294,13 @@ bool TimelineMediaBuffer::pick_audio_track(TrackId& out) {
 }
 
 // ============================================================================
-// decode_into_cache — video: one frame decode + stride fill
+// decode_into_cache — video: one frame (or a forward range) decode + stride fill
 // ============================================================================
 
-void TimelineMediaBuffer::decode_into_cache(
+int64_t TimelineMediaBuffer::decode_into_cache(
         const TrackId& track, const Segment& seg, int64_t position, int stride,
         int direction, ReaderHandle& held_reader, std::string& held_clip_id,
-        std::shared_ptr<Frame>& last_good_frame) {
+        std::shared_ptr<Frame>& last_good_frame, int range_slots) {
 
     assert((direction == 1 || direction == -1) &&
            "decode_into_cache: direction must be +1 or -1");
@@ -2728,28 +3327,23 @@ void TimelineMediaBuffer::decode_into_cache(
     // init (~50-100ms for h264), turning a ~1ms cache-fill into a 70ms
     // stall and throttling prefetch to ~14 frames/sec.
     {
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto& eof_map = tit->second.clip_eof_frame;
+        auto tit = find_track(track);
+        if (tit) {
+            auto tlock = lock_track(*tit);
+            auto& eof_map = tit->clip_eof_frame;
             auto eof_it = eof_map.find(clip->clip_id);
             if (eof_it != eof_map.end() && source_frame >= eof_it->second.source_frame) {
                 auto& ei = eof_it->second;
                 if (ei.hold_frame) {
                     last_good_frame = ei.hold_frame;
-                    auto& cache = tit->second.video_cache;
                     for (int s = 0; s < stride; ++s) {
                         int64_t fill_tf = position + s * direction;
                         if (fill_tf < clip->sequence_start || fill_tf >= clip->sequence_end()) break;
-                        while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                            evict_video_cache_entry(tit->second);
-                        }
                         int64_t fill_sf = clip->source_in +
                             static_cast<int64_t>((fill_tf - clip->sequence_start) * clip->speed_ratio);
-                        cache[fill_tf] = {clip->clip_id, fill_sf,
-                                          ei.hold_frame, ei.rotation,
-                                          ei.par_num, ei.par_den,
-                                          tit->second.video_cache_seq++};
+                        store_video_cache_entry(*tit, fill_tf,
+                            {clip->clip_id, fill_sf, ei.hold_frame, ei.rotation,
+                             ei.par_num, ei.par_den});
                     }
                 } else {
                     char tbuf[8]; track_str(track, tbuf, sizeof(tbuf));
@@ -2758,7 +3352,7 @@ void TimelineMediaBuffer::decode_into_cache(
                                  tbuf, clip->clip_id.c_str(),
                                  (long long)ei.source_frame, (long long)source_frame);
                 }
-                return;
+                return stride;
             }
         }
     }
@@ -2778,7 +3372,7 @@ void TimelineMediaBuffer::decode_into_cache(
                 tbuf, clip->clip_id.c_str(), (long long)skip_to);
             set_already_fetched_video(track, skip_to, direction);
             held_clip_id.clear();
-            return;
+            return stride;
         }
         held_clip_id = clip->clip_id;
     }
@@ -2790,34 +3384,26 @@ void TimelineMediaBuffer::decode_into_cache(
     // would overshoot to the next frame, causing a 1-frame-ahead shift and
     // periodic backwards visual jumps at every duplicate-sf boundary.
     {
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto& cache = tit->second.video_cache;
-            auto prev_it = cache.find(position - direction);
-            if (prev_it != cache.end() &&
-                prev_it->second.clip_id == clip->clip_id &&
-                prev_it->second.source_frame == source_frame &&
-                prev_it->second.frame) {
+        auto tit = find_track(track);
+        if (tit) {
+            auto tlock = lock_track(*tit);
+            auto& cache = tit->video_cache;
+            const auto* prev_it = cache.find(position - direction);
+            if (prev_it &&
+                prev_it->value.clip_id == clip->clip_id &&
+                prev_it->value.source_frame == source_frame &&
+                prev_it->value.frame) {
                 // Reuse previous frame
-                while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                    evict_video_cache_entry(tit->second);
-                }
                 const auto& info = held_reader->media_file()->info();
                 TrackState::CachedFrame cf{clip->clip_id, source_frame,
-                               prev_it->second.frame,
-                               info.rotation, info.video_par_num, info.video_par_den,
-                               tit->second.video_cache_seq++};
-                cache[position] = cf;
+                               prev_it->value.frame,
+                               info.rotation, info.video_par_num, info.video_par_den};
+                store_video_cache_entry(*tit, position, cf);
                 int fill_count = 1;
                 for (int s = 1; s < stride; ++s) {
                     int64_t fill_tf = position + s * direction;
                     if (fill_tf < clip->sequence_start || fill_tf >= clip->sequence_end()) break;
-                    while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                        evict_video_cache_entry(tit->second);
-                    }
-                    cf.insert_seq = tit->second.video_cache_seq++;
-                    cache[fill_tf] = cf;
+                    store_video_cache_entry(*tit, fill_tf, cf);
                     fill_count++;
                 }
                 {
@@ -2825,9 +3411,9 @@ void TimelineMediaBuffer::decode_into_cache(
                     EMP_LOG_DEBUG("DECODE DUP: %s tf=%lld sf=%lld stride=%d filled=%d cache=%zu buf_end=%lld",
                         tbuf, (long long)position, (long long)source_frame,
                         stride, fill_count, cache.size(),
-                        (long long)tit->second.video_buffer_end);
+                        (long long)tit->video_buffer_end);
                 }
-                return;
+                return stride;
             }
         }
     }
@@ -2843,82 +3429,75 @@ void TimelineMediaBuffer::decode_into_cache(
     // "Not enough media at head" panel renders. Matches the boundary
     // behavior added for GetVideoFrame in 23b5038d.
     if (file_frame < 0) {
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto& cache = tit->second.video_cache;
-            while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                evict_video_cache_entry(tit->second);
-            }
+        auto tit = find_track(track);
+        if (tit) {
+            auto tlock = lock_track(*tit);
             TrackState::CachedFrame cf{};
             cf.clip_id = clip->clip_id;
             cf.source_frame = source_frame;
-            cf.insert_seq = tit->second.video_cache_seq++;
             cf.offline = true;
             cf.error_code = "EOFReached";
             cf.error_msg = "Not enough media at head: source frame "
                 + std::to_string(source_frame)
                 + " is before file start TC "
                 + std::to_string(info.first_frame_tc);
-            cache[position] = cf;
+            store_video_cache_entry(*tit, position, std::move(cf));
         }
-        return;
+        return stride;
     }
     // Use file's native rate for seek (clip rate may differ from file rate)
     Rate file_rate = info.video_rate();
     FrameTime ft = FrameTime::from_frame(file_frame, file_rate);
 
-    auto result = held_reader->DecodeAt(ft);
-
-    // Update decode speed cache. The first decode of any codec includes
-    // one-time overhead (buffer pool page faults, codec warm-up, I/O
-    // cache misses) that inflates the measurement. stride_for_clip uses
-    // this cache — inflated values cause stride > 1, which skips frames
-    // and breaks sequential decoders like qtrle. Solution: don't record
-    // the first measurement. stride_for_clip returns 1 when no cache
-    // entry exists (safe default). The second decode is representative.
-    float per_frame_ms = held_reader->LastBatchMsPerFrame();
-    if (per_frame_ms > 0) {
-        std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
-        auto key = std::make_pair(track, clip->media_path);
-        auto it = m_decode_speed_cache.find(key);
-        if (it == m_decode_speed_cache.end()) {
-            // First measurement — record as sentinel, don't use for stride.
-            // Negative value signals "have one sample, need second to confirm."
-            m_decode_speed_cache[key] = -per_frame_ms;
-        } else if (it->second < 0) {
-            // Second measurement — record actual speed (replaces sentinel).
-            m_decode_speed_cache[key] = per_frame_ms;
-        } else if (per_frame_ms < it->second) {
-            // Subsequent: running minimum for steady-state convergence.
-            m_decode_speed_cache[key] = per_frame_ms;
+    // Above SHUTTLE_FREE_RUN_SPEED the reader decodes keyframes only, at
+    // half resolution (Reader::SetShuttleDecode); stride_for_clip spaces
+    // the decodes a GOP apart to match.
+    const bool shuttle = std::abs(m_playhead_speed.load(std::memory_order_relaxed))
+        > SHUTTLE_FREE_RUN_SPEED;
+    held_reader->SetShuttleDecode(shuttle);
+
+    // Reverse: decode the whole GOP prefix once and cache it, then hand the
+    // preceding GOP to another worker. fill_prefetch walks the cached run
+    // without decoding. A failed GOP decode (EOF included) falls through
+    // to the single-frame path, which owns EOF/hold-frame handling.
+    // Shuttle-speed reverse (J-key 4x+) takes the keyframe path instead.
+    if (direction < 0 && !shuttle) {
+        int cached = decode_gop_into_cache(track, *clip, position,
+                                           *held_reader.reader, &last_good_frame);
+        if (cached > 0) {
+            submit_reverse_gop(track, *clip, position - cached);
+            return stride;
         }
     }
 
+    // Forward: a run of slots from one decode pass (fill_prefetch sizes the
+    // run). Failure — EOF included — falls through to the single-frame
+    // path, as for reverse.
+    if (direction > 0 && !shuttle && range_slots > stride && clip->speed_ratio == 1.0f) {
+        int cached = decode_range_into_cache(track, *clip, position, stride, range_slots,
+                                             *held_reader.reader, &last_good_frame);
+        if (cached > 0) return cached;
+    }
+
+    auto result = held_reader->DecodeAt(ft);
+    note_decode_speed(track, clip->media_path, held_reader->LastBatchMsPerFrame());
+
     if (result.is_ok()) {
         last_good_frame = result.value();
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto& cache = tit->second.video_cache;
-            while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                evict_video_cache_entry(tit->second);
-            }
+        auto tit = find_track(track);
+        if (tit) {
+            auto tlock = lock_track(*tit);
+            auto& cache = tit->video_cache;
             TrackState::CachedFrame cf{clip->clip_id, source_frame, result.value(),
-                           info.rotation, info.video_par_num, info.video_par_den,
-                           tit->second.video_cache_seq++};
-            cache[position] = cf;
+                           info.rotation, info.video_par_num, info.video_par_den};
+            store_video_cache_entry(*tit, position, cf);
 
             // Stride fill: populate cache at skipped positions with same frame
             int fill_count = 1;
             for (int s = 1; s < stride; ++s) {
                 int64_t fill_tf = position + s * direction;
                 if (fill_tf < clip->sequence_start || fill_tf >= clip->sequence_end()) break;
-                while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                    evict_video_cache_entry(tit->second);
-                }
-                cf.insert_seq = tit->second.video_cache_seq++;
-                cache[fill_tf] = cf;
+                store_video_cache_entry(*tit, fill_tf, cf);
                 fill_count++;
             }
             {
@@ -2926,7 +3505,7 @@ void TimelineMediaBuffer::decode_into_cache(
                 EMP_LOG_DEBUG("DECODE OK: %s tf=%lld sf=%lld stride=%d filled=%d cache=%zu buf_end=%lld",
                     tbuf, (long long)position, (long long)source_frame,
                     stride, fill_count, cache.size(),
-                    (long long)tit->second.video_buffer_end);
+                    (long long)tit->video_buffer_end);
             }
         }
     } else {
@@ -2937,21 +3516,20 @@ void TimelineMediaBuffer::decode_into_cache(
                 clip->clip_id.c_str());
 
         if (is_eof) {
-            // Recover hold frame before acquiring m_tracks_mutex — cache lookup
+            // Recover hold frame before acquiring the track lock — cache lookup
             // is quick (short scoped lock), explicit last-frame decode must not
-            // run under m_tracks_mutex.
+            // run under it.
             //
             // Step 1: cache recovery (fast, scoped lock). Covers the common case
             // where fill_prefetch decoded frames this invocation or an earlier
             // one and those are still cached.
             if (!last_good_frame) {
-                std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-                auto tit = m_tracks.find(track);
-                if (tit != m_tracks.end()) {
-                    auto prev = tit->second.video_cache.find(position - direction);
-                    if (prev != tit->second.video_cache.end() &&
-                            prev->second.clip_id == clip->clip_id) {
-                        last_good_frame = prev->second.frame;
+                auto tit = find_track(track);
+                if (tit) {
+                    auto tlock = lock_track(*tit);
+                    const auto* prev = tit->video_cache.find(position - direction);
+                    if (prev && prev->value.clip_id == clip->clip_id) {
+                        last_good_frame = prev->value.frame;
                     }
                 }
             }
@@ -2976,14 +3554,12 @@ void TimelineMediaBuffer::decode_into_cache(
                 }
             }
 
-            std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-            auto tit = m_tracks.find(track);
-            if (tit != m_tracks.end()) {
-                auto& cache = tit->second.video_cache;
-
+            auto tit = find_track(track);
+            if (tit) {
+                auto tlock = lock_track(*tit);
                 // Record EOF with hold frame — subsequent iterations use early
                 // EOF check (no decoder interaction), fill stride at a time.
-                auto& eof_map = tit->second.clip_eof_frame;
+                auto& eof_map = tit->clip_eof_frame;
                 auto eof_it = eof_map.find(clip->clip_id);
                 if (eof_it == eof_map.end() || source_frame < eof_it->second.source_frame) {
                     TrackState::ClipEofInfo ei;
@@ -3003,15 +3579,11 @@ void TimelineMediaBuffer::decode_into_cache(
                     for (int s = 0; s < stride; ++s) {
                         int64_t fill_tf = position + s * direction;
                         if (fill_tf < clip->sequence_start || fill_tf >= clip->sequence_end()) break;
-                        while (cache.size() >= TrackState::MAX_VIDEO_CACHE) {
-                            evict_video_cache_entry(tit->second);
-                        }
                         int64_t fill_sf = clip->source_in +
                             static_cast<int64_t>((fill_tf - clip->sequence_start) * clip->speed_ratio);
-                        cache[fill_tf] = {clip->clip_id, fill_sf,
-                                          last_good_frame, info.rotation,
-                                          info.video_par_num, info.video_par_den,
-                                          tit->second.video_cache_seq++};
+                        store_video_cache_entry(*tit, fill_tf,
+                            {clip->clip_id, fill_sf, last_good_frame, info.rotation,
+                             info.video_par_num, info.video_par_den});
                     }
                 }
                 // No buf_end advance — fill_prefetch advances cursor naturally.
@@ -3020,6 +3592,203 @@ void TimelineMediaBuffer::decode_into_cache(
             }
         }
     }
+    return stride;
+}
+
+void TimelineMediaBuffer::note_decode_speed(const TrackId& track, const std::string& path,
+                                            float per_frame_ms) {
+    // The first decode of any codec includes one-time overhead (buffer
+    // pool page faults, codec warm-up, I/O cache misses) that inflates the
+    // measurement. stride_for_clip uses this cache — inflated values cause
+    // stride > 1, which skips frames and breaks sequential decoders like
+    // qtrle. Solution: don't record the first measurement. stride_for_clip
+    // returns 1 when no cache entry exists (safe default). The second
+    // decode is representative.
+    if (per_frame_ms <= 0) return;
+    std::lock_guard<std::mutex> pool_lock(m_pool_mutex);
+    auto key = std::make_pair(track, path);
+    auto it = m_decode_speed_cache.find(key);
+    if (it == m_decode_speed_cache.end()) {
+        // First measurement — record as sentinel, don't use for stride.
+        // Negative value signals "have one sample, need second to confirm."
+        m_decode_speed_cache[key] = -per_frame_ms;
+    } else if (it->second < 0) {
+        // Second measurement — record actual speed (replaces sentinel).
+        m_decode_speed_cache[key] = per_frame_ms;
+    } else if (per_frame_ms < it->second) {
+        // Subsequent: running minimum for steady-state convergence.
+        m_decode_speed_cache[key] = per_frame_ms;
+    }
+}
+
+// ============================================================================
+// Forward playback — a run of cache slots per decode pass
+// ============================================================================
+//
+// One DecodeAt per slot paid, per frame, a reader-lock round trip, a seek
+// decision, a decode_frames_batch walk and a track-lock acquisition to
+// store the result. decode_range_into_cache asks Reader::DecodeRange for
+// the whole run (VIDEO_RANGE_MIN_SLOTS..VIDEO_RANGE_MAX_SLOTS slots, sized
+// by fill_prefetch) and stores it under one lock. A short result (EOF
+// inside the run, frame arena full) caches what came back; the cursor
+// stops at the first missing slot, where the single-frame path takes over.
+
+int TimelineMediaBuffer::decode_range_into_cache(const TrackId& track, const ClipInfo& clip,
+                                                 int64_t position, int stride, int slots,
+                                                 Reader& reader,
+                                                 std::shared_ptr<Frame>* newest) {
+    assert(position >= clip.sequence_start && position + slots <= clip.sequence_end() &&
+           "decode_range_into_cache: run outside clip");
+    assert(clip.speed_ratio == 1.0f && "decode_range_into_cache: retimed clip");
+    assert(stride >= 1 && slots > 0 && "decode_range_into_cache: empty run");
+    auto tit = find_track(track);
+    if (!tit) return 0;
+    int64_t entry_gen;
+    {
+        auto tlock = lock_track(*tit);
+        entry_gen = tit->prefetch_generation;
+    }
+
+    const auto& info = reader.media_file()->info();
+    const Rate file_rate = info.video_rate();
+    const int64_t source_frame = clip.source_in + (position - clip.sequence_start);
+    const int64_t file_frame = source_frame - info.first_frame_tc;
+    if (file_frame < 0) return 0;
+
+    auto result = reader.DecodeRange(FrameTime::from_frame(file_frame, file_rate),
+                                     FrameTime::from_frame(file_frame + slots, file_rate),
+                                     stride);
+    note_decode_speed(track, clip.media_path, reader.LastBatchMsPerFrame());
+    if (result.is_error()) return 0;
+    const auto& frames = result.value();  // frames[k] is slot position + k*stride
+    assert(!frames.empty() && "decode_range_into_cache: DecodeRange returned no frames");
+
+    auto tlock = lock_track(*tit);
+    if (tit->prefetch_generation != entry_gen) return 0;  // clips changed mid-decode
+    int cached = 0;
+    for (size_t k = 0; k < frames.size(); ++k) {
+        const TrackState::CachedFrame cf{clip.clip_id, source_frame + static_cast<int64_t>(k) * stride, frames[k],
+                                         info.rotation, info.video_par_num, info.video_par_den};
+        for (int s = 0; s < stride && cached < slots; ++s) {
+            store_video_cache_entry(*tit, position + cached, cf);
+            ++cached;
+        }
+    }
+    if (newest) *newest = frames.back();
+
+    char tbuf[8]; track_str(track, tbuf, sizeof(tbuf));
+    EMP_LOG_DEBUG("DECODE RANGE: %s tf=%lld frames=%zu stride=%d cached=%d cache=%zu",
+        tbuf, (long long)position, frames.size(), stride, cached,
+        tit->video_cache.size());
+    return cached;
+}
+
+// ============================================================================
+// Reverse playback — GOP-at-a-time decode, pipelined one GOP ahead
+// ============================================================================
+//
+// Per-frame reverse decode re-seeks to the keyframe and decodes forward to
+// each target: frame k of a GOP costs k decodes, O(GOP²) per GOP — a 60-
+// frame H.264 GOP at 1× reverse needs ~1800 decodes per 2.5s of playback.
+// Reverse instead decodes each GOP forward ONCE (Reader::DecodeGopUS) and
+// caches every frame, so the reverse steps through it are cache hits.
+//
+// The preceding GOP is decoded in parallel: after a GOP lands, a
+// REVERSE_GOP job for the one before it goes to the Warm class, where a
+// second worker runs it on its own reader (REVERSE_GOP_READER_SUFFIX —
+// readers are exclusive per pool key). That job chains the next one, up
+// to the prefetch window. Either path finding its positions already
+// cached just walks past them; a GOP the other path is decoding right now
+// (TrackState::gops_in_flight) is skipped by the job and waited for by
+// fill_prefetch.
+
+int TimelineMediaBuffer::decode_gop_into_cache(const TrackId& track, const ClipInfo& clip,
+                                               int64_t position, Reader& reader,
+                                               std::shared_ptr<Frame>* newest) {
+    assert(position >= clip.sequence_start && position < clip.sequence_end() &&
+           "decode_gop_into_cache: position outside clip");
+    auto tit = find_track(track);
+    if (!tit) return 0;
+    int64_t entry_gen;
+    {
+        auto tlock = lock_track(*tit);
+        entry_gen = tit->prefetch_generation;
+    }
+
+    const auto& info = reader.media_file()->info();
+    const Rate file_rate = info.video_rate();
+    auto file_frame_at = [&](int64_t tf) {
+        return clip.source_in
+            + static_cast<int64_t>((tf - clip.sequence_start) * clip.speed_ratio)
+            - info.first_frame_tc;
+    };
+    const int64_t file_frame = file_frame_at(position);
+    if (file_frame < 0) return 0;
+
+    {
+        auto tlock = lock_track(*tit);
+        if (!tit->gops_in_flight.insert(position).second) return 0;  // other path has it
+    }
+    auto release_claim = make_scope_exit([this, &tit, position] {
+        {
+            auto tlock = lock_track(*tit);
+            tit->gops_in_flight.erase(position);
+        }
+        tit->gop_done.notify_all();
+    });
+
+    auto result = reader.DecodeGopUS(
+        FrameTime::from_frame(file_frame, file_rate).to_us(), REVERSE_GOP_MAX_FRAMES);
+    note_decode_speed(track, clip.media_path, reader.LastBatchMsPerFrame());
+    if (result.is_error()) return 0;
+    const auto& frames = result.value();  // ascending PTS
+    assert(!frames.empty() && "decode_gop_into_cache: DecodeGopUS returned no frames");
+
+    // Walk timeline frames backwards; each takes the newest decoded frame
+    // at or before its source PTS (half-period slack absorbs PTS rounding).
+    // Stop at the first one older than the oldest decoded frame — it
+    // belongs to the preceding GOP.
+    const TimeUS half_period_us = FrameTime::from_frame(1, file_rate).to_us() / 2;
+    auto tlock = lock_track(*tit);
+    if (tit->prefetch_generation != entry_gen) return 0;  // clips changed mid-decode
+    int cached = 0;
+    size_t fi = frames.size();
+    for (int64_t tf = position; tf >= clip.sequence_start; --tf) {
+        const int64_t ff = file_frame_at(tf);
+        if (ff < 0) break;
+        const TimeUS want_us = FrameTime::from_frame(ff, file_rate).to_us() + half_period_us;
+        while (fi > 0 && frames[fi - 1]->source_pts_us() > want_us) --fi;
+        if (fi == 0) break;
+        store_video_cache_entry(*tit, tf,
+            {clip.clip_id, ff + info.first_frame_tc, frames[fi - 1],
+             info.rotation, info.video_par_num, info.video_par_den});
+        ++cached;
+    }
+    if (newest) *newest = frames.back();
+
+    char tbuf[8]; track_str(track, tbuf, sizeof(tbuf));
+    EMP_LOG_DEBUG("DECODE GOP: %s tf=%lld frames=%zu cached=%d down_to=%lld",
+        tbuf, (long long)position, frames.size(), cached,
+        (long long)(position - cached + 1));
+    return cached;
+}
+
+void TimelineMediaBuffer::submit_reverse_gop(const TrackId& track, const ClipInfo& clip,
+                                             int64_t position) {
+    // The clip's first GOP reached: the preceding clip is fill_prefetch's
+    // (leading-boundary decode), not this chain's.
+    if (position < clip.sequence_start) return;
+    if (m_playhead_direction.load(std::memory_order_relaxed) >= 0) return;
+    const int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
+    if (PrefetchCursor(position, -1).ahead_of(playhead) >= VIDEO_PREFETCH_MAX) return;
+
+    PreBufferJob job;
+    job.type = PreBufferJob::REVERSE_GOP;
+    job.track = track;
+    job.clip_id = clip.clip_id;
+    job.media_path = clip.media_path;
+    job.gop_position = position;
+    submit_pre_buffer(job);
 }
 
 // ============================================================================
@@ -3081,10 +3850,10 @@ void TimelineMediaBuffer::decode_audio_into_cache(
         reverse_interleaved(pcm->mutable_data_f32(), pcm->frames(), m_audio_fmt.channels);
     }
     if (pcm && pcm->frames() > 0) {
-        std::lock_guard<std::mutex> tlock(m_tracks_mutex);
-        auto tit = m_tracks.find(track);
-        if (tit != m_tracks.end()) {
-            auto& cache = tit->second.audio_cache;
+        auto tit = find_track(track);
+        if (tit) {
+            auto tlock = lock_track(*tit);
+            auto& cache = tit->audio_cache;
             while (cache.size() >= TrackState::MAX_AUDIO_CACHE) {
                 cache.erase(cache.begin());
             }
@@ -3105,13 +3874,16 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
     auto claim_guard = claim_track_for_prefetch(track, claim_set);
     if (!claim_guard) return;  // another worker already filling this track
 
-    // Capture generation at entry
+    // Capture track + generation at entry. The TrackState stays valid for
+    // the whole call; ReleaseTrack / ClearAllClips bump its generation, so
+    // the per-iteration check below abandons a removed track.
+    auto tsp = find_track(track);
+    if (!tsp) return;
+    auto& ts = *tsp;
     int64_t entry_gen;
     {
-        std::lock_guard<std::mutex> lock(m_tracks_mutex);
-        auto it = m_tracks.find(track);
-        if (it == m_tracks.end()) return;
-        entry_gen = it->second.prefetch_generation;
+        auto lock = lock_track(ts);
+        entry_gen = ts.prefetch_generation;
     }
 
     // Video: locals that persist across frames in the same clip
@@ -3123,11 +3895,12 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
     if (direction == 0) return;
 
     if (track.type == TrackType::Video) {
-        // ── Video prefetch: decode ONE frame then return ──
+        // ── Video prefetch: decode ONE frame (or one forward run) then return ──
         // The worker loop re-picks the most urgent track each iteration,
         // so returning after each decode gives fair interleaving between
         // tracks with different decode speeds (e.g. V2 ProRes 4444 at
-        // 136ms/frame vs V1 H264 at 12ms/frame).
+        // 136ms/frame vs V1 H264 at 12ms/frame). A forward run is sized so
+        // its first slot still makes its deadline.
 
         // Read buf_end ONCE — create cursor before the loop.
         // buf_end reflects cached content distance (not scan position).
@@ -3135,10 +3908,8 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
         // buf_end, so pick_video_track sees accurate urgency.
         int64_t buffer_end;
         {
-            std::lock_guard<std::mutex> lock(m_tracks_mutex);
-            auto it = m_tracks.find(track);
-            if (it == m_tracks.end()) return;
-            buffer_end = it->second.video_buffer_end;
+            auto lock = lock_track(ts);
+            buffer_end = ts.video_buffer_end;
         }
         int64_t playhead = m_playhead_frame.load(std::memory_order_relaxed);
         PrefetchCursor cursor(buffer_end >= 0 ? buffer_end : playhead, direction);
@@ -3156,10 +3927,8 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
 
             // Check generation (clips changed → abandon)
             {
-                std::lock_guard<std::mutex> lock(m_tracks_mutex);
-                auto it = m_tracks.find(track);
-                if (it == m_tracks.end()) return;
-                if (it->second.prefetch_generation != entry_gen) return;
+                auto lock = lock_track(ts);
+                if (ts.prefetch_generation != entry_gen) return;
             }
 
             // Re-read playhead for window check (cursor persists across iterations)
@@ -3182,23 +3951,16 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
                 return;
             }
 
-            // Find segment at cursor position
-            // Deep-copy ClipInfo under lock — seg.clip points into ts.clips vector
-            // which can be reallocated by concurrent SetTrackClips after lock release.
-            Segment seg;
-            ClipInfo clip_copy;
+            // Find segment at cursor position. seg.clip points into the
+            // layout snapshot, which `layout` keeps alive through the decode
+            // even if SetTrackClips publishes a new list meanwhile — no lock,
+            // no ClipInfo copy.
+            const auto layout = ts.layout();
+            Segment seg = find_segment_at(*layout, cursor.pos);
             bool ineligible = false;
-            {
-                std::lock_guard<std::mutex> lock(m_tracks_mutex);
-                auto it = m_tracks.find(track);
-                if (it == m_tracks.end()) return;
-                seg = find_segment_at(it->second, cursor.pos);
-                if (seg.type == Segment::CLIP) {
-                    assert(seg.clip && "fill_prefetch: CLIP segment has null clip pointer");
-                    clip_copy = *seg.clip;
-                    seg.clip = &clip_copy;
-                    ineligible = !track_is_eligible(track.index);
-                }
+            if (seg.type == Segment::CLIP) {
+                assert(seg.clip && "fill_prefetch: CLIP segment has null clip pointer");
+                ineligible = !track_is_eligible(track.index);
             }
 
             if (seg.type == Segment::GAP) {
@@ -3228,6 +3990,25 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
                 continue;
             }
 
+            // Reverse: a GOP decode (ours or a pipelined REVERSE_GOP job)
+            // may already hold this frame — walk past it without decoding.
+            // One still running lands shortly: wait for it rather than
+            // decode the same GOP on this worker too.
+            if (direction < 0) {
+                bool cached = false;
+                {
+                    auto lock = lock_track(ts);
+                    ts.gop_done.wait(lock, [&] { return !ts.gops_in_flight.count(cursor.pos); });
+                    const auto* e = ts.video_cache.find(cursor.pos);
+                    cached = e && e->value.clip_id == seg.clip->clip_id && e->value.frame;
+                }
+                if (cached) {
+                    cursor.advance(1);
+                    set_already_fetched_video(track, cursor.pos, direction);
+                    continue;
+                }
+            }
+
             // Decode one frame, then return to let worker re-pick most urgent track
             decoded_this_call = true;
             int stride = stride_for_clip(track, *seg.clip);
@@ -3237,22 +4018,58 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
             // and skip the clip entirely; this guarantees at least one frame.
             int64_t decode_pos = cursor.pos;
             {
-                std::lock_guard<std::mutex> lock(m_tracks_mutex);
-                auto it = m_tracks.find(track);
-                if (it != m_tracks.end()) {
-                    const auto& cache = it->second.video_cache;
-                    bool clip_cached = false;
-                    for (const auto& kv : cache) {
-                        if (kv.second.clip_id == seg.clip->clip_id) {
-                            clip_cached = true;
-                            break;
-                        }
-                    }
-                    if (!clip_cached) {
-                        decode_pos = (direction > 0)
-                            ? seg.clip->sequence_start
-                            : seg.clip->sequence_end() - 1;
+                auto lock = lock_track(ts);
+                bool clip_cached = false;
+                ts.video_cache.for_each([&](const TrackState::VideoCache::Entry& e) {
+                    if (e.value.clip_id == seg.clip->clip_id) clip_cached = true;
+                });
+                if (!clip_cached) {
+                    decode_pos = (direction > 0)
+                        ? seg.clip->sequence_start
+                        : seg.clip->sequence_end() - 1;
+                }
+            }
+
+            // Deadline check: a decode that can't finish before its frame is
+            // shown is wasted. A late leading boundary falls back to the
+            // cursor frame; any other late cursor frame is dropped and the
+            // cursor moves on without decoding. The playhead frame always
+            // decodes: its deadline is the anchor itself, so it reads as
+            // late on every cold start.
+            int range_slots = 0;
+            {
+                const int64_t decode_ns = expected_decode_ns(track, *seg.clip);
+                const int64_t now_ns = deadline_now_ns();
+                if (decode_pos != cursor.pos &&
+                    now_ns + decode_ns > frame_deadline_ns(decode_pos)) {
+                    decode_pos = cursor.pos;
+                }
+                if (cursor.pos != playhead &&
+                    now_ns + decode_ns > frame_deadline_ns(cursor.pos)) {
+                    char tbuf[8]; track_str(track, tbuf, sizeof(tbuf));
+                    EMP_LOG_DEBUG("PREFETCH DROP: %s tf=%lld late (decode=%.1fms) playhead=%lld",
+                        tbuf, (long long)cursor.pos, decode_ns / 1e6,
+                        (long long)m_playhead_frame.load(std::memory_order_relaxed));
+                    m_video_prefetch_drops.fetch_add(1, std::memory_order_relaxed);
+                    cursor.advance(stride);
+                    set_already_fetched_video(track, cursor.pos, direction);
+                    continue;
+                }
+
+                // Forward with a measured decode speed: decode a run of slots
+                // in one pass when the whole run still lands before the first
+                // slot's deadline. Bounded by the clip end and the window.
+                if (direction > 0 && decode_pos == cursor.pos && decode_ns > 0) {
+                    int64_t slots = std::min<int64_t>({
+                        VIDEO_RANGE_MAX_SLOTS,
+                        seg.clip->sequence_end() - cursor.pos,
+                        playhead + VIDEO_PREFETCH_MAX - cursor.pos});
+                    const int64_t deadline_ns = frame_deadline_ns(cursor.pos);
+                    if (deadline_ns != std::numeric_limits<int64_t>::max()) {
+                        const int64_t decodes = (deadline_ns - now_ns) / decode_ns;
+                        slots = std::min(slots, decodes * stride);
                     }
+                    if (slots >= VIDEO_RANGE_MIN_SLOTS) range_slots = static_cast<int>(slots);
                 }
             }
             {
@@ -3261,9 +4078,10 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
                     tbuf, (long long)cursor.pos, (long long)decode_pos, stride,
                     (long long)playhead, direction, seg.clip->clip_id.c_str());
             }
-            decode_into_cache(track, seg, decode_pos, stride, direction,
-                              held_reader, held_clip_id, last_good_frame);
-            cursor.advance(stride);
+            const int64_t advanced = decode_into_cache(track, seg, decode_pos, stride, direction,
+                                                       held_reader, held_clip_id, last_good_frame,
+                                                       range_slots);
+            cursor.advance(advanced);
             set_already_fetched_video(track, cursor.pos, direction);
             return;  // yield — worker re-picks
         }
@@ -3279,11 +4097,9 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
             int64_t current_gen;
             TimeUS buffer_end;
             {
-                std::lock_guard<std::mutex> lock(m_tracks_mutex);
-                auto it = m_tracks.find(track);
-                if (it == m_tracks.end()) break;
-                current_gen = it->second.prefetch_generation;
-                buffer_end = it->second.audio_buffer_end;
+                auto lock = lock_track(ts);
+                current_gen = ts.prefetch_generation;
+                buffer_end = ts.audio_buffer_end;
             }
             if (current_gen != entry_gen) break;
 
@@ -3292,22 +4108,12 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
             PrefetchCursor cursor(buffer_end >= 0 ? buffer_end : playhead_us, direction);
             if (cursor.ahead_of(playhead_us) >= AUDIO_PREFETCH_MAX) break;  // full
 
-            // Find segment at cursor position
-            // Deep-copy ClipInfo under lock — seg.clip points into ts.clips vector
-            // which can be reallocated by concurrent SetTrackClips after lock release.
-            SegmentUS seg;
-            ClipInfo clip_copy;
-            {
-                std::lock_guard<std::mutex> lock(m_tracks_mutex);
-                auto it = m_tracks.find(track);
-                if (it == m_tracks.end()) break;
-                seg = find_segment_at_us(it->second, cursor.pos);
-                if (seg.type == SegmentUS::CLIP) {
-                    assert(seg.clip && "fill_prefetch: audio CLIP segment has null clip pointer");
-                    clip_copy = *seg.clip;
-                    seg.clip = &clip_copy;
-                }
-            }
+            // Find segment at cursor position (layout snapshot keeps
+            // seg.clip valid through the decode; see video loop above).
+            const auto layout = ts.layout();
+            SegmentUS seg = find_segment_at_us(*layout, cursor.pos);
+            assert((seg.type != SegmentUS::CLIP || seg.clip) &&
+                   "fill_prefetch: audio CLIP segment has null clip pointer");
 
             if (seg.type == SegmentUS::GAP) {
                 bool unbounded = (direction > 0)
@@ -3349,85 +4155,46 @@ void TimelineMediaBuffer::fill_prefetch(const TrackId& track) {
 }
 
 // ============================================================================
-// prep_worker — dedicated thread for SPEED_DETECT + READER_WARM jobs
+// Scheduler sources — one unit of audio refill / video prefetch per call
 // ============================================================================
-// Isolated from video prefetch so slow codec init (H.264 VT = 264ms,
-// BRAW SDK = 128ms) never starves frame decode.
-
-void TimelineMediaBuffer::prep_worker() {
-    jve_init_thread_lua_state();
-    while (!m_shutdown.load()) {
-      try {
-        if (process_next_decode_prep_job()) continue;
 
-        std::unique_lock<std::mutex> lock(m_jobs_mutex);
-        m_jobs_cv.wait_for(lock, std::chrono::milliseconds(100), [this] {
-            return m_shutdown.load() || !m_jobs.empty();
-        });
-      } catch (const JveAssertError& e) {
-        EMP_LOG_WARN("prep_worker: assert caught (continuing): %s", e.what());
-      }
-    }
+bool TimelineMediaBuffer::run_audio_refill() {
+    TrackId target{TrackType::Audio, 0};
+    if (!pick_audio_track(target)) return false;
+    discard_already_played_prefetch(target);
+    fill_prefetch(target);
+    return true;
 }
 
-// ============================================================================
-// prefetch_worker — video prefetch only (no prep jobs)
-// ============================================================================
-
-void TimelineMediaBuffer::prefetch_worker() {
-    jve_init_thread_lua_state();
-    while (!m_shutdown.load()) {
-      try {
-        TrackId target{TrackType::Video, 0};
-        if (pick_video_track(target)) {
-            discard_already_played_prefetch(target);
-            fill_prefetch(target);
-            continue;
-        }
-
-        // Nothing to do — sleep until woken by wake_prefetch_workers
-        // (SetPlayhead, cache miss, buffer low) or 100ms timeout.
-        {
-            std::unique_lock<std::mutex> lock(m_jobs_mutex);
-            m_jobs_cv.wait_for(lock, std::chrono::milliseconds(100), [this] {
-                return m_shutdown.load()
-                    || m_playhead_direction.load(std::memory_order_relaxed) != 0;
-            });
-        }
-      } catch (const JveAssertError& e) {
-        EMP_LOG_WARN("prefetch_worker: assert caught (continuing): %s", e.what());
-      }
-    }
+bool TimelineMediaBuffer::run_video_prefetch(int64_t max_ahead) {
+    TrackId target{TrackType::Video, 0};
+    if (!pick_video_track(target, max_ahead)) return false;
+    discard_already_played_prefetch(target);
+    fill_prefetch(target);
+    return true;
 }
 
 // ============================================================================
-// audio_prefetch_worker — handles audio prefetch only
+// decode_worker — uniform pool thread over the work-stealing scheduler
 // ============================================================================
 
-void TimelineMediaBuffer::audio_prefetch_worker() {
+void TimelineMediaBuffer::decode_worker(int self) {
     jve_init_thread_lua_state();
     while (!m_shutdown.load()) {
       try {
-        TrackId target{TrackType::Audio, 0};
-        if (pick_audio_track(target)) {
-            m_audio_work_pending.store(false, std::memory_order_relaxed);
-            discard_already_played_prefetch(target);
-            fill_prefetch(target);
-            continue;
-        }
-
-        // Nothing to do — sleep on CV until woken by SetPlayhead (discontinuity,
-        // low buffer, or cold start) or shutdown. 50ms timeout as safety net.
-        m_audio_work_pending.store(false, std::memory_order_relaxed);
-        {
-            std::unique_lock<std::mutex> lock(m_jobs_mutex);
-            m_jobs_cv.wait_for(lock, std::chrono::milliseconds(50), [this] {
-                return m_shutdown.load() ||
-                       m_audio_work_pending.load(std::memory_order_relaxed);
-            });
-        }
+        const uint64_t seen = m_scheduler.epoch();
+        if (m_scheduler.run_next(self)) continue;
+
+        // Nothing runnable — sleep until woken (SetPlayhead, cache miss,
+        // buffer low, job submit). While playing, video below
+        // VIDEO_PREFETCH_MAX is topped up without an explicit wake (only
+        // the low watermark wakes), so poll at a fraction of a frame period
+        // instead of the old video workers' hot spin; parked, 100ms is a
+        // safety net only.
+        const bool playing = m_playhead_direction.load(std::memory_order_relaxed) != 0;
+        m_scheduler.wait(seen, std::chrono::milliseconds(playing ? 5 : 100));
       } catch (const JveAssertError& e) {
-        EMP_LOG_WARN("audio_prefetch_worker: assert caught (continuing): %s", e.what());
+        EMP_LOG_WARN("decode_worker: assert caught (continuing): %s", e.what());
       }
     }
 }
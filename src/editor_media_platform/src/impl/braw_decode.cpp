@@ -34,7 +34,7 @@ Result<void> BrawReaderContext::init(const std::string&) {
     return Error::unsupported("Blackmagic RAW SDK not installed");
 }
 void BrawReaderContext::set_resolution_scale(int, int) {}
-Result<std::shared_ptr<Frame>> BrawReaderContext::decode_frame(uint64_t, TimeUS, std::shared_ptr<FrameBufferPool>) {
+Result<std::shared_ptr<Frame>> BrawReaderContext::decode_frame(uint64_t, TimeUS) {
     return Error::unsupported("Blackmagic RAW SDK not installed");
 }
 Result<int64_t> BrawReaderContext::read_audio_f32(int64_t, int64_t, std::vector<float>&) {
@@ -502,19 +502,22 @@ void BrawReaderContext::set_resolution_scale(int max_w, int max_h) {
 }
 
 Result<std::shared_ptr<Frame>> BrawReaderContext::decode_frame(
-        uint64_t frame_index, TimeUS pts_us, std::shared_ptr<FrameBufferPool> pool) {
+        uint64_t frame_index, TimeUS pts_us) {
     assert(m_codec_raw && m_clip_raw && "BrawReaderContext::decode_frame: not initialized");
-    assert(pool && "BrawReaderContext::decode_frame: pool is null");
+    auto& arena = FrameArena::instance();
 
     auto* codec = CODEC();
     auto* clip = CLIP();
     auto* cb = CB();
     auto t0 = std::chrono::steady_clock::now();
 
-    // Acquire output buffer from pool (malloc'd, no zero-init)
+    // Acquire output buffer from the arena (no zero-init)
     int frame_stride = ((m_out_w * 4) + 31) & ~31;
     size_t buf_size = static_cast<size_t>(frame_stride) * m_out_h;
-    auto entry = pool->acquire(buf_size);
+    auto entry = arena.acquire(buf_size);
+    if (!entry.data) {
+        return Error::internal("BRAW: frame arena cap reached");
+    }
 
     // Configure callback output target + resolution scale
     cb->out_data = entry.data;
@@ -528,7 +531,7 @@ Result<std::shared_ptr<Frame>> BrawReaderContext::decode_frame(
     IBlackmagicRawJob* readJob = nullptr;
     HRESULT hr = clip->CreateJobReadFrame(frame_index, &readJob);
     if (FAILED(hr) || !readJob) {
-        pool->release(entry.data, entry.size);
+        arena.release(entry.data, entry.size);
         return Error::internal("BRAW: CreateJobReadFrame failed for frame " +
                               std::to_string(frame_index));
     }
@@ -536,7 +539,7 @@ Result<std::shared_ptr<Frame>> BrawReaderContext::decode_frame(
     hr = readJob->Submit();
     if (FAILED(hr)) {
         readJob->Release();
-        pool->release(entry.data, entry.size);
+        arena.release(entry.data, entry.size);
         return Error::internal("BRAW: Submit failed for frame " +
                               std::to_string(frame_index));
     }
@@ -545,7 +548,7 @@ Result<std::shared_ptr<Frame>> BrawReaderContext::decode_frame(
     codec->FlushJobs();
 
     if (FAILED(cb->decode_result)) {
-        pool->release(entry.data, entry.size);
+        arena.release(entry.data, entry.size);
         return Error::internal("BRAW: decode failed for frame " +
                               std::to_string(frame_index));
     }
@@ -556,11 +559,11 @@ Result<std::shared_ptr<Frame>> BrawReaderContext::decode_frame(
     BRAW_LOG_DEBUG("decode: frame=%llu %.1fms %dx%d",
         (unsigned long long)frame_index, m_last_decode_ms, m_out_w, m_out_h);
 
-    // Wrap in Frame with pool release callback
+    // Wrap in Frame; the buffer goes back to the arena when it dies
     auto result_frame = std::make_shared<Frame>(std::make_unique<FrameImpl>(
         m_out_w, m_out_h, frame_stride, pts_us,
         entry.data, entry.size,
-        FrameBufferPool::make_release_cb(pool)
+        FrameArena::release_cb()
     ));
 
     return result_frame;
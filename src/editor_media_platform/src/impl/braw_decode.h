@@ -12,7 +12,7 @@
 
 #include <editor_media_platform/emp_errors.h>
 #include <editor_media_platform/emp_time.h>
-#include "frame_buffer_pool.h"
+#include "frame_arena.h"
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -69,10 +69,9 @@ public:
     // Uses SDK's native Half/Quarter/Eighth scaling (cheaper than post-decode scale).
     void set_resolution_scale(int max_w, int max_h);
 
-    // Decode one frame by index. Returns BGRA8 Frame with given PTS.
-    // Pool provides pre-allocated malloc'd buffers (no zero-init overhead).
-    Result<std::shared_ptr<Frame>> decode_frame(uint64_t frame_index, TimeUS pts_us,
-                                                 std::shared_ptr<FrameBufferPool> pool);
+    // Decode one frame by index. Returns BGRA8 Frame with given PTS, its
+    // buffer borrowed from the FrameArena.
+    Result<std::shared_ptr<Frame>> decode_frame(uint64_t frame_index, TimeUS pts_us);
 
     // Output dimensions after resolution scaling.
     int output_width() const { return m_out_w; }
@@ -0,0 +1,392 @@
+#include "demux_source.h"
+#include "extent_cache.h"
+#include "task_pool.h"
+#include "../../../assert_handler.h"  // JVE_ASSERT
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace emp {
+namespace impl {
+
+// ============================================================================
+// Registry — path → live source
+// ============================================================================
+//
+// weak_ptr so the registry never keeps a file open: the last demuxer to
+// close releases the descriptor and the block cache with it. Entries whose
+// source died are swept on the next Acquire of any path.
+
+namespace {
+std::mutex g_sources_mutex;
+std::unordered_map<std::string, std::weak_ptr<DemuxSource>> g_sources;
+
+std::atomic<int64_t> g_read_ahead_bytes{DEFAULT_IO_READ_AHEAD};
+std::atomic<int64_t> g_throttle_latency_us{0};
+std::atomic<int64_t> g_throttle_bytes_per_sec{0};
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Read-ahead runs on its own pool: a pread stuck on a slow volume must not
+// hold a decode thread. Leaked like the other pools (a run in flight at
+// exit keeps its source alive).
+TaskPool& io_pool() {
+    static TaskPool* pool = new TaskPool(DemuxSource::IO_THREADS);
+    return *pool;
+}
+
+// Kernel hints: the file is read mostly forward, and [offset, offset+len)
+// is wanted soon. Advisory; failures are ignored.
+void advise_sequential(int fd) {
+#ifdef __APPLE__
+    ::fcntl(fd, F_RDAHEAD, 1);
+#elif defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#else
+    (void)fd;
+#endif
+}
+
+void advise_willneed(int fd, int64_t offset, int64_t len) {
+#ifdef __APPLE__
+    struct radvisory ra;
+    ra.ra_offset = static_cast<off_t>(offset);
+    ra.ra_count = static_cast<int>(len);
+    ::fcntl(fd, F_RDADVISE, &ra);
+#elif defined(POSIX_FADV_WILLNEED)
+    ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(len), POSIX_FADV_WILLNEED);
+#else
+    (void)fd; (void)offset; (void)len;
+#endif
+}
+
+} // namespace
+
+size_t storage_pread(int fd, uint8_t* dst, size_t want, int64_t offset) {
+    const int64_t latency_us = g_throttle_latency_us.load(std::memory_order_relaxed);
+    const int64_t bytes_per_sec = g_throttle_bytes_per_sec.load(std::memory_order_relaxed);
+    if (latency_us > 0 || bytes_per_sec > 0) {
+        int64_t delay_us = latency_us;
+        if (bytes_per_sec > 0) delay_us += static_cast<int64_t>(want) * 1000000 / bytes_per_sec;
+        std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+    }
+    size_t got = 0;
+    while (got < want) {
+        ssize_t n = ::pread(fd, dst + got, want - got,
+                            static_cast<off_t>(offset + static_cast<int64_t>(got)));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += static_cast<size_t>(n);
+    }
+    return got;
+}
+
+namespace {
+
+int64_t stat_mtime_ns(const struct stat& st) {
+#ifdef __APPLE__
+    return static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+}
+} // namespace
+
+Result<std::shared_ptr<DemuxSource>> DemuxSource::Acquire(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        if (errno == ENOENT || errno == ENOTDIR) return Error::file_not_found(path);
+        return Error::internal("stat(" + path + "): " + std::strerror(errno));
+    }
+    const int64_t size = static_cast<int64_t>(st.st_size);
+    const int64_t mtime_ns = stat_mtime_ns(st);
+
+    auto find_live = [&]() -> std::shared_ptr<DemuxSource> {
+        auto it = g_sources.find(path);
+        if (it == g_sources.end()) return nullptr;
+        auto live = it->second.lock();
+        return (live && live->m_size == size && live->m_mtime_ns == mtime_ns) ? live : nullptr;
+    };
+    {
+        std::lock_guard<std::mutex> lock(g_sources_mutex);
+        if (auto live = find_live()) return live;
+    }
+
+    // Open (and hash, for the extent cache) outside the registry lock: on a
+    // network volume both are round trips, and other paths' opens mustn't
+    // queue behind them.
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) return Error::file_not_found(path);
+        return Error::internal("open(" + path + "): " + std::strerror(errno));
+    }
+    auto extents = ExtentCache::shared().open(path, size);
+    std::shared_ptr<DemuxSource> src(
+        new DemuxSource(path, fd, size, mtime_ns, std::move(extents)));
+
+    std::lock_guard<std::mutex> lock(g_sources_mutex);
+    if (auto live = find_live()) return live;  // raced another Acquire; ours closes
+    for (auto sit = g_sources.begin(); sit != g_sources.end();) {
+        sit = sit->second.expired() ? g_sources.erase(sit) : std::next(sit);
+    }
+    g_sources[path] = src;
+    return src;
+}
+
+std::vector<std::shared_ptr<DemuxSource>> DemuxSource::Live() {
+    std::lock_guard<std::mutex> lock(g_sources_mutex);
+    std::vector<std::shared_ptr<DemuxSource>> out;
+    for (const auto& kv : g_sources) {
+        if (auto live = kv.second.lock()) out.push_back(std::move(live));
+    }
+    return out;
+}
+
+void DemuxSource::SetThrottle(int64_t latency_us, int64_t bytes_per_sec) {
+    JVE_ASSERT(latency_us >= 0 && bytes_per_sec >= 0, "DemuxSource::SetThrottle: negative throttle");
+    g_throttle_latency_us.store(latency_us, std::memory_order_relaxed);
+    g_throttle_bytes_per_sec.store(bytes_per_sec, std::memory_order_relaxed);
+}
+
+size_t DemuxSource::LiveCount() {
+    std::lock_guard<std::mutex> lock(g_sources_mutex);
+    size_t n = 0;
+    for (const auto& kv : g_sources) {
+        if (!kv.second.expired()) ++n;
+    }
+    return n;
+}
+
+DemuxSource::DemuxSource(std::string path, int fd, int64_t size, int64_t mtime_ns,
+                         std::shared_ptr<ExtentFile> extents)
+    : m_path(std::move(path)), m_fd(fd), m_size(size), m_mtime_ns(mtime_ns),
+      m_extents(std::move(extents)) {
+    assert(m_fd >= 0 && "DemuxSource: invalid fd");
+    advise_sequential(m_fd);
+}
+
+DemuxSource::~DemuxSource() {
+    ::close(m_fd);
+}
+
+// ============================================================================
+// Block cache
+// ============================================================================
+
+int64_t DemuxSource::block_bytes(int64_t index) const {
+    return std::min(BLOCK_SIZE, m_size - index * BLOCK_SIZE);
+}
+
+DemuxSource::Block DemuxSource::block_at(int64_t index) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    int64_t stall_start = 0;
+    for (;;) {
+        auto it = m_blocks.find(index);
+        if (it != m_blocks.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+            ++m_stats.hits;
+            if (it->second.ahead) {
+                it->second.ahead = false;
+                ++m_stats.read_ahead_hits;
+            }
+            if (stall_start) {
+                ++m_stats.stalls;
+                m_stats.stall_ns += now_ns() - stall_start;
+            }
+            return it->second.block;
+        }
+        if (!m_inflight.count(index)) break;
+        // Being read (read-ahead or another demuxer): wait for that read.
+        // If it comes back short the block isn't cached and we read it.
+        if (!stall_start) stall_start = now_ns();
+        m_fetched.wait(lock);
+    }
+
+    // Miss: claim and read it ourselves, outside the lock. A queued
+    // read-ahead for this block skips it when it starts.
+    if (!stall_start) stall_start = now_ns();
+    m_inflight.insert(index);
+    ++m_stats.misses;
+    lock.unlock();
+    Block block = fetch_run(index, 1, false);
+    lock.lock();
+    ++m_stats.stalls;
+    m_stats.stall_ns += now_ns() - stall_start;
+    return block;
+}
+
+DemuxSource::Block DemuxSource::fetch_run(int64_t first, int64_t count, bool ahead) {
+    assert(count > 0 && "DemuxSource::fetch_run: empty run");
+    const int64_t offset = first * BLOCK_SIZE;
+    const size_t want = static_cast<size_t>(std::min(count * BLOCK_SIZE, m_size - offset));
+    if (ahead) advise_willneed(m_fd, offset, static_cast<int64_t>(want));
+
+    // One pread for the run, then split into blocks. The copy is a memcpy
+    // per 256 KiB — noise next to the storage read it saves.
+    std::vector<uint8_t> run(want);
+    const int64_t t0 = now_ns();
+    const size_t got = m_extents
+        ? ExtentCache::shared().read(*m_extents, m_fd, run.data(), want, offset)
+        : storage_pread(m_fd, run.data(), want, offset);
+    const int64_t read_ns = now_ns() - t0;
+
+    Block first_block;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_stats.reads;
+    m_stats.read_ns += read_ns;
+    m_stats.bytes_read += static_cast<int64_t>(got);
+    for (int64_t i = 0; i < count; ++i) {
+        const int64_t index = first + i;
+        m_inflight.erase(index);
+        const size_t start = static_cast<size_t>(i * BLOCK_SIZE);
+        if (start >= got) continue;
+        const size_t n = std::min(static_cast<size_t>(BLOCK_SIZE), got - start);
+        auto bytes = std::make_shared<const std::vector<uint8_t>>(
+            run.begin() + static_cast<std::ptrdiff_t>(start),
+            run.begin() + static_cast<std::ptrdiff_t>(start + n));
+        if (i == 0) first_block = bytes;
+        // Short block (truncated under us, I/O error): hand it back but
+        // don't cache it — a retry may succeed.
+        if (static_cast<int64_t>(n) < block_bytes(index)) continue;
+        if (m_blocks.count(index)) continue;
+        m_lru.push_front(index);
+        m_blocks.emplace(index, Slot{std::move(bytes), m_lru.begin(), ahead});
+        if (ahead) ++m_stats.read_ahead_blocks;
+    }
+    while (m_blocks.size() > MAX_BLOCKS) {
+        m_blocks.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+    m_fetched.notify_all();
+    return first_block;
+}
+
+// ============================================================================
+// Read-ahead
+// ============================================================================
+//
+// After each read_at the demuxer's next window is checked; the first run of
+// blocks that are neither cached, in flight nor queued is queued as one job.
+// Queued blocks are only a reservation: a demuxer that gets there first
+// reads the block itself, and the job, when it starts, claims just the
+// blocks still missing (the longest run from its first one).
+
+void DemuxSource::schedule_read_ahead(int64_t index) {
+    const int64_t window = std::min(g_read_ahead_bytes.load(std::memory_order_relaxed),
+                                    MAX_READ_AHEAD);
+    if (window <= 0 || m_size <= 0) return;
+    const int64_t last_block = (m_size - 1) / BLOCK_SIZE;
+    const int64_t end = std::min(index + (window + BLOCK_SIZE - 1) / BLOCK_SIZE, last_block + 1);
+
+    int64_t first = -1;
+    int64_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int64_t i = index; i < end && count < MAX_COALESCE_BLOCKS; ++i) {
+            const bool have = m_blocks.count(i) || m_inflight.count(i) || m_queued.count(i);
+            if (!have) {
+                if (first < 0) first = i;
+                ++count;
+            } else if (first >= 0) {
+                break;
+            }
+        }
+        if (first < 0) return;
+        for (int64_t i = first; i < first + count; ++i) m_queued.insert(i);
+    }
+    io_pool().post([weak = weak_from_this(), first, count] {
+        if (auto self = weak.lock()) self->run_read_ahead(first, count);
+    });
+}
+
+void DemuxSource::run_read_ahead(int64_t first, int64_t count) {
+    int64_t start = -1;
+    int64_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int64_t i = first; i < first + count; ++i) {
+            m_queued.erase(i);
+            const bool have = m_blocks.count(i) || m_inflight.count(i);
+            if (!have && (start < 0 || start + n == i)) {
+                if (start < 0) start = i;
+                ++n;
+            }
+        }
+        for (int64_t i = start; i >= 0 && i < start + n; ++i) m_inflight.insert(i);
+    }
+    if (n > 0) fetch_run(start, n, true);
+}
+
+int DemuxSource::read_at(int64_t pos, uint8_t* dst, int len) {
+    JVE_ASSERT(pos >= 0 && len >= 0, "DemuxSource::read_at: negative pos/len");
+    if (pos >= m_size || len == 0) return 0;
+
+    int copied = 0;
+    while (copied < len && pos < m_size) {
+        const int64_t index = pos / BLOCK_SIZE;
+        Block block = block_at(index);
+        if (!block) return copied > 0 ? copied : -EIO;
+        const int64_t in_block = pos - index * BLOCK_SIZE;
+        if (in_block >= static_cast<int64_t>(block->size())) break;  // short block
+        const int n = static_cast<int>(std::min<int64_t>(
+            len - copied, static_cast<int64_t>(block->size()) - in_block));
+        std::memcpy(dst + copied, block->data() + in_block, static_cast<size_t>(n));
+        copied += n;
+        pos += n;
+    }
+    if (copied > 0 && pos < m_size) schedule_read_ahead(pos / BLOCK_SIZE);
+    return copied;
+}
+
+DemuxSource::Stats DemuxSource::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+} // namespace impl
+
+// ============================================================================
+// Public stats / settings (emp_io.h)
+// ============================================================================
+
+std::vector<IoFileStats> GetIoStats() {
+    std::vector<IoFileStats> out;
+    for (const auto& source : impl::DemuxSource::Live()) {
+        const auto st = source->stats();
+        IoFileStats f;
+        f.path = source->path();
+        f.size = source->size();
+        f.bytes_read = st.bytes_read;
+        f.reads = st.reads;
+        f.read_ns = st.read_ns;
+        f.stalls = st.stalls;
+        f.stall_ns = st.stall_ns;
+        f.hits = st.hits;
+        f.misses = st.misses;
+        f.read_ahead_blocks = st.read_ahead_blocks;
+        f.read_ahead_hits = st.read_ahead_hits;
+        out.push_back(std::move(f));
+    }
+    return out;
+}
+
+void SetIoReadAhead(int64_t bytes) {
+    impl::g_read_ahead_bytes.store(std::clamp<int64_t>(bytes, 0, impl::DemuxSource::MAX_READ_AHEAD),
+                                   std::memory_order_relaxed);
+}
+
+int64_t GetIoReadAhead() {
+    return impl::g_read_ahead_bytes.load(std::memory_order_relaxed);
+}
+
+} // namespace emp
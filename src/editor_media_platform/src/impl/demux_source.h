@@ -0,0 +1,142 @@
+#pragma once
+
+// Internal header — per-path shared byte source under every FFmpeg demuxer.
+//
+// Each Reader needs its own AVFormatContext (demux position is per decode
+// session), but N clips cut from one file used to mean N file handles and
+// N passes over the same bytes. A DemuxSource is the shared layer below
+// them: one descriptor per path, positionless pread, and a bounded LRU of
+// fixed-size blocks that every demuxer on the path reads through. The
+// container header, index atoms and any GOP two clips both touch come off
+// disk once.
+//
+// Slow storage (NAS/SMB) turns each demand miss into a demux stall, so a
+// source also reads ahead: after serving a read it queues the next window
+// of uncached blocks on a small I/O pool as one coalesced pread, with a
+// WILLNEED hint so the kernel starts on them first. A demuxer that reaches
+// a block already being read waits for that read instead of issuing its
+// own. Per-file throughput and stall time feed GetIoStats (emp_io.h).
+// With the local extent cache on (extent_cache.h), storage reads of a
+// remote file go through it.
+
+#include <editor_media_platform/emp_errors.h>
+#include <editor_media_platform/emp_io.h>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace emp {
+namespace impl {
+
+struct ExtentFile;
+
+// pread from storage until `want` bytes or EOF/error; returns the count.
+// Every read of media bytes from where they live goes through here
+// (DemuxSource::SetThrottle applies).
+size_t storage_pread(int fd, uint8_t* dst, size_t want, int64_t offset);
+
+class DemuxSource : public std::enable_shared_from_this<DemuxSource> {
+public:
+    // Block granularity and per-path budget (16 MiB). Big enough to hold a
+    // long-GOP HD GOP or a 4K ProRes frame for the demuxers trailing each
+    // other on one file; small enough that a pool of distinct paths stays
+    // cheap.
+    static constexpr int64_t BLOCK_SIZE = 256 * 1024;
+    static constexpr size_t MAX_BLOCKS = 64;
+
+    // Read-ahead window bounds. At most half the cache, so a window of
+    // blocks never evicts the blocks the demuxers are reading now. One
+    // coalesced pread covers at most MAX_COALESCE_BLOCKS (1 MiB): larger
+    // runs save little per-read latency and delay their first block.
+    static constexpr int64_t MAX_READ_AHEAD = BLOCK_SIZE * static_cast<int64_t>(MAX_BLOCKS) / 2;
+    static constexpr int64_t MAX_COALESCE_BLOCKS = 4;
+    // I/O pool threads: reads block on storage, not CPU, so this is sized
+    // for concurrent files, not cores.
+    static constexpr int IO_THREADS = 2;
+
+    struct Stats {
+        int64_t hits = 0;        // block reads served from cache
+        int64_t misses = 0;      // block reads that went to disk
+        int64_t bytes_read = 0;  // bytes pread from disk
+        int64_t reads = 0;       // preads issued (one per coalesced run)
+        int64_t read_ns = 0;     // time spent in those preads
+        int64_t stalls = 0;      // demuxer reads that blocked on storage
+        int64_t stall_ns = 0;    // time demuxers spent blocked
+        int64_t read_ahead_blocks = 0;  // blocks fetched ahead of demand
+        int64_t read_ahead_hits = 0;    // ...that a demuxer then read
+    };
+
+    // Shared source for `path`: the live one if any demuxer still holds it
+    // and the file's size/mtime are unchanged, otherwise a fresh open
+    // (a rewritten file gets a new source; old readers keep the old bytes
+    // until they go away). FileNotFound when the path doesn't exist.
+    static Result<std::shared_ptr<DemuxSource>> Acquire(const std::string& path);
+
+    ~DemuxSource();
+
+    DemuxSource(const DemuxSource&) = delete;
+    DemuxSource& operator=(const DemuxSource&) = delete;
+
+    const std::string& path() const { return m_path; }
+    int64_t size() const { return m_size; }
+
+    // Copy up to `len` bytes at `pos` into `dst`. Returns the count copied,
+    // 0 at/after EOF, or -errno. Thread-safe; disk reads run outside the
+    // cache lock so concurrent demuxers only serialize on the same block.
+    int read_at(int64_t pos, uint8_t* dst, int len);
+
+    Stats stats() const;
+
+    // Number of live sources (test/diagnostic).
+    static size_t LiveCount();
+
+    // Live sources, for GetIoStats.
+    static std::vector<std::shared_ptr<DemuxSource>> Live();
+
+    // Test stand-in for slow storage: every pread sleeps `latency_us` plus
+    // its length at `bytes_per_sec` first. Zeros disable (default).
+    static void SetThrottle(int64_t latency_us, int64_t bytes_per_sec);
+
+private:
+    DemuxSource(std::string path, int fd, int64_t size, int64_t mtime_ns,
+                std::shared_ptr<ExtentFile> extents);
+
+    using Block = std::shared_ptr<const std::vector<uint8_t>>;
+    Block block_at(int64_t index);
+    // Read [first, first+count) — claimed in m_inflight by the caller — with
+    // one pread; cache the blocks, release the claims, wake waiters.
+    // Returns the first block (nullptr when nothing could be read).
+    Block fetch_run(int64_t first, int64_t count, bool ahead);
+    // Queue the first uncached run within the read-ahead window from `index`.
+    void schedule_read_ahead(int64_t index);
+    void run_read_ahead(int64_t first, int64_t count);
+    int64_t block_bytes(int64_t index) const;
+
+    const std::string m_path;
+    const int m_fd;
+    const int64_t m_size;
+    const int64_t m_mtime_ns;
+    const std::shared_ptr<ExtentFile> m_extents;  // null: read storage directly
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_fetched;  // a run finished: m_inflight shrank
+    std::list<int64_t> m_lru;  // block indices, most recent first
+    struct Slot {
+        Block block;
+        std::list<int64_t>::iterator lru_it;
+        bool ahead;  // read ahead, not yet read by a demuxer
+    };
+    std::unordered_map<int64_t, Slot> m_blocks;
+    std::unordered_set<int64_t> m_inflight;  // being pread now
+    std::unordered_set<int64_t> m_queued;    // read-ahead queued, not started
+    Stats m_stats;
+};
+
+} // namespace impl
+} // namespace emp
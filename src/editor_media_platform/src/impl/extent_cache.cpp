@@ -0,0 +1,353 @@
+#include "extent_cache.h"
+#include "demux_source.h"  // storage_pread
+#include <editor_media_platform/emp_io.h>
+#include <editor_media_platform/emp_peak_file.h>  // ComputeContentHash
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+#ifdef __APPLE__
+#include <sys/mount.h>
+#include <sys/param.h>
+#else
+#include <sys/vfs.h>
+#endif
+
+namespace emp {
+namespace impl {
+
+namespace {
+
+uint64_t fnv1a(const std::string& s) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// Network volumes: the only place a local copy saves anything.
+bool is_remote_volume(const std::string& path) {
+    struct statfs fs;
+    if (::statfs(path.c_str(), &fs) != 0) return false;
+#ifdef __APPLE__
+    return (fs.f_flags & MNT_LOCAL) == 0;
+#else
+    switch (static_cast<uint64_t>(fs.f_type)) {
+        case 0x6969:      // NFS
+        case 0x517B:      // SMB
+        case 0xFF534D42:  // CIFS
+        case 0xFE534D42:  // SMB2
+        case 0x65735546:  // FUSE (sshfs, rclone, ...)
+            return true;
+        default:
+            return false;
+    }
+#endif
+}
+
+bool mkdir_p(const std::string& dir) {
+    if (dir.empty()) return false;
+    for (size_t i = 1; i <= dir.size(); ++i) {
+        if (i == dir.size() || dir[i] == '/') {
+            const std::string prefix = dir.substr(0, i);
+            if (::mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        }
+    }
+    return true;
+}
+
+// Local file read: no throttle, no stats — this is the fast path.
+size_t local_pread(int fd, uint8_t* dst, size_t want, int64_t offset) {
+    size_t got = 0;
+    while (got < want) {
+        ssize_t n = ::pread(fd, dst + got, want - got,
+                            static_cast<off_t>(offset + static_cast<int64_t>(got)));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        got += static_cast<size_t>(n);
+    }
+    return got;
+}
+
+bool write_file(const std::string& path, const uint8_t* data, size_t len) {
+    const std::string tmp = path + "." + std::to_string(::getpid()) + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = ::write(fd, data + done, len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+    }
+    ::close(fd);
+    // Rename last: a reader (or a later session) never sees a partial extent.
+    if (done != len || ::rename(tmp.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+ExtentCache& ExtentCache::shared() {
+    static ExtentCache* cache = new ExtentCache();  // leaked like the I/O pool
+    return *cache;
+}
+
+std::string ExtentCache::extent_path(const std::string& name) const {
+    return m_dir + "/" + name + ".ext";
+}
+
+// ============================================================================
+// Configuration — rebuild the index from disk
+// ============================================================================
+
+void ExtentCache::configure(const std::string& dir, int64_t budget_bytes, bool remote_only) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_generation;
+    m_lru.clear();
+    m_entries.clear();
+    m_stats.extents = 0;
+    m_stats.bytes_cached = 0;
+    m_remote_only = remote_only;
+    m_dir = dir;
+    m_budget = (dir.empty() || budget_bytes <= 0 || !mkdir_p(dir)) ? 0 : budget_bytes;
+    m_stats.budget_bytes = m_budget;
+    if (m_budget == 0) return;
+
+    // Extents from earlier sessions, oldest first so the newest end up at
+    // the LRU front. Leftover .tmp files are interrupted writes.
+    struct Found { std::string name; int64_t bytes; int64_t mtime; };
+    std::vector<Found> found;
+    if (DIR* top = ::opendir(m_dir.c_str())) {
+        while (dirent* d = ::readdir(top)) {
+            if (d->d_name[0] == '.') continue;
+            const std::string key = d->d_name;
+            const std::string sub = m_dir + "/" + key;
+            DIR* files = ::opendir(sub.c_str());
+            if (!files) continue;
+            while (dirent* f = ::readdir(files)) {
+                const std::string file = f->d_name;
+                const std::string full = sub + "/" + file;
+                if (file.size() > 4 && file.compare(file.size() - 4, 4, ".tmp") == 0) {
+                    ::unlink(full.c_str());
+                    continue;
+                }
+                if (file.size() <= 4 || file.compare(file.size() - 4, 4, ".ext") != 0) continue;
+                struct stat st;
+                if (::stat(full.c_str(), &st) != 0) continue;
+                found.push_back({key + "/" + file.substr(0, file.size() - 4),
+                                 static_cast<int64_t>(st.st_size),
+                                 static_cast<int64_t>(st.st_mtime)});
+            }
+            ::closedir(files);
+        }
+        ::closedir(top);
+    }
+    std::sort(found.begin(), found.end(),
+              [](const Found& a, const Found& b) { return a.mtime < b.mtime; });
+    for (const auto& f : found) insert_locked(f.name, f.bytes);
+    evict_locked();
+}
+
+std::shared_ptr<ExtentFile> ExtentCache::open(const std::string& path, int64_t size) {
+    bool remote_only;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_budget == 0) return nullptr;
+        remote_only = m_remote_only;
+    }
+    if (size <= 0) return nullptr;
+    if (remote_only && !is_remote_volume(path)) return nullptr;
+    const uint64_t content_hash = ComputeContentHash(path, size);
+    if (content_hash == 0) return nullptr;
+
+    auto file = std::make_shared<ExtentFile>();
+    file->path = path;
+    file->path_hash = fnv1a(path);
+    file->size = size;
+    char key[40];
+    std::snprintf(key, sizeof(key), "%016llx-%016llx",
+                  static_cast<unsigned long long>(file->path_hash),
+                  static_cast<unsigned long long>(content_hash));
+    file->key = key;
+    return file;
+}
+
+// ============================================================================
+// Reads
+// ============================================================================
+
+size_t ExtentCache::read(const ExtentFile& file, int fd, uint8_t* dst, size_t len, int64_t offset) {
+    size_t done = 0;
+    while (done < len && offset + static_cast<int64_t>(done) < file.size) {
+        const int64_t pos = offset + static_cast<int64_t>(done);
+        const int64_t index = pos / EXTENT_SIZE;
+        const int64_t from = pos - index * EXTENT_SIZE;
+        const int64_t extent_bytes = std::min(EXTENT_SIZE, file.size - index * EXTENT_SIZE);
+        const int64_t n = std::min(static_cast<int64_t>(len - done), extent_bytes - from);
+        if (!read_extent(file, fd, index, dst + done, from, n)) break;
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
+
+bool ExtentCache::read_extent(const ExtentFile& file, int fd, int64_t index,
+                              uint8_t* dst, int64_t from, int64_t len) {
+    const std::string name = file.key + "/" + std::to_string(index);
+    const int64_t extent_off = index * EXTENT_SIZE;
+    const int64_t extent_bytes = std::min(EXTENT_SIZE, file.size - extent_off);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_budget == 0) {  // disabled since the source opened
+        lock.unlock();
+        return storage_pread(fd, dst, static_cast<size_t>(len), extent_off + from)
+            == static_cast<size_t>(len);
+    }
+    for (;;) {
+        auto it = m_entries.find(name);
+        if (it != m_entries.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.lru_it);
+            const std::string local = extent_path(name);
+            lock.unlock();
+            bool ok = false;
+            int lfd = ::open(local.c_str(), O_RDONLY);
+            if (lfd >= 0) {
+                ok = local_pread(lfd, dst, static_cast<size_t>(len), from) == static_cast<size_t>(len);
+                ::close(lfd);
+            }
+            lock.lock();
+            if (ok) {
+                ++m_stats.hits;
+                return true;
+            }
+            // Deleted or truncated under us (cache dir purged): forget it
+            // and fetch again.
+            if (m_entries.count(name)) remove_locked(name);
+            continue;
+        }
+        if (!m_inflight.count(name)) break;
+        m_fetched.wait(lock);  // another reader is fetching this extent
+    }
+    m_inflight.insert(name);
+    ++m_stats.misses;
+    const uint64_t generation = m_generation;
+    const std::string local = extent_path(name);
+    const std::string local_dir = m_dir + "/" + file.key;
+    lock.unlock();
+
+    // Whole extent from the network, so its other blocks are local next
+    // time; then onto local disk.
+    std::vector<uint8_t> bytes(static_cast<size_t>(extent_bytes));
+    const size_t got = storage_pread(fd, bytes.data(), bytes.size(), extent_off);
+    const bool complete = got == bytes.size();
+    const bool stored = complete && mkdir_p(local_dir) &&
+        write_file(local, bytes.data(), bytes.size());
+
+    lock.lock();
+    m_inflight.erase(name);
+    if (stored) {
+        // configure/invalidate ran meanwhile: these bytes may be stale.
+        if (generation == m_generation) {
+            insert_locked(name, extent_bytes);
+            evict_locked();
+        } else {
+            ::unlink(local.c_str());
+        }
+    }
+    m_fetched.notify_all();
+    lock.unlock();
+
+    if (static_cast<int64_t>(got) < from + len) return false;
+    std::memcpy(dst, bytes.data() + from, static_cast<size_t>(len));
+    return true;
+}
+
+// ============================================================================
+// Index / budget
+// ============================================================================
+
+void ExtentCache::insert_locked(const std::string& name, int64_t bytes) {
+    if (m_entries.count(name)) return;
+    m_lru.push_front(name);
+    m_entries.emplace(name, Entry{bytes, m_lru.begin()});
+    m_stats.bytes_cached += bytes;
+    ++m_stats.extents;
+}
+
+void ExtentCache::remove_locked(const std::string& name) {
+    auto it = m_entries.find(name);
+    assert(it != m_entries.end() && "ExtentCache::remove_locked: unknown extent");
+    const std::string local = extent_path(name);
+    ::unlink(local.c_str());
+    // Drops the file's directory once its last extent goes (fails harmlessly otherwise).
+    ::rmdir(local.substr(0, local.rfind('/')).c_str());
+    m_stats.bytes_cached -= it->second.bytes;
+    --m_stats.extents;
+    m_lru.erase(it->second.lru_it);
+    m_entries.erase(it);
+}
+
+void ExtentCache::evict_locked() {
+    while (m_stats.bytes_cached > m_budget && !m_lru.empty()) {
+        remove_locked(m_lru.back());
+        ++m_stats.evictions;
+    }
+}
+
+void ExtentCache::invalidate(const std::string& path) {
+    char prefix[24];
+    std::snprintf(prefix, sizeof(prefix), "%016llx-",
+                  static_cast<unsigned long long>(fnv1a(path)));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_generation;  // in-flight fetches of the old bytes don't land
+    std::vector<std::string> doomed;
+    for (const auto& kv : m_entries) {
+        if (kv.first.compare(0, 17, prefix) == 0) doomed.push_back(kv.first);
+    }
+    for (const auto& name : doomed) remove_locked(name);
+}
+
+ExtentCache::Stats ExtentCache::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+} // namespace impl
+
+// ============================================================================
+// Public API (emp_io.h)
+// ============================================================================
+
+void SetIoExtentCache(const std::string& dir, int64_t budget_bytes, bool remote_only) {
+    impl::ExtentCache::shared().configure(dir, budget_bytes, remote_only);
+}
+
+IoExtentCacheStats GetIoExtentCacheStats() {
+    const auto st = impl::ExtentCache::shared().stats();
+    IoExtentCacheStats out;
+    out.hits = st.hits;
+    out.misses = st.misses;
+    out.evictions = st.evictions;
+    out.extents = st.extents;
+    out.bytes_cached = st.bytes_cached;
+    out.budget_bytes = st.budget_bytes;
+    return out;
+}
+
+void InvalidateIoExtentCache(const std::string& path) {
+    impl::ExtentCache::shared().invalidate(path);
+}
+
+} // namespace emp
@@ -0,0 +1,106 @@
+#pragma once
+
+// Internal header — local-disk extent cache under DemuxSource (emp_io.h:
+// SetIoExtentCache).
+//
+// Media on shared storage was re-read over the network on every scrub and
+// every session; the in-memory block cache only spans one file's demuxers
+// while they're open. The extent cache keeps fixed-size extents of remote
+// files on a local disk: DemuxSource's storage reads go through it, an
+// extent already on disk is read locally, and a missing one is read from
+// the network once — whole, so the rest of it is local next time — and
+// written beside the others.
+//
+// Extents live in "<dir>/<path hash>-<content hash>/<index>.ext", so a
+// rewritten file (new ComputeContentHash) never serves old bytes and
+// InvalidatePath can drop every extent of a path without knowing its hash.
+// The budget is LRU by bytes across all files; the index is rebuilt from
+// the directory (mtime order) when the cache is configured, so it persists
+// across sessions.
+
+#include <cstdint>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace emp {
+namespace impl {
+
+// One file's identity in the cache; DemuxSource holds it for its lifetime.
+struct ExtentFile {
+    std::string path;
+    std::string key;      // "<path hash>-<content hash>" (directory name)
+    uint64_t path_hash;
+    int64_t size;
+};
+
+class ExtentCache {
+public:
+    // 2 MiB: eight DemuxSource blocks, one network read per extent.
+    static constexpr int64_t EXTENT_SIZE = 2 * 1024 * 1024;
+
+    struct Stats {
+        int64_t hits = 0;           // extent reads served from local disk
+        int64_t misses = 0;         // extents fetched from the network
+        int64_t evictions = 0;      // extents dropped for the budget
+        int64_t extents = 0;        // extents on disk now
+        int64_t bytes_cached = 0;   // their total size
+        int64_t budget_bytes = 0;   // 0 = disabled
+    };
+
+    static ExtentCache& shared();
+
+    // Enable with `dir` (created if missing) and a byte budget, or disable
+    // with an empty dir / zero budget. remote_only limits caching to files
+    // on network volumes (caching a local disk on a local disk is pure
+    // overhead); tests turn it off. Reconfiguring rescans `dir`.
+    void configure(const std::string& dir, int64_t budget_bytes, bool remote_only);
+
+    // Cache identity for `path`, or nullptr when the cache doesn't apply
+    // (disabled, local volume under remote_only, no content hash).
+    std::shared_ptr<ExtentFile> open(const std::string& path, int64_t size);
+
+    // Read [offset, offset+len) of `file` — local extents where present,
+    // `fd` (the network file, via storage_pread) for the rest, which is
+    // then cached. Returns bytes read; short only at EOF or on I/O error.
+    size_t read(const ExtentFile& file, int fd, uint8_t* dst, size_t len, int64_t offset);
+
+    // Drop every extent of `path` (any content hash).
+    void invalidate(const std::string& path);
+
+    Stats stats() const;
+
+private:
+    ExtentCache() = default;
+
+    struct Entry {
+        int64_t bytes;
+        std::list<std::string>::iterator lru_it;
+    };
+
+    std::string extent_path(const std::string& name) const;
+    // Read one extent, or part of it, into dst. false = fetch failed.
+    bool read_extent(const ExtentFile& file, int fd, int64_t index,
+                     uint8_t* dst, int64_t from, int64_t len);
+    void insert_locked(const std::string& name, int64_t bytes);
+    void evict_locked();
+    void remove_locked(const std::string& name);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_fetched;
+    std::string m_dir;
+    int64_t m_budget = 0;
+    bool m_remote_only = true;
+    uint64_t m_generation = 0;  // bumped by configure/invalidate
+    std::list<std::string> m_lru;  // extent names ("<key>/<index>"), most recent first
+    std::unordered_map<std::string, Entry> m_entries;
+    std::unordered_set<std::string> m_inflight;
+    Stats m_stats;
+};
+
+} // namespace impl
+} // namespace emp
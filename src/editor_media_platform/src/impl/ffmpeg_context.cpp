@@ -1,5 +1,7 @@
 #include "ffmpeg_context.h"
 #include "ffmpeg_hwaccel.h"
+#include "demux_source.h"
+#include <editor_media_platform/emp_cpu_budget.h>
 #include "../../../assert_handler.h"  // JVE_ASSERT (fires in Release; plain assert is stripped by -DNDEBUG)
 #include <cassert>
 #include <cstdio>
@@ -48,46 +50,123 @@ Error ffmpeg_error(int errnum, const std::string& context) {
 
 // FFmpegFormatContext implementation
 
+// Read cursor behind one context's AVIOContext: the shared source plus
+// this demuxer's own position in it.
+struct DemuxCursor {
+    std::shared_ptr<DemuxSource> source;
+    int64_t pos = 0;
+};
+
+static constexpr int DEMUX_AVIO_BUFFER_SIZE = 64 * 1024;
+
+static int demux_read_packet(void* opaque, uint8_t* buf, int buf_size) {
+    auto* cursor = static_cast<DemuxCursor*>(opaque);
+    int n = cursor->source->read_at(cursor->pos, buf, buf_size);
+    if (n < 0) return AVERROR(-n);
+    if (n == 0) return AVERROR_EOF;
+    cursor->pos += n;
+    return n;
+}
+
+static int64_t demux_seek(void* opaque, int64_t offset, int whence) {
+    auto* cursor = static_cast<DemuxCursor*>(opaque);
+    const int64_t size = cursor->source->size();
+    whence &= ~AVSEEK_FORCE;
+    int64_t pos;
+    switch (whence) {
+        case AVSEEK_SIZE: return size;
+        case SEEK_SET: pos = offset; break;
+        case SEEK_CUR: pos = cursor->pos + offset; break;
+        case SEEK_END: pos = size + offset; break;
+        default: return AVERROR(EINVAL);
+    }
+    if (pos < 0) return AVERROR(EINVAL);
+    cursor->pos = pos;
+    return pos;
+}
+
+FFmpegFormatContext::FFmpegFormatContext() = default;
+
 FFmpegFormatContext::~FFmpegFormatContext() {
+    close();
+}
+
+void FFmpegFormatContext::close() {
     if (m_fmt_ctx) {
         avformat_close_input(&m_fmt_ctx);
     }
+    if (m_io) {
+        // The buffer may have been reallocated by avio; free whatever is current.
+        av_freep(&m_io->buffer);
+        avio_context_free(&m_io);
+    }
+    m_cursor.reset();
 }
 
 FFmpegFormatContext::FFmpegFormatContext(FFmpegFormatContext&& other) noexcept
     : m_fmt_ctx(other.m_fmt_ctx),
+      m_io(other.m_io),
+      m_cursor(std::move(other.m_cursor)),
       m_video_stream_idx(other.m_video_stream_idx),
       m_audio_stream_idx(other.m_audio_stream_idx) {
     other.m_fmt_ctx = nullptr;
+    other.m_io = nullptr;
     other.m_video_stream_idx = -1;
     other.m_audio_stream_idx = -1;
 }
 
 FFmpegFormatContext& FFmpegFormatContext::operator=(FFmpegFormatContext&& other) noexcept {
     if (this != &other) {
-        if (m_fmt_ctx) {
-            avformat_close_input(&m_fmt_ctx);
-        }
+        close();
         m_fmt_ctx = other.m_fmt_ctx;
+        m_io = other.m_io;
+        m_cursor = std::move(other.m_cursor);
         m_video_stream_idx = other.m_video_stream_idx;
         m_audio_stream_idx = other.m_audio_stream_idx;
         other.m_fmt_ctx = nullptr;
+        other.m_io = nullptr;
         other.m_video_stream_idx = -1;
         other.m_audio_stream_idx = -1;
     }
     return *this;
 }
 
-Result<void> FFmpegFormatContext::open(const std::string& path) {
+Result<void> FFmpegFormatContext::open_io(const std::string& path,
+                                          std::shared_ptr<DemuxSource> source) {
+    assert(!m_fmt_ctx && !m_io && "FFmpegFormatContext already open");
+    m_cursor = std::make_unique<DemuxCursor>();
+    m_cursor->source = std::move(source);
+
+    auto* buffer = static_cast<unsigned char*>(av_malloc(DEMUX_AVIO_BUFFER_SIZE));
+    if (!buffer) return Error::internal("av_malloc(avio buffer) failed");
+    m_io = avio_alloc_context(buffer, DEMUX_AVIO_BUFFER_SIZE, 0, m_cursor.get(),
+                              demux_read_packet, nullptr, demux_seek);
+    if (!m_io) {
+        av_free(buffer);
+        return Error::internal("avio_alloc_context failed");
+    }
+
+    m_fmt_ctx = avformat_alloc_context();
+    if (!m_fmt_ctx) return Error::internal("avformat_alloc_context failed");
+    m_fmt_ctx->pb = m_io;
+
+    // The path still goes in as the URL: probing scores on the extension.
     int ret = avformat_open_input(&m_fmt_ctx, path.c_str(), nullptr, nullptr);
     if (ret < 0) {
-        if (ret == AVERROR(ENOENT)) {
-            return Error::file_not_found(path);
-        }
+        // avformat_open_input freed m_fmt_ctx; m_io is ours (close()).
         return ffmpeg_error(ret, "avformat_open_input(" + path + ")");
     }
+    return Result<void>();
+}
+
+Result<void> FFmpegFormatContext::open(const std::string& path) {
+    auto source = DemuxSource::Acquire(path);
+    if (source.is_error()) return source.error();
 
-    ret = avformat_find_stream_info(m_fmt_ctx, nullptr);
+    auto open_result = open_io(path, source.value());
+    if (open_result.is_error()) return open_result.error();
+
+    int ret = avformat_find_stream_info(m_fmt_ctx, nullptr);
     if (ret < 0) {
         return ffmpeg_error(ret, "avformat_find_stream_info");
     }
@@ -95,6 +174,84 @@ Result<void> FFmpegFormatContext::open(const std::string& path) {
     return Result<void>();
 }
 
+Result<std::shared_ptr<const StreamParamsSnapshot>>
+FFmpegFormatContext::snapshot_stream_params() const {
+    JVE_ASSERT(m_fmt_ctx && m_cursor,
+        "FFmpegFormatContext::snapshot_stream_params: context not open");
+    auto snap = std::make_shared<StreamParamsSnapshot>();
+    snap->path = m_cursor->source->path();
+    snap->source = m_cursor->source;
+    snap->lazy_streams = (m_fmt_ctx->ctx_flags & AVFMTCTX_NOHEADER) != 0;
+    snap->start_time = m_fmt_ctx->start_time;
+    snap->duration = m_fmt_ctx->duration;
+    snap->bit_rate = m_fmt_ctx->bit_rate;
+    snap->video_stream_idx = m_video_stream_idx;
+    snap->audio_stream_idx = m_audio_stream_idx;
+    snap->streams.resize(m_fmt_ctx->nb_streams);
+    for (unsigned int i = 0; i < m_fmt_ctx->nb_streams; ++i) {
+        const AVStream* from = m_fmt_ctx->streams[i];
+        auto& to = snap->streams[i];
+        to.codecpar.reset(avcodec_parameters_alloc());
+        if (!to.codecpar) return Error::internal("avcodec_parameters_alloc failed");
+        int ret = avcodec_parameters_copy(to.codecpar.get(), from->codecpar);
+        if (ret < 0) return ffmpeg_error(ret, "avcodec_parameters_copy");
+        to.time_base = from->time_base;
+        to.start_time = from->start_time;
+        to.duration = from->duration;
+        to.nb_frames = from->nb_frames;
+        to.avg_frame_rate = from->avg_frame_rate;
+        to.r_frame_rate = from->r_frame_rate;
+        to.sample_aspect_ratio = from->sample_aspect_ratio;
+        to.disposition = from->disposition;
+    }
+    return std::shared_ptr<const StreamParamsSnapshot>(std::move(snap));
+}
+
+Result<void> FFmpegFormatContext::open_session(const StreamParamsSnapshot& primary) {
+    JVE_ASSERT(primary.source,
+        "FFmpegFormatContext::open_session: snapshot has no source");
+    const std::string& path = primary.path;
+
+    auto open_result = open_io(path, primary.source);
+    if (open_result.is_error()) return open_result.error();
+
+    const unsigned int nb_streams = static_cast<unsigned int>(primary.streams.size());
+    if (m_fmt_ctx->nb_streams != nb_streams || primary.lazy_streams ||
+        (m_fmt_ctx->ctx_flags & AVFMTCTX_NOHEADER)) {
+        int ret = avformat_find_stream_info(m_fmt_ctx, nullptr);
+        if (ret < 0) return ffmpeg_error(ret, "avformat_find_stream_info");
+        if (m_fmt_ctx->nb_streams != nb_streams) {
+            return Error::internal("open_session: stream layout differs from primary for " + path);
+        }
+    } else {
+        for (unsigned int i = 0; i < nb_streams; ++i) {
+            const auto& from = primary.streams[i];
+            AVStream* to = m_fmt_ctx->streams[i];
+            int ret = avcodec_parameters_copy(to->codecpar, from.codecpar.get());
+            if (ret < 0) return ffmpeg_error(ret, "avcodec_parameters_copy");
+            to->time_base = from.time_base;
+            to->start_time = from.start_time;
+            to->duration = from.duration;
+            to->nb_frames = from.nb_frames;
+            to->avg_frame_rate = from.avg_frame_rate;
+            to->r_frame_rate = from.r_frame_rate;
+            to->sample_aspect_ratio = from.sample_aspect_ratio;
+            to->disposition = from.disposition;
+        }
+        m_fmt_ctx->start_time = primary.start_time;
+        m_fmt_ctx->duration = primary.duration;
+        m_fmt_ctx->bit_rate = primary.bit_rate;
+    }
+
+    m_video_stream_idx = primary.video_stream_idx;
+    m_audio_stream_idx = primary.audio_stream_idx;
+    return Result<void>();
+}
+
+DemuxSource* FFmpegFormatContext::source() const {
+    return m_cursor ? m_cursor->source.get() : nullptr;
+}
+
 Result<int> FFmpegFormatContext::find_video_stream() {
     assert(m_fmt_ctx && "Format context not opened");
 
@@ -171,6 +328,9 @@ FFmpegCodecContext::~FFmpegCodecContext() {
     if (m_hw_device_ctx) {
         av_buffer_unref(&m_hw_device_ctx);
     }
+    if (m_budget_counted) {
+        cpu_budget_video_decoder_closed();
+    }
 }
 
 FFmpegCodecContext::FFmpegCodecContext(FFmpegCodecContext&& other) noexcept
@@ -178,12 +338,14 @@ FFmpegCodecContext::FFmpegCodecContext(FFmpegCodecContext&& other) noexcept
       m_hw_device_ctx(other.m_hw_device_ctx),
       m_hw_pix_fmt(other.m_hw_pix_fmt),
       m_hw_active(other.m_hw_active),
-      m_negotiation(other.m_negotiation) {
+      m_negotiation(other.m_negotiation),
+      m_budget_counted(other.m_budget_counted) {
     other.m_codec_ctx = nullptr;
     other.m_hw_device_ctx = nullptr;
     other.m_hw_pix_fmt = AV_PIX_FMT_NONE;
     other.m_hw_active = false;
     other.m_negotiation = {};
+    other.m_budget_counted = false;
 }
 
 FFmpegCodecContext& FFmpegCodecContext::operator=(FFmpegCodecContext&& other) noexcept {
@@ -194,16 +356,21 @@ FFmpegCodecContext& FFmpegCodecContext::operator=(FFmpegCodecContext&& other) no
         if (m_hw_device_ctx) {
             av_buffer_unref(&m_hw_device_ctx);
         }
+        if (m_budget_counted) {
+            cpu_budget_video_decoder_closed();
+        }
         m_codec_ctx = other.m_codec_ctx;
         m_hw_device_ctx = other.m_hw_device_ctx;
         m_hw_pix_fmt = other.m_hw_pix_fmt;
         m_hw_active = other.m_hw_active;
         m_negotiation = other.m_negotiation;
+        m_budget_counted = other.m_budget_counted;
         other.m_codec_ctx = nullptr;
         other.m_hw_device_ctx = nullptr;
         other.m_hw_pix_fmt = AV_PIX_FMT_NONE;
         other.m_hw_active = false;
         other.m_negotiation = {};
+        other.m_budget_counted = false;
     }
     return *this;
 }
@@ -334,6 +501,11 @@ Result<void> FFmpegCodecContext::init(AVCodecParameters* params) {
             }
             m_codec_ctx->opaque = &m_negotiation;
             m_codec_ctx->get_format = get_hw_format;
+        } else if (params->codec_type == AVMEDIA_TYPE_VIDEO) {
+            // SW video decode: FFmpeg's default is one thread. Take a share
+            // of the CPU budget instead (emp_cpu_budget.h). Fixed for the
+            // codec's lifetime — thread_count can't change after open.
+            m_codec_ctx->thread_count = CpuBudgetCodecThreads();
         }
 
         // 5. Open codec (still under vt_lock if VT-capable)
@@ -383,6 +555,12 @@ Result<void> FFmpegCodecContext::init(AVCodecParameters* params) {
         break;  // no VT device or not VT-capable — done
     }
 
+    // SW video codecs count against the budget's codec-thread split.
+    if (params->codec_type == AVMEDIA_TYPE_VIDEO && !m_hw_active && !m_budget_counted) {
+        cpu_budget_video_decoder_opened();
+        m_budget_counted = true;
+    }
+
     EMP_LOG_DEBUG("Codec opened: %s %dx%d profile=%d — %s decode (pix_fmt=%s)",
                   codec->name, params->width, params->height, params->profile,
                   m_hw_active ? "HW" : "SW",
@@ -422,6 +600,16 @@ Result<void> FFmpegScaleContext::init(int src_width, int src_height, AVPixelForm
         return Error::internal("Failed to create swscale context");
     }
 
+    // Native path: downscale only (the box filter can't upscale); an
+    // upscaling target stays on swscale.
+    m_native = YuvConverter();
+    YuvLayout layout;
+    YuvRange range;
+    if (native_yuv_layout(src_fmt, &layout, &range) &&
+            dst_width <= src_width && dst_height <= src_height) {
+        m_native.init(layout, range, src_width, src_height, dst_width, dst_height);
+    }
+
     return Result<void>();
 }
 
@@ -435,6 +623,12 @@ Result<void> FFmpegScaleContext::reinit_output(int dst_width, int dst_height) {
 void FFmpegScaleContext::convert(AVFrame* src, uint8_t* dst_data, int dst_stride) {
     JVE_ASSERT(m_sws_ctx, "FFmpegScaleContext::convert: scale context not initialized");
 
+    if (m_native.initialized() && src->format == m_src_fmt &&
+            src->width == m_src_width && src->height == m_src_height) {
+        m_native.convert(src->data, src->linesize, dst_data, dst_stride);
+        return;
+    }
+
     uint8_t* dst_planes[4] = {dst_data, nullptr, nullptr, nullptr};
     int dst_strides[4] = {dst_stride, 0, 0, 0};
 
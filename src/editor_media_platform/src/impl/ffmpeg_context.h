@@ -10,21 +10,58 @@ extern "C" {
 #include <libswscale/swscale.h>
 }
 
+#include "yuv_convert.h"
 #include <editor_media_platform/emp_errors.h>
 #include <editor_media_platform/emp_time.h>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace emp {
 namespace impl {
 
+class DemuxSource;
+struct DemuxCursor;
+
 // Convert FFmpeg error code to EMP Error
 Error ffmpeg_error(int errnum, const std::string& context);
 
+struct CodecParamsDeleter {
+    void operator()(AVCodecParameters* p) const { avcodec_parameters_free(&p); }
+};
+
+// Everything open_session needs from a primary context, copied once right
+// after the primary is opened and analysed (MediaFile::Open) — before any
+// Reader demuxes on it. Sessions are built from this snapshot, never from
+// the primary's live AVStreams: av_read_frame on the Reader holding the
+// primary may update those concurrently.
+struct StreamParamsSnapshot {
+    struct Stream {
+        std::unique_ptr<AVCodecParameters, CodecParamsDeleter> codecpar;
+        AVRational time_base{0, 1};
+        int64_t start_time = 0;
+        int64_t duration = 0;
+        int64_t nb_frames = 0;
+        AVRational avg_frame_rate{0, 1};
+        AVRational r_frame_rate{0, 1};
+        AVRational sample_aspect_ratio{0, 1};
+        int disposition = 0;
+    };
+    std::string path;
+    std::shared_ptr<DemuxSource> source;
+    std::vector<Stream> streams;
+    bool lazy_streams = false;  // AVFMTCTX_NOHEADER
+    int64_t start_time = 0;
+    int64_t duration = 0;
+    int64_t bit_rate = 0;
+    int video_stream_idx = -1;
+    int audio_stream_idx = -1;
+};
+
 // FFmpeg format context wrapper (for MediaFile)
 class FFmpegFormatContext {
 public:
-    FFmpegFormatContext() = default;
+    FFmpegFormatContext();
     ~FFmpegFormatContext();
 
     // Non-copyable
@@ -40,8 +77,27 @@ public:
     // consumer. Empirically, skipping find_stream_info produced wrong
     // fps for MXF and wrong duration for some MOV/MP4, so there is no
     // "fast-open" variant at this layer.
+    //
+    // Bytes come through the path's shared DemuxSource (demux_source.h)
+    // via a custom AVIOContext, so every context open on one file shares a
+    // descriptor and a block cache.
     Result<void> open(const std::string& path);
 
+    // Copy this (open, analysed) context's stream parameters and stream
+    // indices for open_session. Call before anything demuxes on it.
+    Result<std::shared_ptr<const StreamParamsSnapshot>> snapshot_stream_params() const;
+
+    // Open a second demuxer on the snapshotted primary's file: own read
+    // position, shared DemuxSource, and stream parameters copied from the
+    // snapshot instead of re-running find_stream_info (whose analysis the
+    // primary already paid for). Falls back to find_stream_info when the
+    // container creates streams lazily (AVFMTCTX_NOHEADER) or the stream
+    // count differs. Stream indices are inherited from the snapshot.
+    Result<void> open_session(const StreamParamsSnapshot& primary);
+
+    // Shared byte source (null before open).
+    DemuxSource* source() const;
+
     // Find video stream
     Result<int> find_video_stream();
 
@@ -67,7 +123,12 @@ public:
     AVCodecParameters* audio_codec_params() const;
 
 private:
+    Result<void> open_io(const std::string& path, std::shared_ptr<DemuxSource> source);
+    void close();
+
     AVFormatContext* m_fmt_ctx = nullptr;
+    AVIOContext* m_io = nullptr;               // custom IO; not freed by avformat_close_input
+    std::unique_ptr<DemuxCursor> m_cursor;     // m_io's opaque: source + read position
     int m_video_stream_idx = -1;
     int m_audio_stream_idx = -1;
 };
@@ -118,9 +179,14 @@ private:
     AVPixelFormat m_hw_pix_fmt = AV_PIX_FMT_NONE;
     bool m_hw_active = false;
     HwFormatNegotiation m_negotiation;
+    bool m_budget_counted = false;  // counted in cpu_budget_video_decoder_opened
 };
 
-// SwScale context wrapper (for format conversion)
+// Source → BGRA32 conversion context. Layouts YuvConverter covers
+// (yuv_convert.h) convert natively — SIMD, sliced across SlicePool, downscale
+// fused; everything else goes through swscale. The swscale context is built
+// either way: it is the fallback for frames whose format or size differs
+// from the one init() saw (mid-stream HW → SW fallback).
 class FFmpegScaleContext {
 public:
     FFmpegScaleContext() = default;
@@ -137,11 +203,17 @@ public:
     // Convert frame to BGRA32
     void convert(AVFrame* src, uint8_t* dst_data, int dst_stride);
 
+    // True when init()'s format converts on the native path.
+    bool native() const { return m_native.initialized(); }
+
     // Re-init with different output dimensions (same source).
     // Used when SetMaxOutputResolution changes the target after initial init.
     Result<void> reinit_output(int dst_width, int dst_height);
 
     SwsContext* get() const { return m_sws_ctx; }
+    int src_width() const { return m_src_width; }
+    int src_height() const { return m_src_height; }
+    AVPixelFormat src_fmt() const { return m_src_fmt; }
     int dst_width() const { return m_dst_width; }
     int dst_height() const { return m_dst_height; }
 
@@ -152,8 +224,13 @@ private:
     AVPixelFormat m_src_fmt = AV_PIX_FMT_NONE;
     int m_dst_width = 0;
     int m_dst_height = 0;
+    YuvConverter m_native;  // uninitialized = swscale path
 };
 
+// Native converter layout/range for `fmt`; false when YuvConverter doesn't
+// cover it (swscale handles those).
+bool native_yuv_layout(AVPixelFormat fmt, YuvLayout* layout, YuvRange* range);
+
 // Convert AVRational to our Rate
 Rate av_rational_to_rate(AVRational r);
 
@@ -13,7 +13,37 @@ std::vector<uint8_t> allocate_bgra_buffer(int width, int height, int* out_stride
     return std::vector<uint8_t>(stride * height);
 }
 
-// Convert AVFrame to BGRA32 buffer
+// Formats the native converter takes. Range follows swscale's rule (it is
+// what the output must match): full only for the deprecated yuvj formats —
+// swscale never sees AVFrame::color_range through FFmpegScaleContext.
+bool native_yuv_layout(AVPixelFormat fmt, YuvLayout* layout, YuvRange* range) {
+    *range = YuvRange::Limited;
+    switch (fmt) {
+    case AV_PIX_FMT_YUVJ420P:
+        *range = YuvRange::Full;
+        [[fallthrough]];
+    case AV_PIX_FMT_YUV420P:
+        *layout = YuvLayout::I420;
+        return true;
+    case AV_PIX_FMT_NV12:
+        *layout = YuvLayout::NV12;
+        return true;
+    case AV_PIX_FMT_YUV422P10LE:
+        *layout = YuvLayout::I422P10;
+        return true;
+    case AV_PIX_FMT_YUVJ444P:
+        *range = YuvRange::Full;
+        [[fallthrough]];
+    case AV_PIX_FMT_YUV444P:
+        *layout = YuvLayout::I444;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Convert AVFrame to BGRA32 buffer. Native for the layouts above (SIMD,
+// row slices on SlicePool, downscale fused), swscale for the rest.
 void convert_frame_to_bgra(FFmpegScaleContext& scale_ctx, AVFrame* frame,
                             uint8_t* dst_data, int dst_stride) {
     scale_ctx.convert(frame, dst_data, dst_stride);
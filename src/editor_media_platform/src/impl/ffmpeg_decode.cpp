@@ -72,6 +72,38 @@ Result<AVFrame*> decode_next_frame(AVCodecContext* codec_ctx, AVFormatContext* f
     }
 }
 
+// Shuttle decode: after a seek, decode ONLY the next keyframe packet of the
+// stream, then drain. One packet read (plus interleaved packets of other
+// streams), one decode — no walk to the target through the GOP, and no
+// wait for a frame-threaded decoder to fill its pipeline (which would
+// otherwise hold output until thread_count packets were sent). The decoder
+// is left drained: the caller must seek (which flushes) before decoding
+// again.
+Result<AVFrame*> decode_next_keyframe(AVCodecContext* codec_ctx, AVFormatContext* fmt_ctx,
+                                      int stream_idx, AVPacket* pkt, AVFrame* frame) {
+    int ret;
+    while (true) {
+        ret = av_read_frame(fmt_ctx, pkt);
+        if (ret == AVERROR_EOF) return Error::eof();
+        if (ret < 0) return ffmpeg_error(ret, "av_read_frame");
+        if (pkt->stream_index == stream_idx && (pkt->flags & AV_PKT_FLAG_KEY)) break;
+        av_packet_unref(pkt);
+    }
+
+    ret = avcodec_send_packet(codec_ctx, pkt);
+    av_packet_unref(pkt);
+    if (ret < 0) return ffmpeg_error(ret, "avcodec_send_packet (keyframe)");
+
+    ret = avcodec_send_packet(codec_ctx, nullptr);
+    if (ret < 0 && ret != AVERROR_EOF) {
+        return ffmpeg_error(ret, "avcodec_send_packet (flush)");
+    }
+    ret = avcodec_receive_frame(codec_ctx, frame);
+    if (ret == AVERROR_EOF) return Error::eof();
+    if (ret < 0) return ffmpeg_error(ret, "avcodec_receive_frame (keyframe)");
+    return frame;
+}
+
 // Decode frames until we find one with pts <= target_us
 // Returns the frame with largest pts <= target_us (floor-on-grid semantics)
 // NOTE: With B-frames, decoder output is NOT in PTS order. We must continue
@@ -1,5 +1,6 @@
 #include "ffmpeg_context.h"
 #include <editor_media_platform/emp_errors.h>
+#include <editor_media_platform/emp_keyframe_index.h>
 
 namespace emp {
 namespace impl {
@@ -11,9 +12,15 @@ constexpr TimeUS SEEK_BACKOFF_US = 2000000;
 // backoff_us is always 0 in practice — AVSEEK_FLAG_BACKWARD already lands on
 // the keyframe at or before the seek target, so extra backoff just forces
 // decoding through unnecessary frames.
+//
+// With a keyframe index the target is first snapped to the keyframe that
+// owns it, so the demuxer's search is an exact hit instead of a hunt (for
+// formats without a sample table, e.g. MPEG-TS, the search is a binary
+// search over packet reads). When the demuxer has no index of its own and
+// allows byte seeks, the keyframe's recorded byte position is used directly.
 Result<void> seek_with_backoff(AVFormatContext* fmt_ctx, AVStream* stream,
                                 AVCodecContext* codec_ctx, TimeUS target_us,
-                                TimeUS backoff_us) {
+                                TimeUS backoff_us, const KeyframeIndex* kf_index) {
     // Calculate seek target with backoff
     TimeUS stream_start_us = stream_pts_to_us(stream->start_time, stream);
     TimeUS seek_target_us = target_us - backoff_us;
@@ -23,12 +30,35 @@ Result<void> seek_with_backoff(AVFormatContext* fmt_ctx, AVStream* stream,
 
     // Convert to stream time base
     int64_t seek_pts = us_to_stream_pts(seek_target_us, stream);
+    // Byte offset of the target's keyframe, or -1: seek by PTS.
+    int64_t seek_byte_pos = -1;
+
+    if (kf_index && kf_index->stream_index() == stream->index) {
+        int g = kf_index->GopAt(seek_pts);
+        if (g >= 0) {
+            const auto& gop = kf_index->gops()[static_cast<size_t>(g)];
+            if (gop.keyframe_pos >= 0 &&
+                !(fmt_ctx->iformat->flags & AVFMT_NO_BYTE_SEEK) &&
+                avformat_index_get_entries_count(stream) == 0) {
+                seek_byte_pos = gop.keyframe_pos;
+            } else {
+                seek_pts = gop.keyframe_pts;
+            }
+        }
+    }
 
     // Flush codec before seeking
     avcodec_flush_buffers(codec_ctx);
 
-    // Seek to keyframe at or before target
-    int ret = av_seek_frame(fmt_ctx, stream->index, seek_pts, AVSEEK_FLAG_BACKWARD);
+    // Seek to keyframe at or before target; a refused byte seek falls back
+    // to the PTS seek.
+    int ret = -1;
+    if (seek_byte_pos >= 0) {
+        ret = av_seek_frame(fmt_ctx, stream->index, seek_byte_pos, AVSEEK_FLAG_BYTE);
+    }
+    if (ret < 0) {
+        ret = av_seek_frame(fmt_ctx, stream->index, seek_pts, AVSEEK_FLAG_BACKWARD);
+    }
     if (ret < 0) {
         // Try seeking to start on failure
         ret = av_seek_frame(fmt_ctx, stream->index, stream->start_time, AVSEEK_FLAG_BACKWARD);
@@ -50,7 +80,15 @@ Result<void> seek_with_backoff(AVFormatContext* fmt_ctx, AVStream* stream,
 // (caught in production by the 2026-05-15 same-file-two-tracks spike).
 //
 // Hence target_us <= current_pts_us forces a seek, not target_us < current_pts_us.
-bool need_seek(TimeUS current_pts_us, TimeUS target_us, bool have_current) {
+//
+// The >2s forward rule is a guess that a seek beats decoding forward. With
+// a keyframe index it can be checked: if the target's keyframe is at or
+// before the decoder's position, a seek lands behind us and re-decodes
+// frames already passed — decoding forward is strictly less work. Long-GOP
+// camera originals (GOPs of several seconds) hit this on every jump that
+// stays inside one GOP.
+bool need_seek(TimeUS current_pts_us, TimeUS target_us, bool have_current,
+               const KeyframeIndex* kf_index, AVStream* stream) {
     if (!have_current) {
         return true;
     }
@@ -61,8 +99,16 @@ bool need_seek(TimeUS current_pts_us, TimeUS target_us, bool have_current) {
         return true;
     }
 
-    // If target is more than 2 seconds ahead, seek (optimization)
+    // If target is more than 2 seconds ahead, seek (optimization) —
+    // unless the index shows no keyframe between here and the target.
     if (target_us - current_pts_us > SEEK_BACKOFF_US) {
+        if (kf_index && stream && kf_index->stream_index() == stream->index) {
+            int g = kf_index->GopAt(us_to_stream_pts(target_us, stream));
+            if (g >= 0 && kf_index->gops()[static_cast<size_t>(g)].keyframe_pts
+                               <= us_to_stream_pts(current_pts_us, stream)) {
+                return false;
+            }
+        }
         return true;
     }
 
@@ -0,0 +1,195 @@
+#include "frame_arena.h"
+#include "../../../assert_handler.h"  // JVE_ASSERT
+#include <algorithm>
+#include <cassert>
+#include <sys/mman.h>
+
+namespace emp {
+
+FrameArena& FrameArena::instance() {
+    // Leaked on purpose: Frames cached in static/Lua-owned state may die
+    // after static destructors run and still call release().
+    static FrameArena* arena = new FrameArena();
+    return *arena;
+}
+
+size_t FrameArena::size_class(size_t size) {
+    JVE_ASSERT(size > 0, "FrameArena::size_class: size must be > 0");
+    if (size >= SLAB_ALIGN) {
+        return (size + SLAB_ALIGN - 1) / SLAB_ALIGN * SLAB_ALIGN;
+    }
+    size_t cls = MIN_CLASS;
+    while (cls < size) cls <<= 1;
+    return cls;
+}
+
+// ============================================================================
+// Mapping
+// ============================================================================
+
+uint8_t* FrameArena::map_buffer(size_t class_size) {
+    if (class_size < SLAB_ALIGN) {
+        void* p = ::mmap(nullptr, class_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANON, -1, 0);
+        return p == MAP_FAILED ? nullptr : static_cast<uint8_t*>(p);
+    }
+
+    // Over-map by one slab and trim head/tail so the buffer starts on a
+    // 2 MiB boundary — the precondition for the kernel to back it with
+    // hugepages.
+    const size_t span = class_size + SLAB_ALIGN;
+    void* raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    const uintptr_t base = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (base + SLAB_ALIGN - 1) & ~(uintptr_t(SLAB_ALIGN) - 1);
+    const size_t head = aligned - base;
+    const size_t tail = span - head - class_size;
+    if (head) ::munmap(raw, head);
+    if (tail) ::munmap(reinterpret_cast<void*>(aligned + class_size), tail);
+#ifdef MADV_HUGEPAGE
+    ::madvise(reinterpret_cast<void*>(aligned), class_size, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<uint8_t*>(aligned);
+}
+
+void FrameArena::unmap_buffer(uint8_t* data, size_t class_size) {
+    ::munmap(data, class_size);
+}
+
+// Release an idle buffer's pages but keep the mapping. DONTNEED drops them
+// immediately on Linux; Darwin's equivalent for "reuse later, free now" is
+// MADV_FREE_REUSABLE (plain DONTNEED there is advisory and keeps RSS).
+static void drop_pages(uint8_t* data, size_t size) {
+#if defined(MADV_FREE_REUSABLE)
+    ::madvise(data, size, MADV_FREE_REUSABLE);
+#else
+    ::madvise(data, size, MADV_DONTNEED);
+#endif
+}
+
+static void reuse_pages([[maybe_unused]] uint8_t* data, [[maybe_unused]] size_t size) {
+#if defined(MADV_FREE_REUSE)
+    ::madvise(data, size, MADV_FREE_REUSE);
+#endif
+}
+
+void FrameArena::make_room(size_t need, size_t keep_class) {
+    // Largest idle classes first: fewest unmaps per byte, and they are the
+    // likeliest leftovers of a resolution the timeline no longer uses.
+    std::vector<size_t> classes;
+    for (const auto& kv : m_free) {
+        if (kv.first != keep_class && !kv.second.empty()) classes.push_back(kv.first);
+    }
+    std::sort(classes.rbegin(), classes.rend());
+    for (size_t cls : classes) {
+        auto& bucket = m_free[cls];
+        while (!bucket.empty() &&
+               m_stats.reserved_bytes + static_cast<int64_t>(need) > m_stats.cap_bytes) {
+            unmap_buffer(bucket.back().data, cls);
+            bucket.pop_back();
+            m_stats.reserved_bytes -= static_cast<int64_t>(cls);
+        }
+        if (m_stats.reserved_bytes + static_cast<int64_t>(need) <= m_stats.cap_bytes) return;
+    }
+}
+
+// ============================================================================
+// Acquire / release
+// ============================================================================
+
+FrameArena::Entry FrameArena::acquire(size_t size) {
+    const size_t cls = size_class(size);
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto& bucket = m_free[cls];
+    if (!bucket.empty()) {
+        FreeBuffer buf = bucket.back();
+        bucket.pop_back();
+        if (buf.trimmed) reuse_pages(buf.data, cls);
+        m_stats.in_use_bytes += static_cast<int64_t>(cls);
+        m_stats.high_water_bytes = std::max(m_stats.high_water_bytes, m_stats.in_use_bytes);
+        return {buf.data, cls};
+    }
+
+    if (m_stats.reserved_bytes + static_cast<int64_t>(cls) > m_stats.cap_bytes) {
+        make_room(cls, cls);
+        if (m_stats.reserved_bytes + static_cast<int64_t>(cls) > m_stats.cap_bytes) {
+            ++m_stats.cap_failures;
+            return {nullptr, 0};
+        }
+    }
+
+    uint8_t* data = map_buffer(cls);
+    if (!data) {
+        ++m_stats.cap_failures;
+        return {nullptr, 0};
+    }
+    m_stats.reserved_bytes += static_cast<int64_t>(cls);
+    m_stats.in_use_bytes += static_cast<int64_t>(cls);
+    m_stats.high_water_bytes = std::max(m_stats.high_water_bytes, m_stats.in_use_bytes);
+    return {data, cls};
+}
+
+void FrameArena::release(uint8_t* data, size_t size) {
+    assert(data && "FrameArena::release: data must not be null");
+    JVE_ASSERT(size == size_class(size), "FrameArena::release: size is not a class size");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.in_use_bytes -= static_cast<int64_t>(size);
+    assert(m_stats.in_use_bytes >= 0 && "FrameArena::release: in_use underflow");
+    if (m_stats.reserved_bytes > m_stats.cap_bytes) {
+        // Cap was lowered while this buffer was out: give it back.
+        unmap_buffer(data, size);
+        m_stats.reserved_bytes -= static_cast<int64_t>(size);
+        return;
+    }
+    m_free[size].push_back({data, false});
+}
+
+FrameImpl::RawReleaseCallback FrameArena::release_cb() {
+    return [](uint8_t* data, size_t size) { FrameArena::instance().release(data, size); };
+}
+
+// ============================================================================
+// Stats / cap / trim
+// ============================================================================
+
+FrameArenaStats FrameArena::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void FrameArena::set_cap(int64_t bytes) {
+    JVE_ASSERT(bytes > 0, "FrameArena::set_cap: cap must be > 0");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.cap_bytes = bytes;
+    if (m_stats.reserved_bytes > bytes) make_room(0, 0);
+}
+
+int64_t FrameArena::trim() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int64_t trimmed = 0;
+    for (auto& kv : m_free) {
+        for (auto& buf : kv.second) {
+            if (buf.trimmed) continue;
+            drop_pages(buf.data, kv.first);
+            buf.trimmed = true;
+            trimmed += static_cast<int64_t>(kv.first);
+        }
+    }
+    m_stats.trimmed_bytes += trimmed;
+    return trimmed;
+}
+
+FrameArenaStats GetFrameArenaStats() {
+    return FrameArena::instance().stats();
+}
+
+void SetFrameArenaCap(int64_t bytes) {
+    FrameArena::instance().set_cap(bytes);
+}
+
+int64_t TrimFrameArena() {
+    return FrameArena::instance().trim();
+}
+
+} // namespace emp
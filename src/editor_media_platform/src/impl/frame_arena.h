@@ -0,0 +1,61 @@
+#pragma once
+
+// Internal side of the frame arena (emp_frame_arena.h): acquire/release of
+// raw BGRA buffers for FrameImpl's raw-pointer constructor.
+
+#include "frame_impl.h"
+#include <editor_media_platform/emp_frame_arena.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace emp {
+
+class FrameArena {
+public:
+    static FrameArena& instance();
+
+    struct Entry { uint8_t* data; size_t size; };
+
+    // Slab granularity for large classes (x86-64/arm64 hugepage size).
+    static constexpr size_t SLAB_ALIGN = 2u << 20;
+    static constexpr size_t MIN_CLASS = 64u << 10;
+
+    static size_t size_class(size_t size);
+
+    // A buffer of at least `size` bytes (entry.size = its class), or
+    // {nullptr, 0} when reserving it would pass the cap even after
+    // unmapping idle buffers of other classes. Contents are undefined.
+    Entry acquire(size_t size);
+
+    // Return a buffer from acquire(). `size` must be the entry's size.
+    void release(uint8_t* data, size_t size);
+
+    // Release callback for FrameImpl: hands the buffer back on Frame death.
+    static FrameImpl::RawReleaseCallback release_cb();
+
+    FrameArenaStats stats() const;
+    void set_cap(int64_t bytes);
+    int64_t trim();
+
+private:
+    FrameArena() = default;
+
+    uint8_t* map_buffer(size_t class_size);
+    void unmap_buffer(uint8_t* data, size_t class_size);
+    // Unmap free buffers (other than `keep_class`) until reserved + need
+    // fits the cap. Caller holds m_mutex.
+    void make_room(size_t need, size_t keep_class);
+
+    // Idle buffer. trimmed = pages already madvised away (refault as zero
+    // pages on next write — the decoder overwrites every byte anyway).
+    struct FreeBuffer { uint8_t* data; bool trimmed; };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<size_t, std::vector<FreeBuffer>> m_free;  // class → idle, LIFO
+    FrameArenaStats m_stats{DEFAULT_FRAME_ARENA_CAP};
+};
+
+} // namespace emp
@@ -3,6 +3,7 @@
 // Internal header - defines FrameImpl
 // Supports both CPU buffer and hardware buffer (VideoToolbox CVPixelBuffer)
 
+#include <editor_media_platform/emp_frame.h>
 #include <editor_media_platform/emp_time.h>
 #include <cstdint>
 #include <cstdlib>
@@ -22,9 +23,10 @@ class FFmpegScaleContext;
 
 } // namespace impl
 
-// FrameImpl holds EITHER hw buffer OR cpu buffer
-// The hw→cpu transfer is lazy (happens on first data() call)
-// INVARIANT: Exactly one of cpu_buffer_valid or hw_buffer must be true/non-null
+// FrameImpl holds EITHER hw buffer OR cpu buffer OR planar YUV
+// The hw→cpu transfer is lazy (first data() call); YUV→BGRA conversion
+// only ever writes into a caller-owned buffer (copy_bgra)
+// INVARIANT: Exactly one of cpu_buffer_valid, hw_buffer or is_yuv must be true/non-null
 class FrameImpl {
 public:
     // Optional release callback: when set, the destructor passes the cpu_buffer
@@ -75,6 +77,34 @@ public:
                "FrameImpl(raw): buffer too small for dimensions");
     }
 
+    // Planar YUV storage. Planes point into one raw buffer (raw_data,
+    // handed back via raw_release_cb like the raw-pointer constructor).
+    struct YuvPlanes {
+        PixelFormat format = PixelFormat::YUV420P;
+        ColorSpace colorspace = ColorSpace::Unspecified;
+        ColorRange range = ColorRange::Limited;
+        const uint8_t* plane[3] = {nullptr, nullptr, nullptr};
+        int stride[3] = {0, 0, 0};
+    };
+
+    FrameImpl(int w, int h, TimeUS pts, const YuvPlanes& yuv,
+              uint8_t* raw_data, size_t raw_size,
+              RawReleaseCallback raw_release_cb = nullptr)
+        : m_width(w), m_height(h), m_stride(((w * 4) + 31) & ~31), m_pts_us(pts),
+          m_cpu_buffer_valid(false),
+          m_raw_data(raw_data), m_raw_size(raw_size),
+          m_raw_release_cb(std::move(raw_release_cb)),
+#ifdef EMP_HAS_VIDEOTOOLBOX
+          m_hw_buffer(nullptr),
+#endif
+          m_is_yuv(true), m_yuv(yuv)
+    {
+        assert(w > 0 && "FrameImpl(yuv): width must be > 0");
+        assert(h > 0 && "FrameImpl(yuv): height must be > 0");
+        assert(yuv.format != PixelFormat::BGRA32 && "FrameImpl(yuv): format must be YUV");
+        assert(raw_data && yuv.plane[0] && yuv.plane[1] && "FrameImpl(yuv): missing planes");
+    }
+
 #ifdef EMP_HAS_VIDEOTOOLBOX
     // HW buffer constructor (VideoToolbox path)
     // Takes ownership of the CVPixelBuffer reference (caller should NOT release)
@@ -122,10 +152,16 @@ public:
     int stride() const { return m_stride; }
     TimeUS pts_us() const { return m_pts_us; }
 
-    // Returns CPU pixel data, triggering hw→cpu transfer if needed
-    // Thread-safe via mutex
+    // Returns CPU pixel data, triggering hw→cpu transfer if needed.
+    // Thread-safe via mutex. Not valid on a YUV frame (asserts).
     const uint8_t* data();
 
+    // BGRA32 into a caller-owned buffer; YUV frames convert directly.
+    void copy_bgra(uint8_t* dst, int dst_stride);
+
+    bool is_yuv() const { return m_is_yuv; }
+    const YuvPlanes& yuv() const { return m_yuv; }
+
     size_t data_size() const {
         if (m_raw_data) return m_raw_size;
         return static_cast<size_t>(m_stride) * m_height;
@@ -170,11 +206,18 @@ private:
     CVPixelBufferRef m_hw_buffer;
 #endif
 
+    // Planar YUV storage (in m_raw_data). m_cpu_buffer stays empty.
+    bool m_is_yuv = false;
+    YuvPlanes m_yuv;
+
     // Mutex for lazy transfer
     std::mutex m_transfer_mutex;
 
     // Perform hw→cpu transfer (called from data() if needed)
     void ensure_cpu_buffer();
+
+    // Convert the YUV planes to BGRA32 at dst.
+    void convert_yuv(uint8_t* dst, int dst_stride) const;
 };
 
 } // namespace emp
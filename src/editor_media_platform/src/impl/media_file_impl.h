@@ -4,6 +4,9 @@
 // FFmpeg headers allowed here (we're in impl/)
 
 #include "ffmpeg_context.h"
+#include <editor_media_platform/emp_keyframe_index.h>
+#include <atomic>
+#include <memory>
 
 namespace emp {
 
@@ -15,6 +18,25 @@ class MediaFileImpl {
 public:
     impl::FFmpegFormatContext fmt_ctx;
     MediaFileBackend backend = MediaFileBackend::FFmpeg;
+
+    // Identity of the file's bytes (ComputeContentHash; 0 = unknown) and
+    // the keyframe index found for it at Open. Set once in Open, read-only
+    // afterwards.
+    uint64_t content_hash = 0;
+    int64_t source_size = 0;
+    std::shared_ptr<const KeyframeIndex> keyframe_index;
+
+    // Demux lease (Reader::Create). fmt_ctx — opened and analysed once by
+    // Open — goes to the first Reader to ask; Readers created while it is
+    // out open their own session over the same DemuxSource
+    // (FFmpegFormatContext::open_session). Lets any number of Readers
+    // share one MediaFile without sharing a demux position.
+    std::atomic<bool> primary_leased{false};
+
+    // fmt_ctx's stream parameters as Open left them, for building sessions
+    // and for reads that must not touch the leased primary's live streams.
+    // Set once in Open (FFmpeg backend only), read-only afterwards.
+    std::shared_ptr<const impl::StreamParamsSnapshot> stream_params;
 };
 
 } // namespace emp
@@ -1,11 +1,19 @@
 #include "qtrle_decode.h"
+#include "slice_pool.h"
 #include <cassert>
 #include <cstring>
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
-#include <dispatch/dispatch.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define EMP_QTRLE_HAVE_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define EMP_QTRLE_HAVE_NEON 1
+#endif
 
 // EMP log level for qtrle decode timing (EMP_LOG_LEVEL >= 2)
 static int qtrle_log_level() {
@@ -35,6 +43,118 @@ static inline uint32_t argb_to_bgra(const uint8_t* src) {
 namespace emp {
 namespace impl {
 
+// ============================================================================
+// Scanline kernels — RLE fill and ARGB → BGRA literal swizzle
+// ============================================================================
+//
+// ARGB → BGRA reverses the bytes of each 4-byte pixel, so the literal
+// kernels are one byte shuffle per vector. Runs are a broadcast + stores.
+
+static void fill_scalar(uint32_t* dst, uint32_t bgra, int n) {
+    for (int i = 0; i < n; ++i) dst[i] = bgra;
+}
+
+static void literal_scalar(const uint8_t* argb, uint32_t* dst, int n) {
+    for (int i = 0; i < n; ++i) dst[i] = argb_to_bgra(argb + i * 4);
+}
+
+#ifdef EMP_QTRLE_HAVE_X86
+__attribute__((target("avx2")))
+static void fill_avx2(uint32_t* dst, uint32_t bgra, int n) {
+    const __m256i v = _mm256_set1_epi32(static_cast<int>(bgra));
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    }
+    if (i + 4 <= n) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(v));
+        i += 4;
+    }
+    fill_scalar(dst + i, bgra, n - i);
+}
+
+__attribute__((target("avx2")))
+static void literal_avx2(const uint8_t* argb, uint32_t* dst, int n) {
+    // Per 128-bit lane; pixels never straddle lanes.
+    const __m256i rev = _mm256_setr_epi8(
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(argb + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(px, rev));
+    }
+    literal_scalar(argb + i * 4, dst + i, n - i);
+}
+
+static void fill_sse2(uint32_t* dst, uint32_t bgra, int n) {
+    const __m128i v = _mm_set1_epi32(static_cast<int>(bgra));
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    fill_scalar(dst + i, bgra, n - i);
+}
+
+__attribute__((target("ssse3")))
+static void literal_ssse3(const uint8_t* argb, uint32_t* dst, int n) {
+    const __m128i rev = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(argb + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(px, rev));
+    }
+    literal_scalar(argb + i * 4, dst + i, n - i);
+}
+#endif
+
+#ifdef EMP_QTRLE_HAVE_NEON
+static void fill_neon(uint32_t* dst, uint32_t bgra, int n) {
+    const uint32x4_t v = vdupq_n_u32(bgra);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        vst1q_u32(dst + i, v);
+        vst1q_u32(dst + i + 4, v);
+    }
+    if (i + 4 <= n) {
+        vst1q_u32(dst + i, v);
+        i += 4;
+    }
+    fill_scalar(dst + i, bgra, n - i);
+}
+
+static void literal_neon(const uint8_t* argb, uint32_t* dst, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const uint8x16_t a = vld1q_u8(argb + i * 4);
+        const uint8x16_t b = vld1q_u8(argb + i * 4 + 16);
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(vrev32q_u8(a)));
+        vst1q_u32(dst + i + 4, vreinterpretq_u32_u8(vrev32q_u8(b)));
+    }
+    literal_scalar(argb + i * 4, dst + i, n - i);
+}
+#endif
+
+const QtrleKernels& qtrle_scalar_kernels() {
+    static const QtrleKernels k{fill_scalar, literal_scalar, "scalar"};
+    return k;
+}
+
+const QtrleKernels& qtrle_simd_kernels() {
+#if defined(EMP_QTRLE_HAVE_X86)
+    static const QtrleKernels avx2{fill_avx2, literal_avx2, "avx2"};
+    static const QtrleKernels ssse3{fill_sse2, literal_ssse3, "ssse3"};
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    static const bool has_ssse3 = __builtin_cpu_supports("ssse3");
+    if (has_avx2) return avx2;
+    if (has_ssse3) return ssse3;
+#elif defined(EMP_QTRLE_HAVE_NEON)
+    static const QtrleKernels neon{fill_neon, literal_neon, "neon"};
+    return neon;
+#endif
+    return qtrle_scalar_kernels();
+}
+
 Result<void> QtrleDecoder::init(int width, int height) {
     assert(width > 0 && "QtrleDecoder::init: width must be > 0");
     assert(height > 0 && "QtrleDecoder::init: height must be > 0");
@@ -173,27 +293,48 @@ void QtrleDecoder::decode_scanline(
             pos += 4;
 
             int end = std::min(col + count, m_width);
-            for (int i = col; i < end; i++) {
-                row32[i] = pixel;
-            }
+            m_kernels->fill(row32 + col, pixel, end - col);
             col = end;
         } else {
-            // Literal copy: code ARGB pixels
+            // Literal copy: code ARGB pixels; any past the right edge are
+            // consumed but not written
             int count = code;
             int end = std::min(col + count, m_width);
-            for (int i = col; i < end; i++) {
-                row32[i] = argb_to_bgra(data + pos);
-                pos += 4;
-            }
-            // Skip any remaining pixels that went past width
-            if (col + count > m_width) {
-                pos += (col + count - m_width) * 4;
-            }
+            m_kernels->literal(data + pos, row32 + col, end - col);
+            pos += count * 4;
             col = end;
         }
     }
 }
 
+void QtrleDecoder::scale_rows(int oy0, int oy1, uint8_t* scaled_out, int scaled_stride) const {
+    const float scale_x = static_cast<float>(m_width) / m_scaled_w;
+    const float scale_y = static_cast<float>(m_height) / m_scaled_h;
+    const int block_x = std::max(1, static_cast<int>(scale_x));
+    const int block_y = std::max(1, static_cast<int>(scale_y));
+
+    for (int oy = oy0; oy < oy1; oy++) {
+        int sy = static_cast<int>(oy * scale_y);
+        uint8_t* dst_row = scaled_out + static_cast<size_t>(oy) * scaled_stride;
+        for (int ox = 0; ox < m_scaled_w; ox++) {
+            int sx = static_cast<int>(ox * scale_x);
+            uint32_t r = 0, g = 0, b = 0, a = 0;
+            int count = 0;
+            for (int by = 0; by < block_y && (sy + by) < m_height; by++) {
+                const uint8_t* sr = m_ref_buffer.data() + static_cast<size_t>(sy + by) * m_ref_stride;
+                for (int bx = 0; bx < block_x && (sx + bx) < m_width; bx++) {
+                    const uint8_t* p = sr + (sx + bx) * 4;
+                    b += p[0]; g += p[1]; r += p[2]; a += p[3];
+                    count++;
+                }
+            }
+            uint8_t* dp = dst_row + ox * 4;
+            dp[0] = b / count; dp[1] = g / count;
+            dp[2] = r / count; dp[3] = a / count;
+        }
+    }
+}
+
 Result<void> QtrleDecoder::decode(const uint8_t* pkt_data, int pkt_size,
                                   uint8_t* scaled_out, int scaled_stride) {
     assert(pkt_data && "QtrleDecoder::decode: pkt_data is null");
@@ -211,72 +352,89 @@ Result<void> QtrleDecoder::decode(const uint8_t* pkt_data, int pkt_size,
 
     int start_line = hdr.start_line;
     int num_lines = hdr.num_lines;
-    constexpr int NUM_CHUNKS = 16;
-    int lines_per_chunk = (num_lines + NUM_CHUNKS - 1) / NUM_CHUNKS;
+    SlicePool& pool = m_pool ? *m_pool : SlicePool::shared();
+    // A few chunks per thread: scanline cost varies with content (flat
+    // runs vs literals), so finer chunks keep the threads evenly loaded.
+    const int num_chunks = std::max(1, std::min(m_height, std::max(16, pool.width() * 4)));
 
     bool do_scale = scaled_out && m_scaled_w > 0 && m_scaled_h > 0;
     if (do_scale) {
         assert(scaled_stride >= m_scaled_w * 4 &&
             "QtrleDecoder::decode: scaled_stride too small for scaled width");
     }
-    float scale_x = do_scale ? static_cast<float>(m_width) / m_scaled_w : 0;
-    float scale_y = do_scale ? static_cast<float>(m_height) / m_scaled_h : 0;
-
-    // Phase A: Parallel RLE decode into reference buffer
-    dispatch_apply(static_cast<size_t>(NUM_CHUNKS),
-                   dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0),
-                   ^(size_t chunk_idx) {
-        int chunk_start = static_cast<int>(chunk_idx) * lines_per_chunk;
-        int chunk_end = std::min(chunk_start + lines_per_chunk, num_lines);
-        for (int i = chunk_start; i < chunk_end; i++) {
-            int line = start_line + i;
-            if (line >= m_height) break;
+
+    // Decode packet lines covering frame rows [r0, r1).
+    auto decode_rows = [&](int r0, int r1) {
+        const int i0 = std::max(0, r0 - start_line);
+        const int i1 = std::min(num_lines, r1 - start_line);
+        for (int i = i0; i < i1; i++) {
             if (m_line_offsets[i] >= rle_size) continue;
             decode_scanline(rle_data, m_line_offsets[i],
-                            m_ref_buffer.data() + line * m_ref_stride);
+                            m_ref_buffer.data() + static_cast<size_t>(start_line + i) * m_ref_stride);
         }
-    });
-    auto t2 = std::chrono::steady_clock::now();
+    };
 
-    // Phase B: Parallel box downscale — writes directly into caller's buffer
+    // Fused decode + downscale: slices own runs of output rows and decode
+    // exactly the frame rows those output rows' boxes read, so each slice
+    // box-filters its own freshly decoded rows. Box of output row oy is
+    // [sy(oy), sy(oy) + block_y), disjoint from the next row's; the check
+    // below guards float rounding — on failure decode and scale run as
+    // two passes.
+    std::vector<int> bounds;  // frame row where each slice starts, + m_height
+    int scale_chunks = 0, rows_per_chunk = 0;
     if (do_scale) {
-        int block_x = std::max(1, static_cast<int>(scale_x));
-        int block_y = std::max(1, static_cast<int>(scale_y));
-        int scaled_w = m_scaled_w;
-        int scaled_h = m_scaled_h;
-
-        dispatch_apply(static_cast<size_t>(16),
-                       dispatch_get_global_queue(QOS_CLASS_USER_INTERACTIVE, 0),
-                       ^(size_t ci) {
-            int oy0 = static_cast<int>(ci) * ((scaled_h + 15) / 16);
-            int oy1 = std::min(oy0 + ((scaled_h + 15) / 16), scaled_h);
-            for (int oy = oy0; oy < oy1; oy++) {
-                int sy = static_cast<int>(oy * scale_y);
-                uint8_t* dst_row = scaled_out + oy * scaled_stride;
-                for (int ox = 0; ox < scaled_w; ox++) {
-                    int sx = static_cast<int>(ox * scale_x);
-                    uint32_t r = 0, g = 0, b = 0, a = 0;
-                    int count = 0;
-                    for (int by = 0; by < block_y && (sy + by) < m_height; by++) {
-                        const uint8_t* sr = m_ref_buffer.data() + (sy + by) * m_ref_stride;
-                        for (int bx = 0; bx < block_x && (sx + bx) < m_width; bx++) {
-                            const uint8_t* p = sr + (sx + bx) * 4;
-                            b += p[0]; g += p[1]; r += p[2]; a += p[3];
-                            count++;
-                        }
-                    }
-                    uint8_t* dp = dst_row + ox * 4;
-                    dp[0] = b / count; dp[1] = g / count;
-                    dp[2] = r / count; dp[3] = a / count;
-                }
+        const float scale_y = static_cast<float>(m_height) / m_scaled_h;
+        const int block_y = std::max(1, static_cast<int>(scale_y));
+        auto sy = [&](int oy) { return static_cast<int>(oy * scale_y); };
+        scale_chunks = std::max(1, std::min(m_scaled_h, num_chunks));
+        rows_per_chunk = (m_scaled_h + scale_chunks - 1) / scale_chunks;
+        scale_chunks = (m_scaled_h + rows_per_chunk - 1) / rows_per_chunk;
+        bounds.resize(static_cast<size_t>(scale_chunks) + 1);
+        bounds[0] = 0;
+        bounds[scale_chunks] = m_height;
+        for (int c = 1; c < scale_chunks; ++c) {
+            const int oy0 = c * rows_per_chunk;
+            bounds[c] = sy(oy0);
+            if (sy(oy0 - 1) + block_y > bounds[c] || bounds[c] < bounds[c - 1]) {
+                bounds.clear();
+                break;
             }
+        }
+    }
+    auto t2 = t1;
+
+    if (do_scale && !bounds.empty()) {
+        pool.parallel_for(scale_chunks, [&](int c) {
+            decode_rows(bounds[c], bounds[c + 1]);
+            const int oy0 = c * rows_per_chunk;
+            scale_rows(oy0, std::min(oy0 + rows_per_chunk, m_scaled_h), scaled_out, scaled_stride);
         });
+        t2 = std::chrono::steady_clock::now();
+    } else {
+        // Phase A: Parallel RLE decode into reference buffer
+        const int line_chunks = std::max(1, std::min(num_lines, num_chunks));
+        const int lines_per = (num_lines + line_chunks - 1) / line_chunks;
+        pool.parallel_for(line_chunks, [&](int c) {
+            decode_rows(start_line + c * lines_per,
+                        start_line + std::min((c + 1) * lines_per, num_lines));
+        });
+        t2 = std::chrono::steady_clock::now();
+
+        // Phase B: Parallel box downscale — writes directly into caller's buffer
+        if (do_scale) {
+            pool.parallel_for(scale_chunks, [&](int c) {
+                const int oy0 = c * rows_per_chunk;
+                scale_rows(oy0, std::min(oy0 + rows_per_chunk, m_scaled_h),
+                           scaled_out, scaled_stride);
+            });
+        }
     }
     auto t3 = std::chrono::steady_clock::now();
 
     auto us = [](auto a, auto b) {
         return std::chrono::duration_cast<std::chrono::microseconds>(b - a).count();
     };
+    // Fused path: "rle" covers decode + scale, "scale" is ~0.
     QTRLE_LOG_DEBUG("prescan=%.1fms rle=%.1fms scale=%.1fms total=%.1fms out=%dx%d",
             us(t0, t1)/1000.0, us(t1, t2)/1000.0, us(t2, t3)/1000.0,
             us(t0, t3)/1000.0,
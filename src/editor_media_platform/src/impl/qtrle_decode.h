@@ -2,7 +2,8 @@
 
 // Custom parallel QuickTime Animation (qtrle) decoder.
 // Replaces FFmpeg's single-threaded implementation for 32bpp ARGB.
-// Uses GCD dispatch_apply for row-level parallelism.
+// Row-level parallelism runs on SlicePool (slice_pool.h) — portable, so
+// Linux gets the same fast path as macOS (this used GCD dispatch_apply).
 //
 // qtrle format: per-scanline RLE with skip/run/literal opcodes.
 // Delta coding: unchanged pixels persist from previous frame via
@@ -15,6 +16,22 @@
 namespace emp {
 namespace impl {
 
+class SlicePool;
+
+// Scanline primitives decode_scanline is built from. The SIMD set (AVX2 or
+// SSSE3 on x86-64, NEON on ARM, picked per CPU at first use) must match the
+// scalar set byte for byte; test_qtrle_decode checks both.
+struct QtrleKernels {
+    // RLE run: n copies of one BGRA pixel. n <= 0 is a no-op.
+    void (*fill)(uint32_t* dst, uint32_t bgra, int n);
+    // Literal: n ARGB pixels (big-endian byte order) → BGRA. n <= 0 is a no-op.
+    void (*literal)(const uint8_t* argb, uint32_t* dst, int n);
+    const char* name;  // "avx2", "ssse3", "neon" or "scalar"
+};
+
+const QtrleKernels& qtrle_scalar_kernels();
+const QtrleKernels& qtrle_simd_kernels();  // best for this CPU; scalar if none
+
 class QtrleDecoder {
 public:
     // Initialize for given frame dimensions.
@@ -28,7 +45,9 @@ public:
 
     // Decode one qtrle packet into the internal reference buffer.
     // If set_scaled_output was called AND scaled_out is non-null,
-    // also writes a downscaled copy directly into scaled_out.
+    // also writes a downscaled copy directly into scaled_out — in the same
+    // slice pass, each slice box-filtering the rows it just decoded while
+    // they are still in cache.
     // The caller owns scaled_out — decoder writes there, no internal copy.
     Result<void> decode(const uint8_t* pkt_data, int pkt_size,
                         uint8_t* scaled_out = nullptr, int scaled_stride = 0);
@@ -49,9 +68,18 @@ public:
     int width() const { return m_width; }
     int height() const { return m_height; }
 
+    // Pool decode() slices across; SlicePool::shared() unless set (tests and
+    // the scaling benchmark pin the thread count). Not owned.
+    void set_slice_pool(SlicePool* pool) { m_pool = pool; }
+
+    // false pins the scalar kernels (tests compare against them).
+    void set_use_simd(bool on) { m_kernels = on ? &qtrle_simd_kernels() : &qtrle_scalar_kernels(); }
+
 private:
     int m_width = 0;
     int m_height = 0;
+    SlicePool* m_pool = nullptr;
+    const QtrleKernels* m_kernels = &qtrle_simd_kernels();
 
     // Reference frame in BGRA format. Persists across frames for delta coding.
     // Stride is 32-byte aligned.
@@ -81,6 +109,9 @@ private:
     // Decode a single scanline from opcode stream into reference buffer.
     // row_ptr points to start of this row in m_ref_buffer.
     void decode_scanline(const uint8_t* data, int offset, uint8_t* row_ptr);
+
+    // Box-downscale output rows [oy0, oy1) from the reference buffer.
+    void scale_rows(int oy0, int oy1, uint8_t* scaled_out, int scaled_stride) const;
 };
 
 } // namespace impl
@@ -0,0 +1,96 @@
+#include "slice_pool.h"
+#include <editor_media_platform/emp_cpu_budget.h>
+#include <algorithm>
+#include <cassert>
+
+namespace emp {
+namespace impl {
+
+SlicePool& SlicePool::shared() {
+    // Leaked on purpose: a decode racing process exit must not find the
+    // workers joined under it by static destruction.
+    static SlicePool* pool = new SlicePool(CpuBudgetSliceWorkers());
+    return *pool;
+}
+
+SlicePool::SlicePool(int workers) {
+    assert(workers >= 0 && "SlicePool: workers must be >= 0");
+    m_workers.reserve(static_cast<size_t>(workers));
+    for (int i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&SlicePool::worker_loop, this);
+    }
+}
+
+SlicePool::~SlicePool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for (auto& t : m_workers) t.join();
+}
+
+void SlicePool::run_slices(Job& job) {
+    int i;
+    while ((i = job.next.fetch_add(1, std::memory_order_relaxed)) < job.n) {
+        (*job.fn)(i);
+        if (job.done.fetch_add(1, std::memory_order_acq_rel) + 1 == job.n) {
+            // Notify under the lock: the caller checks `done` under it, so
+            // the wakeup can't slip in between its check and its wait.
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done_cv.notify_all();
+        }
+    }
+}
+
+void SlicePool::worker_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_work_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+        if (m_stop) return;
+        std::shared_ptr<Job> job = m_jobs.front();
+        if (job->next.load(std::memory_order_relaxed) >= job->n) {
+            // Every slice claimed (some may still be running elsewhere).
+            m_jobs.pop_front();
+            continue;
+        }
+        lock.unlock();
+        run_slices(*job);
+        lock.lock();
+    }
+}
+
+void SlicePool::parallel_for(int n, const std::function<void(int)>& fn) {
+    if (n <= 0) return;
+    if (n == 1 || m_workers.empty()) {
+        for (int i = 0; i < n; ++i) fn(i);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->fn = &fn;
+    job->n = n;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(job);
+    }
+    // One wakeup per slice beyond the caller's own; extra workers would
+    // only find the job exhausted.
+    if (n - 1 >= static_cast<int>(m_workers.size())) {
+        m_work_cv.notify_all();
+    } else {
+        for (int i = 0; i < n - 1; ++i) m_work_cv.notify_one();
+    }
+
+    run_slices(*job);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = std::find(m_jobs.begin(), m_jobs.end(), job);
+    if (it != m_jobs.end()) m_jobs.erase(it);
+    // Workers may still be inside fn; `fn` lives on the caller's stack, so
+    // don't return until the last slice has finished.
+    m_done_cv.wait(lock, [&] { return job->done.load(std::memory_order_acquire) == n; });
+}
+
+} // namespace impl
+} // namespace emp
@@ -0,0 +1,65 @@
+#pragma once
+
+// Internal header — small shared worker pool for splitting one frame's
+// per-row work (pixel conversion, scaling) into slices.
+//
+// Every TMB prefetch worker converts its own frames, so several callers can
+// be in parallel_for at once. Each call is a job on a shared queue; the
+// caller works its own job's slices too, so a call never waits on a pool
+// that is busy with somebody else's frame — with every worker taken it just
+// runs serially on the calling thread.
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace emp {
+namespace impl {
+
+class SlicePool {
+public:
+    // Process-wide pool: CpuBudgetSliceWorkers() workers, sized once at
+    // first use. The budget leaves that share out of the TMB decode pool
+    // and the codec threads, so the three never add up past the machine.
+    static SlicePool& shared();
+
+    explicit SlicePool(int workers);
+    ~SlicePool();
+
+    SlicePool(const SlicePool&) = delete;
+    SlicePool& operator=(const SlicePool&) = delete;
+
+    // Threads that can run one job's slices: workers + the caller.
+    int width() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    // Run fn(0) .. fn(n-1), each exactly once, on the workers and the
+    // calling thread; returns when all have finished. fn must not throw.
+    void parallel_for(int n, const std::function<void(int)>& fn);
+
+private:
+    struct Job {
+        const std::function<void(int)>* fn = nullptr;
+        int n = 0;
+        std::atomic<int> next{0};
+        std::atomic<int> done{0};
+    };
+
+    // Claim and run slices of `job` until none are left.
+    void run_slices(Job& job);
+    void worker_loop();
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;   // jobs queued / stop
+    std::condition_variable m_done_cv;   // some job's last slice finished
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    bool m_stop = false;
+    std::vector<std::thread> m_workers;
+};
+
+} // namespace impl
+} // namespace emp
@@ -0,0 +1,48 @@
+#include "task_pool.h"
+#include <cassert>
+
+namespace emp {
+namespace impl {
+
+TaskPool::TaskPool(int workers) {
+    assert(workers > 0 && "TaskPool: workers must be > 0");
+    m_workers.reserve(static_cast<size_t>(workers));
+    for (int i = 0; i < workers; ++i) {
+        m_workers.emplace_back(&TaskPool::worker_loop, this);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& t : m_workers) t.join();
+}
+
+void TaskPool::post(std::function<void()> fn) {
+    assert(fn && "TaskPool::post: fn must be set");
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(fn));
+    }
+    m_cv.notify_one();
+}
+
+void TaskPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        if (m_stop) return;
+        std::function<void()> fn = std::move(m_queue.front());
+        m_queue.pop_front();
+        lock.unlock();
+        fn();
+        fn = nullptr;  // drop captures (a source ref) before sleeping
+        lock.lock();
+    }
+}
+
+} // namespace impl
+} // namespace emp
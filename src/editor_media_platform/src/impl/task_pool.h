@@ -0,0 +1,41 @@
+#pragma once
+
+// Internal header — small FIFO pool for background work that blocks on
+// something other than the CPU (DemuxSource read-ahead). Callers never
+// block on the pool — post() queues and returns.
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace emp {
+namespace impl {
+
+class TaskPool {
+public:
+    explicit TaskPool(int workers);
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    int worker_count() const { return static_cast<int>(m_workers.size()); }
+
+    // Queue fn to run on a worker, FIFO. fn must not throw.
+    void post(std::function<void()> fn);
+
+private:
+    void worker_loop();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<std::function<void()>> m_queue;
+    bool m_stop = false;
+    std::vector<std::thread> m_workers;
+};
+
+} // namespace impl
+} // namespace emp
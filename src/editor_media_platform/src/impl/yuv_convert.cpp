@@ -0,0 +1,477 @@
+#include "yuv_convert.h"
+#include "slice_pool.h"
+#include "../../../assert_handler.h"  // JVE_ASSERT
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define EMP_YUV_HAVE_AVX2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define EMP_YUV_HAVE_NEON 1
+#endif
+
+namespace emp {
+namespace impl {
+
+// Output rows per slice floor: below this the wakeup costs more than the
+// rows. 4K → 2160 / 32 = 67 slices before the pool-width clamp.
+static constexpr int MIN_SLICE_ROWS = 32;
+
+// ============================================================================
+// Coefficients
+// ============================================================================
+
+// BT.601, Q12 of the float coefficient (the extra >> 2 from the 10-bit
+// input scale is folded into the final >> 14).
+static constexpr YuvConverter::Coeffs BT601_LIMITED = {
+    64, 512,     // 16 << 2, 128 << 2
+    4769,        // 255/219  = 1.164383
+    6537,        //            1.596027
+    -1605,       //           -0.391762
+    -3330,       //           -0.812968
+    8263,        //            2.017232
+};
+static constexpr YuvConverter::Coeffs BT601_FULL = {
+    0, 512,
+    4096,        // 1.0
+    5743,        // 1.402
+    -1410,       // -0.344136
+    -2925,       // -0.714136
+    7258,        // 1.772
+};
+
+// ============================================================================
+// Row kernels — y/u/v are dst-width rows on the 10-bit scale; every kernel
+// computes exactly the scalar kernel's integer math, so output is identical
+// whichever one the CPU gets.
+// ============================================================================
+
+static inline int clamp_u8(int x) {
+    return x < 0 ? 0 : (x > 255 ? 255 : x);
+}
+
+static void row_scalar(const int16_t* y, const int16_t* u, const int16_t* v,
+                       uint8_t* dst, int n, const YuvConverter::Coeffs& c) {
+    uint32_t* out = reinterpret_cast<uint32_t*>(dst);
+    for (int i = 0; i < n; ++i) {
+        const int yy = (y[i] - c.y_off) * c.cy + (1 << 13);
+        const int uu = u[i] - c.c_off;
+        const int vv = v[i] - c.c_off;
+        const int r = clamp_u8((yy + c.crv * vv) >> 14);
+        const int g = clamp_u8((yy + c.cgu * uu + c.cgv * vv) >> 14);
+        const int b = clamp_u8((yy + c.cbu * uu) >> 14);
+        // BGRA byte order: [B, G, R, A]
+        out[i] = static_cast<uint32_t>(b)
+               | (static_cast<uint32_t>(g) << 8)
+               | (static_cast<uint32_t>(r) << 16)
+               | 0xFF000000u;
+    }
+}
+
+#ifdef EMP_YUV_HAVE_AVX2
+// 8 pixels per iteration in 32-bit lanes. Packing through 32-bit words
+// (b | g<<8 | r<<16 | a<<24) sidesteps AVX2's per-128-bit-lane pack order.
+__attribute__((target("avx2")))
+static void row_avx2(const int16_t* y, const int16_t* u, const int16_t* v,
+                     uint8_t* dst, int n, const YuvConverter::Coeffs& c) {
+    const __m256i y_off = _mm256_set1_epi32(c.y_off);
+    const __m256i c_off = _mm256_set1_epi32(c.c_off);
+    const __m256i cy = _mm256_set1_epi32(c.cy);
+    const __m256i crv = _mm256_set1_epi32(c.crv);
+    const __m256i cgu = _mm256_set1_epi32(c.cgu);
+    const __m256i cgv = _mm256_set1_epi32(c.cgv);
+    const __m256i cbu = _mm256_set1_epi32(c.cbu);
+    const __m256i rnd = _mm256_set1_epi32(1 << 13);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max8 = _mm256_set1_epi32(255);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i Y = _mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i)));
+        const __m256i U = _mm256_sub_epi32(_mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + i))), c_off);
+        const __m256i V = _mm256_sub_epi32(_mm256_cvtepi16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i))), c_off);
+        const __m256i yy = _mm256_add_epi32(
+            _mm256_mullo_epi32(_mm256_sub_epi32(Y, y_off), cy), rnd);
+
+        __m256i r = _mm256_srai_epi32(_mm256_add_epi32(yy, _mm256_mullo_epi32(V, crv)), 14);
+        __m256i g = _mm256_srai_epi32(_mm256_add_epi32(
+            _mm256_add_epi32(yy, _mm256_mullo_epi32(U, cgu)), _mm256_mullo_epi32(V, cgv)), 14);
+        __m256i b = _mm256_srai_epi32(_mm256_add_epi32(yy, _mm256_mullo_epi32(U, cbu)), 14);
+        r = _mm256_min_epi32(_mm256_max_epi32(r, zero), max8);
+        g = _mm256_min_epi32(_mm256_max_epi32(g, zero), max8);
+        b = _mm256_min_epi32(_mm256_max_epi32(b, zero), max8);
+
+        const __m256i px = _mm256_or_si256(
+            _mm256_or_si256(b, _mm256_slli_epi32(g, 8)),
+            _mm256_or_si256(_mm256_slli_epi32(r, 16), alpha));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), px);
+    }
+    row_scalar(y + i, u + i, v + i, dst + i * 4, n - i, c);
+}
+#endif
+
+#ifdef EMP_YUV_HAVE_NEON
+static inline uint32x4_t neon_px4(int16x4_t y4, int16x4_t u4, int16x4_t v4,
+                                  const YuvConverter::Coeffs& c) {
+    const int32x4_t yy = vmlaq_s32(vdupq_n_s32(1 << 13),
+                                   vsubq_s32(vmovl_s16(y4), vdupq_n_s32(c.y_off)),
+                                   vdupq_n_s32(c.cy));
+    const int32x4_t uu = vsubq_s32(vmovl_s16(u4), vdupq_n_s32(c.c_off));
+    const int32x4_t vv = vsubq_s32(vmovl_s16(v4), vdupq_n_s32(c.c_off));
+    const int32x4_t zero = vdupq_n_s32(0);
+    const int32x4_t max8 = vdupq_n_s32(255);
+
+    int32x4_t r = vshrq_n_s32(vmlaq_s32(yy, vv, vdupq_n_s32(c.crv)), 14);
+    int32x4_t g = vshrq_n_s32(vmlaq_s32(vmlaq_s32(yy, uu, vdupq_n_s32(c.cgu)),
+                                        vv, vdupq_n_s32(c.cgv)), 14);
+    int32x4_t b = vshrq_n_s32(vmlaq_s32(yy, uu, vdupq_n_s32(c.cbu)), 14);
+    r = vminq_s32(vmaxq_s32(r, zero), max8);
+    g = vminq_s32(vmaxq_s32(g, zero), max8);
+    b = vminq_s32(vmaxq_s32(b, zero), max8);
+
+    uint32x4_t px = vreinterpretq_u32_s32(b);
+    px = vorrq_u32(px, vshlq_n_u32(vreinterpretq_u32_s32(g), 8));
+    px = vorrq_u32(px, vshlq_n_u32(vreinterpretq_u32_s32(r), 16));
+    return vorrq_u32(px, vdupq_n_u32(0xFF000000u));
+}
+
+static void row_neon(const int16_t* y, const int16_t* u, const int16_t* v,
+                     uint8_t* dst, int n, const YuvConverter::Coeffs& c) {
+    uint32_t* out = reinterpret_cast<uint32_t*>(dst);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t Y = vld1q_s16(y + i);
+        const int16x8_t U = vld1q_s16(u + i);
+        const int16x8_t V = vld1q_s16(v + i);
+        vst1q_u32(out + i, neon_px4(vget_low_s16(Y), vget_low_s16(U), vget_low_s16(V), c));
+        vst1q_u32(out + i + 4, neon_px4(vget_high_s16(Y), vget_high_s16(U), vget_high_s16(V), c));
+    }
+    row_scalar(y + i, u + i, v + i, dst + i * 4, n - i, c);
+}
+#endif
+
+static YuvConverter::RowKernel simd_kernel() {
+#if defined(EMP_YUV_HAVE_AVX2)
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) return row_avx2;
+#elif defined(EMP_YUV_HAVE_NEON)
+    return row_neon;
+#endif
+    return row_scalar;
+}
+
+const char* YuvConverter::simd_kernel_name() {
+    const RowKernel k = simd_kernel();
+#if defined(EMP_YUV_HAVE_AVX2)
+    if (k == row_avx2) return "avx2";
+#elif defined(EMP_YUV_HAVE_NEON)
+    if (k == row_neon) return "neon";
+#endif
+    (void)k;
+    return "scalar";
+}
+
+// ============================================================================
+// Row fetch — source planes → dst-width y/u/v rows on the 10-bit scale
+// ============================================================================
+
+// Sample x of one plane row, widened to 10 bits. STEP/OFFSET address NV12's
+// interleaved UV; TEN_BIT reads 16-bit little-endian samples. raw(j) reads
+// the j-th stored sample regardless of interleave (box accumulation sums
+// whole rows and picks its channel afterwards).
+template <int STEP_, int OFFSET_, bool TEN_BIT>
+struct PlaneReader {
+    static constexpr int STEP = STEP_;
+    static constexpr int OFFSET = OFFSET_;
+    static inline int raw(const uint8_t* row, int j) {
+        if (TEN_BIT) {
+            uint16_t s;
+            std::memcpy(&s, row + 2 * j, sizeof(s));
+            return s & 0x3FF;
+        }
+        return row[j] << 2;
+    }
+    static inline int at(const uint8_t* row, int x) { return raw(row, x * STEP + OFFSET); }
+};
+
+// Rounded sum / cnt. Power-of-two boxes — 2x and 4x downscales, the common
+// SetMaxOutputResolution ratios — skip the divide.
+static inline int div_round(int sum, int cnt) {
+    if ((cnt & (cnt - 1)) == 0) return (sum + (cnt >> 1)) >> __builtin_ctz(static_cast<unsigned>(cnt));
+    return (sum + cnt / 2) / cnt;
+}
+
+// identity_shift >= 0: 1:1 row, sample i >> identity_shift (chroma
+// replication, as swscale's unscaled converters do). Otherwise the box
+// average of `rows` x cols[i], accumulated through `acc` (one int per
+// stored sample of the plane row).
+template <typename R>
+static void fetch_plane(const uint8_t* base, int stride, YuvConverter::Span rows,
+                        const YuvConverter::Span* cols, int n, int identity_shift,
+                        int32_t* acc, int16_t* out) {
+    if (identity_shift >= 0) {
+        const uint8_t* row = base + static_cast<ptrdiff_t>(rows.first) * stride;
+        if (identity_shift == 0) {
+            for (int i = 0; i < n; ++i) out[i] = static_cast<int16_t>(R::at(row, i));
+        } else {
+            // Half-width chroma: each sample covers two output pixels.
+            int i = 0;
+            for (; i + 1 < n; i += 2) {
+                const int16_t s = static_cast<int16_t>(R::at(row, i >> 1));
+                out[i] = s;
+                out[i + 1] = s;
+            }
+            if (i < n) out[i] = static_cast<int16_t>(R::at(row, i >> 1));
+        }
+        return;
+    }
+
+    // Vertical pass: sum the span's rows sample by sample (contiguous, so
+    // it vectorizes); horizontal pass: each column sums its run of `acc`.
+    const YuvConverter::Span last = cols[n - 1];
+    const int samples = (last.first + last.count) * R::STEP;
+    const uint8_t* row = base + static_cast<ptrdiff_t>(rows.first) * stride;
+    for (int j = 0; j < samples; ++j) acc[j] = R::raw(row, j);
+    for (int r = 1; r < rows.count; ++r) {
+        row += stride;
+        for (int j = 0; j < samples; ++j) acc[j] += R::raw(row, j);
+    }
+    for (int i = 0; i < n; ++i) {
+        const YuvConverter::Span col = cols[i];
+        const int32_t* a = acc + col.first * R::STEP + R::OFFSET;
+        int sum = 0;
+        for (int k = 0; k < col.count; ++k) sum += a[k * R::STEP];
+        out[i] = static_cast<int16_t>(div_round(sum, rows.count * col.count));
+    }
+}
+
+void YuvConverter::fetch_row(int oy, const uint8_t* const planes[3], const int strides[3],
+                             int32_t* acc, int16_t* y, int16_t* u, int16_t* v) const {
+    using P8 = PlaneReader<1, 0, false>;
+    using P10 = PlaneReader<1, 0, true>;
+    const int n = m_dst_w;
+    const int luma_id = m_identity ? 0 : -1;
+    const int chroma_id = m_identity ? m_chroma_shift_x : -1;
+    const Span ly = m_luma_y[static_cast<size_t>(oy)];
+    const Span cy = m_chroma_y[static_cast<size_t>(oy)];
+    const Span* lx = m_luma_x.data();
+    const Span* cx = m_chroma_x.data();
+
+    switch (m_layout) {
+    case YuvLayout::I420:
+    case YuvLayout::I444:
+        fetch_plane<P8>(planes[0], strides[0], ly, lx, n, luma_id, acc, y);
+        fetch_plane<P8>(planes[1], strides[1], cy, cx, n, chroma_id, acc, u);
+        fetch_plane<P8>(planes[2], strides[2], cy, cx, n, chroma_id, acc, v);
+        break;
+    case YuvLayout::NV12:
+        fetch_plane<P8>(planes[0], strides[0], ly, lx, n, luma_id, acc, y);
+        fetch_plane<PlaneReader<2, 0, false>>(planes[1], strides[1], cy, cx, n, chroma_id, acc, u);
+        fetch_plane<PlaneReader<2, 1, false>>(planes[1], strides[1], cy, cx, n, chroma_id, acc, v);
+        break;
+    case YuvLayout::I422P10:
+        fetch_plane<P10>(planes[0], strides[0], ly, lx, n, luma_id, acc, y);
+        fetch_plane<P10>(planes[1], strides[1], cy, cx, n, chroma_id, acc, u);
+        fetch_plane<P10>(planes[2], strides[2], cy, cx, n, chroma_id, acc, v);
+        break;
+    }
+}
+
+// ============================================================================
+// Setup / convert
+// ============================================================================
+
+// Box spans along one axis, qtrle-downscale style: block = floor(src/dst)
+// samples starting at floor(o * src / dst). Chroma spans cover the chroma
+// samples under each luma span.
+static void build_spans(int src, int dst, int chroma_shift,
+                        std::vector<YuvConverter::Span>& luma,
+                        std::vector<YuvConverter::Span>& chroma) {
+    const int block = std::max(1, src / dst);
+    const int chroma_size = (src + (1 << chroma_shift) - 1) >> chroma_shift;
+    luma.resize(static_cast<size_t>(dst));
+    chroma.resize(static_cast<size_t>(dst));
+    for (int o = 0; o < dst; ++o) {
+        const int first = static_cast<int>(static_cast<int64_t>(o) * src / dst);
+        const int count = std::min(block, src - first);
+        luma[static_cast<size_t>(o)] = {first, count};
+        const int c0 = first >> chroma_shift;
+        const int c1 = std::min((first + count - 1) >> chroma_shift, chroma_size - 1);
+        chroma[static_cast<size_t>(o)] = {c0, c1 - c0 + 1};
+    }
+}
+
+void YuvConverter::init(YuvLayout layout, YuvRange range, int src_w, int src_h,
+                        int dst_w, int dst_h, bool use_simd) {
+    JVE_ASSERT(src_w > 0 && src_h > 0, "YuvConverter::init: empty source");
+    JVE_ASSERT(dst_w > 0 && dst_h > 0 && dst_w <= src_w && dst_h <= src_h,
+        "YuvConverter::init: output must be non-empty and no larger than the source");
+
+    m_layout = layout;
+    m_range = range;
+    m_src_w = src_w;
+    m_src_h = src_h;
+    m_dst_w = dst_w;
+    m_dst_h = dst_h;
+    m_chroma_shift_x = layout == YuvLayout::I444 ? 0 : 1;
+    m_chroma_shift_y = (layout == YuvLayout::I420 || layout == YuvLayout::NV12) ? 1 : 0;
+    m_identity = dst_w == src_w && dst_h == src_h;
+    m_coeffs = range == YuvRange::Full ? BT601_FULL : BT601_LIMITED;
+    m_kernel = use_simd ? simd_kernel() : row_scalar;
+
+    build_spans(src_w, dst_w, m_chroma_shift_x, m_luma_x, m_chroma_x);
+    build_spans(src_h, dst_h, m_chroma_shift_y, m_luma_y, m_chroma_y);
+}
+
+void YuvConverter::convert(const uint8_t* const planes[3], const int strides[3],
+                           uint8_t* dst, int dst_stride) const {
+    JVE_ASSERT(initialized(), "YuvConverter::convert: init() not called");
+    assert(dst && "YuvConverter::convert: dst is null");
+    assert(dst_stride >= m_dst_w * 4 && "YuvConverter::convert: dst_stride too small");
+
+    SlicePool& pool = SlicePool::shared();
+    const int slices = std::clamp(m_dst_h / MIN_SLICE_ROWS, 1, pool.width() * 2);
+    const int rows_per_slice = (m_dst_h + slices - 1) / slices;
+
+    pool.parallel_for(slices, [&](int s) {
+        // Per-thread row scratch: grows to the widest output seen, then
+        // converts allocation-free.
+        thread_local std::vector<int16_t> scratch;
+        thread_local std::vector<int32_t> acc;
+        const size_t pad = (static_cast<size_t>(m_dst_w) + 15) & ~size_t(15);
+        if (scratch.size() < 3 * pad) scratch.resize(3 * pad);
+        // Box accumulator: one int per stored sample of the widest plane
+        // row (NV12's interleaved UV row is 2 x chroma width).
+        if (acc.size() < static_cast<size_t>(m_src_w) + 1) acc.resize(static_cast<size_t>(m_src_w) + 1);
+        int16_t* y = scratch.data();
+        int16_t* u = y + pad;
+        int16_t* v = u + pad;
+
+        const int oy0 = s * rows_per_slice;
+        const int oy1 = std::min(oy0 + rows_per_slice, m_dst_h);
+        for (int oy = oy0; oy < oy1; ++oy) {
+            fetch_row(oy, planes, strides, acc.data(), y, u, v);
+            m_kernel(y, u, v, dst + static_cast<ptrdiff_t>(oy) * dst_stride, m_dst_w, m_coeffs);
+        }
+    });
+}
+
+// ============================================================================
+// Planar storage
+// ============================================================================
+
+YuvPlaneGeometry yuv_plane_geometry(YuvLayout layout, int w, int h) {
+    assert(w > 0 && h > 0 && "yuv_plane_geometry: empty frame");
+    YuvPlaneGeometry g;
+    const int sx = layout == YuvLayout::I444 ? 0 : 1;
+    const int sy = (layout == YuvLayout::I420 || layout == YuvLayout::NV12) ? 1 : 0;
+    const int cw = (w + (1 << sx) - 1) >> sx;
+    const int ch = (h + (1 << sy) - 1) >> sy;
+    g.bytes_per_sample = layout == YuvLayout::I422P10 ? 2 : 1;
+    g.planes = layout == YuvLayout::NV12 ? 2 : 3;
+    g.width[0] = w;
+    g.height[0] = h;
+    for (int p = 1; p < g.planes; ++p) {
+        g.width[p] = cw;
+        g.height[p] = ch;
+    }
+    const int channels1 = layout == YuvLayout::NV12 ? 2 : 1;
+    for (int p = 0; p < g.planes; ++p) {
+        const int row_bytes = g.width[p] * g.bytes_per_sample * (p == 1 ? channels1 : 1);
+        g.stride[p] = (row_bytes + 31) & ~31;
+        g.offset[p] = g.total;
+        g.total += static_cast<size_t>(g.stride[p]) * g.height[p];
+    }
+    return g;
+}
+
+// Box-downscale (or copy, at equal size) one plane of `channels`
+// interleaved samples of `bps` bytes each, rows [y0, y1) of the output.
+static void resample_plane_rows(const uint8_t* src, int src_stride, int sw, int sh,
+                                uint8_t* dst, int dst_stride, int dw, int dh,
+                                int bps, int channels, int y0, int y1,
+                                const std::vector<YuvConverter::Span>& xs,
+                                const std::vector<YuvConverter::Span>& ys) {
+    const int row_bytes = dw * bps * channels;
+    if (sw == dw && sh == dh) {
+        for (int y = y0; y < y1; ++y) {
+            std::memcpy(dst + static_cast<ptrdiff_t>(y) * dst_stride,
+                        src + static_cast<ptrdiff_t>(y) * src_stride, static_cast<size_t>(row_bytes));
+        }
+        return;
+    }
+    auto sample = [bps](const uint8_t* row, int idx) -> int {
+        if (bps == 2) {
+            uint16_t s;
+            std::memcpy(&s, row + 2 * idx, sizeof(s));
+            return s;
+        }
+        return row[idx];
+    };
+    for (int y = y0; y < y1; ++y) {
+        const YuvConverter::Span sy = ys[static_cast<size_t>(y)];
+        uint8_t* out = dst + static_cast<ptrdiff_t>(y) * dst_stride;
+        for (int x = 0; x < dw; ++x) {
+            const YuvConverter::Span sx = xs[static_cast<size_t>(x)];
+            for (int c = 0; c < channels; ++c) {
+                int sum = 0;
+                for (int r = 0; r < sy.count; ++r) {
+                    const uint8_t* row = src + static_cast<ptrdiff_t>(sy.first + r) * src_stride;
+                    for (int k = 0; k < sx.count; ++k) {
+                        sum += sample(row, (sx.first + k) * channels + c);
+                    }
+                }
+                const int v = div_round(sum, sy.count * sx.count);
+                const int idx = x * channels + c;
+                if (bps == 2) {
+                    const uint16_t s = static_cast<uint16_t>(v);
+                    std::memcpy(out + 2 * idx, &s, sizeof(s));
+                } else {
+                    out[idx] = static_cast<uint8_t>(v);
+                }
+            }
+        }
+    }
+}
+
+void yuv_resample_planes(YuvLayout layout, const uint8_t* const src[3], const int src_stride[3],
+                         int src_w, int src_h, uint8_t* dst, const YuvPlaneGeometry& g) {
+    JVE_ASSERT(g.width[0] <= src_w && g.height[0] <= src_h,
+        "yuv_resample_planes: output larger than source");
+    const YuvPlaneGeometry sg = yuv_plane_geometry(layout, src_w, src_h);
+
+    // Spans per plane (luma, chroma); unused at equal size.
+    std::vector<YuvConverter::Span> xs[3], ys[3], unused;
+    const bool identity = g.width[0] == src_w && g.height[0] == src_h;
+    if (!identity) {
+        for (int p = 0; p < g.planes; ++p) {
+            build_spans(sg.width[p], g.width[p], 0, xs[p], unused);
+            build_spans(sg.height[p], g.height[p], 0, ys[p], unused);
+        }
+    }
+
+    SlicePool& pool = SlicePool::shared();
+    const int slices = std::clamp(g.height[0] / MIN_SLICE_ROWS, 1, pool.width() * 2);
+    pool.parallel_for(slices, [&](int s) {
+        for (int p = 0; p < g.planes; ++p) {
+            const int h = g.height[p];
+            const int y0 = static_cast<int>(static_cast<int64_t>(h) * s / slices);
+            const int y1 = static_cast<int>(static_cast<int64_t>(h) * (s + 1) / slices);
+            resample_plane_rows(src[p], src_stride[p], sg.width[p], sg.height[p],
+                                dst + g.offset[p], g.stride[p], g.width[p], g.height[p],
+                                g.bytes_per_sample, (layout == YuvLayout::NV12 && p == 1) ? 2 : 1,
+                                y0, y1, xs[p], ys[p]);
+        }
+    });
+}
+
+} // namespace impl
+} // namespace emp
@@ -0,0 +1,118 @@
+#pragma once
+
+// Internal header — native YUV → BGRA32 converter for the SW decode hot path.
+//
+// swscale ran every software-decoded frame through one thread inside the
+// prefetch worker; at 4K60 that conversion was a large share of per-frame
+// cost. This converter covers the layouts that dominate the timeline
+// (yuv420p, nv12, yuv422p10le, yuv444p) with an AVX2 / NEON row kernel,
+// splits output rows into slices across SlicePool, and folds the
+// SetMaxOutputResolution downscale into the same pass: each output row
+// box-averages its source rows in YUV, then converts once. FFmpegScaleContext
+// falls back to swscale for every other format.
+//
+// Parity with swscale as configured by FFmpegScaleContext: BT.601 matrix
+// (swscale's default — it never sees the stream's colorspace), limited range
+// except for the yuvj formats, chroma replicated at 1:1. Differences are
+// rounding-level (≤ a few code values); test_yuv_convert pins the tolerance.
+//
+// FFmpeg-free on purpose (plain plane pointers) so the kernels can be tested
+// and benchmarked against swscale without an AVFrame in between.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace emp {
+namespace impl {
+
+enum class YuvLayout {
+    I420,     // Y, U, V planes; chroma half width, half height (8-bit)
+    NV12,     // Y plane + interleaved UV plane; chroma half width, half height
+    I422P10,  // Y, U, V planes of 16-bit LE samples, 10 significant bits;
+              // chroma half width, full height
+    I444,     // Y, U, V planes; full-resolution chroma (8-bit)
+};
+
+enum class YuvRange { Limited, Full };
+
+class YuvConverter {
+public:
+    // Configure for src_w x src_h input in `layout`, converting (and box-
+    // downscaling) to dst_w x dst_h BGRA. dst must not exceed src in either
+    // axis. use_simd=false pins the scalar kernel (tests compare against it).
+    void init(YuvLayout layout, YuvRange range, int src_w, int src_h,
+              int dst_w, int dst_h, bool use_simd = true);
+
+    bool initialized() const { return m_dst_w > 0; }
+    YuvLayout layout() const { return m_layout; }
+    YuvRange range() const { return m_range; }
+    int dst_width() const { return m_dst_w; }
+    int dst_height() const { return m_dst_h; }
+
+    // Convert one frame. planes/strides as in AVFrame::data/linesize
+    // (NV12 uses planes[0..1]). dst_stride >= dst_width * 4.
+    void convert(const uint8_t* const planes[3], const int strides[3],
+                 uint8_t* dst, int dst_stride) const;
+
+    // Row kernel the build and CPU resolved to: "avx2", "neon" or "scalar".
+    static const char* simd_kernel_name();
+
+    // Fixed-point YUV→RGB coefficients on a 10-bit input scale (8-bit
+    // samples are widened by << 2): out8 = (coef * (in10 - off) + round) >> 14.
+    struct Coeffs {
+        int32_t y_off, c_off;
+        int32_t cy, crv, cgu, cgv, cbu;
+    };
+    using RowKernel = void (*)(const int16_t* y, const int16_t* u, const int16_t* v,
+                               uint8_t* dst, int n, const Coeffs& c);
+
+    // Source box of one output coordinate: first sample and sample count.
+    struct Span { int first; int count; };
+
+private:
+    // Fill y/u/v rows (dst_w samples, 10-bit scale) for output row `oy`.
+    // acc: box-filter scratch, src_w + 1 ints.
+    void fetch_row(int oy, const uint8_t* const planes[3], const int strides[3],
+                   int32_t* acc, int16_t* y, int16_t* u, int16_t* v) const;
+
+    YuvLayout m_layout = YuvLayout::I420;
+    YuvRange m_range = YuvRange::Limited;
+    int m_src_w = 0, m_src_h = 0;
+    int m_dst_w = 0, m_dst_h = 0;
+    int m_chroma_shift_x = 0, m_chroma_shift_y = 0;
+    bool m_identity = false;  // 1:1 — no box filter, chroma replicated
+    Coeffs m_coeffs{};
+    RowKernel m_kernel = nullptr;
+
+    // Per output column / row: luma and chroma source spans.
+    std::vector<Span> m_luma_x, m_chroma_x;
+    std::vector<Span> m_luma_y, m_chroma_y;
+};
+
+// ============================================================================
+// Planar storage — frames kept as YUV (emp::Frame::pixel_format() != BGRA32)
+// ============================================================================
+
+// Plane arrangement of a w x h frame in `layout` inside one buffer: rows
+// 32-byte aligned, planes back to back. NV12 has two planes (Y, UV).
+struct YuvPlaneGeometry {
+    int planes = 0;
+    int bytes_per_sample = 1;  // 2 for I422P10 (16-bit LE containers)
+    int width[3] = {0, 0, 0};  // in samples; NV12 plane 1 counts UV pairs
+    int height[3] = {0, 0, 0};
+    int stride[3] = {0, 0, 0};
+    size_t offset[3] = {0, 0, 0};
+    size_t total = 0;
+};
+
+YuvPlaneGeometry yuv_plane_geometry(YuvLayout layout, int w, int h);
+
+// Copy a src_w x src_h frame's planes into `dst` (laid out per `g`), box-
+// downscaling each plane when g describes a smaller frame. Rows are sliced
+// across SlicePool like YuvConverter::convert.
+void yuv_resample_planes(YuvLayout layout, const uint8_t* const src[3], const int src_stride[3],
+                         int src_w, int src_h, uint8_t* dst, const YuvPlaneGeometry& g);
+
+} // namespace impl
+} // namespace emp
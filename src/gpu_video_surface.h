@@ -7,6 +7,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <editor_media_platform/emp_cdl.h>
 #include <editor_media_platform/emp_lut3d.h>
@@ -177,6 +178,10 @@ private:
     // setFrame MUST overwrite this before draw. See public CscParams
     // declaration above for layout invariants.
     CscParams m_csc{};
+
+    // BGRA conversion target for planar YUV frames on the SW path (main
+    // thread only; setFrameSW uploads synchronously).
+    std::vector<uint8_t> m_sw_staging;
 };
 
 #else
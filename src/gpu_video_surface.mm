@@ -665,12 +665,19 @@ void GPUVideoSurface::setFrameImpl(const std::shared_ptr<emp::Frame>& frame) {
     void* hw_buffer = frame->native_buffer();
     if (hw_buffer) {
         setFrameHW(hw_buffer, frame->width(), frame->height());
-    } else {
-        setFrameSW(frame->data(), frame->width(), frame->height(), frame->stride_bytes());
+        return;
     }
-#else
-    setFrameSW(frame->data(), frame->width(), frame->height(), frame->stride_bytes());
 #endif
+    if (frame->is_yuv()) {
+        // Planar YUV (TMB cache): convert into the surface's staging buffer
+        // so the cached frame stays at its planar size.
+        int stride = ((frame->width() * 4) + 31) & ~31;
+        m_sw_staging.resize(static_cast<size_t>(stride) * frame->height());
+        frame->CopyBGRA(m_sw_staging.data(), stride);
+        setFrameSW(m_sw_staging.data(), frame->width(), frame->height(), stride);
+        return;
+    }
+    setFrameSW(frame->data(), frame->width(), frame->height(), frame->stride_bytes());
 }
 
 #ifdef EMP_HAS_VIDEOTOOLBOX
@@ -725,6 +725,38 @@ function M.get_peak_cache_dir()
     return cache_dir
 end
 
+--- Get the GLOBAL keyframe-index cache directory and ensure it exists.
+---
+--- Sibling of the peak cache and global for the same reason: an index
+--- (<content_hash>.kfidx, see emp_keyframe_index.h) is a pure function of
+--- the source file's bytes, so it carries no project identity.
+---
+--- @return string absolute path to the global keyframe-index directory
+function M.get_keyframe_index_dir()
+    local cache_dir = M.get_cache_root() .. "/keyframes"
+    local ok, err = qt_fs_mkdir_p(cache_dir)
+    assert(ok, string.format(
+        "database.get_keyframe_index_dir: mkdir failed for %s: %s",
+        cache_dir, tostring(err)))
+    return cache_dir
+end
+
+--- Get the GLOBAL media extent cache directory and ensure it exists.
+---
+--- Local copies of network-volume media, in 2 MiB extents keyed by path +
+--- content hash (emp_io.h SetIoExtentCache). Global like the peak cache:
+--- the same remote file is the same bytes in every project.
+---
+--- @return string absolute path to the global extent cache directory
+function M.get_extent_cache_dir()
+    local cache_dir = M.get_cache_root() .. "/extents"
+    local ok, err = qt_fs_mkdir_p(cache_dir)
+    assert(ok, string.format(
+        "database.get_extent_cache_dir: mkdir failed for %s: %s",
+        cache_dir, tostring(err)))
+    return cache_dir
+end
+
 -- SQL ISOLATION ENFORCEMENT - ACTIVE
 -- Models (models/*.lua) = ONLY SQL layer
 -- Commands (core/commands/*.lua) = call models
@@ -51,6 +51,13 @@ local CFG = {
     MIX_LOOKAHEAD_US = 2000000,     -- 2s ahead (matches C++ MIX_LOOKAHEAD_US)
     MIX_REFILL_AT_US = 500000,      -- refill when <500ms of audio remains in SSE
 
+    -- Headless virtual output (JVE_AOP_VIRTUAL=realtime|unpaced): a
+    -- simulated device pulls this many frames per period, and reports
+    -- AUDIBLE_US this far behind PLAYHEAD_US (override with
+    -- JVE_AOP_VIRTUAL_LATENCY_US). JVE_AOP_VIRTUAL_WAV records the output.
+    VIRTUAL_PERIOD_FRAMES = 512,
+    VIRTUAL_SINK_LATENCY_US = 40000,
+
     -- Audio output latency compensation (Qt buffer + CoreAudio + driver + DAC)
     -- This is the delay between when Qt consumes audio and when it reaches ears.
     -- Components: Qt internal buffer (~50ms) + CoreAudio (~20ms) + speakers (~15ms)
@@ -207,9 +214,32 @@ function M.init_session(sample_rate, channels)
     assert(type(channels) == "number" and channels > 0,
         "audio_playback.init_session: channels must be positive number")
 
-    -- Open AOP device
-    local aop, err = qt_constants.AOP.OPEN(sample_rate, channels, CFG.TARGET_BUFFER_MS)
-    assert(aop, "audio_playback.init_session: AOP.OPEN failed: " .. tostring(err))
+    -- Open AOP device (or the headless virtual one, for benchmarks / CI)
+    local aop, err
+    local virtual_mode = os.getenv("JVE_AOP_VIRTUAL")
+    if virtual_mode then
+        assert(virtual_mode == "realtime" or virtual_mode == "unpaced", string.format(
+            "audio_playback.init_session: JVE_AOP_VIRTUAL must be realtime|unpaced, got %s",
+            virtual_mode))
+        local latency_env = os.getenv("JVE_AOP_VIRTUAL_LATENCY_US")
+        local latency_us = CFG.VIRTUAL_SINK_LATENCY_US
+        if latency_env then
+            latency_us = tonumber(latency_env)
+            assert(latency_us and latency_us >= 0, string.format(
+                "audio_playback.init_session: JVE_AOP_VIRTUAL_LATENCY_US must be a number >= 0, got %s",
+                latency_env))
+        end
+        aop, err = qt_constants.AOP.OPEN_VIRTUAL(sample_rate, channels, CFG.TARGET_BUFFER_MS, {
+            realtime = (virtual_mode == "realtime"),
+            period_frames = CFG.VIRTUAL_PERIOD_FRAMES,
+            sink_latency_us = latency_us,
+            wav_path = os.getenv("JVE_AOP_VIRTUAL_WAV"),
+        })
+        assert(aop, "audio_playback.init_session: AOP.OPEN_VIRTUAL failed: " .. tostring(err))
+    else
+        aop, err = qt_constants.AOP.OPEN(sample_rate, channels, CFG.TARGET_BUFFER_MS)
+        assert(aop, "audio_playback.init_session: AOP.OPEN failed: " .. tostring(err))
+    end
     M.aop = aop
 
     -- Verify actual sample rate matches requested (NSF: no silent rate mismatch)
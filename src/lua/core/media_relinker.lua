@@ -321,7 +321,7 @@ end
 M.probe_file_emp = probe_file_emp
 
 --- Pre-probe a set of candidate paths in parallel and populate a probe cache.
--- Uses EMP.MEDIA_PROBE_BATCH with default parallelism (hardware_concurrency).
+-- Uses EMP.MEDIA_PROBE_BATCH with default parallelism (CPU budget Probe slots).
 -- cache[path] is set to a result table on success or `false` on failure, so
 -- cached_probe can distinguish "not yet probed" (nil) from "probed, got nothing"
 -- (false).
@@ -1711,7 +1711,7 @@ end
 
 -- Pre-probe candidates in parallel. Serial single-shot probes were the
 -- dominant cost (72.5 ms × 562 calls = 40s observed). MEDIA_PROBE_BATCH
--- dispatches hardware_concurrency workers through
+-- dispatches CPU-budget-sized worker pools through
 -- emp::MediaFile::ProbeMetadata, each of which skips
 -- avformat_find_stream_info (~5× faster per probe). Combined expectation:
 -- ~40s → ~1s on 8-core hardware.
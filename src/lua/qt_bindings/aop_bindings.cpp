@@ -82,6 +82,64 @@ static int lua_aop_open(lua_State* L) {
     return 1;
 }
 
+// AOP.OPEN_VIRTUAL(sample_rate, channels, target_buffer_ms, opts) -> aop | nil, err
+//
+// Headless backend (no sound hardware): a simulated device thread consumes
+// the ring. opts = { realtime = bool, period_frames = int,
+// sink_latency_us = int, wav_path = string|nil }. Everything but wav_path
+// is required — same no-silent-defaults rule as OPEN.
+static int lua_aop_open_virtual(lua_State* L) {
+    int32_t sample_rate = static_cast<int32_t>(luaL_checkinteger(L, 1));
+    int32_t channels = static_cast<int32_t>(luaL_checkinteger(L, 2));
+    int32_t buffer_ms = static_cast<int32_t>(luaL_checkinteger(L, 3));
+    luaL_checktype(L, 4, LUA_TTABLE);
+
+    aop::AopConfig config;
+    config.sample_rate = sample_rate;
+    config.channels = channels;
+    config.target_buffer_ms = buffer_ms;
+    config.backend = aop::AopBackend::Virtual;
+
+    lua_getfield(L, 4, "realtime");
+    if (!lua_isboolean(L, -1)) {
+        return luaL_error(L, "AOP.OPEN_VIRTUAL: opts.realtime (boolean) is required");
+    }
+    config.virtual_device.realtime = lua_toboolean(L, -1) != 0;
+    lua_pop(L, 1);
+
+    lua_getfield(L, 4, "period_frames");
+    if (!lua_isnumber(L, -1)) {
+        return luaL_error(L, "AOP.OPEN_VIRTUAL: opts.period_frames (integer) is required");
+    }
+    config.virtual_device.period_frames = static_cast<int32_t>(lua_tointeger(L, -1));
+    lua_pop(L, 1);
+
+    lua_getfield(L, 4, "sink_latency_us");
+    if (!lua_isnumber(L, -1)) {
+        return luaL_error(L, "AOP.OPEN_VIRTUAL: opts.sink_latency_us (integer) is required");
+    }
+    config.virtual_device.sink_latency_us = static_cast<int64_t>(lua_tointeger(L, -1));
+    lua_pop(L, 1);
+
+    lua_getfield(L, 4, "wav_path");
+    if (lua_isstring(L, -1)) {
+        config.virtual_device.wav_path = lua_tostring(L, -1);
+    }
+    lua_pop(L, 1);
+
+    aop::AopOpenReport report;
+    auto output = aop::AudioOutput::Open(config, &report);
+
+    if (!output) {
+        push_aop_error(L, report.device_name.c_str());
+        return 2;
+    }
+
+    void* key = push_aop_userdata(L, output.get());
+    g_audio_outputs[key] = std::move(output);
+    return 1;
+}
+
 // AOP.CLOSE(aop)
 static int lua_aop_close(lua_State* L) {
     void* key = static_cast<void*>(luaL_checkudata(L, 1, AOP_METATABLE));
@@ -305,6 +363,8 @@ void register_aop_bindings(lua_State* L) {
 
     lua_pushcfunction(L, lua_aop_open);
     lua_setfield(L, -2, "OPEN");
+    lua_pushcfunction(L, lua_aop_open_virtual);
+    lua_setfield(L, -2, "OPEN_VIRTUAL");
     lua_pushcfunction(L, lua_aop_close);
     lua_setfield(L, -2, "CLOSE");
     lua_pushcfunction(L, lua_aop_start);
@@ -10,6 +10,10 @@
 #include <editor_media_platform/emp_timeline_media_buffer.h>
 #include <editor_media_platform/emp_peak_file.h>
 #include <editor_media_platform/emp_peak_generator.h>
+#include <editor_media_platform/emp_keyframe_index.h>
+#include <editor_media_platform/emp_frame_arena.h>
+#include <editor_media_platform/emp_cpu_budget.h>
+#include <editor_media_platform/emp_io.h>
 #include <editor_media_platform/emp_cdl.h>
 #include <editor_media_platform/emp_lut3d.h>
 
@@ -260,7 +264,7 @@ static int lua_emp_media_file_info(lua_State* L) {
 // when you need to feed a Reader / decode path.
 //
 // For batches use MEDIA_PROBE_BATCH — it dispatches probes across a
-// worker pool with hardware_concurrency parallelism.
+// worker pool sized by the CPU budget's Probe slots.
 static int lua_emp_media_probe(lua_State* L) {
     const char* path = luaL_checkstring(L, 1);
     auto result = emp::MediaFile::ProbeMetadata(path);
@@ -283,7 +287,8 @@ static int lua_emp_media_probe(lua_State* L) {
 // a populated info table (success) or nil (probe failed — input file missing,
 // unsupported container, etc). A failure on one path does not abort the batch.
 //
-// parallelism: optional integer. Default = hardware_concurrency. Pass 1 to
+// parallelism: optional integer. Default = CPU budget Probe slots (the whole
+// machine when idle, one thread while playing). Pass 1 to
 // force serial execution (useful for debugging).
 static int lua_emp_media_probe_batch(lua_State* L) {
     luaL_checktype(L, 1, LUA_TTABLE);
@@ -518,6 +523,16 @@ static int lua_emp_frame_data_ptr(lua_State* L) {
     if (it == g_frames.end()) {
         return luaL_error(L, "EMP.FRAME_DATA_PTR: invalid frame handle");
     }
+    if (it->second->is_yuv()) {
+        // The handle takes its own BGRA copy; the (possibly TMB-cached)
+        // YUV frame is left at its planar size.
+        const auto& yuv = it->second;
+        const int stride = ((yuv->width() * 4) + 31) & ~31;
+        std::vector<uint8_t> pixels(static_cast<size_t>(stride) * yuv->height());
+        yuv->CopyBGRA(pixels.data(), stride);
+        it->second = emp::Frame::CreateCPU(yuv->width(), yuv->height(), stride,
+                                           yuv->source_pts_us(), std::move(pixels));
+    }
 
     lua_pushlightuserdata(L, const_cast<uint8_t*>(it->second->data()));
     return 1;
@@ -633,7 +648,7 @@ static int lua_emp_tmb_create(lua_State* L) {
     } else {
         int pool_threads = static_cast<int>(luaL_checkinteger(L, 1));
         if (pool_threads < 0 || (pool_threads != 0 && pool_threads < 3)) {
-            return luaL_error(L, "TMB_CREATE: pool_threads must be 0 (sync) or >= 3 (1 prep + 1 video + 1 audio), got %d", pool_threads);
+            return luaL_error(L, "TMB_CREATE: pool_threads must be 0 (sync) or >= 3 (1 reserved + 2 warm-capable workers), got %d", pool_threads);
         }
         tmb = emp::TimelineMediaBuffer::Create(pool_threads);
     }
@@ -751,6 +766,225 @@ static int lua_emp_tmb_set_max_readers(lua_State* L) {
     return 0;
 }
 
+// EMP.TMB_SET_CACHE_BUDGET(tmb, bytes)
+// TMB-wide byte budget shared by every video track's frame cache.
+static int lua_emp_tmb_set_cache_budget(lua_State* L) {
+    auto tmb = get_tmb(L, 1);
+    int64_t bytes = static_cast<int64_t>(luaL_checkinteger(L, 2));
+    if (bytes <= 0) {
+        return luaL_error(L, "TMB_SET_CACHE_BUDGET: bytes must be > 0, got %lld", (long long)bytes);
+    }
+    tmb->SetCacheBudget(bytes);
+    return 0;
+}
+
+// EMP.TMB_GET_VIDEO_CACHE_STATS(tmb) -> {budget_bytes, used_bytes, tracks = {
+//   {index, bytes, share_bytes, entries, hits, misses, evictions}, ... }}
+// tracks is a sequence ordered by track index.
+static int lua_emp_tmb_get_video_cache_stats(lua_State* L) {
+    auto tmb = get_tmb(L, 1);
+    auto stats = tmb->GetVideoCacheStats();
+
+    lua_createtable(L, 0, 3);
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.budget_bytes));
+    lua_setfield(L, -2, "budget_bytes");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.used_bytes));
+    lua_setfield(L, -2, "used_bytes");
+
+    lua_createtable(L, static_cast<int>(stats.tracks.size()), 0);
+    for (size_t i = 0; i < stats.tracks.size(); ++i) {
+        const auto& t = stats.tracks[i];
+        lua_createtable(L, 0, 7);
+        lua_pushinteger(L, t.track.index);
+        lua_setfield(L, -2, "index");
+        lua_pushinteger(L, static_cast<lua_Integer>(t.bytes));
+        lua_setfield(L, -2, "bytes");
+        lua_pushinteger(L, static_cast<lua_Integer>(t.share_bytes));
+        lua_setfield(L, -2, "share_bytes");
+        lua_pushinteger(L, static_cast<lua_Integer>(t.entries));
+        lua_setfield(L, -2, "entries");
+        lua_pushinteger(L, static_cast<lua_Integer>(t.hits));
+        lua_setfield(L, -2, "hits");
+        lua_pushinteger(L, static_cast<lua_Integer>(t.misses));
+        lua_setfield(L, -2, "misses");
+        lua_pushinteger(L, static_cast<lua_Integer>(t.evictions));
+        lua_setfield(L, -2, "evictions");
+        lua_rawseti(L, -2, static_cast<int>(i + 1));
+    }
+    lua_setfield(L, -2, "tracks");
+    return 1;
+}
+
+// EMP.FRAME_ARENA_STATS() -> {cap_bytes, reserved_bytes, in_use_bytes,
+//   high_water_bytes, trimmed_bytes, cap_failures}
+// Process-wide decoded-frame buffer arena (emp_frame_arena.h).
+static int lua_emp_frame_arena_stats(lua_State* L) {
+    auto stats = emp::GetFrameArenaStats();
+    lua_createtable(L, 0, 6);
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.cap_bytes));
+    lua_setfield(L, -2, "cap_bytes");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.reserved_bytes));
+    lua_setfield(L, -2, "reserved_bytes");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.in_use_bytes));
+    lua_setfield(L, -2, "in_use_bytes");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.high_water_bytes));
+    lua_setfield(L, -2, "high_water_bytes");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.trimmed_bytes));
+    lua_setfield(L, -2, "trimmed_bytes");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.cap_failures));
+    lua_setfield(L, -2, "cap_failures");
+    return 1;
+}
+
+// EMP.SET_FRAME_ARENA_CAP(bytes)
+static int lua_emp_set_frame_arena_cap(lua_State* L) {
+    int64_t bytes = static_cast<int64_t>(luaL_checkinteger(L, 1));
+    if (bytes <= 0) {
+        return luaL_error(L, "SET_FRAME_ARENA_CAP: bytes must be > 0, got %lld", (long long)bytes);
+    }
+    emp::SetFrameArenaCap(bytes);
+    return 0;
+}
+
+// EMP.CPU_BUDGET_STATS() -> {total_threads, video_decoders, decode_workers, slice_workers,
+//   rebalances, slots = {playback, scrub, peaks, probe}, active = {...same keys}}
+// Process-wide decode thread budget (emp_cpu_budget.h).
+static int lua_emp_cpu_budget_stats(lua_State* L) {
+    static const char* const kClassNames[emp::CPU_CLASS_COUNT] = {
+        "playback", "scrub", "peaks", "probe"};
+    auto stats = emp::GetCpuBudgetStats();
+    lua_createtable(L, 0, 7);
+    lua_pushinteger(L, stats.total_threads);
+    lua_setfield(L, -2, "total_threads");
+    lua_pushinteger(L, stats.video_decoders);
+    lua_setfield(L, -2, "video_decoders");
+    lua_pushinteger(L, stats.decode_workers);
+    lua_setfield(L, -2, "decode_workers");
+    lua_pushinteger(L, stats.slice_workers);
+    lua_setfield(L, -2, "slice_workers");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.rebalances));
+    lua_setfield(L, -2, "rebalances");
+    lua_createtable(L, 0, emp::CPU_CLASS_COUNT);
+    for (int i = 0; i < emp::CPU_CLASS_COUNT; ++i) {
+        lua_pushinteger(L, stats.class_slots[i]);
+        lua_setfield(L, -2, kClassNames[i]);
+    }
+    lua_setfield(L, -2, "slots");
+    lua_createtable(L, 0, emp::CPU_CLASS_COUNT);
+    for (int i = 0; i < emp::CPU_CLASS_COUNT; ++i) {
+        lua_pushinteger(L, stats.active[i]);
+        lua_setfield(L, -2, kClassNames[i]);
+    }
+    lua_setfield(L, -2, "active");
+    return 1;
+}
+
+// EMP.SET_CPU_BUDGET_THREADS(n) — machine size the budget divides;
+// 0 restores hardware_concurrency.
+static int lua_emp_set_cpu_budget_threads(lua_State* L) {
+    int64_t threads = static_cast<int64_t>(luaL_checkinteger(L, 1));
+    if (threads < 0) {
+        return luaL_error(L, "SET_CPU_BUDGET_THREADS: threads must be >= 0, got %lld", (long long)threads);
+    }
+    emp::SetCpuBudgetThreads(static_cast<int>(threads));
+    return 0;
+}
+
+// EMP.IO_STATS() -> array of {path, size, bytes_read, reads, read_ms,
+//   stalls, stall_ms, throughput_mbps, hits, misses, read_ahead_blocks,
+//   read_ahead_hits}, one per file open by a demuxer (emp_io.h).
+static int lua_emp_io_stats(lua_State* L) {
+    const auto stats = emp::GetIoStats();
+    lua_createtable(L, static_cast<int>(stats.size()), 0);
+    int i = 1;
+    for (const auto& f : stats) {
+        lua_createtable(L, 0, 12);
+        lua_pushstring(L, f.path.c_str());
+        lua_setfield(L, -2, "path");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.size));
+        lua_setfield(L, -2, "size");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.bytes_read));
+        lua_setfield(L, -2, "bytes_read");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.reads));
+        lua_setfield(L, -2, "reads");
+        lua_pushnumber(L, static_cast<double>(f.read_ns) / 1e6);
+        lua_setfield(L, -2, "read_ms");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.stalls));
+        lua_setfield(L, -2, "stalls");
+        lua_pushnumber(L, static_cast<double>(f.stall_ns) / 1e6);
+        lua_setfield(L, -2, "stall_ms");
+        lua_pushnumber(L, f.throughput_mbps());
+        lua_setfield(L, -2, "throughput_mbps");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.hits));
+        lua_setfield(L, -2, "hits");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.misses));
+        lua_setfield(L, -2, "misses");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.read_ahead_blocks));
+        lua_setfield(L, -2, "read_ahead_blocks");
+        lua_pushinteger(L, static_cast<lua_Integer>(f.read_ahead_hits));
+        lua_setfield(L, -2, "read_ahead_hits");
+        lua_rawseti(L, -2, i++);
+    }
+    return 1;
+}
+
+// EMP.SET_IO_READ_AHEAD(bytes) — per-file read-ahead window; 0 disables.
+// Clamped to 8 MiB.
+static int lua_emp_set_io_read_ahead(lua_State* L) {
+    int64_t bytes = static_cast<int64_t>(luaL_checkinteger(L, 1));
+    if (bytes < 0) {
+        return luaL_error(L, "SET_IO_READ_AHEAD: bytes must be >= 0, got %lld", (long long)bytes);
+    }
+    emp::SetIoReadAhead(bytes);
+    return 0;
+}
+
+// EMP.SET_IO_EXTENT_CACHE(dir, budget_bytes [, remote_only=true]) — local
+// extent cache for media on network volumes; "" or 0 disables.
+static int lua_emp_set_io_extent_cache(lua_State* L) {
+    const char* dir = luaL_checkstring(L, 1);
+    int64_t budget = static_cast<int64_t>(luaL_checkinteger(L, 2));
+    if (budget < 0) {
+        return luaL_error(L, "SET_IO_EXTENT_CACHE: budget_bytes must be >= 0, got %lld", (long long)budget);
+    }
+    bool remote_only = !(lua_gettop(L) >= 3 && !lua_isnil(L, 3)) || lua_toboolean(L, 3) != 0;
+    emp::SetIoExtentCache(dir, budget, remote_only);
+    return 0;
+}
+
+// EMP.IO_EXTENT_CACHE_STATS() -> {hits, misses, hit_ratio, evictions,
+//   extents, bytes_cached, budget_bytes}
+static int lua_emp_io_extent_cache_stats(lua_State* L) {
+    const auto stats = emp::GetIoExtentCacheStats();
+    lua_createtable(L, 0, 7);
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.hits));
+    lua_setfield(L, -2, "hits");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.misses));
+    lua_setfield(L, -2, "misses");
+    lua_pushnumber(L, stats.hit_ratio());
+    lua_setfield(L, -2, "hit_ratio");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.evictions));
+    lua_setfield(L, -2, "evictions");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.extents));
+    lua_setfield(L, -2, "extents");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.bytes_cached));
+    lua_setfield(L, -2, "bytes_cached");
+    lua_pushinteger(L, static_cast<lua_Integer>(stats.budget_bytes));
+    lua_setfield(L, -2, "budget_bytes");
+    return 1;
+}
+
+// EMP.TMB_GET_LOCK_CONTENTION(tmb [, reset]) -> count
+// Track / track-map lock acquisitions that had to wait. reset=true zeroes
+// the counter after reading (per-session measurement).
+static int lua_emp_tmb_get_lock_contention(lua_State* L) {
+    auto tmb = get_tmb(L, 1);
+    bool reset = lua_toboolean(L, 2);
+    lua_pushinteger(L, static_cast<lua_Integer>(tmb->GetLockContentionCount()));
+    if (reset) tmb->ResetLockContentionCount();
+    return 1;
+}
+
 // EMP.TMB_SET_SEQUENCE_RATE(tmb, num, den)
 static int lua_emp_tmb_set_sequence_rate(lua_State* L) {
     auto tmb = get_tmb(L, 1);
@@ -2772,6 +3006,16 @@ static int lua_emp_peak_refresh_header_mtime(lua_State* L) {
     return 1;
 }
 
+// EMP.KEYFRAME_INDEX_SET_DIR(dir) -> nil
+//
+// Directory for persisted keyframe indexes (emp_keyframe_index.h). Until
+// set, indexes found or built this session stay in memory only.
+static int lua_emp_keyframe_index_set_dir(lua_State* L) {
+    const char* dir = luaL_checkstring(L, 1);
+    emp::SetKeyframeIndexDir(dir);
+    return 0;
+}
+
 // EMP.PEAK_RELEASE(peak_handle) -> nil
 static int lua_emp_peak_release(lua_State* L) {
     void* key = luaL_checkudata(L, 1, EMP_PEAK_METATABLE);
@@ -2870,6 +3114,28 @@ void register_emp_bindings(lua_State* L) {
     lua_pushcfunction(L, lua_emp_set_decode_mode);
     lua_setfield(L, -2, "SET_DECODE_MODE");
 
+    // Frame arena
+    lua_pushcfunction(L, lua_emp_frame_arena_stats);
+    lua_setfield(L, -2, "FRAME_ARENA_STATS");
+    lua_pushcfunction(L, lua_emp_set_frame_arena_cap);
+    lua_setfield(L, -2, "SET_FRAME_ARENA_CAP");
+
+    // CPU budget
+    lua_pushcfunction(L, lua_emp_cpu_budget_stats);
+    lua_setfield(L, -2, "CPU_BUDGET_STATS");
+    lua_pushcfunction(L, lua_emp_set_cpu_budget_threads);
+    lua_setfield(L, -2, "SET_CPU_BUDGET_THREADS");
+
+    // Demux I/O
+    lua_pushcfunction(L, lua_emp_io_stats);
+    lua_setfield(L, -2, "IO_STATS");
+    lua_pushcfunction(L, lua_emp_set_io_read_ahead);
+    lua_setfield(L, -2, "SET_IO_READ_AHEAD");
+    lua_pushcfunction(L, lua_emp_set_io_extent_cache);
+    lua_setfield(L, -2, "SET_IO_EXTENT_CACHE");
+    lua_pushcfunction(L, lua_emp_io_extent_cache_stats);
+    lua_setfield(L, -2, "IO_EXTENT_CACHE_STATS");
+
     // Frame functions
     lua_pushcfunction(L, lua_emp_frame_info);
     lua_setfield(L, -2, "FRAME_INFO");
@@ -2899,6 +3165,12 @@ void register_emp_bindings(lua_State* L) {
     lua_setfield(L, -2, "TMB_CLOSE");
     lua_pushcfunction(L, lua_emp_tmb_set_max_readers);
     lua_setfield(L, -2, "TMB_SET_MAX_READERS");
+    lua_pushcfunction(L, lua_emp_tmb_set_cache_budget);
+    lua_setfield(L, -2, "TMB_SET_CACHE_BUDGET");
+    lua_pushcfunction(L, lua_emp_tmb_get_video_cache_stats);
+    lua_setfield(L, -2, "TMB_GET_VIDEO_CACHE_STATS");
+    lua_pushcfunction(L, lua_emp_tmb_get_lock_contention);
+    lua_setfield(L, -2, "TMB_GET_LOCK_CONTENTION");
     lua_pushcfunction(L, lua_emp_tmb_set_tc_overrides);
     lua_setfield(L, -2, "TMB_SET_TC_OVERRIDES");
     lua_pushcfunction(L, lua_emp_tmb_set_sequence_rate);
@@ -3001,6 +3273,8 @@ void register_emp_bindings(lua_State* L) {
     lua_setfield(L, -2, "MEDIA_CONTENT_HASH");
     lua_pushcfunction(L, lua_emp_peak_refresh_header_mtime);
     lua_setfield(L, -2, "PEAK_REFRESH_HEADER_MTIME");
+    lua_pushcfunction(L, lua_emp_keyframe_index_set_dir);
+    lua_setfield(L, -2, "KEYFRAME_INDEX_SET_DIR");
 
     lua_setfield(L, -2, "EMP");
 
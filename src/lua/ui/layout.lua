@@ -139,6 +139,19 @@ local function open_and_init_project(path)
     local peak_cache = require("core.media.peak_cache")
     peak_cache.init_for_project(pid)
 
+    -- Persist per-file keyframe indexes next to the peak cache so seeks on
+    -- long-GOP media skip the scan on every later open.
+    qt_constants.EMP.KEYFRAME_INDEX_SET_DIR(require("core.database").get_keyframe_index_dir())
+
+    -- Opt-in local cache of network-volume media: JVE_EXTENT_CACHE_GB=<n>
+    -- keeps up to n GiB of remote files' bytes on the local disk, so a
+    -- second pass reads local disk instead of the network.
+    local extent_cache_gb = tonumber(os.getenv("JVE_EXTENT_CACHE_GB"))
+    if extent_cache_gb and extent_cache_gb > 0 then
+        qt_constants.EMP.SET_IO_EXTENT_CACHE(require("core.database").get_extent_cache_dir(),
+            math.floor(extent_cache_gb * 1024 * 1024 * 1024))
+    end
+
     -- Initialize bug reporter (continuous background capture)
     local bug_reporter = require("bug_reporter.init")
     bug_reporter.init()
@@ -257,6 +257,17 @@ public:
 
     // Diagnostics (read after Stop)
     int64_t UnderrunCount() const { return m_underrun_count; }
+    // Pump wakeups by cause, and pump-thread CPU time, over the last run.
+    // cpu_us / wall_us is the pump's share of a core during playback.
+    struct WakeStats {
+        int64_t cycles = 0;
+        int64_t low_watermark = 0;  // AOP ring fell below the low watermark
+        int64_t audio_ready = 0;    // TMB mixed a new chunk
+        int64_t timeouts = 0;       // fallback deadline (or hungry retry)
+        int64_t cpu_us = 0;
+        int64_t wall_us = 0;
+    };
+    WakeStats GetWakeStats() const { return m_wake_stats; }
 
     // Reset incremental push tracking (call at every transport change)
     void ResetPushState();
@@ -292,8 +303,8 @@ public:
     // on the caller's thread with SSE ownership transferred in. Use for
     // mid-play SSE touches that are NOT a full flush — the JKL shuttle
     // lightweight SetSpeed path is the canonical caller (one m_sse->SetSpeed
-    // write, no AOP teardown). Latency: one pump-cycle worst case
-    // (PUMP_INTERVAL_OK_MS = 15 ms), typically much less.
+    // write, no AOP teardown). Latency: the request notifies the pump's
+    // wait directly, so at most the remainder of one in-progress cycle.
     void WithSseOwnerOnMain(std::function<void()> work);
 
     // Per-cycle render cap (independent of buffer sizing).
@@ -308,6 +319,12 @@ public:
 private:
     void pumpLoop();
 
+    // Wake the pump from its between-cycle wait. Called from the AOP pull
+    // thread (low watermark) and the TMB mix thread (audio ready): an
+    // atomic store and a notify, no lock.
+    enum WakeCause : int { WAKE_LOW_WATERMARK = 1, WAKE_AUDIO_READY = 2 };
+    void wake(WakeCause cause);
+
     std::thread m_thread;
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_stop_requested{false};
@@ -329,13 +346,23 @@ private:
     int32_t m_channels{2};
     int32_t m_target_buffer_ms{0};  // Set in Start() from m_aop->TargetBufferMs()
 
-    // Pump timing constants
-    static constexpr int PUMP_INTERVAL_HUNGRY_MS = 2;
-    static constexpr int PUMP_INTERVAL_OK_MS = 15;
+    // Pump timing. The pump sleeps until woken (flush/stop request, AOP
+    // low watermark, TMB audio ready), not on a fixed interval:
+    // - After a cycle that filled the ring to target, it waits for the
+    //   low-watermark event. Its fallback deadline is when the ring would
+    //   reach half the watermark, so a missed notification (the notify is
+    //   lock-free and can race the wait) still refills with ring to spare.
+    // - After a cycle that could NOT fill to target (SSE short of source,
+    //   timeline gap), it retries after PUMP_RETRY_MS.
+    static constexpr int PUMP_RETRY_MS = 2;
+    // Low watermark as a fraction of the target fill (½ = 50ms at 100ms).
+    static constexpr int LOW_WATERMARK_DIVISOR = 2;
 
     // Diagnostics
     DiagRing<PumpMetric, DIAG_AUDIO_RING_SIZE>* m_diag{nullptr};
     int64_t m_underrun_count{0};
+    WakeStats m_wake_stats;                      // pump thread; read after Stop
+    std::atomic<int> m_wake_pending{0};          // WakeCause bits since last cycle
 
     // ── Flush handoff (main ↔ pump, pump-pause variant) ───────────────────
     // Pump owns SSE during play. A mid-play state change on main needs to
@@ -359,7 +386,7 @@ private:
     FlushHandler m_flush_handler;
     std::mutex m_flush_mutex;
     std::condition_variable m_handoff_idle_cv;      // main waits; pump signals after resuming
-    std::condition_variable m_handoff_request_cv;   // pump waits at cycle end; main signals on new request
+    std::condition_variable m_handoff_request_cv;   // pump waits at cycle end; main signals on new request, wake() on refill events
     std::condition_variable m_handoff_released_cv;  // main waits; pump signals after releasing SSE owner
     std::condition_variable m_handoff_resume_cv;    // pump waits; main signals after work completes
     uint64_t m_handoff_request_gen{0};              // guarded by m_flush_mutex
@@ -598,6 +625,10 @@ private:
     // Shuttle boundary lives at emp::TimelineMediaBuffer::SHUTTLE_FREE_RUN_SPEED
     // (canonical single owner in the lower layer).
     bool m_was_shuttle_mode{false};  // detect transitions back to normal play
+    // |rate| the video position advanced at this tick (PlaybackClock
+    // ActiveSpeed, or intent speed in shuttle free-run / without audio).
+    // Passed to TMB::SetPlayhead as the prefetch-deadline rate. Tick thread only.
+    float m_tick_clock_speed{1.0f};
 
     // ---- A/V sync PLL (phase-locked loop) ----
     // Gently steers video frame accumulator toward audio clock each tick.
@@ -625,8 +656,8 @@ private:
     // clip isn't even submitted for READER_WARM until the playhead is already
     // 187ms away. Multiplying by |speed| keeps lead time constant in WALL TIME
     // regardless of shuttle speed. This MUST be paired with proximity-priority
-    // READER_WARM picking in `process_next_decode_prep_job` — without (2), the
-    // expanded warm queue at high speed overloads the single prep_worker and
+    // READER_WARM picking in `pick_decode_prep_job` — without (2), the
+    // expanded warm queue at high speed overloads the warm-capable workers and
     // the imminent clip waits at the queue tail (LIFO over Lua's sequence-
     // ordered insertions), making the freeze WORSE (live-confirmed: 9.8s vs
     // 6.9s pre-scaling).
@@ -23,6 +23,7 @@
 #import <CoreAudio/CoreAudio.h>
 #import <dispatch/dispatch.h>
 #import <mach/mach_time.h>
+#include <time.h>
 #include "jve_log.h"
 
 namespace {
@@ -361,6 +362,17 @@ void AudioPump::Start(emp::TimelineMediaBuffer* tmb, sse::ScrubStretchEngine* ss
     }
     m_running.store(true, std::memory_order_relaxed);
     ResetPushState();
+    m_wake_stats = WakeStats{};
+    m_wake_pending.store(0, std::memory_order_relaxed);
+
+    // Refill events. Registered before the thread starts so the first
+    // watermark crossing can't be missed; unregistered as the thread exits
+    // (both setters wait out an in-flight call, so no callback outlives
+    // the pump).
+    const int64_t target_frames = (static_cast<int64_t>(m_sample_rate) * m_target_buffer_ms) / 1000;
+    m_aop->SetLowWatermark(target_frames / LOW_WATERMARK_DIVISOR,
+                           [this]() { wake(WAKE_LOW_WATERMARK); });
+    m_tmb->SetAudioReadyCallback([this]() { wake(WAKE_AUDIO_READY); });
 
     // The pump thread can self-terminate (a caught assert/exception sets
     // m_running=false) leaving m_thread joinable, and Stop() early-returns
@@ -385,6 +397,8 @@ void AudioPump::Start(emp::TimelineMediaBuffer* tmb, sse::ScrubStretchEngine* ss
         // owner tid. pumpLoop's normal exit also calls ClearOwnerThread;
         // the double-clear is idempotent.
         if (m_sse) m_sse->ClearOwnerThread();
+        if (m_aop) m_aop->SetLowWatermark(0, nullptr);
+        if (m_tmb) m_tmb->SetAudioReadyCallback(nullptr);
         // Mark stop + wake any main-side waiter parked in WithSseOwnerOnMain
         // (released_cv at stage 2, resume_cv between stages 3-4). Without
         // this, a self-terminated pump leaves main blocked until Stop().
@@ -425,16 +439,32 @@ void AudioPump::Stop() {
     // (caught exception sets m_running=false) is still joinable, and both
     // the destructor and a subsequent Start() must not see a joinable
     // thread (destroying or reassigning one is std::terminate).
-    if (m_thread.joinable()) {
+    // Whether there was a session to report is read here, not from
+    // m_running: the pump thread clears m_running on its way out, so by the
+    // time join returns it is always false.
+    const bool had_session = m_thread.joinable();
+    if (had_session) {
         m_thread.join();
     }
+    m_running.store(false, std::memory_order_relaxed);
 
-    if (m_running.load(std::memory_order_relaxed)) {
-        m_running.store(false, std::memory_order_relaxed);
-        JVE_LOG_EVENT(Audio, "AudioPump: stopped");
+    if (had_session) {
+        const WakeStats& w = m_wake_stats;
+        JVE_LOG_EVENT(Audio,
+            "AudioPump: stopped — %lld cycles in %.2fs (wakes: low=%lld ready=%lld "
+            "timeout=%lld), cpu %.2f ms/s, underruns=%lld",
+            (long long)w.cycles, w.wall_us / 1e6, (long long)w.low_watermark,
+            (long long)w.audio_ready, (long long)w.timeouts,
+            w.wall_us > 0 ? (w.cpu_us * 1000.0) / static_cast<double>(w.wall_us) : 0.0,
+            (long long)m_underrun_count);
     }
 }
 
+void AudioPump::wake(WakeCause cause) {
+    m_wake_pending.fetch_or(cause, std::memory_order_release);
+    m_handoff_request_cv.notify_one();
+}
+
 void AudioPump::SetFlushHandler(FlushHandler handler) {
     JVE_ASSERT(static_cast<bool>(handler),
                "AudioPump::SetFlushHandler: handler must not be empty");
@@ -547,11 +577,19 @@ int AudioPump::QualityMode() const {
     return m_quality_mode.load(std::memory_order_relaxed);
 }
 
+static int64_t thread_cpu_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000LL + ts.tv_nsec / 1000;
+}
+
 void AudioPump::pumpLoop() {
     std::vector<float> render_buffer(MAX_RENDER_FRAMES * m_channels);
     int consecutive_dry_cycles = 0;
     int64_t stalled_cycles = 0;
     int64_t last_media_time = -1;
+    const int64_t cpu_start_us = thread_cpu_us();
+    const auto wall_start = std::chrono::steady_clock::now();
 
     // Take ownership of SSE: every public SSE method now asserts the
     // calling thread matches. The pump is the only legitimate writer
@@ -562,6 +600,10 @@ void AudioPump::pumpLoop() {
     int cycle_count = 0;
     while (!m_stop_requested.load(std::memory_order_relaxed)) {
         cycle_count++;
+        m_wake_stats.cycles = cycle_count;
+        m_wake_stats.cpu_us = thread_cpu_us() - cpu_start_us;
+        m_wake_stats.wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - wall_start).count();
 
         // 0. Service any pending handoff BEFORE doing the cycle's regular
         //    work. Pump-pause: release SSE owner, signal main, wait for
@@ -745,17 +787,26 @@ void AudioPump::pumpLoop() {
             }
         }
 
-        // 3. Render from SSE and write to AOP
+        // 3. Render from SSE and write to AOP — the whole deficit, in
+        //    MAX_RENDER_FRAMES pieces, so one cycle refills to target and
+        //    the pump can sleep until the next watermark crossing. SSE
+        //    returning short means it's out of source: `starved`.
         int64_t buffered = m_aop->BufferedFrames();
         int64_t target_frames = (m_sample_rate * m_target_buffer_ms) / 1000;
         int64_t frames_needed = std::max<int64_t>(0, target_frames - buffered);
-        frames_needed = std::min<int64_t>(frames_needed, MAX_RENDER_FRAMES);
 
         int64_t produced = 0;
-        if (frames_needed > 0) {
-            produced = m_sse->Render(render_buffer.data(), frames_needed);
-            if (produced > 0) {
-                m_aop->WriteF32(render_buffer.data(), produced);
+        bool starved = false;
+        while (produced < frames_needed) {
+            int64_t n = std::min<int64_t>(frames_needed - produced, MAX_RENDER_FRAMES);
+            int64_t got = m_sse->Render(render_buffer.data(), n);
+            if (got > 0) {
+                m_aop->WriteF32(render_buffer.data(), got);
+                produced += got;
+            }
+            if (got < n) {
+                starved = true;
+                break;
             }
         }
 
@@ -819,27 +870,42 @@ void AudioPump::pumpLoop() {
             entry.flags = flags;
         }
 
-        // 7. Adaptive sleep based on buffer level — but wake immediately
-        //    if a flush request lands, so mute/solo + direction-flip stay
-        //    snappy instead of waiting out the OK_MS interval.
-        int sleep_ms;
-        int64_t buffered_after = m_aop->BufferedFrames();
-        if (buffered_after < target_frames) {
-            sleep_ms = PUMP_INTERVAL_HUNGRY_MS;
-        } else {
-            sleep_ms = PUMP_INTERVAL_OK_MS;
+        // 7. Sleep until there's work: a flush request (mute/solo,
+        //    direction flip stay snappy), the AOP ring falling below its
+        //    low watermark, or TMB mixing new audio. Starved → short retry.
+        //    Otherwise the fallback deadline is when the ring would drain
+        //    to half the watermark, in case the lock-free notify raced
+        //    this wait and was lost.
+        int64_t wait_us = PUMP_RETRY_MS * 1000;
+        if (!starved) {
+            int64_t buffered_after = m_aop->BufferedFrames();
+            int64_t low_wm = target_frames / LOW_WATERMARK_DIVISOR;
+            wait_us = std::max<int64_t>(wait_us,
+                ((buffered_after - low_wm / 2) * 1000000LL) / m_sample_rate);
         }
 
-        std::unique_lock<std::mutex> lock(m_flush_mutex);
-        m_handoff_request_cv.wait_for(
-            lock,
-            std::chrono::milliseconds(sleep_ms),
-            [this]() {
-                return m_handoff_released_gen < m_handoff_request_gen
-                    || m_stop_requested.load(std::memory_order_relaxed);
-            });
+        bool woken;
+        {
+            std::unique_lock<std::mutex> lock(m_flush_mutex);
+            woken = m_handoff_request_cv.wait_for(
+                lock,
+                std::chrono::microseconds(wait_us),
+                [this]() {
+                    return m_handoff_released_gen < m_handoff_request_gen
+                        || m_stop_requested.load(std::memory_order_relaxed)
+                        || m_wake_pending.load(std::memory_order_acquire) != 0;
+                });
+        }
+        int causes = m_wake_pending.exchange(0, std::memory_order_acquire);
+        if (causes & WAKE_LOW_WATERMARK) ++m_wake_stats.low_watermark;
+        if (causes & WAKE_AUDIO_READY) ++m_wake_stats.audio_ready;
+        if (!woken) ++m_wake_stats.timeouts;
     }
 
+    m_wake_stats.cpu_us = thread_cpu_us() - cpu_start_us;
+    m_wake_stats.wall_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - wall_start).count();
+
     // Shutdown ritual — release SSE owner so post-pump callers (PlayBurst,
     // shutdown, scrub) don't trip the owner assert. AOP teardown does NOT
     // run here in the hybrid: the QAudioSink lives on main (Qt event-loop
@@ -1926,7 +1992,7 @@ void PlaybackController::displayLinkTick(uint64_t host_time, uint64_t /*output_t
     {
         int dir = m_direction.load(std::memory_order_relaxed);
         float spd = m_speed.load(std::memory_order_relaxed);
-        m_tmb->SetPlayhead(new_pos, dir, spd);
+        m_tmb->SetPlayhead(new_pos, dir, spd, m_tick_clock_speed);
     }
     uint64_t t2 = mach_absolute_time();
     tick.setPlayhead_ms = machTimeToSeconds(t2 - t1) * 1000.0;
@@ -2067,6 +2133,7 @@ int64_t PlaybackController::advancePosition(double elapsed_seconds) {
     // past the user's shuttle request.
     float intent_speed = m_speed.load(std::memory_order_relaxed);
     bool shuttle_mode = std::abs(intent_speed) > emp::TimelineMediaBuffer::SHUTTLE_FREE_RUN_SPEED;
+    m_tick_clock_speed = std::abs(shuttle_mode ? intent_speed : speed);
 
     // On the speed-cross back into normal play, re-anchor the clock so the
     // accumulated shuttle-window drift (clock projected at requested speed
@@ -2694,6 +2761,14 @@ void PlaybackController::dumpDiagnostics() {
         }
         fprintf(f, "  underruns=%lld stalls=%lld\n",
                 (long long)underruns, (long long)stall_count);
+        if (m_audio_pump) {
+            const auto w = m_audio_pump->GetWakeStats();
+            fprintf(f, "  wakes: %lld cycles in %.2fs (low=%lld ready=%lld timeout=%lld) "
+                    "cpu=%.2fms/s\n",
+                    (long long)w.cycles, w.wall_us / 1e6, (long long)w.low_watermark,
+                    (long long)w.audio_ready, (long long)w.timeouts,
+                    w.wall_us > 0 ? (w.cpu_us * 1000.0) / static_cast<double>(w.wall_us) : 0.0);
+        }
         fprintf(f, "  fetch: total=%lld hits=%lld first_hit_cycle=%lld first_hit_t=%lldus\n",
                 (long long)total_fetched, (long long)fetch_hit_count,
                 (long long)first_fetch_cycle, (long long)first_fetch_media_t);
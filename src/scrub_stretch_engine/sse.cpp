@@ -3,11 +3,12 @@
 #include "jve_log.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
-#include <deque>
 #include <mutex>
 #include <vector>
 
@@ -15,173 +16,282 @@ namespace sse {
 
 static constexpr float PI = 3.14159265358979f;
 
-// Circular buffer for source PCM with time tracking
+// Source PCM retention around the playhead, each direction. push_source
+// trims anything further behind; the store is sized to hold both sides plus
+// prefill / PlayBurst runway, so steady-state pushes never evict live data.
+static constexpr int64_t SOURCE_KEEP_MARGIN_US = 10000000;  // 10s (matches Lua AUDIO_CACHE_HALF_WINDOW_US)
+static constexpr int64_t SOURCE_STORE_US = 2 * SOURCE_KEEP_MARGIN_US + 4000000;
+
+// Pushes that start (end) within this of buffered data's end (start) are
+// stitched onto it — incremental pump pushes land a few μs off the sample
+// grid, and a sub-ms gap must not split the store.
+static constexpr int64_t OVERLAP_TOLERANCE_US = 1000;
+
+// Time-indexed circular store for source PCM.
+//
+// Frames live on one absolute sample grid: media time t maps to frame
+// round(t * sample_rate / 1e6), and frame f lives at ring slot f mod
+// capacity. Lookup by time is therefore arithmetic, and everything —
+// ring and segment table — is allocated once at construction: neither
+// push (pump thread, every cycle) nor get_samples (Render) allocates.
+//
+// What's buffered is a short sorted list of disjoint frame ranges
+// ("segments"), all within one capacity-wide window so no two collide in
+// the ring. Usually there is exactly one; gaps come from clip gaps the
+// pump skipped over (GetMixedAudio returned nothing) and from seeks.
+//
+// push semantics:
+// - New data overwrites whatever was buffered at the same frames (newer
+//   wins — a re-push after an edit or overlapping prefill must not echo),
+//   and the result is the union of old and new ranges.
+// - A push within OVERLAP_TOLERANCE_US of an existing segment's edge is
+//   snapped onto that edge, in either direction (forward pumps append at
+//   the end, reverse pumps prepend at the start).
+// - When old + new would span more than the capacity, frames furthest from
+//   the playhead on the side playback is leaving are dropped first (behind
+//   it for forward, ahead of it for reverse); if that isn't enough, the far
+//   end of the incoming data is clipped.
 class SourceBuffer {
 public:
-    struct Chunk {
-        std::vector<float> data;  // Interleaved
-        int64_t start_time_us;
-        int64_t frames;
+    struct Segment {
+        int64_t begin;  // absolute frames, [begin, end)
+        int64_t end;
     };
+    static constexpr int MAX_SEGMENTS = 16;
+
+    SourceBuffer(int channels, int sample_rate, int64_t capacity_frames)
+        : m_channels(channels)
+        , m_sample_rate(sample_rate)
+        , m_capacity(capacity_frames)
+        , m_tolerance_frames((OVERLAP_TOLERANCE_US * sample_rate) / 1000000)
+        , m_ring(static_cast<size_t>(capacity_frames * channels), 0.0f)
+        , m_count(0) {
+        assert(capacity_frames > 0 && "SourceBuffer: capacity must be positive");
+    }
 
-    SourceBuffer(int channels) : m_channels(channels), m_total_frames(0) {}
-
-    void push(const float* data, int64_t frames, int64_t start_time_us, int sample_rate) {
+    // playhead_us / reverse: where playback is and which way it's heading,
+    // for choosing what to drop when the window overflows.
+    void push(const float* data, int64_t frames, int64_t start_time_us,
+              int64_t playhead_us, bool reverse) {
         std::lock_guard<std::mutex> lock(m_mutex);
-        // Calculate new chunk's time range
-        int64_t new_end_us = start_time_us + (frames * 1000000LL) / sample_rate;
-
-        // Handle overlapping chunks: trim or remove existing chunks so the new
-        // chunk's time range doesn't produce echo from duplicate PCM data.
-        // Old behavior removed the entire old chunk — this preserves any
-        // non-overlapping prefix (data before the new chunk's start).
-        auto it = m_chunks.begin();
-        while (it != m_chunks.end()) {
-            int64_t chunk_end_us = it->start_time_us + (it->frames * 1000000LL) / sample_rate;
-
-            constexpr int64_t OVERLAP_TOLERANCE_US = 1000;
-            bool overlaps = (it->start_time_us + OVERLAP_TOLERANCE_US < new_end_us)
-                         && (start_time_us + OVERLAP_TOLERANCE_US < chunk_end_us);
-
-            if (overlaps) {
-                // If old chunk starts before new chunk, trim it to keep the prefix
-                if (it->start_time_us + OVERLAP_TOLERANCE_US < start_time_us) {
-                    int64_t keep_frames = ((start_time_us - it->start_time_us)
-                                           * sample_rate) / 1000000;
-                    if (keep_frames > 0 && keep_frames < it->frames) {
-                        it->data.resize(static_cast<size_t>(keep_frames * m_channels));
-                        m_total_frames -= (it->frames - keep_frames);
-                        it->frames = keep_frames;
-                        ++it;
-                        continue;
-                    }
-                }
-                // Fully overlapped or starts after new chunk — remove entirely
-                m_total_frames -= it->frames;
-                it = m_chunks.erase(it);
-            } else {
-                ++it;
+        if (frames <= 0) return;
+
+        int64_t begin = frame_at(start_time_us);
+        int64_t end = begin + frames;
+
+        // Stitch onto a neighbour across a sub-tolerance gap.
+        for (int i = 0; i < m_count; i++) {
+            const Segment& seg = m_segments[i];
+            if (begin > seg.end && begin - seg.end <= m_tolerance_frames) {
+                end -= begin - seg.end;
+                begin = seg.end;
+                break;
+            }
+            if (end < seg.begin && seg.begin - end <= m_tolerance_frames) {
+                begin += seg.begin - end;
+                end = seg.begin;
+                break;
             }
         }
 
-        // Add the new chunk in sorted position (ascending start_time_us).
-        // Forward pushes append naturally. Backward pushes insert at front.
-        // Sorted order is required by get_samples' span-two-chunks fallback
-        // which reads ci+1 — only correct when chunks are time-ascending.
-        Chunk chunk;
-        chunk.data.assign(data, data + frames * m_channels);
-        chunk.start_time_us = start_time_us;
-        chunk.frames = frames;
-
-        // Find insertion point: first chunk with start_time > new chunk
-        auto insert_pos = m_chunks.end();
-        for (auto it = m_chunks.begin(); it != m_chunks.end(); ++it) {
-            if (it->start_time_us > start_time_us) {
-                insert_pos = it;
-                break;
+        // Fit old ∪ new into one capacity-wide window that keeps the playhead
+        // (plus a grain's worth of search margin around it).
+        int64_t lo = begin, hi = end;
+        if (m_count > 0) {
+            lo = std::min(lo, m_segments[0].begin);
+            hi = std::max(hi, m_segments[m_count - 1].end);
+        }
+        if (hi - lo > m_capacity) {
+            const int64_t guard = m_sample_rate;  // 1s
+            const int64_t play = frame_at(playhead_us);
+            int64_t win_lo;
+            if (!reverse) {
+                win_lo = std::max(lo, std::min(hi - m_capacity, play - guard));
+            } else {
+                const int64_t win_hi = std::min(hi, std::max(lo + m_capacity, play + guard));
+                win_lo = win_hi - m_capacity;
             }
+            clip_segments(win_lo, win_lo + m_capacity);
+            const int64_t clip_begin = std::max(begin, win_lo);
+            const int64_t clip_end = std::min(end, win_lo + m_capacity);
+            if (clip_end <= clip_begin) {
+                JVE_LOG_DETAIL(Audio, "SSE source push [%.3f..%.3f)s outside store window, dropped",
+                    time_at(begin) / 1e6, time_at(end) / 1e6);
+                return;
+            }
+            data += (clip_begin - begin) * m_channels;
+            begin = clip_begin;
+            end = clip_end;
         }
-        m_chunks.insert(insert_pos, std::move(chunk));
-        m_total_frames += frames;
+
+        copy_in(begin, data, end - begin);
+        add_segment(begin, end, frame_at(playhead_us));
     }
 
     void clear() {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_chunks.clear();
-        m_total_frames = 0;
+        m_count = 0;
     }
 
     // Get samples at a specific media time.
-    // Handles reads that span two adjacent chunks (common with incremental push).
-    // Returns false if time is not covered by buffered data.
+    // The read must start inside buffered data. It may run across a gap to
+    // the next segment (a clip gap the pump skipped: the gap reads as
+    // silence, which is what the timeline has there), but not past the end
+    // of the last one. Returns false if the range isn't covered.
     bool get_samples(int64_t time_us, int sample_rate, float* out, int64_t frames) {
+        assert(sample_rate == m_sample_rate && "SourceBuffer: sample rate is fixed at construction");
         std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_chunks.empty()) return false;
-
-        // Find chunk containing start time
-        for (size_t ci = 0; ci < m_chunks.size(); ci++) {
-            const auto& chunk = m_chunks[ci];
-            int64_t chunk_end_us = chunk.start_time_us + (chunk.frames * 1000000LL) / sample_rate;
-
-            if (time_us >= chunk.start_time_us && time_us < chunk_end_us) {
-                int64_t offset_us = time_us - chunk.start_time_us;
-                int64_t offset_samples = (offset_us * sample_rate) / 1000000LL;
-                int64_t avail = chunk.frames - offset_samples;
-
-                if (avail >= frames) {
-                    // Fast path: entire read within single chunk
-                    std::memcpy(out, chunk.data.data() + offset_samples * m_channels,
-                                frames * m_channels * sizeof(float));
-                    return true;
-                }
-
-                // Partial: copy what we have, try next chunk for remainder
-                if (avail > 0) {
-                    std::memcpy(out, chunk.data.data() + offset_samples * m_channels,
-                                avail * m_channels * sizeof(float));
-                }
-                int64_t remaining = frames - avail;
-
-                if (ci + 1 < m_chunks.size()) {
-                    const auto& next = m_chunks[ci + 1];
-                    if (remaining <= next.frames) {
-                        std::memcpy(out + avail * m_channels, next.data.data(),
-                                    remaining * m_channels * sizeof(float));
-                        return true;
-                    }
-                }
-                return false;  // Not enough data across chunks
+        int64_t frame = frame_at(time_us);
+
+        int si = 0;
+        while (si < m_count && m_segments[si].end <= frame) si++;
+        if (si == m_count || m_segments[si].begin > frame) return false;
+        if (m_segments[m_count - 1].end < frame + frames) return false;
+
+        int64_t remaining = frames;
+        while (remaining > 0) {
+            const Segment& seg = m_segments[si];
+            if (frame < seg.begin) {
+                const int64_t gap = std::min(remaining, seg.begin - frame);
+                std::memset(out, 0, static_cast<size_t>(gap * m_channels) * sizeof(float));
+                out += gap * m_channels;
+                frame += gap;
+                remaining -= gap;
+                continue;
             }
+            const int64_t n = std::min(remaining, seg.end - frame);
+            copy_out(frame, out, n);
+            out += n * m_channels;
+            frame += n;
+            remaining -= n;
+            si++;
         }
-        return false;
+        return true;
     }
 
     bool get_time_range(int64_t* min_us, int64_t* max_us, int sample_rate) {
+        assert(sample_rate == m_sample_rate && "SourceBuffer: sample rate is fixed at construction");
         std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_chunks.empty()) return false;
-        *min_us = m_chunks.front().start_time_us;
-        const auto& last = m_chunks.back();
-        *max_us = last.start_time_us + (last.frames * 1000000LL) / sample_rate;
+        if (m_count == 0) return false;
+        *min_us = time_at(m_segments[0].begin);
+        *max_us = time_at(m_segments[m_count - 1].end);
         return true;
     }
 
+    // Drop everything before keep_after_us.
     void trim(int64_t keep_after_us, int sample_rate) {
+        assert(sample_rate == m_sample_rate && "SourceBuffer: sample rate is fixed at construction");
         std::lock_guard<std::mutex> lock(m_mutex);
-        while (!m_chunks.empty()) {
-            const auto& chunk = m_chunks.front();
-            int64_t chunk_end_us = chunk.start_time_us + (chunk.frames * 1000000LL) / sample_rate;
-            if (chunk_end_us < keep_after_us) {
-                m_total_frames -= chunk.frames;
-                m_chunks.pop_front();
-            } else {
-                break;
-            }
-        }
+        clip_segments(frame_at(keep_after_us), INT64_MAX);
     }
 
+    // Drop everything after keep_before_us.
     void trim_after(int64_t keep_before_us, int sample_rate) {
+        assert(sample_rate == m_sample_rate && "SourceBuffer: sample rate is fixed at construction");
         std::lock_guard<std::mutex> lock(m_mutex);
-        while (!m_chunks.empty()) {
-            const auto& chunk = m_chunks.back();
-            // If chunk starts after the threshold, remove it
-            if (chunk.start_time_us > keep_before_us) {
-                m_total_frames -= chunk.frames;
-                m_chunks.pop_back();
-            } else {
-                break;
-            }
-        }
+        clip_segments(INT64_MIN, frame_at(keep_before_us));
     }
 
-    int64_t total_frames() const { return m_total_frames; }
-    bool empty() const { return m_chunks.empty(); }
-    int chunk_count() { std::lock_guard<std::mutex> lock(m_mutex); return (int)m_chunks.size(); }
+    bool empty() const { std::lock_guard<std::mutex> lock(m_mutex); return m_count == 0; }
+    int segment_count() { std::lock_guard<std::mutex> lock(m_mutex); return m_count; }
 
 private:
+    static int64_t floor_div(int64_t a, int64_t b) {
+        int64_t q = a / b;
+        return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+    }
+
+    // Nearest grid frame: a start time that was itself derived from a frame
+    // count (truncated to μs) maps back to that frame.
+    int64_t frame_at(int64_t time_us) const {
+        return floor_div(time_us * m_sample_rate + 500000, 1000000);
+    }
+
+    int64_t time_at(int64_t frame) const {
+        return floor_div(frame * 1000000LL, m_sample_rate);
+    }
+
+    size_t slot(int64_t frame) const {
+        int64_t s = frame % m_capacity;
+        return static_cast<size_t>(s < 0 ? s + m_capacity : s);
+    }
+
+    void copy_in(int64_t frame, const float* src, int64_t frames) {
+        const size_t pos = slot(frame);
+        const size_t first = std::min(static_cast<size_t>(frames), static_cast<size_t>(m_capacity) - pos);
+        std::memcpy(m_ring.data() + pos * m_channels, src, first * m_channels * sizeof(float));
+        if (static_cast<size_t>(frames) > first) {
+            std::memcpy(m_ring.data(), src + first * m_channels,
+                        (static_cast<size_t>(frames) - first) * m_channels * sizeof(float));
+        }
+    }
+
+    void copy_out(int64_t frame, float* dst, int64_t frames) const {
+        const size_t pos = slot(frame);
+        const size_t first = std::min(static_cast<size_t>(frames), static_cast<size_t>(m_capacity) - pos);
+        std::memcpy(dst, m_ring.data() + pos * m_channels, first * m_channels * sizeof(float));
+        if (static_cast<size_t>(frames) > first) {
+            std::memcpy(dst + first * m_channels, m_ring.data(),
+                        (static_cast<size_t>(frames) - first) * m_channels * sizeof(float));
+        }
+    }
+
+    // Intersect every segment with [lo, hi), dropping the empty ones.
+    void clip_segments(int64_t lo, int64_t hi) {
+        int out = 0;
+        for (int i = 0; i < m_count; i++) {
+            Segment seg = m_segments[i];
+            seg.begin = std::max(seg.begin, lo);
+            seg.end = std::min(seg.end, hi);
+            if (seg.begin < seg.end) m_segments[out++] = seg;
+        }
+        m_count = out;
+    }
+
+    // Union [begin, end) into the sorted segment list, merging anything it
+    // overlaps or touches. If the table is full the segment furthest from
+    // the playhead is dropped (its frames stay in the ring, unreferenced).
+    void add_segment(int64_t begin, int64_t end, int64_t play) {
+        int first = 0;
+        while (first < m_count && m_segments[first].end < begin) first++;
+        int last = first;
+        while (last < m_count && m_segments[last].begin <= end) {
+            begin = std::min(begin, m_segments[last].begin);
+            end = std::max(end, m_segments[last].end);
+            last++;
+        }
+        // Replace [first, last) with the merged segment.
+        const int removed = last - first;
+        if (removed == 0) {
+            if (m_count == MAX_SEGMENTS) {
+                const int64_t d_front = play - m_segments[0].end;
+                const int64_t d_back = m_segments[m_count - 1].begin - play;
+                const int drop = (d_front > d_back) ? 0 : m_count - 1;
+                JVE_LOG_DETAIL(Audio, "SSE source store: segment table full, dropping [%.3f..%.3f)s",
+                    time_at(m_segments[drop].begin) / 1e6, time_at(m_segments[drop].end) / 1e6);
+                for (int i = drop; i + 1 < m_count; i++) m_segments[i] = m_segments[i + 1];
+                m_count--;
+                if (drop < first) first--;
+            }
+            for (int i = m_count; i > first; i--) m_segments[i] = m_segments[i - 1];
+            m_count++;
+        } else if (removed > 1) {
+            for (int i = first + 1; i + removed - 1 < m_count; i++) {
+                m_segments[i] = m_segments[i + removed - 1];
+            }
+            m_count -= removed - 1;
+        }
+        m_segments[first] = {begin, end};
+    }
+
     mutable std::mutex m_mutex;
-    int m_channels;
-    std::deque<Chunk> m_chunks;
-    int64_t m_total_frames;
+    const int m_channels;
+    const int m_sample_rate;
+    const int64_t m_capacity;          // frames
+    const int64_t m_tolerance_frames;  // OVERLAP_TOLERANCE_US on the grid
+    std::vector<float> m_ring;         // capacity × channels, interleaved
+    std::array<Segment, MAX_SEGMENTS> m_segments;  // sorted, disjoint, non-touching
+    int m_count;
 };
 
 // Overlap-add stretch/scrub engine. Two synthesis paths share one 50%-overlap,
@@ -204,7 +314,8 @@ class ScrubStretchEngineImpl {
 public:
     ScrubStretchEngineImpl(const SseConfig& config)
         : m_config(config)
-        , m_source_buffer(config.channels)
+        , m_source_buffer(config.channels, config.sample_rate,
+                          (SOURCE_STORE_US * config.sample_rate) / 1000000)
         , m_current_time_us(0)
         , m_speed(1.0f)
         , m_quality(QualityMode::Q1)
@@ -240,6 +351,14 @@ public:
         m_natural_ref.resize(static_cast<size_t>(m_hop_frames * config.channels), 0.0f);
         m_have_ref = false;
 
+        // Similarity search: fixed geometry (hop-long reference over 2*tol+1
+        // offsets), so the kernel and its scratch are sized once here.
+        const int search_offsets = 2 * m_search_frames + 1;
+        m_xcorr = MakeCrossCorrelator(config.xcorr_kernel, m_hop_frames,
+                                      search_offsets, config.channels);
+        m_xcorr_dot.resize(static_cast<size_t>(search_offsets));
+        m_cand_energy.resize(static_cast<size_t>(wsola_fetch + 1));
+
         // Hann window over snippet_frames
         m_window.resize(static_cast<size_t>(m_snippet_frames));
         for (int i = 0; i < m_snippet_frames; i++) {
@@ -283,17 +402,16 @@ public:
     }
 
     void push_source(const float* data, int64_t frames, int64_t start_time_us) {
-        m_source_buffer.push(data, frames, start_time_us, m_config.sample_rate);
+        m_source_buffer.push(data, frames, start_time_us, m_current_time_us, m_speed < 0);
 
-        // Trim data far outside playhead to prevent unbounded memory growth
-        int64_t keep_margin_us = 10000000;  // 10s (matches Lua AUDIO_CACHE_HALF_WINDOW_US)
+        // Trim data far behind the playhead so it never crowds out what's ahead
         if (m_speed >= 0) {
-            int64_t min_keep = m_current_time_us - keep_margin_us;
+            int64_t min_keep = m_current_time_us - SOURCE_KEEP_MARGIN_US;
             if (min_keep > 0) {
                 m_source_buffer.trim(min_keep, m_config.sample_rate);
             }
         } else {
-            int64_t max_keep = m_current_time_us + keep_margin_us;
+            int64_t max_keep = m_current_time_us + SOURCE_KEEP_MARGIN_US;
             m_source_buffer.trim_after(max_keep, m_config.sample_rate);
         }
     }
@@ -376,11 +494,11 @@ private:
             // If we're at the start of a new hop, prepare the next snippet
             if (m_scrub_pos >= m_hop_frames || !m_snippet_valid) {
                 if (!prepare_next_snippet()) {
-                    if (m_source_buffer.chunk_count() > 0) {
-                        // Chunks present but fetch_time is outside the buffered range — real starvation
+                    if (!m_source_buffer.empty()) {
+                        // Source present but fetch_time is outside the buffered range — real starvation
                         m_starved = true;
-                        JVE_LOG_WARN(Audio, "SSE scrub starved at %.3fs chunks=%d",
-                            m_current_time_us / 1e6, (int)m_source_buffer.chunk_count());
+                        JVE_LOG_WARN(Audio, "SSE scrub starved at %.3fs segments=%d",
+                            m_current_time_us / 1e6, m_source_buffer.segment_count());
                     }
                     // else: buffer empty — no audio clips at this position, silence is correct
                     int64_t remaining = out_frames - frames_produced;
@@ -441,14 +559,14 @@ private:
             fetch_time, m_config.sample_rate, out, out_frames);
 
         if (!have_source) {
-            if (m_source_buffer.chunk_count() > 0) {
-                // Chunks present but fetch_time is outside the buffered range — real starvation
+            if (!m_source_buffer.empty()) {
+                // Source present but fetch_time is outside the buffered range — real starvation
                 m_starved = true;
                 int64_t buf_min = 0, buf_max = 0;
                 m_source_buffer.get_time_range(&buf_min, &buf_max, m_config.sample_rate);
-                JVE_LOG_WARN(Audio, "SSE passthrough starved: fetch=%.3fs buf=[%.3f..%.3f)s chunks=%d frames=%lld",
+                JVE_LOG_WARN(Audio, "SSE passthrough starved: fetch=%.3fs buf=[%.3f..%.3f)s segments=%d frames=%lld",
                     fetch_time / 1e6, buf_min / 1e6, buf_max / 1e6,
-                    (int)m_source_buffer.chunk_count(), (long long)out_frames);
+                    m_source_buffer.segment_count(), (long long)out_frames);
             }
             // else: buffer empty — no audio clips at this timeline position, silence is correct
             std::memset(out, 0, out_frames * ch * sizeof(float));
@@ -563,23 +681,42 @@ private:
     // Normalized cross-correlation search: among the first `num_offsets` grain
     // positions in m_fetch_buffer, return the one whose leading overlap region
     // best matches the stored natural-continuation reference.
+    //
+    // The numerators (ref · candidate for every offset) come from m_xcorr in
+    // one call; that's the O(offsets × hop) part. The normalizers are cheap:
+    // the reference energy once, each candidate's energy as a difference of
+    // running sums over the search region (double, so the subtraction
+    // doesn't eat the small-signal tail).
     int find_best_offset(int num_offsets) {
         int ch = m_config.channels;
+        assert(num_offsets <= static_cast<int>(m_xcorr_dot.size()) &&
+               "find_best_offset: more offsets than the correlator was sized for");
+
+        // Edge fetches never get here (num_offsets == 1), so the region is the
+        // full search region the correlator expects.
+        m_xcorr->correlate(m_natural_ref.data(), m_fetch_buffer.data(), m_xcorr_dot.data());
+
+        float norm_ref = 0.0f;
+        for (float r : m_natural_ref) norm_ref += r * r;
+
+        const int region_frames = m_hop_frames + num_offsets - 1;
+        m_cand_energy[0] = 0.0;
+        for (int i = 0; i < region_frames; i++) {
+            double e = 0.0;
+            for (int c = 0; c < ch; c++) {
+                const double s = m_fetch_buffer[i * ch + c];
+                e += s * s;
+            }
+            m_cand_energy[i + 1] = m_cand_energy[i] + e;
+        }
+
         int best = 0;
         float best_corr = -2.0f;
         for (int off = 0; off < num_offsets; off++) {
-            float sum = 0.0f, norm_ref = 0.0f, norm_cand = 0.0f;
-            for (int i = 0; i < m_hop_frames; i++) {
-                for (int c = 0; c < ch; c++) {
-                    float r = m_natural_ref[i * ch + c];
-                    float s = m_fetch_buffer[(off + i) * ch + c];
-                    sum += r * s;
-                    norm_ref += r * r;
-                    norm_cand += s * s;
-                }
-            }
+            const float norm_cand = static_cast<float>(
+                m_cand_energy[off + m_hop_frames] - m_cand_energy[off]);
             float corr = (norm_ref > 1e-6f && norm_cand > 1e-6f)
-                ? sum / std::sqrt(norm_ref * norm_cand)
+                ? m_xcorr_dot[off] / std::sqrt(norm_ref * norm_cand)
                 : 0.0f;
             if (corr > best_corr) {
                 best_corr = corr;
@@ -746,6 +883,11 @@ private:
     std::vector<float> m_xfade_buffer;  // Direction crossfade snapshot
     std::vector<float> m_window;        // Hann window (snippet_frames)
     std::vector<float> m_natural_ref;   // WSOLA reference: ideal next-grain head (hop frames)
+
+    // WSOLA similarity search (find_best_offset)
+    std::unique_ptr<CrossCorrelator> m_xcorr;  // Kernel per SseConfig::xcorr_kernel
+    std::vector<float> m_xcorr_dot;            // ref · candidate, per offset
+    std::vector<double> m_cand_energy;         // Running Σ s² over the search region (frames + 1)
 };
 
 // ScrubStretchEngine implementation
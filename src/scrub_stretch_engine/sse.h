@@ -5,6 +5,8 @@
 #include <memory>
 #include <thread>
 
+#include "xcorr.h"
+
 namespace sse {
 
 // Quality modes
@@ -33,6 +35,7 @@ struct SseConfig {
     float min_speed_q2;        // Q2 min speed (default 0.10)
     float max_speed;           // Max speed (default 4.0)
     int32_t xfade_ms;          // Direction change crossfade (default 15)
+    XcorrKernel xcorr_kernel = XcorrKernel::Auto;  // WSOLA search kernel (xcorr.h)
 };
 
 // Forward declaration
@@ -117,6 +120,7 @@ inline SseConfig default_config() {
     cfg.min_speed_q2 = 0.10f;
     cfg.max_speed = 4.0f;
     cfg.xfade_ms = 15;
+    cfg.xcorr_kernel = XcorrKernel::Auto;
     return cfg;
 }
 
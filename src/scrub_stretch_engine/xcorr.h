@@ -0,0 +1,56 @@
+#pragma once
+
+// Cross-correlation kernels for the WSOLA similarity search (sse.cpp).
+//
+// Each pitch-corrected grain slides a one-hop reference (the natural
+// continuation of the previous grain) across 2*tol+1 candidate offsets of
+// the fetched search region and keeps the best normalized match. Done
+// directly that is offsets × hop × channels multiply-adds per grain —
+// ~1.8M at 48 kHz stereo, the bulk of SSE's CPU in slow-motion scrub,
+// where every output hop needs a fresh grain.
+//
+// Two implementations behind one interface, fixed geometry so everything
+// is allocated up front (the render path doesn't allocate):
+//   Direct — one SIMD dot product per offset (SSE2 / NEON, scalar
+//            fallback). Cheapest for small windows.
+//   Fft    — zero-padded correlation via a radix-2 complex FFT, two channels
+//            packed per transform as real/imaginary parts (the real part
+//            of conj(FFT(a)) · FFT(b) is their summed correlation).
+//            O(n log n) in the window size.
+// ChooseXcorrKernel picks by window size; SseConfig::xcorr_kernel can
+// force one (benchmarks, A/B listening).
+
+#include <memory>
+#include <vector>
+
+namespace sse {
+
+enum class XcorrKernel {
+    Auto = 0,    // by window size (ChooseXcorrKernel)
+    Direct = 1,
+    Fft = 2,
+};
+
+class CrossCorrelator {
+public:
+    virtual ~CrossCorrelator() = default;
+
+    // dot[off] = Σ_{j < ref_frames*channels} ref[j] · x[off*channels + j]
+    // for off in [0, num_offsets). ref holds ref_frames interleaved frames,
+    // x holds ref_frames + num_offsets - 1. Geometry is the one the
+    // correlator was made for.
+    virtual void correlate(const float* ref, const float* x, float* dot) = 0;
+
+    virtual XcorrKernel kind() const = 0;
+};
+
+// Direct below the crossover, Fft above it (measured: they break even
+// around offsets × ref_frames × channels ≈ 450K; the 48 kHz stereo
+// window is 1.8M, where Fft is ~2× faster).
+XcorrKernel ChooseXcorrKernel(int ref_frames, int num_offsets, int channels);
+
+// kind == Auto resolves through ChooseXcorrKernel.
+std::unique_ptr<CrossCorrelator> MakeCrossCorrelator(
+    XcorrKernel kind, int ref_frames, int num_offsets, int channels);
+
+} // namespace sse
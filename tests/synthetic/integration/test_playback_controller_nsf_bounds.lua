@@ -95,7 +95,7 @@ end
 --------------------------------------------------------------------------------
 section("4. TMB_CREATE rejects pool_threads < 3 (except 0)")
 do
-    -- pool_threads=1 or 2 can't satisfy 1 prep + N-2 video + 1 audio.
+    -- pool_threads=1 or 2 can't satisfy 1 reserved + 2 warm-capable workers.
     -- Binding returns luaL_error (catchable with pcall).
     local ok1, err1 = pcall(EMP.TMB_CREATE, 1)
     check(not ok1, "TMB_CREATE(1) should error")
@@ -123,7 +123,7 @@ do
     check(tmb0 ~= nil, "TMB_CREATE(0) should succeed")
     EMP.TMB_CLOSE(tmb0)
 
-    -- 3 = minimum valid worker count (1 prep + 1 video + 1 audio)
+    -- 3 = minimum valid worker count (1 reserved + 2 warm-capable)
     local tmb3 = EMP.TMB_CREATE(3)
     check(tmb3 ~= nil, "TMB_CREATE(3) should succeed")
     EMP.TMB_CLOSE(tmb3)
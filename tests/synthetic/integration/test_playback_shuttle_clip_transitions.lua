@@ -135,7 +135,7 @@ PLAYBACK.SET_SURFACE(pc, surface)
 -- [from, to) to TMB via TMB_ADD_CLIPS.
 --
 -- This is the path that triggers READER_WARM jobs: AddClips submits one
--- warm per new clip per track. process_next_decode_prep_job's picker
+-- warm per new clip per track. pick_decode_prep_job's picker
 -- determines WHICH gets warmed first — that's the proximity-priority code
 -- path under test.
 local provider_calls = 0
@@ -54,7 +54,7 @@ print(string.format("  qtrle: %dx%d @ %d/%d fps, %d frames",
     info.width, info.height, info.fps_num, info.fps_den,
     math.floor(info.duration_us * info.fps_num / (1000000 * info.fps_den))))
 
--- pool_threads=3 is the minimum for playback (1 prep + 1 video + 1 audio).
+-- pool_threads=3 is the minimum for playback (1 reserved + 2 warm-capable workers).
 -- pool_threads=0 cannot be used: deliverFrame() during Tick calls
 -- GetVideoFrame(cache_only=true), which skips sync decode. Without prefetch
 -- workers the video cache stays empty and no frames arrive during Play.
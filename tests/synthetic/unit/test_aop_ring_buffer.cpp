@@ -0,0 +1,191 @@
+// Unit test for the AOP PCM ring (audio_output_platform/ring_buffer.h).
+//
+// The ring is single-producer/single-consumer and lock-free: the pump
+// writes, the device pull thread reads, and neither ever waits on the
+// other. Checks wrap-around and partial writes/reads on one thread, then
+// the real shape of playback: a pump thread topping the ring up to its
+// target and a simulated device consuming it at the sample rate, both on
+// 2ms periods. Every sample carries its frame index and channel, so a
+// torn read (a frame the consumer saw before all of it was written), a
+// dropped frame or a repeat shows up as a discontinuity.
+//
+// The stress run is JVE_AOP_STRESS_SECONDS long (default 3); set it to a
+// few hundred for a soak.
+
+#include <QtTest>
+
+#include "audio_output_platform/ring_buffer.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using aop::RingBuffer;
+
+class TestAopRingBuffer : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int CHANNELS = 2;
+
+    // Frame index (mod 2^20, exact in a float) plus a channel offset.
+    static float sample(int64_t frame, int ch) {
+        return static_cast<float>(frame & ((1 << 20) - 1)) + 0.25f * static_cast<float>(ch);
+    }
+
+    static void fill(std::vector<float>& buf, int64_t first_frame, int64_t frames) {
+        buf.resize(static_cast<size_t>(frames * CHANNELS));
+        for (int64_t f = 0; f < frames; ++f) {
+            for (int c = 0; c < CHANNELS; ++c) {
+                buf[static_cast<size_t>(f * CHANNELS + c)] = sample(first_frame + f, c);
+            }
+        }
+    }
+
+private slots:
+    void capacityRoundsToPowerOfTwo() {
+        RingBuffer ring(14400, CHANNELS);  // 3 × 100ms at 48k
+        QCOMPARE(ring.capacity_frames(), size_t(16384));
+        RingBuffer exact(4096, CHANNELS);
+        QCOMPARE(exact.capacity_frames(), size_t(4096));
+    }
+
+    void wrapsAndPadsWithSilence() {
+        RingBuffer ring(8, CHANNELS);
+        std::vector<float> in;
+        std::vector<float> out(16 * CHANNELS);
+        int64_t next_in = 0;
+        int64_t next_out = 0;
+
+        // Fill, drain partly, refill across the end of the buffer.
+        fill(in, next_in, 10);
+        QCOMPARE(ring.write(in.data(), 10), int64_t(8));  // full: short write
+        next_in += 8;
+        QCOMPARE(ring.available_frames(), int64_t(8));
+        QCOMPARE(ring.write(in.data(), 1), int64_t(0));
+
+        QCOMPARE(ring.read(out.data(), 5), int64_t(5));
+        for (int64_t f = 0; f < 5; ++f) QCOMPARE(out[size_t(f * CHANNELS + 1)], sample(next_out + f, 1));
+        next_out += 5;
+
+        fill(in, next_in, 5);
+        QCOMPARE(ring.write(in.data(), 5), int64_t(5));  // wraps
+        next_in += 5;
+
+        // Ask for more than buffered: 8 real frames, the rest silence.
+        QCOMPARE(ring.read(out.data(), 12), int64_t(8));
+        for (int64_t f = 0; f < 8; ++f) {
+            for (int c = 0; c < CHANNELS; ++c) {
+                QCOMPARE(out[size_t(f * CHANNELS + c)], sample(next_out + f, c));
+            }
+        }
+        for (size_t i = 8 * CHANNELS; i < 12 * CHANNELS; ++i) QCOMPARE(out[i], 0.0f);
+        QCOMPARE(ring.available_frames(), int64_t(0));
+    }
+
+    void clearDropsBuffered() {
+        RingBuffer ring(64, CHANNELS);
+        std::vector<float> in;
+        fill(in, 0, 40);
+        QCOMPARE(ring.write(in.data(), 40), int64_t(40));
+        ring.clear();
+        QCOMPARE(ring.available_frames(), int64_t(0));
+
+        // Full capacity is usable again, and reads resume at the new data.
+        fill(in, 100, 64);
+        QCOMPARE(ring.write(in.data(), 64), int64_t(64));
+        std::vector<float> out(CHANNELS);
+        QCOMPARE(ring.read(out.data(), 1), int64_t(1));
+        QCOMPARE(out[0], sample(100, 0));
+    }
+
+    void pumpAndDeviceAtTwoMsNoUnderrunNoTear() {
+        const char* env = std::getenv("JVE_AOP_STRESS_SECONDS");
+        const int seconds = env ? std::max(1, std::atoi(env)) : 3;
+
+        // AOP's sizing: ring 3× a 100ms target, pump fills to the target.
+        constexpr int TARGET_FRAMES = SAMPLE_RATE / 10;
+        constexpr int MAX_RENDER_FRAMES = 4096;  // AudioPump's per-cycle cap
+        constexpr auto PERIOD = std::chrono::milliseconds(2);
+        RingBuffer ring(3 * TARGET_FRAMES, CHANNELS);
+
+        std::atomic<bool> stop{false};
+        int64_t produced = 0;
+
+        auto top_up = [&](std::vector<float>& buf) {
+            int64_t deficit = TARGET_FRAMES - ring.available_frames();
+            while (deficit > 0) {
+                const int64_t n = std::min<int64_t>(deficit, MAX_RENDER_FRAMES);
+                fill(buf, produced, n);
+                const int64_t w = ring.write(buf.data(), n);
+                produced += w;
+                deficit -= w;
+                if (w < n) break;
+            }
+        };
+
+        // Prefill as PlaybackController does before AOP.Start.
+        std::vector<float> pump_buf;
+        top_up(pump_buf);
+
+        std::thread pump([&] {
+            auto next = std::chrono::steady_clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                top_up(pump_buf);
+                next += PERIOD;
+                std::this_thread::sleep_until(next);
+            }
+        });
+
+        // The device: consumes whatever frames the sample clock says are
+        // due (an oversleep catches up, as a real device pulls a bigger
+        // period), checks every sample, and counts short reads.
+        int64_t consumed = 0;   // device clock, in frames
+        int64_t next_frame = 0; // next frame index the data should carry
+        int64_t underruns = 0;
+        int64_t bad_samples = 0;
+        int64_t max_pull = 0;
+        std::thread device([&] {
+            std::vector<float> out;
+            const auto t0 = std::chrono::steady_clock::now();
+            auto next = t0;
+            const auto end = t0 + std::chrono::seconds(seconds);
+            while (next < end) {
+                next += PERIOD;
+                std::this_thread::sleep_until(next);
+                const int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - t0).count();
+                const int64_t due = elapsed_us * SAMPLE_RATE / 1000000 - consumed;
+                if (due <= 0) continue;
+                max_pull = std::max(max_pull, due);
+                out.resize(static_cast<size_t>(due * CHANNELS));
+                const int64_t got = ring.read(out.data(), due);
+                if (got < due) ++underruns;
+                for (int64_t f = 0; f < got; ++f) {
+                    for (int c = 0; c < CHANNELS; ++c) {
+                        if (out[static_cast<size_t>(f * CHANNELS + c)] != sample(next_frame + f, c)) ++bad_samples;
+                    }
+                }
+                next_frame += got;
+                consumed += due;  // the device clock advances regardless
+            }
+            stop.store(true);
+        });
+
+        device.join();
+        pump.join();
+
+        qDebug() << "ring stress:" << seconds << "s," << consumed << "frames consumed,"
+                 << underruns << "underruns," << bad_samples << "bad samples, largest pull"
+                 << max_pull << "frames";
+        QCOMPARE(bad_samples, int64_t(0));
+        QCOMPARE(underruns, int64_t(0));
+        QVERIFY(consumed >= int64_t(seconds) * SAMPLE_RATE * 9 / 10);
+    }
+};
+
+QTEST_MAIN(TestAopRingBuffer)
+#include "test_aop_ring_buffer.moc"
@@ -0,0 +1,229 @@
+// Unit test for the AOP virtual backend (AopBackend::Virtual, aop.h).
+//
+// The virtual device is what lets the audio path run on machines with no
+// sound hardware, so these pin down the properties benchmarks rely on:
+// - unpaced: the consumed stream is exactly what was written (WAV record
+//   matches sample for sample, including a final partial period) and
+//   PlayheadTimeUS / AudibleTimeUS are exact functions of frames consumed
+//   and the configured sink latency;
+// - realtime: the simulated clock tracks the wall clock, a writer driven
+//   only by the low-watermark notification keeps it fed, and a writer that
+//   stops shows up as an underrun. The realtime bounds are loose — they
+//   must hold on a loaded CI machine; the printed numbers are the measure.
+
+#include <QtTest>
+#include <QTemporaryDir>
+
+#include "audio_output_platform/aop.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TestAopVirtual : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr int SAMPLE_RATE = 48000;
+    static constexpr int CHANNELS = 2;
+    static constexpr int TARGET_MS = 100;
+
+    QTemporaryDir m_dir;
+
+    static float sample(int64_t frame, int ch) {
+        return static_cast<float>(frame % 100000) * 1e-5f + (ch ? 0.5f : 0.0f);
+    }
+
+    static std::vector<float> ramp(int64_t first, int64_t frames) {
+        std::vector<float> v(static_cast<size_t>(frames * CHANNELS));
+        for (int64_t f = 0; f < frames; ++f) {
+            for (int c = 0; c < CHANNELS; ++c) v[static_cast<size_t>(f * CHANNELS + c)] = sample(first + f, c);
+        }
+        return v;
+    }
+
+    static std::unique_ptr<aop::AudioOutput> open_virtual(bool realtime, int period,
+                                                          int64_t latency_us,
+                                                          const std::string& wav = "") {
+        aop::AopConfig config;
+        config.sample_rate = SAMPLE_RATE;
+        config.channels = CHANNELS;
+        config.target_buffer_ms = TARGET_MS;
+        config.backend = aop::AopBackend::Virtual;
+        config.virtual_device.realtime = realtime;
+        config.virtual_device.period_frames = period;
+        config.virtual_device.sink_latency_us = latency_us;
+        config.virtual_device.wav_path = wav;
+        aop::AopOpenReport report;
+        return aop::AudioOutput::Open(config, &report);
+    }
+
+    // Write `frames` of the ramp, waiting for ring space as the device drains.
+    static void write_all(aop::AudioOutput& out, int64_t frames) {
+        const auto pcm = ramp(0, frames);
+        int64_t done = 0;
+        while (done < frames) {
+            done += out.WriteF32(pcm.data() + done * CHANNELS, frames - done);
+            if (done < frames) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Unpaced run of `frames`: drain, stop, then check the clock and the
+    // recorded WAV against the ramp.
+    void check_unpaced_record(int period, int64_t frames, const QString& name) {
+        const std::string wav = m_dir.filePath(name).toStdString();
+        auto out = open_virtual(/*realtime=*/false, period, 30000, wav);
+        QVERIFY(out);
+
+        out->Start();
+        write_all(*out, frames);
+        QTRY_VERIFY(out->BufferedFrames() == 0);
+        out->Stop();  // joins the device thread, patches the WAV header
+
+        const int64_t expect_us = frames * 1000000LL / SAMPLE_RATE;
+        QCOMPARE(out->PlayheadTimeUS(), expect_us);
+        QCOMPARE(out->AudibleTimeUS(), expect_us - 30000);
+        QVERIFY(!out->HadUnderrun());
+
+        std::FILE* f = std::fopen(wav.c_str(), "rb");
+        QVERIFY(f);
+        uint8_t header[58];
+        QCOMPARE(std::fread(header, 1, sizeof(header), f), sizeof(header));
+        QVERIFY(std::memcmp(header, "RIFF", 4) == 0);
+        QVERIFY(std::memcmp(header + 8, "WAVE", 4) == 0);
+        QVERIFY(std::memcmp(header + 50, "data", 4) == 0);
+        uint32_t data_bytes = 0;
+        std::memcpy(&data_bytes, header + 54, 4);  // little-endian host
+        QCOMPARE(static_cast<int64_t>(data_bytes), frames * CHANNELS * 4);
+        std::vector<float> got(static_cast<size_t>(frames * CHANNELS));
+        QCOMPARE(std::fread(got.data(), sizeof(float), got.size(), f), got.size());
+        std::fclose(f);
+        QVERIFY(got == ramp(0, frames));
+    }
+
+    static int64_t wall_us_since(std::chrono::steady_clock::time_point t0) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+    }
+
+private slots:
+    void initTestCase() {
+        QVERIFY(m_dir.isValid());
+    }
+
+    void rejectsBadConfig() {
+        aop::AopConfig config;
+        config.sample_rate = SAMPLE_RATE;
+        config.channels = CHANNELS;
+        config.target_buffer_ms = TARGET_MS;
+        config.backend = aop::AopBackend::Virtual;
+        config.virtual_device.period_frames = 0;
+        aop::AopOpenReport report;
+        QVERIFY(!aop::AudioOutput::Open(config, &report));
+        QVERIFY(report.device_name.find("period_frames") != std::string::npos);
+    }
+
+    void unpacedRecordsExactStream() {
+        constexpr int PERIOD = 256;
+        // 0.8s, more than the ring holds.
+        check_unpaced_record(PERIOD, PERIOD * 150, "unpaced.wav");
+    }
+
+    void unpacedDrainsPartialFinalPeriod() {
+        // The last 100 frames are less than a period: still consumed and
+        // recorded once the writer stops.
+        constexpr int PERIOD = 256;
+        check_unpaced_record(PERIOD, PERIOD * 150 + 100, "unpaced_tail.wav");
+    }
+
+    void realtimeWatermarkWriterKeepsUp() {
+        constexpr int PERIOD = 480;  // 10ms device pulls
+        auto out = open_virtual(/*realtime=*/true, PERIOD, 20000);
+        QVERIFY(out);
+        const int64_t target = SAMPLE_RATE * TARGET_MS / 1000;
+
+        // An event-driven writer, as AudioPump: refill to target only when
+        // the device reports the ring fell below half of it.
+        std::mutex mu;
+        std::condition_variable cv;
+        std::atomic<int> wakes{0};
+        std::atomic<bool> stop{false};
+        out->SetLowWatermark(target / 2, [&] {
+            ++wakes;
+            cv.notify_one();
+        });
+
+        int64_t written = 0;
+        auto refill = [&] {
+            const int64_t deficit = target - out->BufferedFrames();
+            if (deficit <= 0) return;
+            const auto pcm = ramp(written, deficit);
+            written += out->WriteF32(pcm.data(), deficit);
+        };
+        refill();
+
+        std::thread writer([&] {
+            int seen = 0;
+            while (!stop.load()) {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait_for(lock, std::chrono::milliseconds(200),
+                            [&] { return stop.load() || wakes.load() != seen; });
+                seen = wakes.load();
+                lock.unlock();
+                refill();
+            }
+        });
+
+        const auto t0 = std::chrono::steady_clock::now();
+        out->Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+        const int64_t playhead = out->PlayheadTimeUS();
+        const int64_t wall = wall_us_since(t0);
+        stop.store(true);
+        cv.notify_one();
+        writer.join();
+        out->SetLowWatermark(0, nullptr);
+        out->Stop();
+
+        qDebug() << "virtual realtime: playhead" << playhead << "us after" << wall
+                 << "us wall," << wakes.load() << "watermark wakes, underrun"
+                 << out->HadUnderrun();
+        // PlayheadTimeUS counts frames the writer supplied: a starving
+        // writer falls behind the wall clock, a free-running sink would
+        // race ahead of it. Either is far outside 150ms.
+        QVERIFY2(std::abs(playhead - wall) < 150000,
+                 qPrintable(QString("playhead %1us vs wall %2us").arg(playhead).arg(wall)));
+        // ~50ms of audio per wake at half-target: ~20 wakes in a second.
+        // Edge-triggered, not one per 10ms pull (100).
+        QVERIFY2(wakes.load() >= 5 && wakes.load() <= 80,
+                 qPrintable(QString("%1 watermark wakes").arg(wakes.load())));
+    }
+
+    void realtimeUnderrunsWhenStarved() {
+        auto out = open_virtual(/*realtime=*/true, 480, 20000);
+        QVERIFY(out);
+        const auto pcm = ramp(0, SAMPLE_RATE / 10);  // 100ms, then nothing
+        out->WriteF32(pcm.data(), SAMPLE_RATE / 10);
+
+        const auto t0 = std::chrono::steady_clock::now();
+        out->Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        const int64_t playhead = out->PlayheadTimeUS();
+        const int64_t wall = wall_us_since(t0);
+        out->Stop();
+
+        QVERIFY(out->HadUnderrun());
+        // PlayheadTimeUS counts frames read from the ring — it stops at
+        // what was written, while the simulated device kept pulling.
+        QCOMPARE(playhead, int64_t(100000));
+        QVERIFY(wall >= 300000);
+    }
+};
+
+QTEST_MAIN(TestAopVirtual)
+#include "test_aop_virtual.moc"
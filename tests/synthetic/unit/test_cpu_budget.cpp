@@ -0,0 +1,177 @@
+// Unit test for the process-wide decode thread budget (emp_cpu_budget.h).
+//
+// Pins the machine at 16 threads and walks the foreground / activity states
+// the editor goes through: idle, playing, scrubbing, with and without peak
+// generation. Checks the share-out per class, the codec thread split
+// (around the TMB decode pool and the slice pool), that the three pools
+// never add up past the machine, that listeners fire only when slots
+// actually move, and that a PeakGenerator (the live-resizing consumer)
+// survives rebalances and teardown.
+
+#include <QtTest>
+
+#include <editor_media_platform/emp_cpu_budget.h>
+#include <editor_media_platform/emp_peak_generator.h>
+#include <editor_media_platform/emp_reader.h>
+#include <editor_media_platform/emp_timeline_media_buffer.h>
+#include <atomic>
+#include <memory>
+
+using emp::CpuClass;
+using emp::CpuForeground;
+
+class TestCpuBudget : public QObject
+{
+    Q_OBJECT
+
+private:
+    static int budget(CpuClass c) { return emp::CpuBudgetSlots(c); }
+
+private slots:
+    void init() {
+        emp::SetCpuBudgetThreads(16);
+        emp::SetCpuForeground(CpuForeground::Idle);
+    }
+
+    void cleanup() {
+        emp::SetCpuForeground(CpuForeground::Idle);
+        emp::SetCpuBudgetThreads(0);
+    }
+
+    void idleGivesEveryClassItsCap() {
+        QCOMPARE(emp::GetCpuBudgetStats().total_threads, 16);
+        QCOMPARE(budget(CpuClass::Playback), 16);
+        QCOMPARE(budget(CpuClass::Scrub), 16);
+        QCOMPARE(budget(CpuClass::Peaks), 4);
+        QCOMPARE(emp::CpuBudgetCap(CpuClass::Peaks), 4);
+        QCOMPARE(budget(CpuClass::Probe), 16);
+    }
+
+    void playbackSqueezesLowerClasses() {
+        emp::SetCpuForeground(CpuForeground::Playback);
+        QCOMPARE(budget(CpuClass::Playback), 16);
+        // Playback claims 16 - 16/8 = 14; two threads left below it.
+        QCOMPARE(budget(CpuClass::Scrub), 2);
+        QCOMPARE(budget(CpuClass::Peaks), 2);
+        QCOMPARE(budget(CpuClass::Probe), 2);
+
+        {
+            emp::CpuActivity peaks(CpuClass::Peaks);
+            QCOMPARE(emp::GetCpuBudgetStats().active[static_cast<int>(CpuClass::Peaks)], 1);
+            // Nothing left for Probe but its floor of one.
+            QCOMPARE(budget(CpuClass::Probe), 1);
+        }
+        QCOMPARE(budget(CpuClass::Probe), 2);
+
+        emp::SetCpuForeground(CpuForeground::Idle);
+        QCOMPARE(budget(CpuClass::Peaks), 4);
+        QCOMPARE(budget(CpuClass::Probe), 16);
+    }
+
+    void scrubLeavesAQuarter() {
+        emp::SetCpuForeground(CpuForeground::Scrub);
+        QCOMPARE(budget(CpuClass::Scrub), 16);
+        QCOMPARE(budget(CpuClass::Peaks), 4);
+        QCOMPARE(budget(CpuClass::Probe), 4);
+        emp::CpuActivity peaks(CpuClass::Peaks);
+        QCOMPARE(budget(CpuClass::Probe), 1);
+    }
+
+    void idlePeaksLeaveRestToProbe() {
+        emp::CpuActivity peaks(CpuClass::Peaks);
+        QCOMPARE(budget(CpuClass::Probe), 12);
+    }
+
+    void decodeModeDrivesForeground() {
+        emp::SetDecodeMode(emp::DecodeMode::Play);
+        QCOMPARE(budget(CpuClass::Peaks), 2);
+        emp::SetDecodeMode(emp::DecodeMode::Scrub);
+        QCOMPARE(budget(CpuClass::Probe), 4);
+        emp::SetDecodeMode(emp::DecodeMode::Park);
+        QCOMPARE(budget(CpuClass::Probe), 16);
+    }
+
+    void codecThreadsSplitAcrossOpenDecoders() {
+        // 16 Playback slots less the slice share of 4; first codec: capped
+        // at MAX_CODEC_THREADS.
+        QCOMPARE(emp::CpuBudgetSliceWorkers(), 4);
+        QCOMPARE(emp::CpuBudgetCodecThreads(), emp::MAX_CODEC_THREADS);
+        for (int i = 0; i < 3; ++i) emp::impl::cpu_budget_video_decoder_opened();
+        QCOMPARE(emp::GetCpuBudgetStats().video_decoders, 3);
+        QCOMPARE(emp::CpuBudgetCodecThreads(), 3);  // 12 / (3 + 1)
+        for (int i = 0; i < 3; ++i) emp::impl::cpu_budget_video_decoder_closed();
+
+        emp::SetCpuBudgetThreads(1);
+        QCOMPARE(emp::CpuBudgetCodecThreads(), 1);
+    }
+
+    void codecThreadsLeaveDecodePoolSlots() {
+        // A 10-worker TMB pool and the 4 slice workers leave 2 of the 16
+        // Playback slots to codecs.
+        emp::impl::cpu_budget_decode_workers_started(10);
+        QCOMPARE(emp::GetCpuBudgetStats().decode_workers, 10);
+        QCOMPARE(emp::CpuBudgetCodecThreads(), 2);
+        emp::impl::cpu_budget_video_decoder_opened();
+        QCOMPARE(emp::CpuBudgetCodecThreads(), 1);  // 2 / (1 + 1)
+        for (int i = 0; i < 3; ++i) emp::impl::cpu_budget_video_decoder_opened();
+        QCOMPARE(emp::CpuBudgetCodecThreads(), 1);  // never below one
+        for (int i = 0; i < 4; ++i) emp::impl::cpu_budget_video_decoder_closed();
+        emp::impl::cpu_budget_decode_workers_stopped(10);
+        QCOMPARE(emp::CpuBudgetCodecThreads(), emp::MAX_CODEC_THREADS);
+    }
+
+    void poolsNeverExceedTheMachine() {
+        // Decode pool + slice pool + the first codec's threads (1 = decodes
+        // on the calling worker, no thread of its own) at every machine
+        // size down to the decode pool's MIN_POOL_THREADS floor.
+        emp::SetCpuForeground(CpuForeground::Playback);
+        for (int total : {4, 5, 6, 8, 12, 16, 24, 32, 64, 128}) {
+            emp::SetCpuBudgetThreads(total);
+            auto tmb = emp::TimelineMediaBuffer::Create();
+            const auto stats = emp::GetCpuBudgetStats();
+            QCOMPARE(stats.slice_workers, emp::CpuBudgetSliceWorkers());
+            QVERIFY(stats.decode_workers >= 1);
+            const int codec = emp::CpuBudgetCodecThreads();
+            const int codec_extra = codec > 1 ? codec : 0;
+            const int used = stats.decode_workers + stats.slice_workers + codec_extra;
+            QVERIFY2(used <= total, qPrintable(QString("total %1: %2 decode + %3 slice + %4 codec")
+                .arg(total).arg(stats.decode_workers).arg(stats.slice_workers).arg(codec_extra)));
+            tmb.reset();
+            QCOMPARE(emp::GetCpuBudgetStats().decode_workers, 0);
+        }
+    }
+
+    void listenersFireOnlyOnChange() {
+        std::atomic<int> calls{0};
+        const int id = emp::AddCpuBudgetListener([&calls]() { ++calls; });
+
+        emp::SetCpuForeground(CpuForeground::Playback);
+        QCOMPARE(calls.load(), 1);
+        emp::SetCpuForeground(CpuForeground::Playback);  // no change
+        QCOMPARE(calls.load(), 1);
+        emp::SetCpuForeground(CpuForeground::Idle);
+        QCOMPARE(calls.load(), 2);
+
+        emp::RemoveCpuBudgetListener(id);
+        emp::SetCpuForeground(CpuForeground::Playback);
+        QCOMPARE(calls.load(), 2);
+    }
+
+    void peakGeneratorFollowsRebalances() {
+        auto gen = std::make_unique<emp::PeakGenerator>();
+        QCOMPARE(gen->GetWorkerCount(), 4);
+        QCOMPARE(gen->GetActiveWorkerCount(), 4);
+
+        emp::SetCpuForeground(CpuForeground::Playback);
+        QCOMPARE(gen->GetActiveWorkerCount(), 2);
+        emp::SetCpuForeground(CpuForeground::Idle);
+        QCOMPARE(gen->GetActiveWorkerCount(), 4);
+
+        // Teardown removes the listener before the generator's state dies.
+        gen.reset();
+        emp::SetCpuForeground(CpuForeground::Playback);
+    }
+};
+
+QTEST_MAIN(TestCpuBudget)
+#include "test_cpu_budget.moc"
@@ -598,6 +598,39 @@ private slots:
         }
     }
 
+    void test_reader_decode_gop_ends_at_target() {
+        // DecodeGopUS (reverse playback): frames from the target's keyframe
+        // through the target, ascending, newest max_frames kept. The last
+        // one must be exactly what DecodeAt returns for the target.
+        if (!m_hasTestVideo) QSKIP("No test video");
+
+        auto mf = emp::MediaFile::Open(m_testVideoPath.toStdString()).value();
+        const auto& info = mf->info();
+        emp::Rate rate{info.video_fps_num, info.video_fps_den};
+        const auto target = emp::FrameTime::from_frame(30, rate);
+
+        auto ref_reader = emp::Reader::Create(mf).value();
+        auto ref = ref_reader->DecodeAt(target);
+        if (ref.is_error()) QSKIP("Video too short");
+
+        auto reader = emp::Reader::Create(mf).value();
+        auto gop = reader->DecodeGopUS(target.to_us(), 48);
+        QVERIFY(gop.is_ok());
+        const auto& frames = gop.value();
+        QVERIFY(!frames.empty());
+        QVERIFY(frames.size() <= 48);
+        QCOMPARE(frames.back()->source_pts_us(), ref.value()->source_pts_us());
+        for (size_t i = 1; i < frames.size(); ++i) {
+            QVERIFY(frames[i]->source_pts_us() > frames[i - 1]->source_pts_us());
+        }
+
+        // Cap keeps the newest frames.
+        auto capped = reader->DecodeGopUS(target.to_us(), 4);
+        QVERIFY(capped.is_ok());
+        QVERIFY(capped.value().size() <= 4);
+        QCOMPARE(capped.value().back()->source_pts_us(), ref.value()->source_pts_us());
+    }
+
     void test_reader_reuse_after_eof() {
         if (!m_hasTestVideo) QSKIP("No test video");
 
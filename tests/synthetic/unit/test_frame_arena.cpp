@@ -0,0 +1,144 @@
+// Unit test for the process-wide frame arena (emp_frame_arena.h) — the
+// buffer source for every CPU-decoded Frame.
+//
+// Decodes through real Readers (skipped without the fixture): buffers are
+// recycled across Readers instead of reserved per Reader, in_use tracks live
+// Frames, TrimFrameArena releases idle pages without unmapping, and the cap
+// is hard — a decode past it fails cleanly and succeeds again once frames die.
+
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+
+#include <editor_media_platform/emp_frame_arena.h>
+#include <editor_media_platform/emp_media_file.h>
+#include <editor_media_platform/emp_reader.h>
+#include <editor_media_platform/emp_frame.h>
+#include <memory>
+#include <vector>
+
+class TestFrameArena : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString m_videoPath;
+
+    std::shared_ptr<emp::Reader> open_reader() {
+        auto mf = emp::MediaFile::Open(m_videoPath.toStdString());
+        if (mf.is_error()) return nullptr;
+        auto reader = emp::Reader::Create(mf.value());
+        return reader.is_ok() ? reader.value() : nullptr;
+    }
+
+    static std::shared_ptr<emp::Frame> decode(emp::Reader& reader, int64_t frame) {
+        const emp::Rate rate = reader.media_file()->info().video_rate();
+        auto r = reader.DecodeAt(emp::FrameTime::from_frame(frame, rate));
+        return r.is_ok() ? r.value() : nullptr;
+    }
+
+private slots:
+    void initTestCase() {
+        QStringList searchDirs = {
+            QDir::homePath() + "/Local/jve/tests/fixtures/media",
+            QDir::currentPath() + "/../tests/fixtures/media",
+        };
+        for (const auto& dirPath : searchDirs) {
+            QString candidate = QDir(dirPath).absoluteFilePath("test_bars_tone.mp4");
+            if (QFile::exists(candidate)) { m_videoPath = candidate; break; }
+        }
+    }
+
+    void cleanup() {
+        emp::SetFrameArenaCap(emp::DEFAULT_FRAME_ARENA_CAP);
+    }
+
+    void test_default_cap() {
+        QCOMPARE(emp::GetFrameArenaStats().cap_bytes, emp::DEFAULT_FRAME_ARENA_CAP);
+    }
+
+    void test_buffers_recycle_across_readers() {
+        if (m_videoPath.isEmpty()) QSKIP("test_bars_tone.mp4 fixture not found");
+        auto a = open_reader();
+        QVERIFY(a);
+        if (a->IsHwAccelerated()) QSKIP("HW frames don't use the arena");
+
+        const auto before = emp::GetFrameArenaStats();
+        auto frame = decode(*a, 5);
+        QVERIFY(frame);
+        const auto held = emp::GetFrameArenaStats();
+        QVERIFY(held.in_use_bytes > before.in_use_bytes);
+        QVERIFY(held.high_water_bytes >= held.in_use_bytes);
+        const int64_t frame_bytes = held.in_use_bytes - before.in_use_bytes;
+        QVERIFY(frame_bytes >= static_cast<int64_t>(frame->stride_bytes()) * frame->height());
+
+        frame.reset();
+        const auto released = emp::GetFrameArenaStats();
+        QCOMPARE(released.in_use_bytes, before.in_use_bytes);
+        QCOMPARE(released.reserved_bytes, held.reserved_bytes);  // kept for reuse
+
+        // A different Reader reuses the idle buffer: nothing new reserved,
+        // and creating the Reader reserved nothing up front.
+        a.reset();
+        auto b = open_reader();
+        QVERIFY(b);
+        QCOMPARE(emp::GetFrameArenaStats().reserved_bytes, released.reserved_bytes);
+        auto again = decode(*b, 10);
+        QVERIFY(again);
+        QCOMPARE(emp::GetFrameArenaStats().reserved_bytes, released.reserved_bytes);
+    }
+
+    void test_trim_releases_idle_buffers_only() {
+        if (m_videoPath.isEmpty()) QSKIP("test_bars_tone.mp4 fixture not found");
+        auto reader = open_reader();
+        QVERIFY(reader);
+        if (reader->IsHwAccelerated()) QSKIP("HW frames don't use the arena");
+
+        auto live = decode(*reader, 3);
+        auto idle = decode(*reader, 4);
+        QVERIFY(live && idle);
+        idle.reset();
+        emp::TrimFrameArena();  // drop anything left idle by earlier tests
+
+        auto spare = decode(*reader, 6);
+        QVERIFY(spare);
+        const int64_t spare_bytes = emp::GetFrameArenaStats().in_use_bytes;
+        spare.reset();
+        const int64_t trimmed = emp::TrimFrameArena();
+        QVERIFY(trimmed > 0);
+        QVERIFY(trimmed <= spare_bytes);
+        QCOMPARE(emp::TrimFrameArena(), int64_t(0));  // already trimmed
+
+        // The live frame's bytes are untouched by the trim; a trimmed buffer
+        // decodes fine on reuse.
+        QVERIFY(live->data() != nullptr);
+        QVERIFY(decode(*reader, 7));
+    }
+
+    void test_cap_is_hard() {
+        if (m_videoPath.isEmpty()) QSKIP("test_bars_tone.mp4 fixture not found");
+        auto reader = open_reader();
+        QVERIFY(reader);
+        if (reader->IsHwAccelerated()) QSKIP("HW frames don't use the arena");
+
+        std::vector<std::shared_ptr<emp::Frame>> held;
+        held.push_back(decode(*reader, 1));
+        QVERIFY(held.back());
+        const auto stats = emp::GetFrameArenaStats();
+
+        // Cap at exactly what live frames occupy: idle buffers are unmapped
+        // and the next decode has nowhere to go.
+        emp::SetFrameArenaCap(stats.in_use_bytes);
+        QCOMPARE(emp::GetFrameArenaStats().reserved_bytes, stats.in_use_bytes);
+        const int64_t failures = emp::GetFrameArenaStats().cap_failures;
+        QVERIFY(!decode(*reader, 2));
+        QCOMPARE(emp::GetFrameArenaStats().cap_failures, failures + 1);
+
+        // Releasing a frame makes room again.
+        held.clear();
+        QVERIFY(decode(*reader, 2));
+    }
+};
+
+QTEST_GUILESS_MAIN(TestFrameArena)
+#include "test_frame_arena.moc"
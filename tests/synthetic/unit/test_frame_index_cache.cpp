@@ -0,0 +1,275 @@
+// Unit test + microbenchmark for emp::FrameIndexCache — the ring-indexed,
+// intrusive-LRU store behind TMB's per-track video cache.
+//
+// Correctness half: the cache must behave like the std::map + insert_seq
+// structure it replaced — exact lookup, lower_bound/prev neighbour queries,
+// insertion-order LRU, and eviction of keys that fall off the ring window.
+//
+// Benchmark half: insert / lookup / evict timed at 144 (the TMB per-track
+// cap), 1k, and 10k entries, printed only. Per-op cost must stay flat as
+// the cache grows: 10x the entries may cost at most 3x per op (cache
+// misses on the larger pool), where an accidental O(n) path costs ~10x.
+// A ratio, not an absolute ceiling, so machine speed and build type
+// don't matter.
+//
+// PURE unit test — no media, no workers.
+
+#include <QtTest>
+#include <editor_media_platform/emp_frame_index_cache.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+
+using emp::FrameIndexCache;
+
+class TestFrameIndexCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    using Cache = FrameIndexCache<int>;
+
+    static void noop(const Cache::Entry&) {}
+
+    // Mean nanoseconds per op for `ops` calls of f.
+    template <typename F>
+    static double ns_per_op(int ops, F&& f) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < ops; ++i) f(i);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        return static_cast<double>(ns) / ops;
+    }
+
+    struct OpCosts {
+        double insert_ns;
+        double lookup_ns;
+        double evict_ns;
+        bool drained;  // every run's drain emptied the cache
+    };
+
+    // Per-op cost of insert-at-capacity, lookup and drain on a cache of
+    // `entries`. Best of `reps` runs, to keep scheduler noise out of ratios.
+    static OpCosts measure(int entries, int reps) {
+        OpCosts best{1e30, 1e30, 1e30, true};
+        for (int rep = 0; rep < reps; ++rep) {
+            const int ops = 200000;
+            Cache c(static_cast<size_t>(entries), static_cast<size_t>(entries) * 4);
+            fill_forward(c, 0, entries);
+
+            // Insert at capacity: every op evicts the oldest and inserts the
+            // next forward frame (steady-state prefetch).
+            int64_t next = entries;
+            double insert_ns = ns_per_op(ops, [&](int) {
+                c.erase(c.oldest());
+                c.insert(next, 0, noop);
+                next++;
+            });
+
+            // Lookup: exact hits spread over the resident range, plus the
+            // nearest-neighbour query the cache_only path runs on a miss.
+            const int64_t lo_key = next - entries;
+            volatile int64_t sink = 0;
+            double lookup_ns = ns_per_op(ops, [&](int i) {
+                int64_t k = lo_key + (static_cast<int64_t>(i) * 7919) % entries;
+                sink = sink + c.find(k)->key;
+                if (auto* n = c.at_or_after(k + 1, 16)) sink = sink + n->key;
+            });
+
+            // Evict: drain oldest-first.
+            double evict_ns = ns_per_op(entries, [&](int) { c.erase(c.oldest()); });
+            best.drained = best.drained && c.empty();
+            best.insert_ns = std::min(best.insert_ns, insert_ns);
+            best.lookup_ns = std::min(best.lookup_ns, lookup_ns);
+            best.evict_ns = std::min(best.evict_ns, evict_ns);
+        }
+        return best;
+    }
+
+    // Fill to `n` entries with stride-1 keys, evicting oldest at capacity —
+    // the TMB forward-play pattern.
+    static void fill_forward(Cache& c, int64_t first, int n) {
+        for (int64_t k = first; k < first + n; ++k) {
+            if (c.size() == c.capacity()) c.erase(c.oldest());
+            c.insert(k, static_cast<int>(k), noop);
+        }
+    }
+
+private slots:
+
+    // ── Correctness ──
+
+    void test_find_hit_and_miss() {
+        Cache c(16, 256);
+        QVERIFY(c.find(0) == nullptr);
+        c.insert(100, 1, noop);
+        c.insert(105, 2, noop);
+        QCOMPARE(c.size(), size_t(2));
+        QVERIFY(c.find(100) && c.find(100)->value == 1);
+        QVERIFY(c.find(105) && c.find(105)->value == 2);
+        QVERIFY(c.find(101) == nullptr);
+        QVERIFY(c.find(100 + int64_t(c.window_frames())) == nullptr);  // aliases slot of 100
+    }
+
+    void test_window_rounds_to_power_of_two() {
+        Cache a(4, 1);
+        QCOMPARE(a.window_frames(), size_t(64));
+        Cache b(4, 100);
+        QCOMPARE(b.window_frames(), size_t(128));
+    }
+
+    void test_lru_is_insertion_order() {
+        Cache c(4, 256);
+        c.insert(50, 0, noop);
+        c.insert(10, 0, noop);
+        c.insert(30, 0, noop);
+        c.find(50);  // lookups must not promote
+        QCOMPARE(c.oldest()->key, int64_t(50));
+        c.erase(c.oldest());
+        QCOMPARE(c.oldest()->key, int64_t(10));
+        c.erase(c.find(30));
+        QCOMPARE(c.oldest()->key, int64_t(10));
+        c.erase(c.oldest());
+        QVERIFY(c.empty());
+        QVERIFY(c.oldest() == nullptr);
+    }
+
+    void test_neighbour_queries() {
+        Cache c(8, 256);
+        for (int64_t k : {10, 20, 75, 140}) c.insert(k, 0, noop);
+
+        QCOMPARE(c.at_or_after(20)->key, int64_t(20));
+        QCOMPARE(c.at_or_after(21)->key, int64_t(75));
+        QCOMPARE(c.at_or_after(76)->key, int64_t(140));
+        QVERIFY(c.at_or_after(141) == nullptr);
+        QVERIFY(c.at_or_after(21, 16) == nullptr);  // 75 is 54 away
+        QCOMPARE(c.at_or_after(60, 16)->key, int64_t(75));
+
+        QCOMPARE(c.before(20)->key, int64_t(10));
+        QCOMPARE(c.before(75)->key, int64_t(20));
+        QCOMPARE(c.before(1000)->key, int64_t(140));
+        QVERIFY(c.before(10) == nullptr);
+        QVERIFY(c.before(139, 16) == nullptr);  // 75 is 64 away
+        QCOMPARE(c.before(30, 16)->key, int64_t(20));
+
+        QCOMPARE(c.first()->key, int64_t(10));
+        QCOMPARE(c.last()->key, int64_t(140));
+    }
+
+    void test_window_slide_evicts_far_entries() {
+        Cache c(8, 64);
+        std::vector<int64_t> evicted;
+        auto on_evict = [&](const Cache::Entry& e) { evicted.push_back(e.key); };
+        c.insert(1000, 0, on_evict);
+        c.insert(1010, 0, on_evict);
+        c.insert(1020, 0, on_evict);
+        QVERIFY(evicted.empty());
+
+        // 1070 is beyond the 64-frame window from 1000 — window slides up
+        // just far enough; 1000 falls off, 1010 and 1020 survive.
+        c.insert(1070, 0, on_evict);
+        QCOMPARE(evicted, std::vector<int64_t>{1000});
+        QVERIFY(c.find(1010) && c.find(1020) && c.find(1070));
+
+        // Long backward seek: everything else falls off.
+        evicted.clear();
+        c.insert(0, 0, on_evict);
+        QCOMPARE(evicted.size(), size_t(3));
+        QCOMPARE(c.size(), size_t(1));
+        QCOMPARE(c.first()->key, int64_t(0));
+    }
+
+    void test_erase_if_and_clear() {
+        Cache c(16, 256);
+        for (int64_t k = 0; k < 10; ++k) c.insert(k, static_cast<int>(k % 2), noop);
+        int erased = 0;
+        c.erase_if([](const Cache::Entry& e) { return e.value == 1; },
+                   [&](const Cache::Entry&) { erased++; });
+        QCOMPARE(erased, 5);
+        QCOMPARE(c.size(), size_t(5));
+        int visited = 0;
+        c.for_each([&](const Cache::Entry& e) { QCOMPARE(e.value, 0); visited++; });
+        QCOMPARE(visited, 5);
+        c.clear();
+        QVERIFY(c.empty());
+        QVERIFY(c.first() == nullptr);
+    }
+
+    void test_matches_ordered_map_randomized() {
+        // Differential check against std::map under a TMB-like mix of
+        // stride inserts, seeks, LRU eviction and random erases.
+        Cache c(144, 4096);
+        std::map<int64_t, int> ref;
+        std::mt19937 rng(1234);
+        int64_t pos = 0;
+        auto on_evict = [&](const Cache::Entry& e) { ref.erase(e.key); };
+        for (int i = 0; i < 20000; ++i) {
+            int r = static_cast<int>(rng() % 100);
+            if (r < 2) pos = static_cast<int64_t>(rng() % 20000) - 5000;  // seek
+            else pos += 1 + static_cast<int64_t>(rng() % 3);
+
+            if (!c.find(pos)) {
+                if (c.size() == c.capacity()) {
+                    ref.erase(c.oldest()->key);
+                    c.erase(c.oldest());
+                }
+                c.insert(pos, i, on_evict);
+                ref[pos] = i;
+            }
+            if (r >= 95 && !ref.empty()) {
+                auto it = ref.begin();
+                std::advance(it, static_cast<long>(rng() % ref.size()));
+                c.erase(c.find(it->first));
+                ref.erase(it);
+            }
+
+            QCOMPARE(c.size(), ref.size());
+            int64_t q = pos + static_cast<int64_t>(rng() % 64) - 32;
+            auto lo = ref.lower_bound(q);
+            auto* a = c.at_or_after(q);
+            QCOMPARE(a != nullptr, lo != ref.end());
+            if (a) QCOMPARE(a->key, lo->first);
+            auto* b = c.before(q);
+            QCOMPARE(b != nullptr, lo != ref.begin());
+            if (b) QCOMPARE(b->key, std::prev(lo)->first);
+        }
+    }
+
+    // ── Benchmark ──
+
+    void bench_insert_lookup_evict_data() {
+        QTest::addColumn<int>("entries");
+        QTest::newRow("144") << 144;
+        QTest::newRow("1k") << 1000;
+        QTest::newRow("10k") << 10000;
+    }
+
+    void bench_insert_lookup_evict() {
+        QFETCH(int, entries);
+        const OpCosts t = measure(entries, 1);
+        QVERIFY(t.drained);
+        qDebug("FrameIndexCache entries=%d: insert+evict %.1f ns/op, "
+               "lookup %.1f ns/op, evict %.1f ns/op",
+               entries, t.insert_ns, t.lookup_ns, t.evict_ns);
+    }
+
+    void test_per_op_cost_flat_with_size() {
+        const OpCosts small = measure(1000, 5);
+        const OpCosts large = measure(10000, 5);
+        QVERIFY(small.drained && large.drained);
+        auto ratio = [](double l, double s) { return l / std::max(s, 1.0); };
+        qDebug("FrameIndexCache 10k/1k per-op ratio: insert+evict %.2f, lookup %.2f, evict %.2f",
+               ratio(large.insert_ns, small.insert_ns), ratio(large.lookup_ns, small.lookup_ns),
+               ratio(large.evict_ns, small.evict_ns));
+
+        // 10x the entries for <= 3x the cost: O(1), not O(n).
+        QVERIFY2(ratio(large.insert_ns, small.insert_ns) <= 3.0, "insert+evict per-op cost not O(1)");
+        QVERIFY2(ratio(large.lookup_ns, small.lookup_ns) <= 3.0, "lookup per-op cost not O(1)");
+        QVERIFY2(ratio(large.evict_ns, small.evict_ns) <= 3.0, "evict per-op cost not O(1)");
+    }
+};
+
+QTEST_GUILESS_MAIN(TestFrameIndexCache)
+#include "test_frame_index_cache.moc"
@@ -0,0 +1,242 @@
+// Unit test for emp::KeyframeIndex — the per-file GOP map behind
+// keyframe-exact seeks and stride_for_clip's decode-cost prediction.
+//
+// Pure half (no media): GOP lookup and reach math, the on-disk format
+// (round-trip, rejection of stale/corrupt files), and the content-hash
+// registry with its disk fallback.
+//
+// Media half (skipped without the fixture): a packet scan of
+// test_bars_tone.mp4 produces a sane index, MediaFile::Open picks up a
+// published index, and a Park decode through the index-snapped seek still
+// lands on the requested frame.
+
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+
+#include <editor_media_platform/emp_keyframe_index.h>
+#include <editor_media_platform/emp_media_file.h>
+#include <editor_media_platform/emp_reader.h>
+#include <editor_media_platform/emp_frame.h>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using emp::KeyframeIndex;
+
+class TestKeyframeIndex : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString m_testVideoPath;
+
+    // 25fps at a 1/12800 time base (512 ticks per frame), GOPs of
+    // 12, 12, 6 frames starting at pts 0.
+    static constexpr int64_t kFrame = 512;
+
+    static std::shared_ptr<KeyframeIndex> make_index(uint64_t hash = 0x1234, int64_t size = 4096) {
+        std::vector<KeyframeIndex::Gop> gops = {
+            {0,            100,  12},
+            {12 * kFrame,  5000, 12},
+            {24 * kFrame,  9000, 6},
+        };
+        return std::make_shared<KeyframeIndex>(hash, size, 0, 1, 12800, kFrame, std::move(gops));
+    }
+
+    static bool write_bytes(const QString& path, const QByteArray& bytes) {
+        QFile f(path);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+        return f.write(bytes) == bytes.size();
+    }
+
+private slots:
+    void initTestCase() {
+        QStringList searchDirs = {
+            QDir::homePath() + "/Local/jve/tests/fixtures/media",
+            QDir::currentPath() + "/../tests/fixtures/media",
+        };
+        for (const auto& dirPath : searchDirs) {
+            QString candidate = QDir(dirPath).absoluteFilePath("test_bars_tone.mp4");
+            if (QFile::exists(candidate)) { m_testVideoPath = candidate; break; }
+        }
+    }
+
+    void cleanup() {
+        emp::ClearKeyframeIndexRegistry();
+        emp::SetKeyframeIndexDir("");
+    }
+
+    // ── Lookup ──
+
+    void test_gop_at_finds_owning_keyframe() {
+        auto idx = make_index();
+        QCOMPARE(idx->GopAt(-1), -1);
+        QCOMPARE(idx->GopAt(0), 0);
+        QCOMPARE(idx->GopAt(11 * kFrame), 0);
+        QCOMPARE(idx->GopAt(12 * kFrame), 1);
+        QCOMPARE(idx->GopAt(23 * kFrame + 7), 1);
+        QCOMPARE(idx->GopAt(1000 * kFrame), 2);
+    }
+
+    void test_frames_to_reach_counts_from_keyframe() {
+        auto idx = make_index();
+        QCOMPARE(idx->FramesToReach(0), int64_t(1));
+        QCOMPARE(idx->FramesToReach(5 * kFrame), int64_t(6));
+        QCOMPARE(idx->FramesToReach(12 * kFrame), int64_t(1));
+        // Clamped to the GOP length past the last keyframe.
+        QCOMPARE(idx->FramesToReach(1000 * kFrame), int64_t(6));
+        // Before the first keyframe: seek lands on frame 0.
+        QCOMPARE(idx->FramesToReach(-kFrame), int64_t(1));
+    }
+
+    void test_mean_reach_intra_vs_long_gop() {
+        std::vector<KeyframeIndex::Gop> intra;
+        for (int i = 0; i < 50; ++i) intra.push_back({i * kFrame, -1, 1});
+        KeyframeIndex all_intra(1, 1, 0, 1, 12800, kFrame, intra);
+        QCOMPARE(all_intra.MeanFramesToReach(), 1.0);
+
+        // 12-frame GOPs: mean of 1..12 = 6.5.
+        std::vector<KeyframeIndex::Gop> long_gop;
+        for (int i = 0; i < 10; ++i) long_gop.push_back({i * 12 * kFrame, -1, 12});
+        KeyframeIndex lg(1, 1, 0, 1, 12800, kFrame, long_gop);
+        QCOMPARE(lg.MeanFramesToReach(), 6.5);
+    }
+
+    // ── On-disk format ──
+
+    void test_save_load_round_trip() {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const std::string path = dir.filePath("a.kfidx").toStdString();
+
+        auto idx = make_index();
+        QVERIFY(idx->Save(path));
+        QVERIFY(!QFile::exists(QString::fromStdString(path + ".tmp")));
+
+        auto loaded = KeyframeIndex::Load(path, 0x1234, 4096);
+        QVERIFY(loaded);
+        QCOMPARE(loaded->stream_index(), 0);
+        QCOMPARE(loaded->time_base_den(), 12800);
+        QCOMPARE(loaded->frame_duration(), kFrame);
+        QCOMPARE(loaded->gops().size(), size_t(3));
+        QCOMPARE(loaded->gops()[1].keyframe_pts, 12 * kFrame);
+        QCOMPARE(loaded->gops()[1].keyframe_pos, int64_t(5000));
+        QCOMPARE(loaded->gops()[2].frames, uint32_t(6));
+        QCOMPARE(loaded->MeanFramesToReach(), idx->MeanFramesToReach());
+    }
+
+    void test_load_rejects_changed_source() {
+        QTemporaryDir dir;
+        const std::string path = dir.filePath("a.kfidx").toStdString();
+        QVERIFY(make_index()->Save(path));
+
+        QVERIFY(!KeyframeIndex::Load(path, 0x9999, 4096));   // bytes changed
+        QVERIFY(!KeyframeIndex::Load(path, 0x1234, 4097));   // size changed
+        QVERIFY(!KeyframeIndex::Load(path, 0, 4096));        // no fingerprint
+    }
+
+    void test_load_rejects_corrupt_files() {
+        QTemporaryDir dir;
+        const QString qpath = dir.filePath("a.kfidx");
+        const std::string path = qpath.toStdString();
+        QVERIFY(make_index()->Save(path));
+
+        QFile f(qpath);
+        QVERIFY(f.open(QIODevice::ReadOnly));
+        const QByteArray good = f.readAll();
+        f.close();
+
+        // Truncated GOP table.
+        QVERIFY(write_bytes(qpath, good.left(good.size() - 5)));
+        QVERIFY(!KeyframeIndex::Load(path, 0x1234, 4096));
+
+        // Bad magic.
+        QByteArray bad_magic = good;
+        bad_magic[0] = 'X';
+        QVERIFY(write_bytes(qpath, bad_magic));
+        QVERIFY(!KeyframeIndex::Load(path, 0x1234, 4096));
+
+        // Header only.
+        QVERIFY(write_bytes(qpath, good.left(int(emp::KEYFRAME_INDEX_HEADER_SIZE))));
+        QVERIFY(!KeyframeIndex::Load(path, 0x1234, 4096));
+
+        QVERIFY(!KeyframeIndex::Load(dir.filePath("missing.kfidx").toStdString(), 0x1234, 4096));
+    }
+
+    // ── Registry ──
+
+    void test_registry_publish_persists_and_reloads() {
+        QTemporaryDir dir;
+        emp::SetKeyframeIndexDir(dir.path().toStdString());
+
+        auto published = emp::PublishKeyframeIndex(make_index(0xabcdef, 4096));
+        const std::string path = emp::KeyframeIndexPath(0xabcdef);
+        QVERIFY(QFile::exists(QString::fromStdString(path)));
+        QCOMPARE(emp::FindKeyframeIndex(0xabcdef, 4096).get(), published.get());
+
+        // A size mismatch is a different file, even with the same hash.
+        QVERIFY(!emp::FindKeyframeIndex(0xabcdef, 1));
+
+        // New session: memory cold, disk warm.
+        emp::ClearKeyframeIndexRegistry();
+        QVERIFY(!emp::FindKeyframeIndex(0xabcdef, 4096, /*check_disk=*/false));
+        auto reloaded = emp::FindKeyframeIndex(0xabcdef, 4096);
+        QVERIFY(reloaded);
+        QCOMPARE(reloaded->gops().size(), size_t(3));
+        // The disk hit was registered.
+        QCOMPARE(emp::FindKeyframeIndex(0xabcdef, 4096, false).get(), reloaded.get());
+    }
+
+    void test_registry_first_publish_wins() {
+        auto first = emp::PublishKeyframeIndex(make_index(0x77, 4096));
+        auto second = emp::PublishKeyframeIndex(make_index(0x77, 4096));
+        QCOMPARE(second.get(), first.get());
+        QVERIFY(emp::KeyframeIndexPath(0x77).empty());  // no dir: memory only
+    }
+
+    // ── Media ──
+
+    void test_scan_fixture_and_seek_through_index() {
+        if (m_testVideoPath.isEmpty()) QSKIP("test_bars_tone.mp4 fixture not found");
+        const std::string path = m_testVideoPath.toStdString();
+
+        auto built = emp::BuildKeyframeIndex(path);
+        QVERIFY2(built.is_ok(), built.is_ok() ? "" : built.error().message.c_str());
+        auto idx = built.value();
+        QVERIFY(!idx->gops().empty());
+        QVERIFY(idx->content_hash() != 0);
+        QCOMPARE(idx->FramesToReach(idx->gops()[0].keyframe_pts), int64_t(1));
+        uint32_t total = 0;
+        for (const auto& g : idx->gops()) total += g.frames;
+        QVERIFY(total >= 70);  // 3s at 25fps, give or take edit-list trimming
+
+        emp::PublishKeyframeIndex(idx);
+        auto mf_result = emp::MediaFile::Open(path);
+        QVERIFY(mf_result.is_ok());
+        auto mf = mf_result.value();
+        QCOMPARE(mf->content_hash(), idx->content_hash());
+        QVERIFY(mf->keyframe_index());
+
+        // Park decode goes through the index-snapped seek and must still
+        // produce the requested frame, not its keyframe.
+        auto reader_result = emp::Reader::Create(mf);
+        QVERIFY(reader_result.is_ok());
+        auto reader = reader_result.value();
+        emp::SetDecodeMode(emp::DecodeMode::Park);
+        const emp::Rate rate = mf->info().video_rate();
+        const int64_t target_frame = 40;
+        auto frame = reader->DecodeAt(emp::FrameTime::from_frame(target_frame, rate));
+        emp::SetDecodeMode(emp::DecodeMode::Play);
+        QVERIFY(frame.is_ok());
+        const emp::TimeUS target_us = emp::FrameTime::from_frame(target_frame, rate).to_us();
+        const emp::TimeUS period_us = 1000000LL * rate.den / rate.num;
+        QVERIFY2(std::llabs(frame.value()->source_pts_us() - target_us) < period_us,
+                 "decoded frame is not the requested one");
+    }
+};
+
+QTEST_MAIN(TestKeyframeIndex)
+#include "test_keyframe_index.moc"
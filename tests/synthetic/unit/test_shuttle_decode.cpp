@@ -0,0 +1,200 @@
+// Unit test + benchmark for Reader shuttle decode — keyframe-only,
+// half-resolution DecodeAt, on in DecodeMode::Scrub and per reader via
+// Reader::SetShuttleDecode (TMB above SHUTTLE_FREE_RUN_SPEED).
+//
+// Test half: a shuttle decode returns the keyframe owning the target (per
+// a packet-scanned KeyframeIndex), at half the Park output size for SW
+// frames, and leaves the reader able to decode the exact frame again.
+//
+// Benchmark half: a simulated 32x shuttle — targets 32 frames apart,
+// looped for a fixed wall time — counts frames delivered per second with
+// exact (Park) decode vs shuttle decode. Prefers the 30s chirp fixture so
+// the walk crosses many GOPs; skipped without media.
+
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include <editor_media_platform/emp_keyframe_index.h>
+#include <editor_media_platform/emp_media_file.h>
+#include <editor_media_platform/emp_reader.h>
+#include <editor_media_platform/emp_frame.h>
+#include <editor_media_platform/emp_time.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+class TestShuttleDecode : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString m_videoPath;
+
+    // Restores Play on scope exit so a failing QVERIFY can't leak Scrub
+    // into later tests (the decode mode is process-global).
+    struct ModeGuard {
+        explicit ModeGuard(emp::DecodeMode m) { emp::SetDecodeMode(m); }
+        ~ModeGuard() { emp::SetDecodeMode(emp::DecodeMode::Play); }
+    };
+
+    static emp::TimeUS period_us(const emp::Rate& rate) {
+        return 1000000LL * rate.den / rate.num;
+    }
+
+    // Frames delivered per second decoding targets `step` frames apart,
+    // wrapping at the end of the file, for `budget_ms` of wall time.
+    static double frames_per_second(emp::Reader& reader, const emp::Rate& rate,
+                                    int64_t total_frames, int64_t step, int budget_ms) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto deadline = t0 + std::chrono::milliseconds(budget_ms);
+        int64_t frame = 0;
+        int delivered = 0;
+        while (std::chrono::steady_clock::now() < deadline) {
+            auto r = reader.DecodeAt(emp::FrameTime::from_frame(frame, rate));
+            if (r.is_ok()) ++delivered;
+            frame += step;
+            if (frame >= total_frames) frame %= step;
+        }
+        const double secs = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - t0).count();
+        return delivered / secs;
+    }
+
+private slots:
+    void initTestCase() {
+        QStringList searchDirs = {
+            QDir::homePath() + "/Local/jve/tests/fixtures/media",
+            QDir::currentPath() + "/../tests/fixtures/media",
+        };
+        for (const char* name : {"countdown_chirp_30s.mp4", "test_bars_tone.mp4"}) {
+            for (const auto& dirPath : searchDirs) {
+                QString candidate = QDir(dirPath).absoluteFilePath(name);
+                if (QFile::exists(candidate)) { m_videoPath = candidate; return; }
+            }
+        }
+    }
+
+    void cleanup() {
+        emp::SetDecodeMode(emp::DecodeMode::Play);
+        emp::ClearKeyframeIndexRegistry();
+    }
+
+    void test_scrub_returns_owning_keyframe() {
+        if (m_videoPath.isEmpty()) QSKIP("no fixture media");
+        const std::string path = m_videoPath.toStdString();
+        auto built = emp::BuildKeyframeIndex(path);
+        QVERIFY(built.is_ok());
+        auto index = built.value();
+
+        auto mf = emp::MediaFile::Open(path).value();
+        auto reader = emp::Reader::Create(mf).value();
+        const emp::Rate rate = mf->info().video_rate();
+        const auto target = emp::FrameTime::from_frame(40, rate);
+
+        std::shared_ptr<emp::Frame> exact, shuttle;
+        {
+            ModeGuard park(emp::DecodeMode::Park);
+            auto r = reader->DecodeAt(target);
+            QVERIFY(r.is_ok());
+            exact = r.value();
+        }
+        {
+            ModeGuard scrub(emp::DecodeMode::Scrub);
+            auto r = reader->DecodeAt(target);
+            QVERIFY(r.is_ok());
+            shuttle = r.value();
+        }
+        QVERIFY(shuttle->source_pts_us() <= exact->source_pts_us());
+
+        // The shuttle frame is the keyframe of the target's GOP.
+        const int64_t target_ticks = target.to_us() * index->time_base_den()
+            / (1000000LL * index->time_base_num());
+        const int gop = index->GopAt(target_ticks);
+        QVERIFY(gop >= 0);
+        const int64_t key_us = index->gops()[gop].keyframe_pts * 1000000LL
+            * index->time_base_num() / index->time_base_den();
+        QVERIFY2(std::llabs(shuttle->source_pts_us() - key_us) < period_us(rate) / 2,
+                 "shuttle decode did not return the owning keyframe");
+    }
+
+    void test_shuttle_output_is_half_resolution() {
+        if (m_videoPath.isEmpty()) QSKIP("no fixture media");
+        auto mf = emp::MediaFile::Open(m_videoPath.toStdString()).value();
+        auto reader = emp::Reader::Create(mf).value();
+        if (reader->IsHwAccelerated()) QSKIP("HW frames are wrapped, not scaled");
+        const emp::Rate rate = mf->info().video_rate();
+
+        auto full = reader->DecodeAt(emp::FrameTime::from_frame(10, rate));
+        QVERIFY(full.is_ok());
+        reader->SetShuttleDecode(true);
+        QVERIFY(reader->ShuttleDecode());
+        auto half = reader->DecodeAt(emp::FrameTime::from_frame(10, rate));
+        QVERIFY(half.is_ok());
+        QCOMPARE(half.value()->width(), std::max(1, full.value()->width() / 2));
+        QCOMPARE(half.value()->height(), std::max(1, full.value()->height() / 2));
+    }
+
+    void test_exact_decode_after_shuttle() {
+        // Shuttle decode drains the decoder; the next Play decode must seek
+        // and land on the exact frame at full size.
+        if (m_videoPath.isEmpty()) QSKIP("no fixture media");
+        auto mf = emp::MediaFile::Open(m_videoPath.toStdString()).value();
+        auto reader = emp::Reader::Create(mf).value();
+        const emp::Rate rate = mf->info().video_rate();
+
+        reader->SetShuttleDecode(true);
+        QVERIFY(reader->DecodeAt(emp::FrameTime::from_frame(50, rate)).is_ok());
+        reader->SetShuttleDecode(false);
+
+        const auto target = emp::FrameTime::from_frame(45, rate);
+        auto r = reader->DecodeAt(target);
+        QVERIFY(r.is_ok());
+        QVERIFY(std::llabs(r.value()->source_pts_us() - target.to_us()) < period_us(rate) / 2);
+
+        auto ref = emp::Reader::Create(mf).value()->DecodeAt(target);
+        QVERIFY(ref.is_ok());
+        QCOMPARE(r.value()->width(), ref.value()->width());
+    }
+
+    // ── Benchmark ──
+
+    void bench_shuttle_32x_frames_per_second() {
+        if (m_videoPath.isEmpty()) QSKIP("no fixture media");
+        auto mf = emp::MediaFile::Open(m_videoPath.toStdString()).value();
+        const auto& info = mf->info();
+        const emp::Rate rate = info.video_rate();
+        const int64_t total_frames = info.duration_us / period_us(rate);
+        QVERIFY(total_frames > 32);
+        const int budget_ms = 1000;
+
+        auto exact_reader = emp::Reader::Create(mf).value();
+        double exact_fps;
+        {
+            ModeGuard park(emp::DecodeMode::Park);
+            exact_fps = frames_per_second(*exact_reader, rate, total_frames, 32, budget_ms);
+        }
+
+        auto shuttle_reader = emp::Reader::Create(mf).value();
+        shuttle_reader->SetShuttleDecode(true);
+        const double shuttle_fps =
+            frames_per_second(*shuttle_reader, rate, total_frames, 32, budget_ms);
+
+        qDebug("32x shuttle over %s (%lld frames, %dx%d):",
+               qPrintable(QFileInfo(m_videoPath).fileName()),
+               static_cast<long long>(total_frames), info.video_width, info.video_height);
+        qDebug("  exact decode:    %.1f frames/s", exact_fps);
+        qDebug("  keyframe + half: %.1f frames/s (%.1fx)", shuttle_fps,
+               exact_fps > 0 ? shuttle_fps / exact_fps : 0.0);
+
+        // 32x at 25fps needs 800 source frames/s; at one decode per displayed
+        // frame the bar is the display rate. Keyframe-only must not lose to
+        // decoding through the GOP (equal on intra-only media).
+        QVERIFY2(shuttle_fps >= exact_fps * 0.9,
+                 "keyframe-only shuttle decode slower than exact decode");
+    }
+};
+
+QTEST_GUILESS_MAIN(TestShuttleDecode)
+#include "test_shuttle_decode.moc"
@@ -1285,16 +1285,21 @@ private slots:
         int sr = cfg.sample_rate;  // 48000
         int ch = cfg.channels;
 
-        // Push enough source data for the test (need ~107s at 48kHz)
-        // Push in 10s chunks to cover the range
-        for (int i = 0; i < 11; ++i) {
-            int64_t chunk_frames = sr * 10;  // 10s
-            int64_t start_us = static_cast<int64_t>(i) * 10000000LL;
-            std::vector<float> pcm(static_cast<size_t>(chunk_frames * ch), 0.5f);
-            engine->PushSourcePcm(pcm.data(), chunk_frames, start_us);
-        }
+        // Source for ~107s at 48kHz, fed in 10s chunks ahead of the playhead
+        // as the pump does (the store holds a window around the playhead,
+        // not the whole range up front)
+        int64_t chunk_frames = sr * 10;  // 10s
+        std::vector<float> pcm(static_cast<size_t>(chunk_frames * ch), 0.5f);
+        int64_t pushed_end_us = 0;
+        auto feed = [&]() {
+            while (pushed_end_us < engine->CurrentTimeUS() + 5000000LL) {
+                engine->PushSourcePcm(pcm.data(), chunk_frames, pushed_end_us);
+                pushed_end_us += 10000000LL;
+            }
+        };
 
         engine->SetTarget(0, 1.0f, sse::QualityMode::Q1);
+        feed();
 
         // Render 10000 blocks of 512 frames
         constexpr int RENDERS = 10000;
@@ -1303,6 +1308,7 @@ private slots:
 
         for (int i = 0; i < RENDERS; ++i) {
             engine->Render(output.data(), BLOCK);
+            feed();
         }
 
         // Expected: exactly (10000 * 512 * 1e6) / 48000 = 106,666,666.667μs
@@ -0,0 +1,241 @@
+// Tests for SSE's source PCM store (the time-indexed ring behind
+// PushSourcePcm / Render, sse.cpp SourceBuffer).
+//
+// The store is preallocated: once an engine exists, the pump's steady
+// cycle — push the next slice of mixed source, render a block — must not
+// touch the heap in any mode or direction. That's checked with a global
+// operator new hook that counts allocations made by this thread while a
+// flag is up.
+//
+// The rest pins the store semantics the engine relies on, using source
+// samples that carry their own frame index so 1x passthrough output shows
+// exactly which frames were read:
+// - pushes within OVERLAP_TOLERANCE_US of buffered data stitch onto it,
+//   whichever side they land on (forward and reverse pumps);
+// - a gap between pushed ranges (a clip gap the pump skipped) reads as
+//   silence, not as starvation and not as the next range spliced early;
+// - more source than the store holds keeps the window around the playhead.
+
+#include <QtTest>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <scrub_stretch_engine/sse.h>
+
+// ── Allocation-counting hook ──
+
+static thread_local bool t_count_allocs = false;
+static std::atomic<int64_t> g_allocs{0};
+
+void* operator new(std::size_t size) {
+    if (t_count_allocs) g_allocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+class TestSSESourceStore : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr int SR = 48000;
+    static constexpr int CH = 2;
+    static constexpr int BLOCK = 512;
+
+    // Frame f carries the value f (exact in a float below 2^24).
+    static std::vector<float> frame_ramp(int64_t first, int64_t frames) {
+        std::vector<float> pcm(static_cast<size_t>(frames * CH));
+        for (int64_t i = 0; i < frames; ++i) {
+            for (int c = 0; c < CH; ++c) pcm[static_cast<size_t>(i * CH + c)] = static_cast<float>(first + i);
+        }
+        return pcm;
+    }
+
+    static int64_t us_of(int64_t frame) { return frame * 1000000LL / SR; }
+
+    static std::unique_ptr<sse::ScrubStretchEngine> make_engine() {
+        return sse::ScrubStretchEngine::Create(sse::default_config());
+    }
+
+private slots:
+    // ========================================================================
+    // ALLOCATION-FREE STEADY STATE
+    // ========================================================================
+
+    void steadyStatePushAndRenderDoNotAllocate() {
+        // 40s of source to slice pushes from, allocated up front.
+        constexpr int64_t SOURCE_FRAMES = int64_t(SR) * 40;
+        std::vector<float> source(static_cast<size_t>(SOURCE_FRAMES * CH));
+        for (int64_t i = 0; i < SOURCE_FRAMES; ++i) {
+            const float s = 0.5f * std::sin(2.0f * 3.14159265f * 220.0f * static_cast<float>(i) / SR);
+            source[static_cast<size_t>(i * CH)] = s;
+            source[static_cast<size_t>(i * CH + 1)] = 0.8f * s;
+        }
+        std::vector<float> out(static_cast<size_t>(BLOCK * CH));
+
+        const struct { float speed; sse::QualityMode mode; } cases[] = {
+            {1.0f, sse::QualityMode::Q1},  {0.5f, sse::QualityMode::Q1},
+            {0.1f, sse::QualityMode::Q2},  {2.0f, sse::QualityMode::Q1},
+            {-1.0f, sse::QualityMode::Q1}, {-0.5f, sse::QualityMode::Q1},
+            {8.0f, sse::QualityMode::Q3_DECIMATE},
+        };
+        for (const auto& tc : cases) {
+            auto engine = make_engine();
+            const bool reverse = tc.speed < 0;
+            // Room for 300 blocks at 8x going forward, or 1x going back.
+            const int64_t start_frame = int64_t(SR) * (reverse ? 20 : 2);
+            engine->SetTarget(us_of(start_frame), tc.speed, tc.mode);
+
+            // Prefill 1s in the playing direction, then pump-sized slices
+            // (100ms) kept ~1s ahead of the playhead.
+            constexpr int64_t SLICE = SR / 10;
+            int64_t pushed_lo = start_frame, pushed_hi = start_frame;
+            auto pump = [&]() {
+                const int64_t play = engine->CurrentTimeUS() * SR / 1000000;
+                while (!reverse && pushed_hi < play + SR) {
+                    engine->PushSourcePcm(source.data() + pushed_hi * CH, SLICE, us_of(pushed_hi));
+                    pushed_hi += SLICE;
+                }
+                while (reverse && pushed_lo > play - SR) {
+                    pushed_lo -= SLICE;
+                    engine->PushSourcePcm(source.data() + pushed_lo * CH, SLICE, us_of(pushed_lo));
+                }
+            };
+            pump();
+            for (int i = 0; i < 8; ++i) {
+                engine->Render(out.data(), BLOCK);
+                pump();
+            }
+
+            g_allocs.store(0);
+            t_count_allocs = true;
+            for (int i = 0; i < 300; ++i) {
+                engine->Render(out.data(), BLOCK);
+                pump();
+            }
+            t_count_allocs = false;
+
+            QVERIFY2(!engine->Starved(),
+                     qPrintable(QString("speed %1 starved in steady state").arg(tc.speed)));
+            QVERIFY2(g_allocs.load() == 0,
+                     qPrintable(QString("speed %1: %2 heap allocations in 300 push+render cycles")
+                                    .arg(tc.speed).arg(g_allocs.load())));
+        }
+    }
+
+    // ========================================================================
+    // STITCHING (OVERLAP_TOLERANCE_US)
+    // ========================================================================
+
+    void forwardPushStitchesAcrossSubMsGap() {
+        auto engine = make_engine();
+        const auto a = frame_ramp(0, SR);
+        const auto b = frame_ramp(SR, SR);
+        engine->PushSourcePcm(a.data(), SR, 0);
+        engine->PushSourcePcm(b.data(), SR, 1000000 + 600);  // 0.6ms late
+
+        engine->SetTarget(us_of(SR - 100), 1.0f, sse::QualityMode::Q1);
+        std::vector<float> out(static_cast<size_t>(BLOCK * CH));
+        QCOMPARE(engine->Render(out.data(), BLOCK), int64_t(BLOCK));
+        QVERIFY(!engine->Starved());
+        for (int i = 0; i < BLOCK; ++i) QCOMPARE(out[static_cast<size_t>(i * CH)], float(SR - 100 + i));
+    }
+
+    void reversePushStitchesOntoLaterData() {
+        // Reverse pump order: the later range first, then one ending 20
+        // frames (~0.4ms) short of it — snapped up against it.
+        auto engine = make_engine();
+        const auto hi = frame_ramp(SR, SR);
+        const auto lo = frame_ramp(0, SR - 20);
+        engine->PushSourcePcm(hi.data(), SR, 1000000);
+        engine->PushSourcePcm(lo.data(), SR - 20, 0);
+
+        engine->SetTarget(us_of(SR - 10), 1.0f, sse::QualityMode::Q1);
+        std::vector<float> out(static_cast<size_t>(32 * CH));
+        QCOMPARE(engine->Render(out.data(), 32), int64_t(32));
+        QVERIFY(!engine->Starved());
+        // Frames 47990..47999 hold lo's last ten (47970..47979), then hi.
+        for (int i = 0; i < 10; ++i) QCOMPARE(out[static_cast<size_t>(i * CH)], float(SR - 30 + i));
+        for (int i = 10; i < 32; ++i) QCOMPARE(out[static_cast<size_t>(i * CH)], float(SR + i - 10));
+    }
+
+    void overlappingPushOverwritesOnlyItsRange() {
+        auto engine = make_engine();
+        const auto base = frame_ramp(0, SR);
+        engine->PushSourcePcm(base.data(), SR, 0);
+        const std::vector<float> patch(static_cast<size_t>(4800 * CH), -1.0f);
+        engine->PushSourcePcm(patch.data(), 4800, 500000);  // [24000, 28800)
+
+        engine->SetTarget(us_of(24000 - 16), 1.0f, sse::QualityMode::Q1);
+        std::vector<float> out(static_cast<size_t>(32 * CH));
+        engine->Render(out.data(), 32);
+        QCOMPARE(out[0], float(24000 - 16));
+        QCOMPARE(out[16 * CH], -1.0f);
+
+        // Data past the patch is still the original.
+        engine->SetTarget(us_of(28800), 1.0f, sse::QualityMode::Q1);
+        engine->Render(out.data(), 32);
+        QCOMPARE(out[0], 28800.0f);
+        QVERIFY(!engine->Starved());
+    }
+
+    // ========================================================================
+    // GAPS AND CAPACITY
+    // ========================================================================
+
+    void gapBetweenPushesReadsAsSilence() {
+        auto engine = make_engine();
+        const auto a = frame_ramp(0, SR);
+        const auto b = frame_ramp(SR * 3 / 2, SR);
+        engine->PushSourcePcm(a.data(), SR, 0);
+        engine->PushSourcePcm(b.data(), SR, 1500000);  // 0.5s gap
+
+        engine->SetTarget(us_of(SR - 100), 1.0f, sse::QualityMode::Q1);
+        std::vector<float> out(static_cast<size_t>(BLOCK * CH));
+        QCOMPARE(engine->Render(out.data(), BLOCK), int64_t(BLOCK));
+        QVERIFY(!engine->Starved());
+        QCOMPARE(out[99 * CH], float(SR - 1));
+        for (int i = 100; i < BLOCK; ++i) QCOMPARE(out[static_cast<size_t>(i * CH)], 0.0f);
+
+        // Starting inside the gap is still starvation.
+        engine->SetTarget(1200000, 1.0f, sse::QualityMode::Q1);
+        engine->Render(out.data(), BLOCK);
+        QVERIFY(engine->Starved());
+    }
+
+    void overflowKeepsWindowAroundPlayhead() {
+        // 40s forward from a playhead at 1s: the far end is what's dropped.
+        auto engine = make_engine();
+        const std::vector<float> ten_s(static_cast<size_t>(int64_t(SR) * 10 * CH), 0.5f);
+        engine->SetTarget(1000000, 1.0f, sse::QualityMode::Q1);
+        for (int i = 0; i < 4; ++i) engine->PushSourcePcm(ten_s.data(), int64_t(SR) * 10, i * 10000000LL);
+        std::vector<float> out(static_cast<size_t>(BLOCK * CH));
+        engine->Render(out.data(), BLOCK);
+        QVERIFY(!engine->Starved());
+        engine->SetTarget(35000000, 1.0f, sse::QualityMode::Q1);
+        engine->Render(out.data(), BLOCK);
+        QVERIFY(engine->Starved());
+
+        // Reverse from 39s, pushed in reverse order: the low end is dropped.
+        auto rev = make_engine();
+        rev->SetTarget(39000000, -1.0f, sse::QualityMode::Q1);
+        for (int i = 3; i >= 0; --i) rev->PushSourcePcm(ten_s.data(), int64_t(SR) * 10, i * 10000000LL);
+        rev->Render(out.data(), BLOCK);
+        QVERIFY(!rev->Starved());
+        rev->SetTarget(5000000, -1.0f, sse::QualityMode::Q1);
+        rev->Render(out.data(), BLOCK);
+        QVERIFY(rev->Starved());
+    }
+};
+
+QTEST_MAIN(TestSSESourceStore)
+#include "test_sse_source_store.moc"
@@ -0,0 +1,171 @@
+// Tests for the WSOLA similarity-search kernels (scrub_stretch_engine/xcorr.h).
+//
+// Both kernels must compute the same thing — the dot product of the
+// reference against every candidate offset — so each is checked against a
+// naive double-precision loop, mono through odd channel counts (the FFT
+// kernel packs channels in pairs and has a lone-channel tail). Engines built
+// on either kernel must then render the same audio.
+//
+// The benchmark renders 512-frame blocks through a full engine at 0.1x (Q2
+// slomo), 0.5x and 2x (Q1), where every output hop costs a fresh grain
+// search, and prints µs per block for each kernel. It asserts nothing about
+// timing — the printed numbers are for comparing machines and changes, and
+// for checking the crossover in xcorr.cpp on a new arch.
+
+#include <QtTest>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <scrub_stretch_engine/sse.h>
+#include <scrub_stretch_engine/xcorr.h>
+
+class TestSSEXcorr : public QObject
+{
+    Q_OBJECT
+
+private:
+    static constexpr int BLOCK = 512;
+
+    // Broadband-ish program material: a few inharmonic partials plus noise,
+    // so the similarity search has a clear best match (a pure sine has one
+    // every period).
+    static std::vector<float> generate_program(int64_t frames, int channels, int sample_rate) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+        std::vector<float> pcm(static_cast<size_t>(frames * channels));
+        for (int64_t i = 0; i < frames; ++i) {
+            const double t = static_cast<double>(i) / sample_rate;
+            const float s = static_cast<float>(0.3 * std::sin(2.0 * M_PI * 220.0 * t)
+                                             + 0.2 * std::sin(2.0 * M_PI * 331.7 * t)
+                                             + 0.1 * std::sin(2.0 * M_PI * 1234.5 * t));
+            for (int c = 0; c < channels; ++c) {
+                pcm[static_cast<size_t>(i * channels + c)] = s * (c ? 0.8f : 1.0f) + noise(rng);
+            }
+        }
+        return pcm;
+    }
+
+    static void check_against_naive(sse::XcorrKernel kind, int ref_frames, int offsets, int channels) {
+        std::mt19937 rng(static_cast<unsigned>(ref_frames * 31 + channels));
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f);
+        std::vector<float> ref(static_cast<size_t>(ref_frames * channels));
+        std::vector<float> x(static_cast<size_t>((ref_frames + offsets - 1) * channels));
+        for (float& v : ref) v = u(rng);
+        for (float& v : x) v = u(rng);
+
+        auto xc = sse::MakeCrossCorrelator(kind, ref_frames, offsets, channels);
+        QCOMPARE(xc->kind(), kind);
+        std::vector<float> dot(static_cast<size_t>(offsets));
+        xc->correlate(ref.data(), x.data(), dot.data());
+
+        for (int off = 0; off < offsets; ++off) {
+            double expect = 0.0;
+            for (int j = 0; j < ref_frames * channels; ++j) {
+                expect += static_cast<double>(ref[j]) * x[off * channels + j];
+            }
+            // Random ±1 data: |dot| ~ sqrt(n); float error grows slower.
+            const double tol = 1e-4 * ref_frames * channels;
+            QVERIFY2(std::abs(dot[off] - expect) < tol,
+                     qPrintable(QString("kernel %1 %2x%3x%4 offset %5: got %6 want %7")
+                                    .arg(static_cast<int>(kind)).arg(ref_frames).arg(offsets)
+                                    .arg(channels).arg(off).arg(dot[off]).arg(expect)));
+        }
+    }
+
+    static std::unique_ptr<sse::ScrubStretchEngine> make_engine(sse::XcorrKernel kind,
+                                                                const std::vector<float>& pcm,
+                                                                int64_t frames) {
+        sse::SseConfig cfg = sse::default_config();
+        cfg.xcorr_kernel = kind;
+        auto engine = sse::ScrubStretchEngine::Create(cfg);
+        engine->PushSourcePcm(pcm.data(), frames, 0);
+        return engine;
+    }
+
+    // µs per rendered block, after a warm-up that primes the grain reference.
+    static double time_blocks(sse::ScrubStretchEngine& engine, float speed, sse::QualityMode mode,
+                              int blocks, int64_t start_us) {
+        std::vector<float> out(static_cast<size_t>(BLOCK * 2));
+        engine.SetTarget(start_us, speed, mode);
+        for (int i = 0; i < 8; ++i) engine.Render(out.data(), BLOCK);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < blocks; ++i) engine.Render(out.data(), BLOCK);
+        const auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::micro>(t1 - t0).count() / blocks;
+    }
+
+private slots:
+    void directMatchesNaive() {
+        check_against_naive(sse::XcorrKernel::Direct, 960, 961, 2);
+        check_against_naive(sse::XcorrKernel::Direct, 37, 19, 1);   // SIMD tail
+        check_against_naive(sse::XcorrKernel::Direct, 64, 33, 3);
+    }
+
+    void fftMatchesNaive() {
+        check_against_naive(sse::XcorrKernel::Fft, 960, 961, 2);
+        check_against_naive(sse::XcorrKernel::Fft, 37, 19, 1);
+        check_against_naive(sse::XcorrKernel::Fft, 64, 33, 3);      // lone channel
+        check_against_naive(sse::XcorrKernel::Fft, 882, 441, 6);    // 44.1k 5.1
+    }
+
+    void autoPicksByWindowSize() {
+        // 48 kHz stereo default window: hop 960 over 961 offsets.
+        QCOMPARE(sse::ChooseXcorrKernel(960, 961, 2), sse::XcorrKernel::Fft);
+        QCOMPARE(sse::ChooseXcorrKernel(1920, 1921, 2), sse::XcorrKernel::Fft);
+        QCOMPARE(sse::ChooseXcorrKernel(64, 33, 2), sse::XcorrKernel::Direct);
+        auto xc = sse::MakeCrossCorrelator(sse::XcorrKernel::Auto, 64, 33, 2);
+        QCOMPARE(xc->kind(), sse::XcorrKernel::Direct);
+    }
+
+    void kernelsRenderSameAudio() {
+        constexpr int64_t FRAMES = 48000 * 4;
+        const auto pcm = generate_program(FRAMES, 2, 48000);
+        auto direct = make_engine(sse::XcorrKernel::Direct, pcm, FRAMES);
+        auto fft = make_engine(sse::XcorrKernel::Fft, pcm, FRAMES);
+
+        const struct { float speed; sse::QualityMode mode; } cases[] = {
+            {0.1f, sse::QualityMode::Q2}, {0.5f, sse::QualityMode::Q1},
+            {2.0f, sse::QualityMode::Q1}, {-0.5f, sse::QualityMode::Q1},
+        };
+        std::vector<float> a(BLOCK * 2), b(BLOCK * 2);
+        for (const auto& tc : cases) {
+            direct->SetTarget(1500000, tc.speed, tc.mode);
+            fft->SetTarget(1500000, tc.speed, tc.mode);
+            float max_diff = 0.0f;
+            for (int blk = 0; blk < 40; ++blk) {
+                QCOMPARE(direct->Render(a.data(), BLOCK), fft->Render(b.data(), BLOCK));
+                for (size_t i = 0; i < a.size(); ++i) max_diff = std::max(max_diff, std::abs(a[i] - b[i]));
+            }
+            // Same offset chosen every grain → identical math downstream.
+            QVERIFY2(max_diff < 1e-5f,
+                     qPrintable(QString("speed %1: max sample diff %2").arg(tc.speed).arg(max_diff)));
+        }
+    }
+
+    void benchmarkRenderPerBlock() {
+        constexpr int64_t FRAMES = 48000 * 12;
+        const auto pcm = generate_program(FRAMES, 2, 48000);
+        // 2x consumes ~1024 source frames per block; 400 blocks stay in 12s.
+        constexpr int BLOCKS = 400;
+
+        const struct { float speed; sse::QualityMode mode; const char* label; } cases[] = {
+            {0.1f, sse::QualityMode::Q2, "0.1x Q2"},
+            {0.5f, sse::QualityMode::Q1, "0.5x Q1"},
+            {2.0f, sse::QualityMode::Q1, "2x   Q1"},
+        };
+        for (const auto& tc : cases) {
+            auto direct = make_engine(sse::XcorrKernel::Direct, pcm, FRAMES);
+            auto fft = make_engine(sse::XcorrKernel::Fft, pcm, FRAMES);
+            const double d = time_blocks(*direct, tc.speed, tc.mode, BLOCKS, 1000000);
+            const double f = time_blocks(*fft, tc.speed, tc.mode, BLOCKS, 1000000);
+            qDebug().noquote() << QString("sse render %1: direct %2 us/block, fft %3 us/block (%4x)")
+                                      .arg(tc.label).arg(d, 0, 'f', 1).arg(f, 0, 'f', 1)
+                                      .arg(d / f, 0, 'f', 2);
+        }
+    }
+};
+
+QTEST_MAIN(TestSSEXcorr)
+#include "test_sse_xcorr.moc"
@@ -4,6 +4,10 @@
 #include <QtTest>
 #include <QDir>
 #include <QFile>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <thread>
 
 #include <editor_media_platform/emp_timeline_media_buffer.h>
 #include <editor_media_platform/emp_time.h>
@@ -34,6 +38,15 @@ static bool poll_until_cached(TimelineMediaBuffer* tmb, const TrackId& track,
     return tmb->GetVideoFrame(track, frame, /*cache_only=*/true).frame != nullptr;
 }
 
+// Deadline clock for EDF prefetch tests: every read moves time forward
+// 100ms. SetPlayhead's anchor is the first read; every later "now" is at
+// least 100ms past it (the extrapolation cap), so every frame due sooner
+// than that reads as late — independent of how fast workers run.
+static std::atomic<int64_t> s_stepping_clock_ns{1000000000};
+static int64_t stepping_deadline_clock() {
+    return s_stepping_clock_ns.fetch_add(100000000);
+}
+
 class TestTimelineMediaBuffer : public QObject {
     Q_OBJECT
 
@@ -484,6 +497,57 @@ private slots:
         }
     }
 
+    void test_clips_of_one_file_share_media_file() {
+        // Ten clips cut from one file (plus one on another track) get ten
+        // Readers — each with its own demux position — but one MediaFile:
+        // one Open, one descriptor, one block cache. Decoded output must
+        // match a Reader on a freshly opened file.
+        if (!m_hasTestVideo) QSKIP("No test video");
+        const std::string path = m_testVideoPath.toStdString();
+
+        auto tmb = TimelineMediaBuffer::Create(0);
+        std::vector<ClipInfo> clips;
+        for (int i = 0; i < 10; ++i) {
+            clips.push_back({"cut" + std::to_string(i), path,
+                             i * 6, 6, (9 - i) * 6, 24, 1, 1.0f});
+        }
+        tmb->SetTrackClips(V1, clips);
+        tmb->SetTrackClips(V2, {{"v2cut", path, 0, 60, 3, 24, 1, 1.0f}});
+
+        auto ref_mf = MediaFile::Open(path);
+        QVERIFY(ref_mf.is_ok());
+        auto ref_reader = Reader::Create(ref_mf.value());
+        QVERIFY(ref_reader.is_ok());
+
+        auto check = [&](const TrackId& track, int64_t frame, const std::string& clip_id) {
+            auto r = tmb->GetVideoFrame(track, frame);
+            QVERIFY2(r.frame != nullptr, clip_id.c_str());
+            QCOMPARE(r.clip_id, clip_id);
+            auto ref = ref_reader.value()->DecodeAtUS(r.frame->source_pts_us());
+            QVERIFY(ref.is_ok());
+            const auto& a = *r.frame;
+            const auto& b = *ref.value();
+            QCOMPARE(a.source_pts_us(), b.source_pts_us());
+            QCOMPARE(a.width(), b.width());
+            QCOMPARE(a.height(), b.height());
+            if (!a.data() || !b.data()) return;  // HW surfaces: no CPU bytes
+            for (int y = 0; y < a.height(); ++y) {
+                QVERIFY2(std::memcmp(a.data() + y * a.stride_bytes(),
+                                     b.data() + y * b.stride_bytes(),
+                                     static_cast<size_t>(a.width()) * 4) == 0,
+                         qPrintable(QString("%1 row %2 differs")
+                                    .arg(QString::fromStdString(clip_id)).arg(y)));
+            }
+        };
+
+        for (int i = 0; i < 10; ++i) {
+            check(V1, i * 6 + 2, "cut" + std::to_string(i));
+        }
+        check(V2, 20, "v2cut");
+
+        QCOMPARE(tmb->GetMediaFileOpenCount(), int64_t(1));
+    }
+
     // ── Multi-track ──
 
     void test_multi_track_independent() {
@@ -1773,6 +1837,43 @@ private slots:
         QCOMPARE(r2.clip_id, std::string("clipA"));
     }
 
+    void test_reverse_play_caches_whole_gop() {
+        // Reverse playback decodes each GOP forward once (Reader::DecodeGopUS)
+        // and caches every frame of it, instead of one decode-from-keyframe
+        // per reverse step with stride fill. Every cached frame must be the
+        // distinct source frame for its position — a stride-filled run
+        // would repeat one frame.
+        if (!m_hasTestVideo) QSKIP("No test video");
+
+        auto tmb = TimelineMediaBuffer::Create();
+        auto path = m_testVideoPath.toStdString();
+        auto probe = TimelineMediaBuffer::ProbeFile(path);
+        QVERIFY(probe.is_ok());
+        const auto& info = probe.value();
+
+        std::vector<ClipInfo> clips = {
+            {"clipA", path, 0, 72, 0, info.video_fps_num, info.video_fps_den, 1.0f},
+        };
+        tmb->SetTrackClips(V1, clips);
+
+        tmb->SetPlayhead(60, -1, 1.0f);
+        QVERIFY2(poll_until_cached(tmb.get(), V1, 30, 3000),
+                 "reverse prefetch should reach frame 30");
+        // Preceding GOP (or the capped remainder of this one) is chained.
+        QVERIFY2(poll_until_cached(tmb.get(), V1, 5, 3000),
+                 "pipelined reverse GOP decode should reach frame 5");
+        tmb->SetPlayhead(60, 0, 1.0f);
+
+        TimeUS prev_pts = std::numeric_limits<TimeUS>::max();
+        for (int64_t tf = 59; tf >= 5; --tf) {
+            auto r = tmb->GetVideoFrame(V1, tf, /*cache_only=*/true);
+            QVERIFY2(r.frame != nullptr, qPrintable(QString("frame %1 not cached").arg(tf)));
+            QVERIFY2(r.frame->source_pts_us() < prev_pts,
+                     qPrintable(QString("frame %1 repeats a later frame").arg(tf)));
+            prev_pts = r.frame->source_pts_us();
+        }
+    }
+
     // ── Worker shutdown mid-batch ──
 
     void test_worker_shutdown_mid_batch_no_hang() {
@@ -4333,6 +4434,246 @@ private slots:
                  "Frame 200 (oldest insert_seq, evicted) should be gone");
     }
 
+    // ── Video cache byte budget (TMB-wide) ──
+
+    void test_cache_budget_bounds_bytes() {
+        // The TMB-wide budget caps total frame bytes well below the 144-entry
+        // per-track ceiling. Per-track stats report bytes, hits, misses and
+        // evictions consistently.
+        if (!m_hasTestVideo) QSKIP("No test video");
+
+        auto tmb = TimelineMediaBuffer::Create(0);
+        tmb->SetTrackClips(V1, {{"clip1", m_testVideoPath.toStdString(), 0, 72, 0, 24, 1, 1.0f}});
+        tmb->SetPlayhead(0, 1, 1.0f);
+
+        auto first = tmb->GetVideoFrame(V1, 0);
+        QVERIFY(first.frame != nullptr);
+        const int64_t frame_bytes = static_cast<int64_t>(first.frame->data_size());
+        tmb->SetCacheBudget(frame_bytes * 10);
+        QCOMPARE(tmb->GetCacheBudget(), frame_bytes * 10);
+
+        for (int64_t f = 1; f < 30; ++f) {
+            tmb->SetPlayhead(f, 1, 1.0f);
+            QVERIFY2(tmb->GetVideoFrame(V1, f).frame != nullptr,
+                qPrintable(QString("Failed to decode frame %1").arg(f)));
+        }
+
+        auto stats = tmb->GetVideoCacheStats();
+        QCOMPARE(stats.budget_bytes, frame_bytes * 10);
+        QVERIFY2(stats.used_bytes <= stats.budget_bytes,
+            qPrintable(QString("used %1 > budget %2").arg(stats.used_bytes).arg(stats.budget_bytes)));
+        QCOMPARE(static_cast<int>(stats.tracks.size()), 1);
+        const auto& t = stats.tracks[0];
+        QCOMPARE(t.track.index, 1);
+        QCOMPARE(t.entries, int64_t(10));
+        QCOMPARE(t.bytes, frame_bytes * 10);
+        QCOMPARE(t.evictions, int64_t(20));
+        QCOMPARE(t.misses, int64_t(30));
+        QCOMPARE(t.hits, int64_t(0));
+
+        // Most recent frame (at the playhead) is a hit; frame 0 was evicted
+        // long ago and is past MAX_NEAREST_DISTANCE of any survivor.
+        QVERIFY(tmb->GetVideoFrame(V1, 29, /*cache_only=*/true).frame != nullptr);
+        QVERIFY(tmb->GetVideoFrame(V1, 0, /*cache_only=*/true).frame == nullptr);
+        stats = tmb->GetVideoCacheStats();
+        QCOMPARE(stats.tracks[0].hits, int64_t(1));
+        QCOMPARE(stats.tracks[0].misses, int64_t(31));
+    }
+
+    void test_cache_budget_ineligible_track_evicted_first() {
+        // Two tracks share the budget. V2 is not in the effective set, so its
+        // share is 0 and every budget eviction comes from V2 until it's empty.
+        if (!m_hasTestVideo) QSKIP("No test video");
+
+        auto tmb = TimelineMediaBuffer::Create(0);
+        tmb->SetTrackClips(V1, {{"c1", m_testVideoPath.toStdString(), 0, 72, 0, 24, 1, 1.0f}});
+        tmb->SetTrackClips(V2, {{"c2", m_testVideoPath.toStdString(), 0, 72, 0, 24, 1, 1.0f}});
+        tmb->SetEffectiveVideoTracks({1});
+        tmb->SetPlayhead(0, 1, 1.0f);
+
+        auto probe = tmb->GetVideoFrame(V2, 0);
+        QVERIFY(probe.frame != nullptr);
+        const int64_t frame_bytes = static_cast<int64_t>(probe.frame->data_size());
+        tmb->SetCacheBudget(frame_bytes * 10);
+
+        for (int64_t f = 1; f < 8; ++f) {
+            QVERIFY(tmb->GetVideoFrame(V2, f).frame != nullptr);
+        }
+        for (int64_t f = 0; f < 8; ++f) {
+            QVERIFY(tmb->GetVideoFrame(V1, f).frame != nullptr);
+        }
+
+        auto stats = tmb->GetVideoCacheStats();
+        QCOMPARE(static_cast<int>(stats.tracks.size()), 2);
+        const auto& v1 = stats.tracks[0];
+        const auto& v2 = stats.tracks[1];
+        QCOMPARE(v1.track.index, 1);
+        QCOMPARE(v2.track.index, 2);
+        QCOMPARE(v1.share_bytes, frame_bytes * 10);
+        QCOMPARE(v2.share_bytes, int64_t(0));
+        QCOMPARE(v1.entries, int64_t(8));
+        QCOMPARE(v1.evictions, int64_t(0));
+        QCOMPARE(v2.entries, int64_t(2));
+        QCOMPARE(v2.evictions, int64_t(6));
+        QVERIFY(stats.used_bytes <= stats.budget_bytes);
+    }
+
+    void test_cache_budget_evicts_played_frames_first() {
+        // Within a track, budget eviction takes the entry furthest from the
+        // playhead, ranking already-played frames (behind, in the direction
+        // of travel) ahead of every frame in the prefetch window.
+        if (!m_hasTestVideo) QSKIP("No test video");
+
+        auto tmb = TimelineMediaBuffer::Create(0);
+        tmb->SetTrackClips(V1, {{"clip1", m_testVideoPath.toStdString(), 0, 72, 0, 24, 1, 1.0f}});
+        tmb->SetPlayhead(40, 1, 1.0f);
+
+        auto behind = tmb->GetVideoFrame(V1, 40);
+        QVERIFY(behind.frame != nullptr);
+        const int64_t frame_bytes = static_cast<int64_t>(behind.frame->data_size());
+        tmb->SetCacheBudget(frame_bytes * 5);
+
+        tmb->SetPlayhead(50, 1, 1.0f);
+        for (int64_t f = 50; f < 55; ++f) {
+            QVERIFY(tmb->GetVideoFrame(V1, f).frame != nullptr);
+        }
+
+        // Frame 40 was behind the playhead → evicted; a cache_only lookup
+        // there can only return a different (nearest) source frame.
+        auto r40 = tmb->GetVideoFrame(V1, 40, /*cache_only=*/true);
+        QVERIFY2(r40.frame == nullptr || r40.source_frame != 40,
+                 "Played frame 40 should have been evicted first");
+        for (int64_t f = 50; f < 55; ++f) {
+            auto r = tmb->GetVideoFrame(V1, f, /*cache_only=*/true);
+            QVERIFY2(r.frame != nullptr && r.source_frame == f,
+                qPrintable(QString("Frame %1 ahead of playhead should survive").arg(f)));
+        }
+    }
+
+    // ── Deadline-driven (EDF) video prefetch ──
+
+    void test_prefetch_without_sequence_rate_never_drops() {
+        // No sequence rate → no deadlines: prefetch behaves as before and
+        // the drop counter stays at zero.
+        if (!m_hasTestVideo) QSKIP("No test video");
+        auto tmb = TimelineMediaBuffer::Create(3);
+        tmb->SetTrackClips(V1, {{"c1", m_testVideoPath.toStdString(), 0, 50, 0, 24, 1, 1.0f}});
+        tmb->ResetVideoPrefetchDropCount();
+        tmb->SetPlayhead(0, 1, 1.0f);
+        poll_until_cached(tmb.get(), V1, 10, 1000);
+        tmb->ParkReaders();
+        QCOMPARE(tmb->GetVideoPrefetchDropCount(), int64_t(0));
+    }
+
+    void test_prefetch_drops_frames_past_deadline() {
+        // 64× with the playhead anchored at frame 0: the 96-frame window is
+        // due within ~62ms, and the stepping clock puts "now" 100ms past
+        // the anchor from the first check on. Every frame ahead of the
+        // playhead is late and dropped; the playhead frame itself — due at
+        // the anchor, so late too — still decodes.
+        if (!m_hasTestVideo) QSKIP("No test video");
+        auto tmb = TimelineMediaBuffer::Create(3);
+        tmb->SetDeadlineClock(stepping_deadline_clock);
+        tmb->SetSequenceRate(24, 1);
+        tmb->SetTrackClips(V1, {{"c1", m_testVideoPath.toStdString(), 0, 200, 0, 24, 1, 1.0f}});
+        tmb->ResetVideoPrefetchDropCount();
+        tmb->SetPlayhead(0, 1, 64.0f);
+        QVERIFY2(poll_until_cached(tmb.get(), V1, 0, 3000),
+                 "playhead frame was dropped as late");
+        // Drops advance the buffer end too: wait for the window (96 frames)
+        // to be processed end to end.
+        for (int waited = 0; tmb->GetVideoBufferEnd(V1) < 96 && waited < 3000; waited += 25) {
+            QThread::msleep(25);
+        }
+        tmb->ParkReaders();
+        QVERIFY(tmb->GetVideoBufferEnd(V1) >= 96);
+        QVERIFY2(tmb->GetVideoPrefetchDropCount() > 0,
+                 "late frames were decoded instead of dropped");
+        QVERIFY(!tmb->GetVideoFrame(V1, 95, /*cache_only=*/true).frame);
+
+        tmb->ResetVideoPrefetchDropCount();
+        QCOMPARE(tmb->GetVideoPrefetchDropCount(), int64_t(0));
+    }
+
+    // ── Per-track locking / RCU clip layouts ──
+
+    void test_lock_contention_counter_idle_single_thread() {
+        // One thread never finds a lock held: the counter stays at zero
+        // through a full SetTrackClips / GetVideoFrame / stats round.
+        auto tmb = TimelineMediaBuffer::Create(0);
+        tmb->ResetLockContentionCount();
+        tmb->SetTrackClips(V1, {{"c1", "/nonexistent/a.mov", 0, 100, 0, 24, 1, 1.0f}});
+        tmb->SetTrackClips(V2, {{"c2", "/nonexistent/b.mov", 0, 100, 0, 24, 1, 1.0f}});
+        for (int64_t f = 0; f < 20; ++f) {
+            tmb->GetVideoFrame(V1, f, /*cache_only=*/true);
+            tmb->GetVideoFrame(V2, f, /*cache_only=*/true);
+        }
+        tmb->GetVideoCacheStats();
+        tmb->ReleaseTrack(V2);
+        QCOMPARE(tmb->GetLockContentionCount(), int64_t(0));
+    }
+
+    void test_clip_layout_swap_during_reads_is_consistent() {
+        // Lua re-posts clip lists while the tick thread reads. Readers work
+        // on an immutable layout snapshot, so every result must describe
+        // exactly one of the two layouts — never a torn mix (clip_id from
+        // one, bounds from the other) and never a dangling clip pointer.
+        auto tmb = TimelineMediaBuffer::Create(0);
+        const std::vector<ClipInfo> layout_a = {
+            {"clipA", "/nonexistent/a.mov", 0, 50, 0, 24, 1, 1.0f},
+            {"clipA2", "/nonexistent/a2.mov", 50, 50, 0, 24, 1, 1.0f},
+        };
+        const std::vector<ClipInfo> layout_b = {
+            {"clipB", "/nonexistent/b.mov", 0, 80, 0, 24, 1, 1.0f},
+        };
+        tmb->SetTrackClips(V1, layout_a);
+
+        std::atomic<bool> stop{false};
+        std::thread writer([&] {
+            for (int i = 0; i < 2000; ++i) {
+                tmb->SetTrackClips(V1, (i & 1) ? layout_a : layout_b);
+            }
+            stop = true;
+        });
+
+        int bad = 0;
+        int64_t reads = 0;
+        while (!stop) {
+            auto r = tmb->GetVideoFrame(V1, 10, /*cache_only=*/true);
+            bool ok = (r.clip_id == "clipA" && r.clip_end_frame == 50)
+                   || (r.clip_id == "clipB" && r.clip_end_frame == 80);
+            if (!ok) bad++;
+            auto ids = tmb->GetVideoTrackIds();
+            if (ids.size() != 1) bad++;
+            reads++;
+        }
+        writer.join();
+        QVERIFY(reads > 0);
+        QCOMPARE(bad, 0);
+    }
+
+    void test_release_track_while_reading_is_safe() {
+        // ReleaseTrack detaches the TrackState; a reader that loaded it
+        // before the release finishes against the detached state and the
+        // next lookup sees no track.
+        auto tmb = TimelineMediaBuffer::Create(0);
+        std::atomic<bool> stop{false};
+        std::thread churn([&] {
+            for (int i = 0; i < 1000; ++i) {
+                tmb->SetTrackClips(V2, {{"c2", "/nonexistent/b.mov", 0, 100, 0, 24, 1, 1.0f}});
+                tmb->ReleaseTrack(V2);
+            }
+            stop = true;
+        });
+        while (!stop) {
+            auto r = tmb->GetVideoFrame(V2, 5, /*cache_only=*/true);
+            QVERIFY(r.clip_id.empty() || r.clip_id == "c2");
+        }
+        churn.join();
+        auto r = tmb->GetVideoFrame(V2, 5, /*cache_only=*/true);
+        QVERIFY(r.clip_id.empty());
+    }
+
     void test_claim_prevents_duplicate_track_fill() {
         // Verify that claim_track_for_prefetch prevents multiple workers
         // from filling the same track concurrently. With N prefetch_workers
@@ -5196,6 +5537,104 @@ private slots:
                 .arg(cached_count)));
     }
 
+    // ── Forward range decode (Reader::DecodeRange) ──
+
+    void test_forward_range_prefetch_matches_single_decode() {
+        // Forward prefetch fills runs of slots from one DecodeRange once the
+        // decode speed is known. Every cached slot must hold the frame a
+        // single DecodeAt returns for it — no off-by-one across runs.
+        if (!m_hasTestVideo) QSKIP("No test video");
+        const std::string path = m_testVideoPath.toStdString();
+
+        auto info = TimelineMediaBuffer::ProbeFile(path);
+        QVERIFY(info.is_ok());
+        const auto& mi = info.value();
+        const int64_t total_frames = (mi.duration_us * mi.video_fps_num)
+                                   / (1000000LL * mi.video_fps_den);
+        const int total = static_cast<int>(std::min(int64_t(72), total_frames));
+        if (total < 48) QSKIP("Test video too short for range prefetch test");
+
+        auto tmb = TimelineMediaBuffer::Create(2);
+        tmb->SetTrackClips(V1, {{"clipRange", path, 0, total,
+                                 mi.first_frame_tc, mi.video_fps_num, mi.video_fps_den, 1.0f}});
+        tmb->SetSequenceRate(mi.video_fps_num, mi.video_fps_den);
+
+        emp::SetDecodeMode(emp::DecodeMode::Play);
+        tmb->SetPlayhead(0, 1, 1.0f);
+        const bool filled = poll_until_cached(tmb.get(), V1, total - 1, 5000);
+        emp::SetDecodeMode(emp::DecodeMode::Park);
+        tmb->SetPlayhead(0, 0, 1.0f);
+        QVERIFY2(filled, "forward prefetch did not reach the clip end");
+
+        auto ref_mf = MediaFile::Open(path);
+        QVERIFY(ref_mf.is_ok());
+        auto ref_reader = Reader::Create(ref_mf.value());
+        QVERIFY(ref_reader.is_ok());
+        const Rate rate = ref_mf.value()->info().video_rate();
+        for (int64_t f = 0; f < total; ++f) {
+            auto r = tmb->GetVideoFrame(V1, f, /*cache_only=*/true);
+            if (!r.frame) continue;  // dropped slot (deadline) — not a mismatch
+            auto ref = ref_reader.value()->DecodeAt(FrameTime::from_frame(f, rate));
+            QVERIFY(ref.is_ok());
+            QVERIFY2(r.frame->source_pts_us() == ref.value()->source_pts_us(),
+                     qPrintable(QString("frame %1: cached pts %2, DecodeAt pts %3")
+                                .arg(f).arg(r.frame->source_pts_us())
+                                .arg(ref.value()->source_pts_us())));
+        }
+    }
+
+    void test_range_decode_per_frame_cost() {
+        // Benchmark: VIDEO_RANGE_MAX_SLOTS frames through one DecodeRange vs
+        // one DecodeAt per frame, both on the Play path (no seeks after the
+        // first). Same frames; the range pass drops the per-frame seek
+        // decision and batch walk, and converts across SlicePool.
+        if (!m_hasTestVideo) QSKIP("No test video");
+        const std::string path = m_testVideoPath.toStdString();
+        constexpr int RUN = 24;
+
+        auto mf = MediaFile::Open(path);
+        QVERIFY(mf.is_ok());
+        const Rate rate = mf.value()->info().video_rate();
+        auto single_reader = Reader::Create(mf.value());
+        auto range_reader = Reader::Create(mf.value());
+        QVERIFY(single_reader.is_ok() && range_reader.is_ok());
+
+        // Warm both decoders (codec init, first seek) outside the timing.
+        QVERIFY(single_reader.value()->DecodeAt(FrameTime::from_frame(0, rate)).is_ok());
+        QVERIFY(range_reader.value()->DecodeAt(FrameTime::from_frame(0, rate)).is_ok());
+
+        emp::SetDecodeMode(emp::DecodeMode::Play);
+        std::vector<std::shared_ptr<Frame>> singles;
+        auto start = std::chrono::steady_clock::now();
+        for (int f = 1; f <= RUN; ++f) {
+            auto r = single_reader.value()->DecodeAt(FrameTime::from_frame(f, rate));
+            QVERIFY(r.is_ok());
+            singles.push_back(r.value());
+        }
+        const auto single_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        auto range = range_reader.value()->DecodeRange(
+            FrameTime::from_frame(1, rate), FrameTime::from_frame(RUN + 1, rate), 1);
+        const auto range_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        emp::SetDecodeMode(emp::DecodeMode::Park);
+
+        QVERIFY2(range.is_ok(), range.is_ok() ? "" : range.error().message.c_str());
+        QCOMPARE(static_cast<int>(range.value().size()), RUN);
+        for (int i = 0; i < RUN; ++i) {
+            QCOMPARE(range.value()[i]->source_pts_us(), singles[i]->source_pts_us());
+        }
+
+        qDebug() << "Per-frame decode:" << (single_us / RUN) << "us DecodeAt vs"
+                 << (range_us / RUN) << "us DecodeRange (" << RUN << "frames)";
+        // Generous bound for CI variance: the range pass must not lose.
+        QVERIFY2(range_us <= single_us + single_us / 2,
+                 qPrintable(QString("DecodeRange %1 us vs DecodeAt loop %2 us")
+                            .arg(range_us).arg(single_us)));
+    }
+
 };
 
 QTEST_MAIN(TestTimelineMediaBuffer)
@@ -0,0 +1,303 @@
+// Unit test + throughput benchmark for the native YUV → BGRA converter
+// (impl/yuv_convert.h) that replaces swscale on the SW decode hot path.
+//
+// Parity: for each native layout, output is checked against swscale
+// configured exactly as FFmpegScaleContext configures it (BGRA, bilinear,
+// default colorspace), at 1:1 and at the fused half-size downscale. Content
+// is smooth so the tolerance measures the conversion, not the two filters'
+// different treatment of edges. The SIMD row kernel must match the scalar
+// kernel bit for bit, including ragged widths that exercise the tail.
+//
+// Benchmark: per-format 4K frames/s, native (sliced) vs single-threaded
+// swscale, 1:1 and 4K → 1080p. Reported, not asserted — the ratio depends
+// on core count.
+
+#include <QtTest>
+
+#include "editor_media_platform/src/impl/yuv_convert.h"
+
+extern "C" {
+#include <libswscale/swscale.h>
+#include <libavutil/pixfmt.h>
+}
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using emp::impl::YuvConverter;
+using emp::impl::YuvLayout;
+using emp::impl::YuvRange;
+
+namespace {
+
+struct Format {
+    const char* name;
+    YuvLayout layout;
+    AVPixelFormat av_fmt;
+};
+
+const Format FORMATS[] = {
+    {"yuv420p", YuvLayout::I420, AV_PIX_FMT_YUV420P},
+    {"nv12", YuvLayout::NV12, AV_PIX_FMT_NV12},
+    {"yuv422p10le", YuvLayout::I422P10, AV_PIX_FMT_YUV422P10LE},
+    {"yuv444p", YuvLayout::I444, AV_PIX_FMT_YUV444P},
+};
+
+// Planes for one synthetic frame: a diagonal luma ramp with slowly varying
+// chroma, stored in `layout`'s plane arrangement and sample size.
+struct TestFrame {
+    int w = 0, h = 0;
+    std::vector<uint8_t> planes[3];
+    // Four entries: sws_scale reads data/linesize[0..3].
+    const uint8_t* data[4] = {nullptr, nullptr, nullptr, nullptr};
+    int strides[4] = {0, 0, 0, 0};
+
+    TestFrame(YuvLayout layout, int width, int height) : w(width), h(height) {
+        const bool ten = layout == YuvLayout::I422P10;
+        const int bps = ten ? 2 : 1;
+        const int sx = layout == YuvLayout::I444 ? 0 : 1;
+        const int sy = (layout == YuvLayout::I420 || layout == YuvLayout::NV12) ? 1 : 0;
+        const int cw = (w + (1 << sx) - 1) >> sx;
+        const int ch = (h + (1 << sy) - 1) >> sy;
+        const int max = ten ? 1023 : 255;
+        const double scale = ten ? 4.0 : 1.0;
+
+        auto put = [&](std::vector<uint8_t>& p, size_t idx, double v8) {
+            int v = std::clamp(static_cast<int>(std::lround(v8 * scale)), 0, max);
+            if (ten) {
+                const uint16_t s = static_cast<uint16_t>(v);
+                std::memcpy(&p[idx * 2], &s, 2);
+            } else {
+                p[idx] = static_cast<uint8_t>(v);
+            }
+        };
+
+        strides[0] = w * bps;
+        planes[0].resize(static_cast<size_t>(strides[0]) * h);
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                put(planes[0], static_cast<size_t>(y) * w + x, 16.0 + 219.0 * (x + y) / (w + h));
+
+        const double two_pi = 6.283185307179586;
+        auto u_at = [&](int x, int) { return 128.0 + 60.0 * std::sin(two_pi * x / cw); };
+        auto v_at = [&](int, int y) { return 128.0 + 60.0 * std::cos(two_pi * y / ch); };
+        if (layout == YuvLayout::NV12) {
+            strides[1] = cw * 2;
+            planes[1].resize(static_cast<size_t>(strides[1]) * ch);
+            for (int y = 0; y < ch; ++y)
+                for (int x = 0; x < cw; ++x) {
+                    put(planes[1], static_cast<size_t>(y) * cw * 2 + 2 * x, u_at(x, y));
+                    put(planes[1], static_cast<size_t>(y) * cw * 2 + 2 * x + 1, v_at(x, y));
+                }
+        } else {
+            for (int p = 1; p <= 2; ++p) {
+                strides[p] = cw * bps;
+                planes[p].resize(static_cast<size_t>(strides[p]) * ch);
+                for (int y = 0; y < ch; ++y)
+                    for (int x = 0; x < cw; ++x)
+                        put(planes[p], static_cast<size_t>(y) * cw + x,
+                            p == 1 ? u_at(x, y) : v_at(x, y));
+            }
+        }
+        for (int p = 0; p < 3; ++p) data[p] = planes[p].empty() ? nullptr : planes[p].data();
+    }
+};
+
+int bgra_stride(int w) { return ((w * 4) + 31) & ~31; }
+
+std::vector<uint8_t> convert_native(const TestFrame& f, YuvLayout layout, int dw, int dh,
+                                    bool simd = true) {
+    YuvConverter conv;
+    conv.init(layout, YuvRange::Limited, f.w, f.h, dw, dh, simd);
+    std::vector<uint8_t> out(static_cast<size_t>(bgra_stride(dw)) * dh, 0);
+    conv.convert(f.data, f.strides, out.data(), bgra_stride(dw));
+    return out;
+}
+
+std::vector<uint8_t> convert_swscale(const TestFrame& f, AVPixelFormat fmt, int dw, int dh) {
+    SwsContext* sws = sws_getContext(f.w, f.h, fmt, dw, dh, AV_PIX_FMT_BGRA,
+                                     SWS_BILINEAR, nullptr, nullptr, nullptr);
+    std::vector<uint8_t> out(static_cast<size_t>(bgra_stride(dw)) * dh, 0);
+    if (!sws) return {};
+    uint8_t* dst[4] = {out.data(), nullptr, nullptr, nullptr};
+    int dst_strides[4] = {bgra_stride(dw), 0, 0, 0};
+    sws_scale(sws, f.data, f.strides, 0, f.h, dst, dst_strides);
+    sws_freeContext(sws);
+    return out;
+}
+
+struct Diff { int max = 0; double mean = 0; };
+
+Diff compare(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int w, int h) {
+    Diff d;
+    int64_t sum = 0;
+    const int stride = bgra_stride(w);
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w * 4; ++x) {
+            const size_t i = static_cast<size_t>(y) * stride + x;
+            const int e = std::abs(int(a[i]) - int(b[i]));
+            d.max = std::max(d.max, e);
+            sum += e;
+        }
+    d.mean = static_cast<double>(sum) / (static_cast<double>(w) * h * 4);
+    return d;
+}
+
+template <typename Fn>
+double ms_per_frame(int frames, Fn fn) {
+    fn();  // warm: page in output, spin up slice workers
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; ++i) fn();
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - t0).count() / frames;
+}
+
+} // namespace
+
+class TestYuvConvert : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase() {
+        qDebug("YUV row kernel: %s", YuvConverter::simd_kernel_name());
+    }
+
+    void test_matches_swscale_data() {
+        QTest::addColumn<int>("format");
+        QTest::addColumn<int>("divisor");
+        for (int i = 0; i < 4; ++i) {
+            QTest::newRow(qPrintable(QString("%1 1:1").arg(FORMATS[i].name))) << i << 1;
+            QTest::newRow(qPrintable(QString("%1 1:2").arg(FORMATS[i].name))) << i << 2;
+        }
+    }
+
+    void test_matches_swscale() {
+        QFETCH(int, format);
+        QFETCH(int, divisor);
+        const Format& fmt = FORMATS[format];
+        const int w = 640, h = 360;
+        const int dw = w / divisor, dh = h / divisor;
+        TestFrame f(fmt.layout, w, h);
+
+        auto native = convert_native(f, fmt.layout, dw, dh);
+        auto ref = convert_swscale(f, fmt.av_fmt, dw, dh);
+        QVERIFY(!ref.empty());
+        const Diff d = compare(native, ref, dw, dh);
+        qDebug("%s %dx%d → %dx%d: max %d, mean %.3f", fmt.name, w, h, dw, dh, d.max, d.mean);
+
+        // swscale's table-driven and dithered paths round differently; a
+        // wrong matrix, range or chroma siting costs tens of code values.
+        QVERIFY2(d.max <= (divisor == 1 ? 6 : 8), "native converter diverges from swscale");
+        QVERIFY2(d.mean <= 2.0, "native converter biased against swscale");
+
+        // Alpha is opaque.
+        for (int x = 0; x < dw; ++x) QCOMPARE(int(native[static_cast<size_t>(x) * 4 + 3]), 255);
+    }
+
+    void test_simd_matches_scalar_bit_exact_data() {
+        QTest::addColumn<int>("format");
+        QTest::addColumn<int>("w");
+        QTest::addColumn<int>("h");
+        QTest::addColumn<int>("dw");
+        QTest::addColumn<int>("dh");
+        for (int i = 0; i < 4; ++i) {
+            // Ragged widths leave a scalar tail after the SIMD body.
+            QTest::newRow(qPrintable(QString("%1 odd").arg(FORMATS[i].name)))
+                << i << 333 << 77 << 333 << 77;
+            QTest::newRow(qPrintable(QString("%1 1080p").arg(FORMATS[i].name)))
+                << i << 1920 << 1080 << 1920 << 1080;
+            QTest::newRow(qPrintable(QString("%1 down 3x").arg(FORMATS[i].name)))
+                << i << 1920 << 1080 << 640 << 360;
+            QTest::newRow(qPrintable(QString("%1 down odd").arg(FORMATS[i].name)))
+                << i << 1001 << 563 << 417 << 250;
+        }
+    }
+
+    void test_simd_matches_scalar_bit_exact() {
+        QFETCH(int, format);
+        QFETCH(int, w);
+        QFETCH(int, h);
+        QFETCH(int, dw);
+        QFETCH(int, dh);
+        const Format& fmt = FORMATS[format];
+        TestFrame f(fmt.layout, w, h);
+        auto simd = convert_native(f, fmt.layout, dw, dh, true);
+        auto scalar = convert_native(f, fmt.layout, dw, dh, false);
+        QVERIFY(simd == scalar);
+    }
+
+    void test_full_range_uses_full_swing() {
+        // Y=0 and Y=255 with neutral chroma hit black and white exactly in
+        // full range; limited range clips them.
+        TestFrame f(YuvLayout::I444, 64, 32);
+        std::memset(f.planes[0].data(), 0, 64 * 16);
+        std::memset(f.planes[0].data() + 64 * 16, 255, 64 * 16);
+        std::memset(f.planes[1].data(), 128, f.planes[1].size());
+        std::memset(f.planes[2].data(), 128, f.planes[2].size());
+
+        YuvConverter conv;
+        conv.init(YuvLayout::I444, YuvRange::Full, 64, 32, 64, 32);
+        std::vector<uint8_t> out(static_cast<size_t>(bgra_stride(64)) * 32);
+        conv.convert(f.data, f.strides, out.data(), bgra_stride(64));
+        for (int c = 0; c < 3; ++c) {
+            QCOMPARE(int(out[c]), 0);
+            QCOMPARE(int(out[static_cast<size_t>(bgra_stride(64)) * 31 + c]), 255);
+        }
+    }
+
+    // ── Benchmark ──
+
+    void bench_4k_throughput_data() {
+        QTest::addColumn<int>("format");
+        for (int i = 0; i < 4; ++i) QTest::newRow(FORMATS[i].name) << i;
+    }
+
+    void bench_4k_throughput() {
+        QFETCH(int, format);
+        const Format& fmt = FORMATS[format];
+        const int w = 3840, h = 2160;
+        const int frames = 10;
+        TestFrame f(fmt.layout, w, h);
+
+        YuvConverter full, half;
+        full.init(fmt.layout, YuvRange::Limited, w, h, w, h);
+        half.init(fmt.layout, YuvRange::Limited, w, h, w / 2, h / 2);
+        std::vector<uint8_t> out(static_cast<size_t>(bgra_stride(w)) * h);
+
+        SwsContext* sws_full = sws_getContext(w, h, fmt.av_fmt, w, h, AV_PIX_FMT_BGRA,
+                                              SWS_BILINEAR, nullptr, nullptr, nullptr);
+        SwsContext* sws_half = sws_getContext(w, h, fmt.av_fmt, w / 2, h / 2, AV_PIX_FMT_BGRA,
+                                              SWS_BILINEAR, nullptr, nullptr, nullptr);
+        QVERIFY(sws_full && sws_half);
+        auto run_sws = [&](SwsContext* sws, int dw) {
+            uint8_t* dst[4] = {out.data(), nullptr, nullptr, nullptr};
+            int strides[4] = {bgra_stride(dw), 0, 0, 0};
+            sws_scale(sws, f.data, f.strides, 0, h, dst, strides);
+        };
+
+        const double native_full = ms_per_frame(frames, [&] {
+            full.convert(f.data, f.strides, out.data(), bgra_stride(w)); });
+        const double native_half = ms_per_frame(frames, [&] {
+            half.convert(f.data, f.strides, out.data(), bgra_stride(w / 2)); });
+        const double swscale_full = ms_per_frame(frames, [&] { run_sws(sws_full, w); });
+        const double swscale_half = ms_per_frame(frames, [&] { run_sws(sws_half, w / 2); });
+        sws_freeContext(sws_full);
+        sws_freeContext(sws_half);
+
+        const double mpix = static_cast<double>(w) * h / 1e6;
+        qDebug("%s 4K → BGRA (%s):", fmt.name, YuvConverter::simd_kernel_name());
+        qDebug("  1:1    native %6.2f ms (%6.0f Mpix/s)  swscale %6.2f ms (%6.0f Mpix/s)  %.1fx",
+               native_full, mpix / native_full * 1000.0,
+               swscale_full, mpix / swscale_full * 1000.0, swscale_full / native_full);
+        qDebug("  →1080p native %6.2f ms (%6.0f Mpix/s)  swscale %6.2f ms (%6.0f Mpix/s)  %.1fx",
+               native_half, mpix / native_half * 1000.0,
+               swscale_half, mpix / swscale_half * 1000.0, swscale_half / native_half);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestYuvConvert)
+#include "test_yuv_convert.moc"
@@ -0,0 +1,353 @@
+// Unit test for planar YUV frame storage — Frame::pixel_format() != BGRA32,
+// produced by Reader::SetYuvOutput for the TMB cache.
+//
+// Storage half (no media): a YUV frame built from yuv_resample_planes
+// reports its planar size from data_size() (what TMB charges), converts
+// through CopyBGRA exactly as YuvConverter does, and converting keeps no
+// BGRA copy (data_size() unchanged). yuv_resample_planes copies
+// planes bit-exactly at 1:1 and box-averages constant planes to the same
+// constants when downscaling.
+//
+// Reader half (needs test_bars_tone.mp4): a YUV reader's frame is ~1.5
+// bytes/pixel and its CopyBGRA matches the default (BGRA) reader's frame —
+// exactly at source size, within box-filter tolerance when
+// SetMaxOutputResolution downscales. At source size the frame references
+// the decoder's buffers (zero-copy) and stays intact while decoding goes on.
+
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+
+#include <editor_media_platform/emp_frame.h>
+#include <editor_media_platform/emp_frame_arena.h>
+#include <editor_media_platform/emp_media_file.h>
+#include <editor_media_platform/emp_reader.h>
+#include <editor_media_platform/emp_time.h>
+#include "editor_media_platform/src/impl/frame_impl.h"
+#include "editor_media_platform/src/impl/yuv_convert.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using emp::impl::YuvLayout;
+using emp::impl::YuvPlaneGeometry;
+
+namespace {
+
+int bgra_stride(int w) { return ((w * 4) + 31) & ~31; }
+
+// Fill every sample of the planes in `buf` (laid out per g) with a pattern
+// that varies per plane, row and column; 10-bit samples stay <= 1023.
+void fill_planes(YuvLayout layout, const YuvPlaneGeometry& g, uint8_t* buf) {
+    for (int p = 0; p < g.planes; ++p) {
+        const int samples = g.width[p] * (layout == YuvLayout::NV12 && p == 1 ? 2 : 1);
+        for (int y = 0; y < g.height[p]; ++y) {
+            uint8_t* row = buf + g.offset[p] + static_cast<size_t>(y) * g.stride[p];
+            for (int x = 0; x < samples; ++x) {
+                const int v = (x * 7 + y * 3 + p * 41) % 220 + 16;
+                if (g.bytes_per_sample == 2) {
+                    const uint16_t s = static_cast<uint16_t>(v * 4);
+                    std::memcpy(row + 2 * x, &s, 2);
+                } else {
+                    row[x] = static_cast<uint8_t>(v);
+                }
+            }
+        }
+    }
+}
+
+void plane_pointers(const YuvPlaneGeometry& g, const uint8_t* buf,
+                    const uint8_t* planes[3], int strides[3]) {
+    for (int p = 0; p < 3; ++p) {
+        planes[p] = p < g.planes ? buf + g.offset[p] : nullptr;
+        strides[p] = p < g.planes ? g.stride[p] : 0;
+    }
+}
+
+// A YUV Frame over a malloc'd copy of `src` (freed by the FrameImpl).
+std::shared_ptr<emp::Frame> make_yuv_frame(YuvLayout layout, emp::PixelFormat fmt,
+                                           int w, int h, const std::vector<uint8_t>& src) {
+    const YuvPlaneGeometry g = emp::impl::yuv_plane_geometry(layout, w, h);
+    auto* buf = static_cast<uint8_t*>(std::malloc(g.total));
+    std::memcpy(buf, src.data(), g.total);
+
+    emp::FrameImpl::YuvPlanes yuv;
+    yuv.format = fmt;
+    yuv.colorspace = emp::ColorSpace::BT709;
+    for (int p = 0; p < g.planes; ++p) {
+        yuv.plane[p] = buf + g.offset[p];
+        yuv.stride[p] = g.stride[p];
+    }
+    return std::make_shared<emp::Frame>(
+        std::make_unique<emp::FrameImpl>(w, h, 0, yuv, buf, g.total));
+}
+
+struct LayoutCase {
+    YuvLayout layout;
+    emp::PixelFormat format;
+};
+
+const LayoutCase LAYOUTS[] = {
+    {YuvLayout::I420, emp::PixelFormat::YUV420P},
+    {YuvLayout::NV12, emp::PixelFormat::NV12},
+    {YuvLayout::I422P10, emp::PixelFormat::YUV422P10},
+    {YuvLayout::I444, emp::PixelFormat::YUV444P},
+};
+
+} // namespace
+
+class TestYuvFrame : public QObject
+{
+    Q_OBJECT
+
+private:
+    QString m_videoPath;
+
+    // Mean and max absolute BGR difference between two w x h BGRA images.
+    static void compare_bgra(const uint8_t* a, int a_stride, const uint8_t* b, int b_stride,
+                             int w, int h, double* mean, int* max) {
+        long long sum = 0;
+        *max = 0;
+        for (int y = 0; y < h; ++y) {
+            const uint8_t* ra = a + static_cast<size_t>(y) * a_stride;
+            const uint8_t* rb = b + static_cast<size_t>(y) * b_stride;
+            for (int x = 0; x < w * 4; ++x) {
+                if (x % 4 == 3) continue;
+                const int d = std::abs(int(ra[x]) - int(rb[x]));
+                sum += d;
+                *max = std::max(*max, d);
+            }
+        }
+        *mean = double(sum) / (double(w) * h * 3);
+    }
+
+private slots:
+    void initTestCase() {
+        QStringList searchDirs = {
+            QDir::homePath() + "/Local/jve/tests/fixtures/media",
+            QDir::currentPath() + "/../tests/fixtures/media",
+        };
+        for (const auto& dirPath : searchDirs) {
+            QString candidate = QDir(dirPath).absoluteFilePath("test_bars_tone.mp4");
+            if (QFile::exists(candidate)) { m_videoPath = candidate; return; }
+        }
+    }
+
+    void yuvFrameStorageAndConversion() {
+        const int w = 1920, h = 1080;
+        for (const auto& c : LAYOUTS) {
+            const YuvPlaneGeometry g = emp::impl::yuv_plane_geometry(c.layout, w, h);
+            std::vector<uint8_t> src(g.total, 0);
+            fill_planes(c.layout, g, src.data());
+
+            auto frame = make_yuv_frame(c.layout, c.format, w, h, src);
+            QVERIFY(frame->is_yuv());
+            QCOMPARE(frame->pixel_format(), c.format);
+            QCOMPARE(frame->bit_depth(), c.layout == YuvLayout::I422P10 ? 10 : 8);
+            QCOMPARE(frame->colorspace(), emp::ColorSpace::BT709);
+            QCOMPARE(frame->data_size(), g.total);
+            QCOMPARE(frame->plane_stride(0), g.stride[0]);
+            QVERIFY(frame->plane_data(1) != nullptr);
+            QCOMPARE(frame->plane_data(2) != nullptr, g.planes == 3);
+
+            const size_t bgra_bytes = static_cast<size_t>(bgra_stride(w)) * h;
+            if (c.layout == YuvLayout::I420 || c.layout == YuvLayout::NV12) {
+                // 4:2:0 8-bit: 1.5 bytes/pixel (plus row padding) vs BGRA's 4.
+                QVERIFY2(frame->data_size() * 10 < bgra_bytes * 4,
+                         qPrintable(QString("%1 bytes vs BGRA %2")
+                             .arg(frame->data_size()).arg(bgra_bytes)));
+            }
+
+            // CopyBGRA == YuvConverter on the same planes.
+            const uint8_t* planes[3];
+            int strides[3];
+            plane_pointers(g, src.data(), planes, strides);
+            emp::impl::YuvConverter conv;
+            conv.init(c.layout, emp::impl::YuvRange::Limited, w, h, w, h);
+            std::vector<uint8_t> expected(bgra_bytes, 0);
+            conv.convert(planes, strides, expected.data(), bgra_stride(w));
+
+            std::vector<uint8_t> copied(bgra_bytes, 0);
+            frame->CopyBGRA(copied.data(), bgra_stride(w));
+            QVERIFY(copied == expected);
+
+            // Converting leaves nothing behind in the frame.
+            QCOMPARE(frame->stride_bytes(), bgra_stride(w));
+            QCOMPARE(frame->data_size(), g.total);
+        }
+    }
+
+    void bgraFrameReportsBgra() {
+        const int w = 64, h = 32, stride = bgra_stride(w);
+        std::vector<uint8_t> px(static_cast<size_t>(stride) * h);
+        for (size_t i = 0; i < px.size(); ++i) px[i] = static_cast<uint8_t>(i * 13);
+        auto frame = emp::Frame::CreateCPU(w, h, stride, 0, px);
+        QVERIFY(!frame->is_yuv());
+        QCOMPARE(frame->pixel_format(), emp::PixelFormat::BGRA32);
+        QVERIFY(frame->plane_data(0) == nullptr);
+
+        // CopyBGRA to a tighter stride copies width*4 bytes per row.
+        std::vector<uint8_t> out(static_cast<size_t>(w) * 4 * h, 0);
+        frame->CopyBGRA(out.data(), w * 4);
+        for (int y = 0; y < h; ++y) {
+            QVERIFY(std::memcmp(out.data() + static_cast<size_t>(y) * w * 4,
+                                px.data() + static_cast<size_t>(y) * stride, w * 4) == 0);
+        }
+    }
+
+    void resamplePlanesCopyAndDownscale() {
+        const int w = 1280, h = 720;
+        for (const auto& c : LAYOUTS) {
+            const YuvPlaneGeometry g = emp::impl::yuv_plane_geometry(c.layout, w, h);
+            std::vector<uint8_t> src(g.total, 0);
+            fill_planes(c.layout, g, src.data());
+            const uint8_t* planes[3];
+            int strides[3];
+            plane_pointers(g, src.data(), planes, strides);
+
+            // 1:1 — every sample copied.
+            std::vector<uint8_t> same(g.total, 0);
+            emp::impl::yuv_resample_planes(c.layout, planes, strides, w, h, same.data(), g);
+            for (int p = 0; p < g.planes; ++p) {
+                const size_t row_bytes = static_cast<size_t>(g.width[p]) * g.bytes_per_sample *
+                    (c.layout == YuvLayout::NV12 && p == 1 ? 2 : 1);
+                for (int y = 0; y < g.height[p]; ++y) {
+                    const size_t off = g.offset[p] + static_cast<size_t>(y) * g.stride[p];
+                    QVERIFY(std::memcmp(same.data() + off, src.data() + off, row_bytes) == 0);
+                }
+            }
+
+            // Downscale of a constant frame: every output sample is that constant.
+            std::vector<uint8_t> flat(g.total, 0);
+            for (int p = 0; p < g.planes; ++p) {
+                uint8_t* base = flat.data() + g.offset[p];
+                const int samples = g.width[p] * (c.layout == YuvLayout::NV12 && p == 1 ? 2 : 1);
+                for (int y = 0; y < g.height[p]; ++y) {
+                    for (int x = 0; x < samples; ++x) {
+                        uint8_t* s = base + static_cast<size_t>(y) * g.stride[p] + x * g.bytes_per_sample;
+                        if (g.bytes_per_sample == 2) {
+                            const uint16_t v = 600;
+                            std::memcpy(s, &v, 2);
+                        } else {
+                            *s = 90;
+                        }
+                    }
+                }
+            }
+            plane_pointers(g, flat.data(), planes, strides);
+            const YuvPlaneGeometry dg = emp::impl::yuv_plane_geometry(c.layout, 853, 480);
+            std::vector<uint8_t> small(dg.total, 0);
+            emp::impl::yuv_resample_planes(c.layout, planes, strides, w, h, small.data(), dg);
+            for (int p = 0; p < dg.planes; ++p) {
+                const int samples = dg.width[p] * (c.layout == YuvLayout::NV12 && p == 1 ? 2 : 1);
+                for (int y = 0; y < dg.height[p]; ++y) {
+                    const uint8_t* row = small.data() + dg.offset[p] + static_cast<size_t>(y) * dg.stride[p];
+                    for (int x = 0; x < samples; ++x) {
+                        int v;
+                        if (dg.bytes_per_sample == 2) {
+                            uint16_t s;
+                            std::memcpy(&s, row + 2 * x, 2);
+                            v = s;
+                        } else {
+                            v = row[x];
+                        }
+                        QCOMPARE(v, dg.bytes_per_sample == 2 ? 600 : 90);
+                    }
+                }
+            }
+        }
+    }
+
+    void readerYuvOutputMatchesBgra() {
+        if (m_videoPath.isEmpty()) QSKIP("test_bars_tone.mp4 not found");
+
+        auto mf_result = emp::MediaFile::Open(m_videoPath.toStdString());
+        QVERIFY(mf_result.is_ok());
+        auto mf = mf_result.value();
+        const emp::Rate rate = mf->info().video_rate();
+
+        auto bgra_reader = emp::Reader::Create(mf);
+        auto yuv_reader = emp::Reader::Create(mf);
+        QVERIFY(bgra_reader.is_ok() && yuv_reader.is_ok());
+        yuv_reader.value()->SetYuvOutput(true);
+        QVERIFY(yuv_reader.value()->YuvOutput());
+
+        const auto t = emp::FrameTime::from_frame(10, rate);
+        auto a = bgra_reader.value()->DecodeAt(t);
+        auto b = yuv_reader.value()->DecodeAt(t);
+        QVERIFY(a.is_ok() && b.is_ok());
+        auto bgra = a.value();
+        auto yuv = b.value();
+        if (bgra_reader.value()->IsHwAccelerated() || !yuv->is_yuv()) {
+            QSKIP("frame not SW-decoded in a native YUV layout");
+        }
+
+        QCOMPARE(yuv->width(), bgra->width());
+        QCOMPARE(yuv->height(), bgra->height());
+        QVERIFY(yuv->data_size() * 2 < bgra->data_size());
+
+        const int w = yuv->width(), h = yuv->height();
+        std::vector<uint8_t> out(static_cast<size_t>(bgra_stride(w)) * h, 0);
+        yuv->CopyBGRA(out.data(), bgra_stride(w));
+        double mean = 0;
+        int max = 0;
+        compare_bgra(out.data(), bgra_stride(w), bgra->data(), bgra->stride_bytes(),
+                     w, h, &mean, &max);
+        QCOMPARE(max, 0);
+
+        // Downscaled: the YUV path box-filters planes then converts 1:1; the
+        // BGRA path fuses both. Same box, chroma sited differently.
+        bgra_reader.value()->SetMaxOutputResolution(w / 2, h / 2);
+        yuv_reader.value()->SetMaxOutputResolution(w / 2, h / 2);
+        a = bgra_reader.value()->DecodeAt(t);
+        b = yuv_reader.value()->DecodeAt(t);
+        QVERIFY(a.is_ok() && b.is_ok());
+        bgra = a.value();
+        yuv = b.value();
+        QVERIFY(yuv->is_yuv());
+        QCOMPARE(yuv->width(), bgra->width());
+        QCOMPARE(yuv->height(), bgra->height());
+        const int sw = yuv->width(), sh = yuv->height();
+        std::vector<uint8_t> small(static_cast<size_t>(bgra_stride(sw)) * sh, 0);
+        yuv->CopyBGRA(small.data(), bgra_stride(sw));
+        compare_bgra(small.data(), bgra_stride(sw), bgra->data(), bgra->stride_bytes(),
+                     sw, sh, &mean, &max);
+        QVERIFY2(mean <= 2.0, qPrintable(QString("mean diff %1").arg(mean)));
+    }
+
+    void readerYuvFrameReferencesDecoderBuffers() {
+        // At source size a YUV frame wraps the decoder's refcounted planes:
+        // no arena buffer is taken, and the pixels survive further decoding
+        // on the same reader (the decoder can't recycle a referenced buffer).
+        if (m_videoPath.isEmpty()) QSKIP("test_bars_tone.mp4 not found");
+
+        auto mf = emp::MediaFile::Open(m_videoPath.toStdString()).value();
+        const emp::Rate rate = mf->info().video_rate();
+        auto reader = emp::Reader::Create(mf).value();
+        if (reader->IsHwAccelerated()) QSKIP("HW frames are wrapped CVPixelBuffers");
+        reader->SetYuvOutput(true);
+
+        const int64_t in_use_before = emp::GetFrameArenaStats().in_use_bytes;
+        auto r = reader->DecodeAt(emp::FrameTime::from_frame(10, rate));
+        QVERIFY(r.is_ok());
+        auto frame = r.value();
+        if (!frame->is_yuv()) QSKIP("fixture not in a native YUV layout");
+        QCOMPARE(emp::GetFrameArenaStats().in_use_bytes, in_use_before);
+
+        const int w = frame->width(), h = frame->height();
+        std::vector<uint8_t> first(static_cast<size_t>(bgra_stride(w)) * h, 0);
+        frame->CopyBGRA(first.data(), bgra_stride(w));
+
+        for (int64_t f = 11; f < 40; ++f) {
+            QVERIFY(reader->DecodeAt(emp::FrameTime::from_frame(f, rate)).is_ok());
+        }
+        std::vector<uint8_t> again(first.size(), 0);
+        frame->CopyBGRA(again.data(), bgra_stride(w));
+        QVERIFY(again == first);
+    }
+};
+
+QTEST_MAIN(TestYuvFrame)
+#include "test_yuv_frame.moc"